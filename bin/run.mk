@@ -19,6 +19,14 @@ LIBS = $(HPHP_LIB)/libhphp_runtime.a $(ALL_LIBS)
 
 include $(HPHP_HOME)/src/rules.mk
 
+# Hot functions are laid out following the call profile, see HOT_FUNCTION().
+# Only gold understands the ordering file.
+ifndef NO_GOLD
+ifneq ($(wildcard section_order.txt),)
+LDFLAGS += -Xlinker --section-ordering-file -Xlinker section_order.txt
+endif
+endif
+
 ifdef HPHP_BUILD_LIBRARY
 TARGETS = $(STATIC_LIB) $(SHARED_LIB)
 else
@@ -32,6 +32,7 @@
 #include <lib/system/gen/php/classes/stdclass.h>
 #include <cpp/base/variable_serializer.h>
 #include <cpp/base/array/zend_array.h>
+#include <cpp/base/array/hphp_array.h>
 #include <cpp/base/runtime_option.h>
 
 using namespace std;
@@ -42,14 +43,28 @@ namespace HPHP {
 
 ArrayData *ArrayData::Create() {
   if (RuntimeOption::UseZendArray) {
+    if (RuntimeOption::UseHphpArray) {
+      return StaticEmptyHphpArray::Get();
+    }
     return StaticEmptyZendArray::Get();
   }
   return StaticEmptyArray::Get();
 }
 
+ArrayData *ArrayData::CreateWithCapacity(uint capacity) {
+  if (RuntimeOption::UseZendArray) {
+    if (RuntimeOption::UseHphpArray) {
+      return NEW(HphpArray)(capacity);
+    }
+    return NEW(ZendArray)(capacity);
+  }
+  return StaticEmptyArray::Get();
+}
+
 ArrayData *ArrayData::Create(CVarRef value) {
   if (RuntimeOption::UseZendArray) {
-    ArrayData *ret = NEW(ZendArray)(1);
+    ArrayData *ret = RuntimeOption::UseHphpArray ?
+      (ArrayData *)NEW(HphpArray)(1) : (ArrayData *)NEW(ZendArray)(1);
     ret->append(value, false);
     return ret;
   }
@@ -74,7 +89,8 @@ ArrayData *ArrayData::Create(CVarRef value) {
 
 ArrayData *ArrayData::Create(CVarRef name, CVarRef value) {
   if (RuntimeOption::UseZendArray) {
-    ArrayData *ret = NEW(ZendArray)(1);
+    ArrayData *ret = RuntimeOption::UseHphpArray ?
+      (ArrayData *)NEW(HphpArray)(1) : (ArrayData *)NEW(ZendArray)(1);
     ret->set(name, value, false);
     return ret;
   }
@@ -119,7 +135,8 @@ ArrayData *ArrayData::Create(const std::vector<ArrayElement *> &elems,
 
   if (RuntimeOption::UseZendArray) {
     uint size = elems.size();
-    ArrayData *ret = NEW(ZendArray)(size);
+    ArrayData *ret = RuntimeOption::UseHphpArray ?
+      (ArrayData *)NEW(HphpArray)(size) : (ArrayData *)NEW(ZendArray)(size);
     for (unsigned int i = 0; i < size; i++) {
       ArrayElement *elem = elems[i];
       if (elem->hasName()) {
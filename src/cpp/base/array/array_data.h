@@ -56,6 +56,13 @@ class ArrayData : public Countable {
   static ArrayData *Create(const std::vector<ArrayElement *> &elems,
                            bool replace = true);
 
+  /**
+   * An empty array with room for "capacity" elements, so its elements stay
+   * where they are until it gets that many, for array types that can
+   * reserve the room. Others get an empty array to escalate.
+   */
+  static ArrayData *CreateWithCapacity(uint capacity);
+
   /**
    * Type conversion functions. All other types are handled inside Array class.
    */
@@ -226,6 +233,14 @@ class ArrayData : public Countable {
    */
   virtual void renumber() {}
 
+  /**
+   * in_array() helper for arrays that keep an index of their values. Returns
+   * false when the caller has to search the values one by one.
+   */
+  virtual bool valueIndexLookup(CVarRef v, bool strict, bool &found) const {
+    return false;
+  }
+
   /**
    * When an array data is set static, some calculated data members need to
    * be initialized, for example, Map::getKeyVector(). More importantly, all
@@ -1,5 +1,6 @@
 #include <cpp/base/array/array_init.h>
 #include <cpp/base/array/zend_array.h>
+#include <cpp/base/array/hphp_array.h>
 #include <cpp/base/runtime_option.h>
 
 namespace HPHP {
@@ -8,7 +9,11 @@ namespace HPHP {
 
 ArrayInit::ArrayInit(int n) : m_elements(NULL), m_data(NULL) {
   if (RuntimeOption::UseZendArray) {
-    m_data = NEW(ZendArray)(n);
+    if (RuntimeOption::UseHphpArray) {
+      m_data = NEW(HphpArray)(n);
+    } else {
+      m_data = NEW(ZendArray)(n);
+    }
   } else {
     // released in create()
     m_elements = new ArrayElementVec(n);
@@ -63,6 +63,13 @@ public:
   ArrayIter(CArrRef array);
   ~ArrayIter();
 
+  /**
+   * Borrowing the array without taking a reference. Generated code only uses
+   * this when static analysis proved the array outlives the iteration.
+   */
+  enum NoIncRef { noIncRef };
+  ArrayIter(CArrRef array, NoIncRef);
+
   virtual bool end();
   virtual void next();
   virtual Variant first();
@@ -72,6 +79,7 @@ public:
 private:
   const ArrayData *m_data;
   ssize_t m_pos;
+  bool m_borrowed;
 
   void create();
 };
@@ -81,7 +89,8 @@ private:
 struct FullPos {
   ssize_t primary;
   ssize_t secondary;
-  FullPos() : primary(0), secondary(0) {}
+  const void *key; // HphpArray only: the key's StringData, NULL for ints
+  FullPos() : primary(0), secondary(0), key(NULL) {}
 };
 
 /**
@@ -15,6 +15,7 @@
 */
 
 #include <cpp/base/array/array_util.h>
+#include <cpp/base/array/value_index.h>
 #include <cpp/base/string_util.h>
 #include <cpp/base/builtin_functions.h>
 #include <util/logger.h>
@@ -467,13 +468,11 @@ Array ArrayUtil::Filter(CArrRef input, PFUNC_FILTER filter /* = NULL */,
 }
 
 Array ArrayUtil::Unique(CArrRef input) {
-  Array seenValues;
+  ValueIndex seenValues(true);
   Array ret = Array::Create();
   for (ArrayIter iter(input); iter; ++iter) {
     Variant entry = iter.second();
-    String str(entry.toString());
-    if (!seenValues.exists(str)) {
-      seenValues.set(str, 1);
+    if (seenValues.add(entry)) {
       ret.set(iter.first(), entry);
     }
   }
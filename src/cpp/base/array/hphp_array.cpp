@@ -0,0 +1,1049 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010 Facebook, Inc. (http://www.facebook.com)          |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include <cpp/base/array/hphp_array.h>
+#include <cpp/base/type_string.h>
+#include <cpp/base/type_array.h>
+#include <cpp/base/memory/size_class_allocator.h>
+#include <util/hash.h>
+
+namespace HPHP {
+
+IMPLEMENT_SMART_ALLOCATION(HphpArray, SmartAllocatorImpl::NeedRestoreOnce);
+///////////////////////////////////////////////////////////////////////////////
+// static members
+
+StaticEmptyHphpArray StaticEmptyHphpArray::s_theEmptyArray;
+
+///////////////////////////////////////////////////////////////////////////////
+// construction/destruciton
+
+HphpArray::HphpArray(uint nSize /* = 0 */) :
+  m_data(NULL), m_hash(NULL), m_used(0), m_size(0), m_hashMask(0),
+  m_hashDeleted(0), m_nextKI(0) {
+  m_pos = ArrayData::invalid_index;
+  if (nSize >= 0x40000000) {
+    m_capacity = 0x40000000; // prevent overflow
+  } else {
+    m_capacity = MinCapacity;
+    while (m_capacity < nSize) {
+      m_capacity <<= 1;
+    }
+  }
+  m_data = (Elm *)smart_malloc(m_capacity * sizeof(Elm));
+}
+
+HphpArray::~HphpArray() {
+  for (uint i = 0; i < m_used; i++) {
+    Elm &e = m_data[i];
+    if (IsLive(e)) {
+      if (e.key && e.key->decRefCount() == 0) {
+        DELETE(StringData)(e.key);
+      }
+      e.data.~Variant();
+    }
+  }
+  if (m_data) {
+    smart_free(m_data);
+  }
+  if (m_hash) {
+    smart_free(m_hash);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// iterations
+
+ssize_t HphpArray::nextLive(ssize_t pos) const {
+  for (; pos < (ssize_t)m_used; pos++) {
+    if (IsLive(m_data[pos])) return pos;
+  }
+  return ArrayData::invalid_index;
+}
+
+ssize_t HphpArray::prevLive(ssize_t pos) const {
+  for (; pos >= 0; pos--) {
+    if (IsLive(m_data[pos])) return pos;
+  }
+  return ArrayData::invalid_index;
+}
+
+ssize_t HphpArray::iter_begin() const {
+  return nextLive(0);
+}
+
+ssize_t HphpArray::iter_end() const {
+  return prevLive((ssize_t)m_used - 1);
+}
+
+ssize_t HphpArray::iter_advance(ssize_t prev) const {
+  if (prev == ArrayData::invalid_index) {
+    return ArrayData::invalid_index;
+  }
+  return nextLive(prev + 1);
+}
+
+ssize_t HphpArray::iter_rewind(ssize_t prev) const {
+  if (prev == ArrayData::invalid_index) {
+    return ArrayData::invalid_index;
+  }
+  return prevLive(prev - 1);
+}
+
+Variant HphpArray::getKey(ssize_t pos) const {
+  ASSERT(pos >= 0 && pos < (ssize_t)m_used && IsLive(m_data[pos]));
+  Elm &e = m_data[pos];
+  if (e.key) {
+    return e.key;
+  }
+  return (int64)e.h;
+}
+
+Variant HphpArray::getValue(ssize_t pos) const {
+  ASSERT(pos >= 0 && pos < (ssize_t)m_used && IsLive(m_data[pos]));
+  // callers may write through the reference
+  m_valueIndex.clear();
+  return m_data[pos].data;
+}
+
+CVarRef HphpArray::getValueRef(ssize_t pos) const {
+  ASSERT(pos >= 0 && pos < (ssize_t)m_used && IsLive(m_data[pos]));
+  return m_data[pos].data;
+}
+
+bool HphpArray::isVectorData() const {
+  if (!m_hash) {
+    return true;
+  }
+  int64 index = 0;
+  for (uint i = 0; i < m_used; i++) {
+    Elm &e = m_data[i];
+    if (!IsLive(e)) continue;
+    if (e.key || e.h != index++) return false;
+  }
+  return true;
+}
+
+Variant HphpArray::reset() {
+  m_pos = iter_begin();
+  if (m_pos != ArrayData::invalid_index) {
+    return m_data[m_pos].data;
+  }
+  return false;
+}
+
+Variant HphpArray::prev() {
+  if (m_pos != ArrayData::invalid_index) {
+    m_pos = iter_rewind(m_pos);
+    if (m_pos != ArrayData::invalid_index) {
+      return m_data[m_pos].data;
+    }
+  }
+  return false;
+}
+
+Variant HphpArray::next() {
+  if (m_pos != ArrayData::invalid_index) {
+    m_pos = iter_advance(m_pos);
+    if (m_pos != ArrayData::invalid_index) {
+      return m_data[m_pos].data;
+    }
+  }
+  return false;
+}
+
+Variant HphpArray::end() {
+  m_pos = iter_end();
+  if (m_pos != ArrayData::invalid_index) {
+    return m_data[m_pos].data;
+  }
+  return false;
+}
+
+Variant HphpArray::key() const {
+  if (m_pos != ArrayData::invalid_index) {
+    return getKey(m_pos);
+  }
+  return null;
+}
+
+Variant HphpArray::value(ssize_t &pos) const {
+  if (idxExists(pos)) {
+    return m_data[pos].data;
+  }
+  return false;
+}
+
+Variant HphpArray::current() const {
+  if (m_pos != ArrayData::invalid_index) {
+    return m_data[m_pos].data;
+  }
+  return false;
+}
+
+Variant HphpArray::each() {
+  if (m_pos != ArrayData::invalid_index) {
+    Array ret;
+    Variant key = getKey(m_pos);
+    Variant value = getValue(m_pos);
+    ret.set(1, value);
+    ret.set("value", value);
+    ret.set(0, key);
+    ret.set("key", key);
+    m_pos = iter_advance(m_pos);
+    return ret;
+  }
+  return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// lookups
+
+/**
+ * Index table is probed with triangular numbers, which visits every entry
+ * of a power-of-2 sized table. addElm() rehashes before live and deleted
+ * entries together take up more than half of the table, so an empty one
+ * always ends the search.
+ */
+#define FOR_EACH_PROBE(i, h)                                            \
+  for (size_t i = (size_t)(h) & m_hashMask, probe = 1; ;                \
+       i = (i + probe++) & m_hashMask)
+
+ssize_t HphpArray::find(int64 h) const {
+  if (!m_hash) {
+    return (uint64)h < m_used ? (ssize_t)h : ArrayData::invalid_index;
+  }
+  FOR_EACH_PROBE(i, h) {
+    int32 pos = m_hash[i];
+    if (pos == EmptySlot) {
+      return ArrayData::invalid_index;
+    }
+    if (pos >= 0) {
+      Elm &e = m_data[pos];
+      if (e.key == NULL && e.h == h) {
+        return pos;
+      }
+    }
+  }
+}
+
+ssize_t HphpArray::find(const char *k, int len,
+                        int64 prehash /* = -1 */,
+                        int64 *h /* = NULL */) const {
+  if (prehash < 0) {
+    prehash = hash_string(k, len);
+    if (h) {
+      *h = prehash;
+    }
+  }
+  if (!m_hash) {
+    return ArrayData::invalid_index;
+  }
+  FOR_EACH_PROBE(i, prehash) {
+    int32 pos = m_hash[i];
+    if (pos == EmptySlot) {
+      return ArrayData::invalid_index;
+    }
+    if (pos >= 0) {
+      Elm &e = m_data[pos];
+      if (e.key && e.h == prehash && e.key->size() == len &&
+          memcmp(e.key->data(), k, len) == 0) {
+        return pos;
+      }
+    }
+  }
+}
+
+int32 *HphpArray::findForInsert(int64 h) const {
+  ASSERT(m_hash);
+  FOR_EACH_PROBE(i, h) {
+    if (m_hash[i] < 0) {
+      return &m_hash[i];
+    }
+  }
+}
+
+bool HphpArray::exists(int64 k, int64 prehash /* = -1 */) const {
+  return find(k) != ArrayData::invalid_index;
+}
+
+bool HphpArray::exists(litstr k, int64 prehash /* = -1 */) const {
+  return find(k, strlen(k), prehash) != ArrayData::invalid_index;
+}
+
+bool HphpArray::exists(CStrRef k, int64 prehash /* = -1 */) const {
+  return find(k.data(), k.size(), prehash) != ArrayData::invalid_index;
+}
+
+bool HphpArray::exists(CVarRef k, int64 prehash /* = -1 */) const {
+  return getIndex(k, prehash) != ArrayData::invalid_index;
+}
+
+bool HphpArray::idxExists(ssize_t idx) const {
+  return idx >= 0 && idx < (ssize_t)m_used && IsLive(m_data[idx]);
+}
+
+Variant HphpArray::get(int64 k, int64 prehash /* = -1 */) const {
+  ssize_t pos = find(k);
+  if (pos != ArrayData::invalid_index) {
+    return m_data[pos].data;
+  }
+  return null;
+}
+
+Variant HphpArray::get(litstr k, int64 prehash /* = -1 */) const {
+  ssize_t pos = find(k, strlen(k), prehash);
+  if (pos != ArrayData::invalid_index) {
+    return m_data[pos].data;
+  }
+  return null;
+}
+
+Variant HphpArray::get(CStrRef k, int64 prehash /* = -1 */) const {
+  ssize_t pos = find(k.data(), k.size(), prehash);
+  if (pos != ArrayData::invalid_index) {
+    return m_data[pos].data;
+  }
+  return null;
+}
+
+Variant HphpArray::get(CVarRef k, int64 prehash /* = -1 */) const {
+  ssize_t pos = getIndex(k, prehash);
+  if (pos != ArrayData::invalid_index) {
+    return m_data[pos].data;
+  }
+  return null;
+}
+
+ssize_t HphpArray::getIndex(int64 k, int64 prehash /* = -1 */) const {
+  return find(k);
+}
+
+ssize_t HphpArray::getIndex(litstr k, int64 prehash /* = -1 */) const {
+  return find(k, strlen(k), prehash);
+}
+
+ssize_t HphpArray::getIndex(CStrRef k, int64 prehash /* = -1 */) const {
+  return find(k.data(), k.size(), prehash);
+}
+
+ssize_t HphpArray::getIndex(CVarRef k, int64 prehash /* = -1 */) const {
+  if (k.isNumeric()) {
+    return find(k.toInt64());
+  }
+  String key = k.toString();
+  return find(key.data(), key.size(), prehash);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// append/insert/update
+
+void HphpArray::allocHash() {
+  ASSERT(!m_hash);
+  m_hashMask = (m_capacity << 1) - 1;
+  m_hash = (int32 *)smart_malloc((m_hashMask + 1) * sizeof(int32));
+}
+
+void HphpArray::rehash() {
+  ASSERT(m_hash);
+  memset(m_hash, 0xff, (m_hashMask + 1) * sizeof(int32)); // all EmptySlot
+  m_hashDeleted = 0;
+  for (uint i = 0; i < m_used; i++) {
+    if (IsLive(m_data[i])) {
+      *findForInsert(m_data[i].h) = i;
+    }
+  }
+}
+
+void HphpArray::unpack() {
+  allocHash();
+  rehash();
+}
+
+void HphpArray::compact(Elm *dest) {
+  ssize_t pos = ArrayData::invalid_index;
+  uint j = 0;
+  for (uint i = 0; i < m_used; i++) {
+    if (!IsLive(m_data[i])) continue;
+    if ((ssize_t)i == m_pos) {
+      pos = j;
+    }
+    if (dest + j != m_data + i) {
+      memcpy(dest + j, m_data + i, sizeof(Elm));
+    }
+    j++;
+  }
+  ASSERT(j == m_size);
+  m_data = dest;
+  m_used = j;
+  m_pos = pos;
+}
+
+HphpArray::Elm *HphpArray::grow() {
+  ASSERT(m_used == m_capacity);
+  Elm *old = m_data;
+  bool doubled = false;
+  if (m_size * 2 > m_capacity) {
+    m_capacity <<= 1;
+    doubled = true;
+  } // otherwise, just squeezing out tombstones
+  compact((Elm *)smart_malloc(m_capacity * sizeof(Elm)));
+  if (m_hash) {
+    if (doubled) {
+      smart_free(m_hash);
+      m_hash = NULL;
+      allocHash();
+    }
+    rehash();
+  }
+  return old;
+}
+
+Variant *HphpArray::addElm(int64 h, StringData *key, CVarRef data) {
+  // data may be one of our own elements, so an outgrown buffer is only
+  // freed after it is copied.
+  Elm *old = NULL;
+  if (m_used == m_capacity) {
+    old = grow();
+  }
+  if (m_hash) {
+    if (m_size + m_hashDeleted >= m_capacity) {
+      // erase() drops trailing tombstones, so m_used may never reach
+      // m_capacity, and grow() alone wouldn't clear deleted entries
+      rehash();
+    }
+    int32 *slot = findForInsert(h);
+    if (*slot == DeletedSlot) {
+      m_hashDeleted--;
+    }
+    *slot = m_used;
+  }
+  Elm &e = m_data[m_used];
+  new (&e.data) Variant();
+  e.h = h;
+  e.key = key;
+  if (m_pos == ArrayData::invalid_index) {
+    m_pos = m_used;
+  }
+  m_used++;
+  m_size++;
+  e.data = data;
+  if (old) {
+    smart_free(old);
+  }
+  return &e.data;
+}
+
+bool HphpArray::update(OpFlag flag, int64 h, CVarRef data,
+                       Variant **pDest /* = NULL */) {
+  m_valueIndex.clear();
+  ssize_t pos = ArrayData::invalid_index;
+  if (flag & HASH_NEXT_INSERT) {
+    h = m_nextKI;
+  } else {
+    pos = find(h);
+  }
+
+  if (pos != ArrayData::invalid_index) {
+    Elm &e = m_data[pos];
+    if (pDest) {
+      *pDest = &e.data;
+    }
+    if (flag & HASH_ADD) {
+      return false;
+    }
+    e.data = data;
+    return true;
+  }
+
+  if (!m_hash && h != (int64)m_used) {
+    unpack(); // no longer 0, 1, 2...
+  }
+  Variant *dest = addElm(h, NULL, data);
+  if (pDest) {
+    *pDest = dest;
+  }
+  if (h >= m_nextKI) {
+    m_nextKI = h + 1;
+  }
+  return true;
+}
+
+bool HphpArray::update(OpFlag flag, litstr key, int64 h, CVarRef data,
+                       Variant **pDest /* = NULL */) {
+  m_valueIndex.clear();
+  int len = strlen(key);
+  ssize_t pos = find(key, len, h, &h);
+  if (pos != ArrayData::invalid_index) {
+    Elm &e = m_data[pos];
+    if (pDest) {
+      *pDest = &e.data;
+    }
+    if (flag & HASH_ADD) {
+      return false;
+    }
+    e.data = data;
+    return true;
+  }
+
+  if (!m_hash) {
+    unpack();
+  }
+  StringData *k = NEW(StringData)(key, len, AttachLiteral);
+  k->incRefCount();
+  Variant *dest = addElm(h, k, data);
+  if (pDest) {
+    *pDest = dest;
+  }
+  return true;
+}
+
+bool HphpArray::update(OpFlag flag, StringData *key, int64 h, CVarRef data,
+                       Variant **pDest /* = NULL */) {
+  m_valueIndex.clear();
+  ssize_t pos = find(key->data(), key->size(), h, &h);
+  if (pos != ArrayData::invalid_index) {
+    Elm &e = m_data[pos];
+    if (pDest) {
+      *pDest = &e.data;
+    }
+    if (flag & HASH_ADD) {
+      return false;
+    }
+    e.data = data;
+    return true;
+  }
+
+  if (!m_hash) {
+    unpack();
+  }
+  StringData *k;
+  if (key->isShared()) {
+    k = NEW(StringData)(key->data(), key->size(), CopyString);
+  } else {
+    k = key;
+  }
+  k->incRefCount();
+  Variant *dest = addElm(h, k, data);
+  if (pDest) {
+    *pDest = dest;
+  }
+  return true;
+}
+
+ArrayData *HphpArray::lval(Variant *&ret, bool copy) {
+  if (copy) {
+    HphpArray *a = copyImpl();
+    ssize_t pos = a->iter_end();
+    ASSERT(pos != ArrayData::invalid_index);
+    ret = &a->m_data[pos].data;
+    return a;
+  }
+  ssize_t pos = iter_end();
+  ASSERT(pos != ArrayData::invalid_index);
+  m_valueIndex.clear();
+  ret = &m_data[pos].data;
+  return NULL;
+}
+
+ArrayData *HphpArray::lval(int64 k, Variant *&ret, bool copy,
+                           int64 prehash /* = -1 */) {
+  if (copy) {
+    HphpArray *a = copyImpl();
+    a->update(HASH_ADD, k, null, &ret);
+    return a;
+  }
+  update(HASH_ADD, k, null, &ret);
+  return NULL;
+}
+
+ArrayData *HphpArray::lval(CStrRef k, Variant *&ret, bool copy,
+                           int64 prehash /* = -1 */) {
+  return lvalImpl(k.get(), ret, copy, prehash);
+}
+
+ArrayData *HphpArray::lval(litstr k, Variant *&ret, bool copy,
+                           int64 prehash /* = -1 */) {
+  return lvalImpl(k, ret, copy, prehash);
+}
+
+ArrayData *HphpArray::lval(CVarRef k, Variant *&ret, bool copy,
+                           int64 prehash /* = -1 */) {
+  if (k.isNumeric()) {
+    return lval(k.toInt64(), ret, copy, prehash);
+  } else {
+    String key = k.toString();
+    return lvalImpl(key.get(), ret, copy, prehash);
+  }
+}
+
+ArrayData *HphpArray::set(int64 k, CVarRef v, bool copy,
+                          int64 prehash /* = -1 */) {
+  if (copy) {
+    HphpArray *a = copyImpl();
+    a->update(HASH_UPDATE, k, v);
+    return a;
+  }
+  update(HASH_UPDATE, k, v);
+  return NULL;
+}
+
+ArrayData *HphpArray::set(CStrRef k, CVarRef v, bool copy,
+                          int64 prehash /* = -1 */) {
+  if (copy) {
+    HphpArray *a = copyImpl();
+    a->update(HASH_UPDATE, k.get(), prehash, v);
+    return a;
+  }
+  update(HASH_UPDATE, k.get(), prehash, v);
+  return NULL;
+}
+
+ArrayData *HphpArray::set(litstr k, CVarRef v, bool copy,
+                          int64 prehash /* = -1 */) {
+  if (copy) {
+    HphpArray *a = copyImpl();
+    a->update(HASH_UPDATE, k, prehash, v);
+    return a;
+  }
+  update(HASH_UPDATE, k, prehash, v);
+  return NULL;
+}
+
+ArrayData *HphpArray::set(CVarRef k, CVarRef v, bool copy,
+                          int64 prehash /* = -1 */) {
+  if (k.isNumeric()) {
+    if (copy) {
+      HphpArray *a = copyImpl();
+      a->update(HASH_UPDATE, k.toInt64(), v);
+      return a;
+    }
+    update(HASH_UPDATE, k.toInt64(), v);
+    return NULL;
+  } else if (k.is(LiteralString)) {
+    if (copy) {
+      HphpArray *a = copyImpl();
+      a->update(HASH_UPDATE, k.getLiteralString(), prehash, v);
+      return a;
+    }
+    update(HASH_UPDATE, k.getLiteralString(), prehash, v);
+    return NULL;
+  } else {
+    String sk = k.toString();
+    StringData *sd = sk.get();
+    if (copy) {
+      HphpArray *a = copyImpl();
+      a->update(HASH_UPDATE, sd, prehash, v);
+      return a;
+    }
+    update(HASH_UPDATE, sd, prehash, v);
+    return NULL;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// delete
+
+void HphpArray::erase(ssize_t pos) {
+  if (pos == ArrayData::invalid_index) {
+    return;
+  }
+  m_valueIndex.clear();
+  Elm &e = m_data[pos];
+  if (!m_hash && pos != (ssize_t)m_used - 1) {
+    unpack(); // about to leave a hole
+  }
+  if (m_hash) {
+    FOR_EACH_PROBE(i, e.h) {
+      if (m_hash[i] == pos) {
+        m_hash[i] = DeletedSlot;
+        m_hashDeleted++;
+        break;
+      }
+    }
+  }
+  if (m_pos == pos) {
+    m_pos = nextLive(pos + 1);
+  }
+
+  // Destructing the value may run arbitrary code touching this array, so
+  // the element is unlinked completely before that.
+  char data[sizeof(Variant)];
+  memcpy(data, &e.data, sizeof(Variant));
+  if (e.key && e.key->decRefCount() == 0) {
+    DELETE(StringData)(e.key);
+  }
+  e.key = Tombstone();
+  m_size--;
+  while (m_used && !IsLive(m_data[m_used - 1])) {
+    m_used--;
+  }
+  ((Variant *)data)->~Variant();
+}
+
+ArrayData *HphpArray::remove(int64 k, bool copy, int64 prehash /* = -1 */) {
+  if (copy) {
+    HphpArray *a = copyImpl();
+    a->erase(a->find(k));
+    return a;
+  }
+  erase(find(k));
+  return NULL;
+}
+
+ArrayData *HphpArray::remove(CStrRef k, bool copy, int64 prehash /* = -1 */) {
+  if (copy) {
+    HphpArray *a = copyImpl();
+    a->erase(a->find(k.data(), k.size(), prehash));
+    return a;
+  }
+  erase(find(k.data(), k.size(), prehash));
+  return NULL;
+}
+
+ArrayData *HphpArray::remove(litstr k, bool copy, int64 prehash /* = -1 */) {
+  if (copy) {
+    HphpArray *a = copyImpl();
+    a->erase(a->find(k, strlen(k), prehash));
+    return a;
+  }
+  erase(find(k, strlen(k), prehash));
+  return NULL;
+}
+
+ArrayData *HphpArray::remove(CVarRef k, bool copy, int64 prehash /* = -1 */) {
+  if (copy) {
+    HphpArray *a = copyImpl();
+    a->erase(a->getIndex(k, prehash));
+    return a;
+  }
+  erase(getIndex(k, prehash));
+  return NULL;
+}
+
+ArrayData *HphpArray::copy() const {
+  return copyImpl();
+}
+
+HphpArray *HphpArray::copyImpl() const {
+  HphpArray *target = NEW(HphpArray)(m_size);
+  if (m_hash) {
+    target->allocHash();
+    memset(target->m_hash, 0xff, (target->m_hashMask + 1) * sizeof(int32));
+  }
+  for (uint i = 0; i < m_used; i++) {
+    Elm &e = m_data[i];
+    if (!IsLive(e)) continue;
+    if (e.data.isReferenced()) {
+      e.data.setContagious();
+    }
+    if (e.key) {
+      e.key->incRefCount();
+    }
+    target->addElm(e.h, e.key, e.data);
+  }
+  target->m_nextKI = m_nextKI;
+  return target;
+}
+
+ArrayData *HphpArray::append(CVarRef v, bool copy) {
+  if (copy) {
+    HphpArray *a = copyImpl();
+    a->update(HASH_NEXT_INSERT, 0, v);
+    return a;
+  }
+  update(HASH_NEXT_INSERT, 0, v);
+  return NULL;
+}
+
+ArrayData *HphpArray::append(const ArrayData *elems, ArrayOp op, bool copy) {
+  if (copy) {
+    HphpArray *a = copyImpl();
+    a->append(elems, op, false);
+    return a;
+  }
+
+  if (elems->supportValueRef()) {
+    if (op == Plus) {
+      for (ArrayIter it(elems); !it.end(); it.next()) {
+        Variant key = it.first();
+        CVarRef value = it.secondRef();
+        if (value.isReferenced()) value.setContagious();
+        if (key.isNumeric()) {
+          update(HASH_ADD, key.toInt64(), value);
+        } else {
+          String skey = key.toString();
+          update(HASH_ADD, skey.get(), -1, value);
+        }
+      }
+    } else {
+      ASSERT(op == Merge);
+      for (ArrayIter it(elems); !it.end(); it.next()) {
+        Variant key = it.first();
+        CVarRef value = it.secondRef();
+        if (value.isReferenced()) value.setContagious();
+        if (key.isNumeric()) {
+          append(value, false);
+        } else {
+          set(key, value, false);
+        }
+      }
+    }
+  } else {
+    if (op == Plus) {
+      for (ArrayIter it(elems); !it.end(); it.next()) {
+        Variant key = it.first();
+        if (key.isNumeric()) {
+          update(HASH_ADD, key.toInt64(), it.second());
+        } else {
+          String skey = key.toString();
+          update(HASH_ADD, skey.get(), -1, it.second());
+        }
+      }
+    } else {
+      ASSERT(op == Merge);
+      for (ArrayIter it(elems); !it.end(); it.next()) {
+        Variant key = it.first();
+        if (key.isNumeric()) {
+          append(it.second(), false);
+        } else {
+          set(key, it.second(), false);
+        }
+      }
+    }
+  }
+  return NULL;
+}
+
+ArrayData *HphpArray::pop(Variant &value) {
+  if (getCount() > 1) {
+    HphpArray *a = copyImpl();
+    a->pop(value);
+    return a;
+  }
+  ssize_t pos = iter_end();
+  if (pos != ArrayData::invalid_index) {
+    Elm &e = m_data[pos];
+    value = e.data;
+    if (!e.key && e.h == m_nextKI - 1) {
+      m_nextKI--;
+    }
+    erase(pos);
+  } else {
+    value = null;
+  }
+  return NULL;
+}
+
+ArrayData *HphpArray::dequeue(Variant &value) {
+  if (getCount() > 1) {
+    HphpArray *a = copyImpl();
+    a->dequeue(value);
+    return a;
+  }
+  ssize_t pos = iter_begin();
+  if (pos != ArrayData::invalid_index) {
+    value = m_data[pos].data;
+    erase(pos);
+    renumber();
+  } else {
+    value = null;
+  }
+  return NULL;
+}
+
+ArrayData *HphpArray::insert(ssize_t pos, CVarRef v, bool copy) {
+  if (copy) {
+    HphpArray *a = copyImpl();
+    a->insert(pos, v, false);
+    return a;
+  }
+
+  // Positions are slot numbers, which shift once tombstones are squeezed
+  // out, so the destination is taken as a count of elements before it.
+  ssize_t oldTail = iter_end();
+  uint target = 0;
+  if (idxExists(pos)) {
+    for (ssize_t i = 0; i < pos; i++) {
+      if (IsLive(m_data[i])) target++;
+    }
+  }
+
+  update(HASH_NEXT_INSERT, 0, v);
+  if (m_size == 1 || pos == oldTail) {
+    return NULL; // already in the proper spot at the end
+  }
+
+  // Move the newly inserted element from the end to whatever position was
+  // requested.
+  compact(m_data);
+  uint last = m_used - 1;
+  char elm[sizeof(Elm)];
+  memcpy(elm, m_data + last, sizeof(Elm));
+  memmove(m_data + target + 1, m_data + target, (last - target) * sizeof(Elm));
+  memcpy(m_data + target, elm, sizeof(Elm));
+  if (m_pos == (ssize_t)last) {
+    m_pos = target;
+  } else if (m_pos >= (ssize_t)target) {
+    m_pos++;
+  }
+
+  // Rewrite numeric keys to start from 0 and rehash
+  renumber();
+  return NULL;
+}
+
+void HphpArray::renumber() {
+  compact(m_data);
+  int64 i = 0;
+  bool packed = true;
+  for (uint j = 0; j < m_used; j++) {
+    Elm &e = m_data[j];
+    if (e.key == NULL) {
+      e.h = i++;
+    } else {
+      packed = false;
+    }
+  }
+  m_nextKI = i;
+  if (packed) {
+    if (m_hash) {
+      smart_free(m_hash);
+      m_hash = NULL;
+    }
+  } else {
+    if (!m_hash) {
+      allocHash();
+    }
+    rehash();
+  }
+}
+
+void HphpArray::onSetStatic() {
+  for (uint i = 0; i < m_used; i++) {
+    Elm &e = m_data[i];
+    if (!IsLive(e)) continue;
+    if (e.key) {
+      e.key->setStatic();
+    }
+    e.data.setStatic();
+  }
+}
+
+bool HphpArray::valueIndexLookup(CVarRef v, bool strict, bool &found) const {
+  if (isStatic()) return false; // shared by all threads
+  return m_valueIndex.exists(this, v, strict, found);
+}
+
+void HphpArray::getFullPos(FullPos &pos) {
+  // 0 means no position, like the Bucket pointers of ZendArray
+  pos.primary = m_pos + 1;
+  if (m_pos != ArrayData::invalid_index) {
+    pos.secondary = (ssize_t)m_data[m_pos].h;
+    pos.key = m_data[m_pos].key;
+  }
+}
+
+bool HphpArray::setFullPos(const FullPos &pos) {
+  // Only set if pos hasn't been invalidated. Elements move when tombstones
+  // are squeezed out, so a slot holding something else is looked up again by
+  // its key. A string key is matched by its StringData, which this array
+  // holds on to for as long as the element lives.
+  if (pos.primary > 0) {
+    ssize_t slot = pos.primary - 1;
+    if (idxExists(slot) && m_data[slot].h == pos.secondary &&
+        m_data[slot].key == pos.key) {
+      m_pos = slot;
+    } else if (m_hash) {
+      FOR_EACH_PROBE(i, pos.secondary) {
+        int32 p = m_hash[i];
+        if (p == EmptySlot) break;
+        if (p >= 0 && m_data[p].h == pos.secondary &&
+            m_data[p].key == pos.key) {
+          m_pos = p;
+          break;
+        }
+      }
+    }
+  }
+  return m_pos != ArrayData::invalid_index;
+}
+
+CVarRef HphpArray::currentRef() {
+  ASSERT(m_pos != ArrayData::invalid_index);
+  m_valueIndex.clear();
+  return m_data[m_pos].data;
+}
+
+CVarRef HphpArray::endRef() {
+  ASSERT(m_pos != ArrayData::invalid_index);
+  m_valueIndex.clear();
+  return m_data[iter_end()].data;
+}
+
+int64 HphpArray::getStorageBytes() const {
+  int64 bytes = (int64)m_capacity * sizeof(Elm);
+  if (m_hash) {
+    bytes += (int64)(m_hashMask + 1) * sizeof(int32);
+  }
+  return bytes;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// memory allocator methods.
+
+bool HphpArray::calculate(int &size) {
+  size += getStorageBytes();
+  return true;
+}
+
+void HphpArray::backup(LinearAllocator &allocator) {
+  m_valueIndex.clear();
+  allocator.backup((const char*)m_data, m_capacity * sizeof(Elm));
+  if (m_hash) {
+    allocator.backup((const char*)m_hash, (m_hashMask + 1) * sizeof(int32));
+  }
+}
+
+void HphpArray::restore(const char *&data) {
+  int bytes = m_capacity * sizeof(Elm);
+  m_data = (Elm *)smart_malloc(bytes);
+  memcpy(m_data, data, bytes);
+  data += bytes;
+  if (m_hash) {
+    bytes = (m_hashMask + 1) * sizeof(int32);
+    m_hash = (int32 *)smart_malloc(bytes);
+    memcpy(m_hash, data, bytes);
+    data += bytes;
+  }
+  m_valueIndex.forget();
+}
+
+void HphpArray::sweep() {
+  m_valueIndex.clear();
+  if (m_data) {
+    smart_free(m_data);
+    m_data = NULL;
+  }
+  if (m_hash) {
+    smart_free(m_hash);
+    m_hash = NULL;
+  }
+  m_used = m_size = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
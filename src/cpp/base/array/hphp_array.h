@@ -0,0 +1,221 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010 Facebook, Inc. (http://www.facebook.com)          |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __HPHP_HPHP_ARRAY_H__
+#define __HPHP_HPHP_ARRAY_H__
+
+#include <cpp/base/types.h>
+#include <cpp/base/type_variant.h>
+#include <cpp/base/array/value_index.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Same semantics as ZendArray, laid out the way a hash table should be on
+ * modern hardware: elements live in one dense array in insertion order, and
+ * a separate open-addressed table of 32-bit slot numbers maps keys to them.
+ * There are no per-element allocations and no list pointers to chase, so an
+ * element costs 32 bytes plus 8 bytes of index, against ZendArray's 64-byte
+ * Bucket plus its table entry.
+ *
+ * Deleted elements are left as tombstones and squeezed out when the element
+ * array runs full. Arrays whose keys are exactly 0, 1, 2... are kept
+ * "packed", without any index table at all, until something else happens to
+ * them, like a string key, a hole or an out of order integer key.
+ *
+ * Iteration positions are slot numbers into the element array, and m_pos is
+ * ArrayData::invalid_index when the internal pointer is past the end.
+ */
+class HphpArray : public ArrayData {
+public:
+  HphpArray(uint nSize = 0);
+  virtual ~HphpArray();
+
+  virtual ssize_t size() const { return m_size;}
+
+  virtual Variant getKey(ssize_t pos) const;
+  virtual Variant getValue(ssize_t pos) const;
+  virtual CVarRef getValueRef(ssize_t pos) const;
+  virtual bool isVectorData() const;
+  virtual bool supportValueRef() const { return true; }
+
+  virtual ssize_t iter_begin() const;
+  virtual ssize_t iter_end() const;
+  virtual ssize_t iter_advance(ssize_t prev) const;
+  virtual ssize_t iter_rewind(ssize_t prev) const;
+
+  virtual Variant reset();
+  virtual Variant prev();
+  virtual Variant current() const;
+  virtual Variant next();
+  virtual Variant end();
+  virtual Variant key() const;
+  virtual Variant value(ssize_t &pos) const;
+  virtual Variant each();
+
+  virtual bool exists(int64   k, int64 prehash = -1) const;
+  virtual bool exists(litstr  k, int64 prehash = -1) const;
+  virtual bool exists(CStrRef k, int64 prehash = -1) const;
+  virtual bool exists(CVarRef k, int64 prehash = -1) const;
+
+  virtual bool idxExists(ssize_t idx) const;
+
+  virtual Variant get(int64   k, int64 prehash = -1) const;
+  virtual Variant get(litstr  k, int64 prehash = -1) const;
+  virtual Variant get(CStrRef k, int64 prehash = -1) const;
+  virtual Variant get(CVarRef k, int64 prehash = -1) const;
+
+  virtual ssize_t getIndex(int64 k, int64 prehash = -1) const;
+  virtual ssize_t getIndex(litstr k, int64 prehash = -1) const;
+  virtual ssize_t getIndex(CStrRef k, int64 prehash = -1) const;
+  virtual ssize_t getIndex(CVarRef k, int64 prehash = -1) const;
+
+  virtual ArrayData *lval(Variant *&ret, bool copy);
+  virtual ArrayData *lval(int64   k, Variant *&ret, bool copy,
+                          int64 prehash = -1);
+  virtual ArrayData *lval(litstr  k, Variant *&ret, bool copy,
+                          int64 prehash = -1);
+  virtual ArrayData *lval(CStrRef k, Variant *&ret, bool copy,
+                          int64 prehash = -1);
+  virtual ArrayData *lval(CVarRef k, Variant *&ret, bool copy,
+                          int64 prehash = -1);
+
+  virtual ArrayData *set(int64   k, CVarRef v, bool copy, int64 prehash = -1);
+  virtual ArrayData *set(litstr  k, CVarRef v, bool copy, int64 prehash = -1);
+  virtual ArrayData *set(CStrRef k, CVarRef v, bool copy, int64 prehash = -1);
+  virtual ArrayData *set(CVarRef k, CVarRef v, bool copy, int64 prehash = -1);
+
+  virtual ArrayData *remove(int64   k, bool copy, int64 prehash = -1);
+  virtual ArrayData *remove(litstr  k, bool copy, int64 prehash = -1);
+  virtual ArrayData *remove(CStrRef k, bool copy, int64 prehash = -1);
+  virtual ArrayData *remove(CVarRef k, bool copy, int64 prehash = -1);
+
+  virtual ArrayData *copy() const;
+  virtual ArrayData *append(CVarRef v, bool copy);
+  virtual ArrayData *append(const ArrayData *elems, ArrayOp op, bool copy);
+  virtual ArrayData *pop(Variant &value);
+  virtual ArrayData *dequeue(Variant &value);
+  virtual ArrayData *insert(ssize_t pos, CVarRef v, bool copy);
+  virtual void renumber();
+  virtual void onSetStatic();
+  virtual bool valueIndexLookup(CVarRef v, bool strict, bool &found) const;
+
+  virtual void getFullPos(FullPos &pos);
+  virtual bool setFullPos(const FullPos &pos);
+  virtual CVarRef currentRef();
+  virtual CVarRef endRef();
+
+  /**
+   * Whether there is no index table, and keys are just slot numbers.
+   */
+  bool isPacked() const { return m_hash == NULL;}
+
+  /**
+   * Bytes of element array and index table, not counting this object.
+   */
+  int64 getStorageBytes() const;
+
+private:
+  enum OpFlag {
+    HASH_UPDATE       =  (1<<0),
+    HASH_ADD          =  (1<<1),
+    HASH_NEXT_INSERT  =  (1<<2)
+  };
+
+  enum {
+    MinCapacity = 8,
+    EmptySlot   = -1, // index table entries
+    DeletedSlot = -2,
+  };
+
+  struct Elm {
+    Variant     data;
+    int64       h;   // integer key, or hash of string key
+    StringData *key; // NULL for integer keys, Tombstone() once deleted
+  };
+
+  static StringData *Tombstone() { return (StringData*)-1;}
+  static bool IsLive(const Elm &e) { return e.key != Tombstone();}
+
+  Elm   *m_data;     // insertion ordered, m_capacity elements
+  int32 *m_hash;     // 2 * m_capacity entries, NULL when packed
+  uint   m_capacity;
+  uint   m_used;     // slots handed out, including tombstones
+  uint   m_size;     // live elements
+  uint   m_hashMask;
+  uint   m_hashDeleted; // DeletedSlot entries in m_hash
+  int64  m_nextKI;   // next integer key for append()
+  mutable ValueIndexCache m_valueIndex;
+
+  ssize_t find(int64 h) const;
+  ssize_t find(const char *k, int len, int64 prehash = -1,
+               int64 *h = NULL) const;
+  int32 *findForInsert(int64 h) const;
+
+  bool update(OpFlag flag, int64 h, CVarRef data, Variant **pDest = NULL);
+  bool update(OpFlag flag, litstr key, int64 h, CVarRef data,
+              Variant **pDest = NULL);
+  bool update(OpFlag flag, StringData *key, int64 h, CVarRef data,
+              Variant **pDest = NULL);
+
+  Variant *addElm(int64 h, StringData *key, CVarRef data);
+  void erase(ssize_t pos);
+  HphpArray *copyImpl() const;
+
+  ssize_t nextLive(ssize_t pos) const;
+  ssize_t prevLive(ssize_t pos) const;
+  Elm *grow();
+  void compact(Elm *dest);
+  void allocHash();
+  void unpack();
+  void rehash();
+
+  /**
+   * Memory allocator methods.
+   */
+  DECLARE_SMART_ALLOCATION(HphpArray, SmartAllocatorImpl::NeedRestoreOnce);
+  bool calculate(int &size);
+  void backup(LinearAllocator &allocator);
+  void restore(const char *&data);
+  void sweep();
+
+  template<class T>
+  ArrayData *lvalImpl(const T& k, Variant *&ret, bool copy, int64 prehash) {
+    if (copy) {
+      HphpArray *a = copyImpl();
+      a->update(HASH_ADD, k, prehash, null, &ret);
+      return a;
+    }
+    update(HASH_ADD, k, prehash, null, &ret);
+    return NULL;
+  }
+};
+
+class StaticEmptyHphpArray : public HphpArray {
+public:
+  StaticEmptyHphpArray() { setStatic();}
+
+  static HphpArray *Get() { return &s_theEmptyArray; }
+
+private:
+  static StaticEmptyHphpArray s_theEmptyArray;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __HPHP_HPHP_ARRAY_H__
@@ -0,0 +1,177 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010 Facebook, Inc. (http://www.facebook.com)          |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include <cpp/base/array/value_index.h>
+#include <cpp/base/array/array_data.h>
+#include <cpp/base/type_variant.h>
+#include <cpp/base/zend/zend_functions.h>
+#include <util/hash.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+size_t ValueIndex::StringKeyHash::operator()(const StringKey &k) const {
+  return hash_string(k.data, k.len);
+}
+
+size_t ValueIndex::IntHash::operator()(int64 v) const {
+  return hash_int64(v);
+}
+
+ValueIndex::ValueIndex(bool byString)
+  : m_byString(byString), m_numericStrings(false) {
+}
+
+bool ValueIndex::GetString(CVarRef v, StringKey &key) {
+  switch (v.getType()) {
+  case LiteralString:
+    key.data = v.getLiteralString();
+    key.len = strlen(key.data);
+    return true;
+  case KindOfString:
+    key.data = v.getStringData()->data();
+    key.len = v.getStringData()->size();
+    return true;
+  default:
+    break;
+  }
+  return false;
+}
+
+bool ValueIndex::CanIndex(CVarRef v) {
+  if (v.isReferenced()) return false;
+  switch (v.getType()) {
+  case KindOfByte:
+  case KindOfInt16:
+  case KindOfInt32:
+  case KindOfInt64:
+  case LiteralString:
+  case KindOfString:
+    return true;
+  default:
+    break;
+  }
+  return false;
+}
+
+ValueIndex *ValueIndex::Build(const ArrayData *arr) {
+  ASSERT(arr->supportValueRef());
+  ValueIndex *index = new ValueIndex(false);
+  for (ssize_t pos = arr->iter_begin(); pos != ArrayData::invalid_index;
+       pos = arr->iter_advance(pos)) {
+    CVarRef v = arr->getValueRef(pos);
+    if (!CanIndex(v)) {
+      delete index;
+      return NULL;
+    }
+    index->add(v);
+  }
+  return index;
+}
+
+bool ValueIndex::add(CVarRef v) {
+  StringKey key;
+  if (v.isInteger()) {
+    return m_ints.insert(v.toInt64()).second;
+  }
+  if (!GetString(v, key)) {
+    ASSERT(m_byString);
+    m_holder.push_back(v.toString());
+    key.data = m_holder.back().data();
+    key.len = m_holder.back().size();
+  } else if (m_byString && v.is(KindOfString) &&
+             v.getStringData()->getCount() == 1) {
+    m_holder.push_back(v.toString()); // v is a temporary holding it alone
+  }
+
+  if (m_byString) {
+    int64 n;
+    if (is_strictly_integer(key.data, key.len, n)) {
+      return m_ints.insert(n).second;
+    }
+  } else if (!m_numericStrings) {
+    int64 lval; double dval;
+    m_numericStrings =
+      is_numeric_string(key.data, key.len, &lval, &dval, 0) != KindOfNull;
+  }
+  return m_strings.insert(key).second;
+}
+
+bool ValueIndex::containsString(CVarRef v) const {
+  ASSERT(m_byString);
+  if (v.isInteger()) {
+    return m_ints.find(v.toInt64()) != m_ints.end();
+  }
+  String holder;
+  StringKey key;
+  if (!GetString(v, key)) {
+    holder = v.toString();
+    key.data = holder.data();
+    key.len = holder.size();
+  }
+  int64 n;
+  if (is_strictly_integer(key.data, key.len, n)) {
+    return m_ints.find(n) != m_ints.end();
+  }
+  return m_strings.find(key) != m_strings.end();
+}
+
+bool ValueIndex::exists(CVarRef v, bool strict, bool &found) const {
+  ASSERT(!m_byString);
+  if (v.isInteger()) {
+    // "1abc" == 1, so loosely, any string may match
+    if (!strict && !m_strings.empty()) return false;
+    found = m_ints.find(v.toInt64()) != m_ints.end();
+    return true;
+  }
+
+  StringKey key;
+  if (!GetString(v, key)) return false;
+  if (!strict) {
+    // "abc" == 0, and "1e1" == "10"
+    if (!m_ints.empty()) return false;
+    if (m_numericStrings) {
+      int64 lval; double dval;
+      if (is_numeric_string(key.data, key.len, &lval, &dval, 0) !=
+          KindOfNull) {
+        return false;
+      }
+    }
+  }
+  found = m_strings.find(key) != m_strings.end();
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ValueIndexCache::exists(const ArrayData *arr, CVarRef v, bool strict,
+                             bool &found) {
+  if (!m_index) {
+    // not worth it for small arrays or one-off searches
+    if (m_searches < 0 || arr->size() < 16 || ++m_searches < 3) {
+      return false;
+    }
+    m_index = ValueIndex::Build(arr);
+    if (!m_index) {
+      m_searches = -1;
+      return false;
+    }
+  }
+  return m_index->exists(v, strict, found);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
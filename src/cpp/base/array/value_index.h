@@ -0,0 +1,137 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010 Facebook, Inc. (http://www.facebook.com)          |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __HPHP_VALUE_INDEX_H__
+#define __HPHP_VALUE_INDEX_H__
+
+#include <cpp/base/types.h>
+#include <cpp/base/type_string.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Hash set of array values. Integers are kept as they are, and strings are
+ * kept as pointers into the strings the values already hold, so indexing an
+ * array of integers or strings doesn't allocate any String.
+ *
+ * In "byString" mode, values are told apart by their string forms, the way
+ * array_unique(), array_diff() and array_intersect() compare them: 5 and
+ * "5" are the same. Otherwise integers and strings are kept apart, and
+ * exists() answers in_array() whenever PHP's comparison rules allow it.
+ *
+ * Strings are only pointed to, so the values added must outlive the index,
+ * unless they are temporaries the index holds on to.
+ */
+class ValueIndex {
+public:
+  ValueIndex(bool byString);
+
+  /**
+   * Whether a value can be added without byString: an integer or a string,
+   * not bound to any other variable.
+   */
+  static bool CanIndex(CVarRef v);
+
+  /**
+   * Indexes all values of an array, or returns NULL if any of them can't be.
+   * Caller deletes.
+   */
+  static ValueIndex *Build(const ArrayData *arr);
+
+  /**
+   * Returns false if an equal value was there already.
+   */
+  bool add(CVarRef v);
+
+  /**
+   * Whether (string)v is the string form of one of the values. byString
+   * mode only.
+   */
+  bool containsString(CVarRef v) const;
+
+  /**
+   * in_array(v, <values>, strict), if it can be told from the index without
+   * looking at the values one by one. Returns false when the caller needs
+   * to scan.
+   */
+  bool exists(CVarRef v, bool strict, bool &found) const;
+
+private:
+  struct StringKey {
+    const char *data;
+    int len;
+  };
+  struct StringKeyHash {
+    size_t operator()(const StringKey &k) const;
+  };
+  struct StringKeyEqual {
+    bool operator()(const StringKey &k1, const StringKey &k2) const {
+      return k1.len == k2.len && memcmp(k1.data, k2.data, k1.len) == 0;
+    }
+  };
+  struct IntHash {
+    size_t operator()(int64 v) const;
+  };
+  typedef hphp_hash_set<int64, IntHash> IntSet;
+  typedef hphp_hash_set<StringKey, StringKeyHash, StringKeyEqual> StringSet;
+
+  bool m_byString;
+  bool m_numericStrings; // any string in m_strings is numeric
+  IntSet m_ints;
+  StringSet m_strings;
+  std::vector<String> m_holder; // temporaries m_strings points into
+
+  static bool GetString(CVarRef v, StringKey &key);
+};
+
+/**
+ * The in_array() index ZendArray and HphpArray keep. It's only built after
+ * an array has been searched a few times without being modified, and any
+ * modification drops it, including handing out a reference to an element.
+ */
+class ValueIndexCache {
+public:
+  ValueIndexCache() : m_index(NULL), m_searches(0) {}
+  ~ValueIndexCache() { clear();}
+
+  bool exists(const ArrayData *arr, CVarRef v, bool strict, bool &found);
+
+  void clear() {
+    if (m_index) {
+      delete m_index;
+      m_index = NULL;
+    }
+    m_searches = 0;
+  }
+
+  /**
+   * For memory restored from a checkpoint, where the index was not copied.
+   */
+  void forget() {
+    m_index = NULL;
+    m_searches = 0;
+  }
+
+private:
+  ValueIndex *m_index;
+  int m_searches; // -1 when the values can't be indexed
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __HPHP_VALUE_INDEX_H__
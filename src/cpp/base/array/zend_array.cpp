@@ -18,6 +18,7 @@
 #include <cpp/base/array/zend_array.h>
 #include <cpp/base/type_string.h>
 #include <cpp/base/type_array.h>
+#include <cpp/base/memory/size_class_allocator.h>
 #include <util/hash.h>
 #include <util/lock.h>
 
@@ -48,7 +49,7 @@ ZendArray::ZendArray(uint nSize /* = 0 */) :
     m_nTableSize = 1 << i;
   }
   m_nTableMask = m_nTableSize - 1;
-  m_arBuckets = (Bucket **)calloc(m_nTableSize, sizeof(Bucket *));
+  m_arBuckets = (Bucket **)smart_calloc(m_nTableSize, sizeof(Bucket *));
 }
 
 ZendArray::~ZendArray() {
@@ -59,7 +60,7 @@ ZendArray::~ZendArray() {
     DELETE(Bucket)(q);
   }
   if (!m_linear && m_arBuckets) {
-    free(m_arBuckets);
+    smart_free(m_arBuckets);
   }
 }
 
@@ -106,6 +107,8 @@ Variant ZendArray::getKey(ssize_t pos) const {
 Variant ZendArray::getValue(ssize_t pos) const {
   ASSERT(pos && pos != ArrayData::invalid_index);
   Bucket *p = reinterpret_cast<Bucket *>(pos);
+  // callers may write through the reference
+  m_valueIndex.clear();
   return p->data;
 }
 
@@ -362,7 +365,7 @@ ssize_t ZendArray::getIndex(CVarRef k, int64 prehash /* = -1 */) const {
 do {                                                                    \
   if (m_linear) {                                                       \
     int nbytes = m_nTableSize * sizeof(Bucket *);                       \
-    Bucket **t = (Bucket **)malloc(nbytes);                             \
+    Bucket **t = (Bucket **)smart_malloc(nbytes);                       \
     memcpy(t, m_arBuckets, nbytes);                                     \
     m_arBuckets = t;                                                    \
     m_linear = false;                                                   \
@@ -373,12 +376,13 @@ do {                                                                    \
 void ZendArray::resize() {
   int curSize = m_nTableSize * sizeof(Bucket *);
   if (m_linear) {
-    Bucket **t = (Bucket **)calloc(m_nTableSize << 1, sizeof(Bucket *));
+    Bucket **t = (Bucket **)smart_calloc(m_nTableSize << 1,
+                                          sizeof(Bucket *));
     memcpy(t, m_arBuckets, curSize);
     m_arBuckets = t;
     m_linear = false;
   } else {
-    m_arBuckets = (Bucket **)realloc(m_arBuckets, curSize << 1);
+    m_arBuckets = (Bucket **)smart_realloc(m_arBuckets, curSize << 1);
     memset((char*)m_arBuckets + curSize, 0, curSize);
   }
   m_nTableSize <<= 1;
@@ -397,6 +401,7 @@ void ZendArray::rehash() {
 
 bool ZendArray::update(OpFlag flag, int64 h, CVarRef data,
                        Variant **pDest /* = NULL */) {
+  m_valueIndex.clear();
   Bucket *p = NULL;
   if (flag & HASH_NEXT_INSERT) {
     h = m_nNextFreeElement;
@@ -441,6 +446,7 @@ bool ZendArray::update(OpFlag flag, int64 h, CVarRef data,
 
 bool ZendArray::update(OpFlag flag, litstr key, int64 h, CVarRef data,
                        Variant **pDest /* = NULL */) {
+  m_valueIndex.clear();
   int len = strlen(key);
   Bucket *p = find(key, len, h, &h);
   if (p) {
@@ -476,6 +482,7 @@ bool ZendArray::update(OpFlag flag, litstr key, int64 h, CVarRef data,
 
 bool ZendArray::update(OpFlag flag, StringData *key, int64 h, CVarRef data,
                        Variant **pDest /* = NULL */) {
+  m_valueIndex.clear();
   Bucket *p = find(key->data(), key->size(), h, &h);
   if (p) {
     if (pDest) {
@@ -520,6 +527,7 @@ ArrayData *ZendArray::lval(Variant *&ret, bool copy) {
     return a;
   }
   ASSERT(m_pListTail);
+  m_valueIndex.clear();
   ret = &m_pListTail->data;
   return NULL;
 }
@@ -624,6 +632,7 @@ ArrayData *ZendArray::set(CVarRef k, CVarRef v, bool copy,
 
 void ZendArray::erase(Bucket *p) {
   if (p) {
+    m_valueIndex.clear();
     uint nIndex = (p->h & m_nTableMask);
     if (p->pLast) {
       p->pLast->pNext = p->pNext;
@@ -898,6 +907,11 @@ void ZendArray::onSetStatic() {
   }
 }
 
+bool ZendArray::valueIndexLookup(CVarRef v, bool strict, bool &found) const {
+  if (isStatic()) return false; // shared by all threads
+  return m_valueIndex.exists(this, v, strict, found);
+}
+
 void ZendArray::getFullPos(FullPos &pos) {
   pos.primary = m_pos;
   if (m_pos) {
@@ -920,12 +934,14 @@ bool ZendArray::setFullPos(const FullPos &pos) {
 
 CVarRef ZendArray::currentRef() {
   ASSERT(m_pos);
+  m_valueIndex.clear();
   Bucket *p = reinterpret_cast<Bucket *>(m_pos);
   return p->data;
 }
 
 CVarRef ZendArray::endRef() {
   ASSERT(m_pos);
+  m_valueIndex.clear();
   Bucket *p = reinterpret_cast<Bucket *>(m_pListTail);
   return p->data;
 }
@@ -939,6 +955,7 @@ bool ZendArray::calculate(int &size) {
 }
 
 void ZendArray::backup(LinearAllocator &allocator) {
+  m_valueIndex.clear();
   allocator.backup((const char*)m_arBuckets, m_nTableSize * sizeof(Bucket *));
 }
 
@@ -946,11 +963,13 @@ void ZendArray::restore(const char *&data) {
   m_arBuckets = (Bucket**)data;
   data += m_nTableSize * sizeof(Bucket *);
   m_linear = true;
+  m_valueIndex.forget();
 }
 
 void ZendArray::sweep() {
+  m_valueIndex.clear();
   if (!m_linear && m_arBuckets) {
-    free(m_arBuckets);
+    smart_free(m_arBuckets);
     m_arBuckets = NULL;
   }
 }
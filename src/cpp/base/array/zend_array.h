@@ -19,6 +19,7 @@
 
 #include <cpp/base/types.h>
 #include <cpp/base/type_variant.h>
+#include <cpp/base/array/value_index.h>
 
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
@@ -95,6 +96,7 @@ public:
   virtual ArrayData *insert(ssize_t pos, CVarRef v, bool copy);
   virtual void renumber();
   virtual void onSetStatic();
+  virtual bool valueIndexLookup(CVarRef v, bool strict, bool &found) const;
 
   virtual void getFullPos(FullPos &pos);
   virtual bool setFullPos(const FullPos &pos);
@@ -136,6 +138,7 @@ private:
   Bucket * m_pListTail;
   Bucket **m_arBuckets;
   bool     m_linear;
+  mutable ValueIndexCache m_valueIndex;
 
   Bucket *find(int64 h) const;
   Bucket *find(const char *k, int len, int64 prehash = -1,
@@ -244,69 +244,85 @@ Variant f_unserialize(CStrRef str) {
   return v;
 }
 
-String concat3(CStrRef s1, CStrRef s2, CStrRef s3) {
-  int len1 = s1.size();
-  int len2 = s2.size();
-  int len3 = s3.size();
-  int len = len1 + len2 + len3;
-  char *buf = (char *)malloc(len + 1);
-  memcpy(buf, s1.data(), len1);
-  memcpy(buf + len1, s2.data(), len2);
-  memcpy(buf + len1 + len2, s3.data(), len3);
-  buf[len] = 0;
-  return String(buf, len, AttachString);
+String binary_serialize(CVarRef value) {
+  VariableSerializer vs(VariableSerializer::Binary);
+  return vs.serialize(value, true);
 }
 
-String concat4(CStrRef s1, CStrRef s2, CStrRef s3, CStrRef s4) {
-  int len1 = s1.size();
-  int len2 = s2.size();
-  int len3 = s3.size();
-  int len4 = s4.size();
-  int len = len1 + len2 + len3 + len4;
-  char *buf = (char *)malloc(len + 1);
-  memcpy(buf, s1.data(), len1);
-  memcpy(buf + len1, s2.data(), len2);
-  memcpy(buf + len1 + len2, s3.data(), len3);
-  memcpy(buf + len1 + len2 + len3, s4.data(), len4);
-  buf[len] = 0;
-  return String(buf, len, AttachString);
+Variant binary_unserialize(CStrRef str, bool &success) {
+  success = false;
+  VariableUnserializer vu(str.data(), str.size());
+  Variant v;
+  try {
+    v = vu.unserialize();
+  } catch (Exception &e) {
+    Logger::Verbose("Unable to unserialize binary data of %d bytes. [%s] %s.",
+                    str.size(), e.getStackTrace().hexEncode().c_str(),
+                    e.getMessage().c_str());
+    return false;
+  }
+  success = true;
+  return v;
 }
 
-String concat5(CStrRef s1, CStrRef s2, CStrRef s3, CStrRef s4, CStrRef s5) {
-  int len1 = s1.size();
-  int len2 = s2.size();
-  int len3 = s3.size();
-  int len4 = s4.size();
-  int len5 = s5.size();
-  int len = len1 + len2 + len3 + len4 + len5;
+String concat_parts(const String * const *parts, int count) {
+  int len = 0;
+  for (int i = 0; i < count; i++) {
+    len += parts[i]->size();
+  }
   char *buf = (char *)malloc(len + 1);
-  memcpy(buf, s1.data(), len1);
-  memcpy(buf + len1, s2.data(), len2);
-  memcpy(buf + len1 + len2, s3.data(), len3);
-  memcpy(buf + len1 + len2 + len3, s4.data(), len4);
-  memcpy(buf + len1 + len2 + len3 + len4, s5.data(), len5);
-  buf[len] = 0;
+  char *p = buf;
+  for (int i = 0; i < count; i++) {
+    int size = parts[i]->size();
+    memcpy(p, parts[i]->data(), size);
+    p += size;
+  }
+  *p = 0;
   return String(buf, len, AttachString);
 }
 
-String concat6(CStrRef s1, CStrRef s2, CStrRef s3, CStrRef s4, CStrRef s5,
-               CStrRef s6) {
-  int len1 = s1.size();
-  int len2 = s2.size();
-  int len3 = s3.size();
-  int len4 = s4.size();
-  int len5 = s5.size();
-  int len6 = s6.size();
-  int len = len1 + len2 + len3 + len4 + len5 + len6;
-  char *buf = (char *)malloc(len + 1);
-  memcpy(buf, s1.data(), len1);
-  memcpy(buf + len1, s2.data(), len2);
-  memcpy(buf + len1 + len2, s3.data(), len3);
-  memcpy(buf + len1 + len2 + len3, s4.data(), len4);
-  memcpy(buf + len1 + len2 + len3 + len4, s5.data(), len5);
-  memcpy(buf + len1 + len2 + len3 + len4 + len5, s6.data(), len6);
-  buf[len] = 0;
-  return String(buf, len, AttachString);
+String &concat_assign_parts(String &s, const String * const *parts,
+                            int count) {
+  ASSERT(count <= MAX_CONCAT_ARGS);
+  StringData *data = s.get();
+  if (data && data->getCount() == 1) {
+    const char *ptrs[MAX_CONCAT_ARGS];
+    int lens[MAX_CONCAT_ARGS];
+    for (int i = 0; i < count; i++) {
+      ptrs[i] = parts[i]->data();
+      lens[i] = parts[i]->size();
+    }
+    data->append(ptrs, lens, count);
+    return s;
+  }
+
+  const String *all[MAX_CONCAT_ARGS + 1];
+  all[0] = &s;
+  memcpy(all + 1, parts, count * sizeof(parts[0]));
+  s = concat_parts(all, count + 1);
+  return s;
+}
+
+Variant &concat_assign_parts(Variant &v, const String * const *parts,
+                             int count) {
+  if (v.getType() == KindOfString) {
+    StringData *data = v.getStringData();
+    if (data->getCount() == 1) {
+      ASSERT(count <= MAX_CONCAT_ARGS);
+      const char *ptrs[MAX_CONCAT_ARGS];
+      int lens[MAX_CONCAT_ARGS];
+      for (int i = 0; i < count; i++) {
+        ptrs[i] = parts[i]->data();
+        lens[i] = parts[i]->size();
+      }
+      data->append(ptrs, lens, count);
+      return v;
+    }
+  }
+  String s = v.toString();
+  concat_assign_parts(s, parts, count);
+  v = s;
+  return v;
 }
 
 Variant &concat_assign(ObjectOffset v1, CStrRef s2) {
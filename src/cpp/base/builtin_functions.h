@@ -245,12 +245,78 @@ inline String concat_rev(CStrRef s2, CStrRef s1)     { return s1 + s2;}
 inline String &concat_assign(String &s1, litstr s2)  { return s1 += s2;}
 inline String &concat_assign(String &s1, CStrRef s2) { return s1 += s2;}
 
-#define MAX_CONCAT_ARGS 6
-String concat3(CStrRef s1, CStrRef s2, CStrRef s3);
-String concat4(CStrRef s1, CStrRef s2, CStrRef s3, CStrRef s4);
-String concat5(CStrRef s1, CStrRef s2, CStrRef s3, CStrRef s4, CStrRef s5);
-String concat6(CStrRef s1, CStrRef s2, CStrRef s3, CStrRef s4, CStrRef s5,
-               CStrRef s6);
+/**
+ * The compiler flattens chains of "." and string interpolation into a single
+ * concatN() call, and "$s .= a . b" into concat_assignN(), so that a chain
+ * measures all its operands, allocates once and copies once.
+ */
+#define MAX_CONCAT_ARGS 16
+String concat_parts(const String * const *parts, int count);
+String &concat_assign_parts(String &s, const String * const *parts,
+                            int count);
+Variant &concat_assign_parts(Variant &v, const String * const *parts,
+                             int count);
+
+#define CONCAT_ARGS_2  CStrRef s1, CStrRef s2
+#define CONCAT_PARTS_2  &s1, &s2
+#define CONCAT_ARGS_3  CONCAT_ARGS_2, CStrRef s3
+#define CONCAT_PARTS_3  CONCAT_PARTS_2, &s3
+#define CONCAT_ARGS_4  CONCAT_ARGS_3, CStrRef s4
+#define CONCAT_PARTS_4  CONCAT_PARTS_3, &s4
+#define CONCAT_ARGS_5  CONCAT_ARGS_4, CStrRef s5
+#define CONCAT_PARTS_5  CONCAT_PARTS_4, &s5
+#define CONCAT_ARGS_6  CONCAT_ARGS_5, CStrRef s6
+#define CONCAT_PARTS_6  CONCAT_PARTS_5, &s6
+#define CONCAT_ARGS_7  CONCAT_ARGS_6, CStrRef s7
+#define CONCAT_PARTS_7  CONCAT_PARTS_6, &s7
+#define CONCAT_ARGS_8  CONCAT_ARGS_7, CStrRef s8
+#define CONCAT_PARTS_8  CONCAT_PARTS_7, &s8
+#define CONCAT_ARGS_9  CONCAT_ARGS_8, CStrRef s9
+#define CONCAT_PARTS_9  CONCAT_PARTS_8, &s9
+#define CONCAT_ARGS_10 CONCAT_ARGS_9, CStrRef s10
+#define CONCAT_PARTS_10 CONCAT_PARTS_9, &s10
+#define CONCAT_ARGS_11 CONCAT_ARGS_10, CStrRef s11
+#define CONCAT_PARTS_11 CONCAT_PARTS_10, &s11
+#define CONCAT_ARGS_12 CONCAT_ARGS_11, CStrRef s12
+#define CONCAT_PARTS_12 CONCAT_PARTS_11, &s12
+#define CONCAT_ARGS_13 CONCAT_ARGS_12, CStrRef s13
+#define CONCAT_PARTS_13 CONCAT_PARTS_12, &s13
+#define CONCAT_ARGS_14 CONCAT_ARGS_13, CStrRef s14
+#define CONCAT_PARTS_14 CONCAT_PARTS_13, &s14
+#define CONCAT_ARGS_15 CONCAT_ARGS_14, CStrRef s15
+#define CONCAT_PARTS_15 CONCAT_PARTS_14, &s15
+#define CONCAT_ARGS_16 CONCAT_ARGS_15, CStrRef s16
+#define CONCAT_PARTS_16 CONCAT_PARTS_15, &s16
+
+#define DECLARE_CONCAT(n)                                               \
+  inline String concat ## n(CONCAT_ARGS_ ## n) {                        \
+    const String *parts[] = { CONCAT_PARTS_ ## n };                     \
+    return concat_parts(parts, n);                                      \
+  }
+
+#define DECLARE_CONCAT_ASSIGN(n)                                        \
+  inline String &concat_assign ## n(String &s, CONCAT_ARGS_ ## n) {     \
+    const String *parts[] = { CONCAT_PARTS_ ## n };                     \
+    return concat_assign_parts(s, parts, n);                            \
+  }                                                                     \
+  inline Variant &concat_assign ## n(Variant &v, CONCAT_ARGS_ ## n) {   \
+    const String *parts[] = { CONCAT_PARTS_ ## n };                     \
+    return concat_assign_parts(v, parts, n);                            \
+  }
+
+DECLARE_CONCAT(3) DECLARE_CONCAT(4) DECLARE_CONCAT(5) DECLARE_CONCAT(6)
+DECLARE_CONCAT(7) DECLARE_CONCAT(8) DECLARE_CONCAT(9) DECLARE_CONCAT(10)
+DECLARE_CONCAT(11) DECLARE_CONCAT(12) DECLARE_CONCAT(13) DECLARE_CONCAT(14)
+DECLARE_CONCAT(15) DECLARE_CONCAT(16)
+
+DECLARE_CONCAT_ASSIGN(2) DECLARE_CONCAT_ASSIGN(3) DECLARE_CONCAT_ASSIGN(4)
+DECLARE_CONCAT_ASSIGN(5) DECLARE_CONCAT_ASSIGN(6) DECLARE_CONCAT_ASSIGN(7)
+DECLARE_CONCAT_ASSIGN(8) DECLARE_CONCAT_ASSIGN(9) DECLARE_CONCAT_ASSIGN(10)
+DECLARE_CONCAT_ASSIGN(11) DECLARE_CONCAT_ASSIGN(12) DECLARE_CONCAT_ASSIGN(13)
+DECLARE_CONCAT_ASSIGN(14) DECLARE_CONCAT_ASSIGN(15) DECLARE_CONCAT_ASSIGN(16)
+
+#undef DECLARE_CONCAT
+#undef DECLARE_CONCAT_ASSIGN
 
 inline Variant &concat_assign(Variant &v1, litstr s2) {
   if (v1.getType() == KindOfString) {
@@ -534,6 +600,13 @@ Object f_clone(Object obj);
 String f_serialize(CVarRef value);
 Variant f_unserialize(CStrRef str);
 
+/**
+ * Same as above, but in VariableSerializer::Binary format. Unlike
+ * f_unserialize(), failures are told apart from a serialized false.
+ */
+String binary_serialize(CVarRef value);
+Variant binary_unserialize(CStrRef str, bool &success);
+
 
 class LVariableTable;
 Variant include(CStrRef file, bool once = false,
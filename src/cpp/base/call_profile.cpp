@@ -0,0 +1,170 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010 Facebook, Inc. (http://www.facebook.com)          |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include <sys/stat.h>
+#include <dirent.h>
+#include <cpp/base/call_profile.h>
+#include <cpp/base/util/request_local.h>
+#include <cpp/base/externals.h>
+#include <cpp/base/runtime_option.h>
+#include <util/lock.h>
+#include <util/logger.h>
+#include <util/util.h>
+
+using namespace std;
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+CallProfile CallProfile::TheCallProfile;
+
+CallProfile::CallProfile() : m_loaded(false), m_count(0) {
+}
+
+class CallCounters : public RequestEventHandler {
+public:
+  CallCounters() : m_data(NULL), m_count(0) { }
+  uint64 *getCounter(int id) { return m_data ? &m_data[id] : NULL; }
+  virtual void requestInit() {
+    if (!m_data) {
+      m_count = CallProfile::TheCallProfile.getCount();
+      if (m_count > 0) {
+        m_data = (uint64 *)calloc(m_count, sizeof(uint64));
+        CallProfile::TheCallProfile.addCounters(m_data);
+      }
+    }
+  }
+  virtual void requestShutdown() {
+    // written out by CallProfile::flush(), off the request threads
+  }
+private:
+  uint64 *m_data;
+  int m_count;
+};
+
+static RequestLocal<CallCounters> s_call_counters;
+
+uint64 *getCallCounter(int id) {
+  return s_call_counters->getCounter(id);
+}
+
+void CallProfile::init(bool createDir) {
+  Lock lock(m_mutex);
+  if (m_loaded) return;
+  for (const char **p = g_callprofile_map; *p; p++) {
+    m_id2name.push_back(*p);
+  }
+  if (!m_id2name.empty() && createDir) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s%d/",
+             RuntimeOption::CallProfileDirectory.c_str(), getpid());
+    Util::mkdir(path);
+  }
+  m_count = m_id2name.size();
+  m_loaded = true;
+}
+
+void CallProfile::addCounters(uint64 *counters) {
+  Lock lock(m_mutex);
+  m_counters.push_back(counters);
+}
+
+void CallProfile::flush() {
+  Lock lock(m_mutex);
+  if (m_counters.empty()) return;
+
+  // counters are read while their threads go on adding to them, which is
+  // fine for a profile: at worst a few calls are missed until next time
+  vector<int64> sums(m_count);
+  for (unsigned int i = 0; i < m_counters.size(); i++) {
+    for (int j = 0; j < m_count; j++) {
+      sums[j] += m_counters[i][j];
+    }
+  }
+
+  // written aside and renamed, so Load() never sees half a file
+  char path[PATH_MAX];
+  snprintf(path, sizeof(path), "%s%d/process.calls",
+           RuntimeOption::CallProfileDirectory.c_str(), getpid());
+  string tmp = string(path) + ".tmp";
+  FILE *f = fopen(tmp.c_str(), "w");
+  if (f == NULL) {
+    Logger::Error("%s", Util::safe_strerror(errno).c_str());
+    return;
+  }
+  for (int i = 0; i < m_count; i++) {
+    if (sums[i]) {
+      fprintf(f, "%lld %s\n", sums[i], m_id2name[i].c_str());
+    }
+  }
+  fclose(f);
+  if (rename(tmp.c_str(), path)) {
+    Logger::Error("%s", Util::safe_strerror(errno).c_str());
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CallProfile::LoadFile(const string &path, map<string, int64> &counts) {
+  FILE *f = fopen(path.c_str(), "r");
+  if (f == NULL) {
+    Logger::Error("%s", Util::safe_strerror(errno).c_str());
+    return;
+  }
+  char line[1024];
+  while (fgets(line, sizeof(line), f)) {
+    char *name = strchr(line, ' ');
+    if (name == NULL) continue;
+    *name++ = '\0';
+    int len = strlen(name);
+    if (len > 0 && name[len - 1] == '\n') name[--len] = '\0';
+    if (len == 0) continue;
+    counts[name] += strtoll(line, NULL, 10);
+  }
+  fclose(f);
+}
+
+bool CallProfile::Load(const char *dir, map<string, int64> &counts) {
+  ASSERT(dir);
+  vector<string> dirs;
+  dirs.push_back(dir);
+  bool found = false;
+  for (unsigned int i = 0; i < dirs.size(); i++) {
+    DIR *dp = opendir(dirs[i].c_str());
+    if (!dp) continue;
+    dirent *de;
+    while ((de = readdir(dp)) != NULL) {
+      if (de->d_name[0] == '.') continue;
+      string path = dirs[i] + "/" + de->d_name;
+      struct stat st;
+      if (stat(path.c_str(), &st)) continue;
+      if ((st.st_mode & S_IFMT) == S_IFDIR) {
+        // per-process sub-directories, see CallProfile::flush()
+        if (i == 0) dirs.push_back(path);
+      } else if ((st.st_mode & S_IFMT) == S_IFREG &&
+                 path.size() > 6 &&
+                 path.compare(path.size() - 6, 6, ".calls") == 0) {
+        LoadFile(path, counts);
+        found = true;
+      }
+    }
+    closedir(dp);
+  }
+  return found;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
@@ -0,0 +1,77 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010 Facebook, Inc. (http://www.facebook.com)          |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __HPHP_CALL_PROFILE_H__
+#define __HPHP_CALL_PROFILE_H__
+
+#include <string>
+#include <vector>
+#include <map>
+#include <util/mutex.h>
+#include <cpp/base/types.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Per-function call counts collected from a program compiled with
+ * GenCallProfileData. Each thread keeps its own counters, and flush() sums
+ * them up and writes "<count> <function id>" lines to
+ * RuntimeOption::CallProfileDirectory/<pid>/process.calls, which hphp
+ * later reads back with --call-profile-directory to lay out generated code.
+ * The server flushes every minute and when it stops, never from a request.
+ */
+class CallProfile {
+public:
+  static CallProfile TheCallProfile;
+
+  /**
+   * Sum up all .calls files under a directory (and one level of <pid>
+   * sub-directories) into function id => call count.
+   */
+  static bool Load(const char *dir, std::map<std::string, int64> &counts);
+
+public:
+  CallProfile();
+
+  void init(bool createDir);
+  int getCount() { return m_count;}
+  const char *getName(int id) { return m_id2name[id].c_str();}
+
+  /**
+   * Threads hand over their counters once, and keep them for good, so a
+   * flush() can read them while they are still being counted into.
+   */
+  void addCounters(uint64 *counters);
+  void flush();
+
+private:
+  Mutex m_mutex;
+  bool m_loaded;
+  int m_count;
+  std::vector<std::string> m_id2name;
+  std::vector<uint64 *> m_counters;
+
+  static void LoadFile(const std::string &path,
+                       std::map<std::string, int64> &counts);
+};
+
+uint64 *getCallCounter(int id);
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __HPHP_CALL_PROFILE_H__
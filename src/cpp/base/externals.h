@@ -82,6 +82,7 @@ extern const char *g_source_info[];
 extern const char *g_source_cls2file[];
 extern const char *g_source_func2file[];
 extern const char *g_paramrtti_map[];
+extern const char *g_callprofile_map[];
 
 /**
  * Dynamically create an object.
@@ -131,6 +132,7 @@ extern SystemGlobals *get_system_globals();
 extern StaticString literalStrings[];
 
 extern unsigned int *getRTTICounter(int id);
+extern uint64 *getCallCounter(int id);
 
 ///////////////////////////////////////////////////////////////////////////////
 }
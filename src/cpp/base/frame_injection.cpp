@@ -59,77 +59,127 @@ ObjectData *FrameInjection::getThis(bool skip /* = false */) {
 
 Array FrameInjection::getBacktrace(bool skip /* = false */,
                                    bool withSelf /* = false */) {
-  Array bt = Array::Create();
+  return BacktraceFrames(skip).toArray(withSelf);
+}
+
+String FrameInjection::getFileName() {
+  return GetFileName(m_class, m_name);
+}
+
+String FrameInjection::GetFileName(const char *cls, const char *name) {
+  if (strncmp(name, "run_init::", 10) == 0) {
+    return name + 10;
+  }
+  const char *c = strstr(name, "::");
+  const char *f = NULL;
+  if (c) {
+    f = SourceInfo::TheSourceInfo.getClassDeclaringFile(cls);
+  } else {
+    f = SourceInfo::TheSourceInfo.getFunctionDeclaringFile(name);
+  }
+  if (f != NULL) {
+    return f;
+  }
+  return String();
+}
+
+Array FrameInjection::getArgs() {
+  return Array();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BacktraceFrames::BacktraceFrames(bool skip /* = false */) : m_first(0) {
   FrameInjection *t = ThreadInfo::s_threadInfo->m_top;
   if (skip && t) {
     t = t->m_prev;
   }
-  if (withSelf && t) {
+  int count = 0;
+  for (FrameInjection *p = t; p; p = p->m_prev) count++;
+  m_frames.resize(count);
+  for (int i = 0; t; t = t->m_prev, i++) {
+    Frame &frame = m_frames[i];
+    frame.cls = t->m_class;
+    frame.name = t->m_name;
+    frame.file = t->peekFileName();
+    frame.line = t->line;
+    frame.object = t->m_object;
+    frame.args = t->getArgs();
+  }
+}
+
+bool BacktraceFrames::Frame::isPseudoMain() const {
+  // TODO should we generate require_once for pseudo mains?
+  return strncmp(name, "run_init::", 10) == 0;
+}
+
+String BacktraceFrames::Frame::getFileName() const {
+  if (file) return file;
+  return FrameInjection::GetFileName(cls, name);
+}
+
+Array BacktraceFrames::toArray(bool withSelf /* = false */) const {
+  Array bt = Array::Create();
+  unsigned int i = m_first;
+  if (withSelf && i < m_frames.size()) {
     // This is used by onError with extended exceptions
     Array frame = Array::Create();
-    frame.set("file", t->getFileName());
-    frame.set("line", t->line);
+    frame.set("file", m_frames[i].getFileName());
+    frame.set("line", m_frames[i].line);
     bt.append(frame);
   }
-  while (t) {
-    if (strncmp(t->m_name, "run_init::", 10) == 0) {
-      // TODO should we generate require_once for pseudo mains?
-      t = t->m_prev;
-      continue;
-    }
+  for (; i < m_frames.size(); i++) {
+    const Frame &t = m_frames[i];
+    if (t.isPseudoMain()) continue;
+
     Array frame = Array::Create();
-    const char *c = strstr(t->m_name, "::");
+    const char *c = strstr(t.name, "::");
     if (c) {
       frame.set("function", String(c + 2));
-      frame.set("class", String(t->m_class));
-      if (t->m_object) {
-        frame.set("object", t->m_object);
+      frame.set("class", String(t.cls));
+      if (!t.object.isNull()) {
+        frame.set("object", t.object);
         frame.set("type", "->");
       } else {
         frame.set("type", "::");
       }
     } else {
-      frame.set("function", t->m_name);
+      frame.set("function", t.name);
     }
 
-    if (t->m_prev) {
-      String file = t->m_prev->getFileName();
+    if (i + 1 < m_frames.size()) {
+      const Frame &prev = m_frames[i + 1];
+      String file = prev.getFileName();
       if (!file.empty()) {
         frame.set("file", file);
       }
-      frame.set("line", t->m_prev->line);
+      frame.set("line", prev.line);
     }
 
-    Array args = t->getArgs();
-    if (!args.isNull()) {
-      frame.set("args", args);
+    if (!t.args.isNull()) {
+      frame.set("args", t.args);
     }
 
     bt.append(frame);
-    t = t->m_prev;
   }
   return bt;
 }
 
-String FrameInjection::getFileName() {
-  if (strncmp(m_name, "run_init::", 10) == 0) {
-    return m_name + 10;
+void BacktraceFrames::shift(Variant &file, Variant &line) {
+  file = null;
+  line = null;
+  while (m_first < m_frames.size() && m_frames[m_first].isPseudoMain()) {
+    m_first++;
   }
-  const char *c = strstr(m_name, "::");
-  const char *f = NULL;
-  if (c) {
-    f = SourceInfo::TheSourceInfo.getClassDeclaringFile(m_class);
-  } else {
-    f = SourceInfo::TheSourceInfo.getFunctionDeclaringFile(m_name);
-  }
-  if (f != NULL) {
-    return f;
+  if (m_first == m_frames.size()) return;
+  if (++m_first < m_frames.size()) {
+    const Frame &prev = m_frames[m_first];
+    String f = prev.getFileName();
+    if (!f.empty()) {
+      file = f;
+    }
+    line = prev.line;
   }
-  return String();
-}
-
-Array FrameInjection::getArgs() {
-  return Array();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
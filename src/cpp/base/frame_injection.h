@@ -19,6 +19,7 @@
 #include <util/base.h>
 #include <util/thread_local.h>
 #include <cpp/base/types.h>
+#include <cpp/base/type_object.h>
 
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
@@ -43,16 +44,61 @@ public:
 
   virtual String getFileName();
 
+  /**
+   * The file name, if it's at hand without looking it up. NULL otherwise.
+   */
+  virtual const char *peekFileName() { return NULL;}
+
   int line;
 
   virtual Array getArgs();
 
 private:
+  friend class BacktraceFrames;
+
   ThreadInfo *m_info;
   FrameInjection *m_prev;
   const char *m_class;
   const char *m_name;
   ObjectData *m_object;
+
+  static String GetFileName(const char *cls, const char *name);
+};
+
+/**
+ * A copy of the FrameInjection chain, taken without building any of the
+ * arrays and strings getBacktrace() returns, so they can be built later, or
+ * never. Only arguments are taken right away, as they go with their frames.
+ */
+class BacktraceFrames {
+public:
+  BacktraceFrames(bool skip = false);
+
+  /**
+   * Same as FrameInjection::getBacktrace() at the time of the copy.
+   */
+  Array toArray(bool withSelf = false) const;
+
+  /**
+   * Takes the first frame off, and gives its "file" and "line", or nulls if
+   * its backtrace frame would have none.
+   */
+  void shift(Variant &file, Variant &line);
+
+private:
+  struct Frame {
+    const char *cls;
+    const char *name;
+    const char *file; // peekFileName()
+    int line;
+    Object object;
+    Array args;
+
+    bool isPseudoMain() const;
+    String getFileName() const;
+  };
+  std::vector<Frame> m_frames;
+  unsigned int m_first; // frames before it were shifted off
 };
 
 /**
@@ -345,6 +345,19 @@ namespace HPHP {
     }                                           \
   } while (0)
 
+// for collecting per-function call counts at runtime
+#define CALL_PROFILE_INJECTION(id)              \
+  do {                                          \
+    uint64 *counter = getCallCounter(id);       \
+    if (counter) (*counter)++;                  \
+  } while (0)
+
+// profile-guided code layout: hot functions get their own sections, named
+// by rank, so the linker can pack them together following the generated
+// section ordering file; never executed ones are moved out of the way
+#define HOT_FUNCTION(n) __attribute__((section(".text.hot." #n)))
+#define COLD_FUNCTION __attribute__((section(".text.unlikely")))
+
 ///////////////////////////////////////////////////////////////////////////////
 }
 
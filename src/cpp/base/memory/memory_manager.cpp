@@ -17,11 +17,28 @@
 #include <cpp/base/memory/memory_manager.h>
 #include <cpp/base/memory/leak_detectable.h>
 #include <cpp/base/runtime_option.h>
+#include <util/atomic.h>
+#include <util/lock.h>
 
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
 ThreadLocal<MemoryManager> *MemoryManager::s_singleton = NULL;
+int MemoryManager::s_trimGeneration = 0;
+
+/**
+ * All threads' memory managers, so the admin server can report on them.
+ * Function statics, as memory managers are created by static initializers.
+ */
+static Mutex &GetRegistryMutex() {
+  static Mutex mutex;
+  return mutex;
+}
+
+static std::set<MemoryManager*> &GetRegistry() {
+  static std::set<MemoryManager*> registry;
+  return registry;
+}
 
 static class MemoryManagerInitializer {
 public:
@@ -37,11 +54,23 @@ ThreadLocal<MemoryManager> &MemoryManager::TheMemoryManager() {
   return *s_singleton;
 }
 
-MemoryManager::MemoryManager() : m_enabled(false), m_checkpoint(false) {
+MemoryManager::MemoryManager()
+  : m_enabled(false), m_checkpoint(false), m_thread(pthread_self()),
+    m_lastActive(time(NULL)), m_idleTrimmed(false),
+    m_trimGeneration(s_trimGeneration) {
   if (RuntimeOption::EnableMemoryManager) {
     m_enabled = true;
   }
+  m_sizeClassAllocator.registerStats(&m_stats);
   resetStats();
+
+  Lock lock(GetRegistryMutex());
+  GetRegistry().insert(this);
+}
+
+MemoryManager::~MemoryManager() {
+  Lock lock(GetRegistryMutex());
+  GetRegistry().erase(this);
 }
 
 void MemoryManager::resetStats() {
@@ -103,14 +132,19 @@ void MemoryManager::checkpoint() {
     m_smartAllocators[i]->backupObjects(m_linearAllocator);
   }
   m_linearAllocator.endBackup();
+
+  // everything allocated from now on is gone by next rollback()
+  m_sizeClassAllocator.enable();
 }
 
 void MemoryManager::rollback() {
+  m_sizeClassAllocator.beginSweep();
   m_linearAllocator.beginRestore();
   for (unsigned int i = 0; i < m_smartAllocators.size(); i++) {
     m_smartAllocators[i]->rollbackObjects(m_linearAllocator);
   }
   m_linearAllocator.endRestore();
+  m_sizeClassAllocator.reset();
   protectUnsafePointers();
 }
 
@@ -127,6 +161,7 @@ void MemoryManager::logStats() {
   for (unsigned int i = 0; i < m_smartAllocators.size(); i++) {
     m_smartAllocators[i]->logStats();
   }
+  m_sizeClassAllocator.logStats();
   LeakDetectable::LogMallocStats();
 }
 
@@ -142,8 +177,122 @@ void MemoryManager::checkMemory(bool detailed) {
     m_smartAllocators[i]->checkMemory(detailed);
   }
   m_linearAllocator.checkMemory(detailed);
+  m_sizeClassAllocator.checkMemory(detailed);
   printf("Unsafe pointers: %d\n", (int)m_unsafePointers.size());
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// retention policy
+
+void MemoryManager::trim(bool force) {
+  m_lastActive = time(NULL);
+  m_idleTrimmed = false;
+  if (force) {
+    releaseMemory();
+    updateUsage();
+  } else if (RuntimeOption::RetainedMemoryMaxBytes >= 0) {
+    int64 retained = m_sizeClassAllocator.getRetainedBytes();
+    for (unsigned int i = 0; i < m_smartAllocators.size(); i++) {
+      retained += m_smartAllocators[i]->getRetainedBytes();
+    }
+    if (retained > RuntimeOption::RetainedMemoryMaxBytes) {
+      releaseMemory();
+    }
+    updateUsage();
+  } else if (RuntimeOption::IdleMemoryTrimSeconds > 0) {
+    updateUsage();
+  }
+}
+
+void MemoryManager::onIdle() {
+  int generation = s_trimGeneration;
+  bool requested = generation != m_trimGeneration;
+  bool timedout = !m_idleTrimmed && RuntimeOption::IdleMemoryTrimSeconds > 0 &&
+    time(NULL) - m_lastActive >= RuntimeOption::IdleMemoryTrimSeconds;
+  if (requested || timedout) {
+    m_trimGeneration = generation;
+    m_idleTrimmed = true;
+    releaseMemory();
+    updateUsage();
+  }
+}
+
+void MemoryManager::TrimAll() {
+  atomic_inc(s_trimGeneration);
+}
+
+void MemoryManager::releaseMemory() {
+  m_sizeClassAllocator.trim();
+  for (unsigned int i = 0; i < m_smartAllocators.size(); i++) {
+    if (m_checkpoint) {
+      // blocks before the checkpoint have to stay to be restored into
+      m_smartAllocators[i]->trimUnused();
+    } else {
+      m_smartAllocators[i]->trim();
+    }
+  }
+}
+
+void MemoryManager::updateUsage() {
+  std::vector<AllocatorUsage> usage(m_smartAllocators.size() + 1);
+  for (unsigned int i = 0; i < m_smartAllocators.size(); i++) {
+    SmartAllocatorImpl *allocator = m_smartAllocators[i];
+    usage[i].name = allocator->getName();
+    usage[i].itemSize = allocator->getItemSize();
+    usage[i].retained = allocator->getRetainedBytes();
+    usage[i].used = allocator->getUsedBytes();
+  }
+  usage.back().name = "sizeclass";
+  usage.back().itemSize = 0;
+  usage.back().retained = m_sizeClassAllocator.getRetainedBytes();
+  usage.back().used = m_sizeClassAllocator.getUsedBytes();
+
+  Lock lock(m_usageMutex);
+  m_usage.swap(usage);
+}
+
+std::string MemoryManager::ReportRetainedMemory() {
+  std::ostringstream out;
+  std::map<std::string, std::pair<int64, int64> > allocators;
+  int64 totalRetained = 0;
+  int64 totalUsed = 0;
+
+  Lock lock(GetRegistryMutex());
+  std::set<MemoryManager*> &registry = GetRegistry();
+  for (std::set<MemoryManager*>::const_iterator iter = registry.begin();
+       iter != registry.end(); ++iter) {
+    Lock usageLock((*iter)->m_usageMutex);
+    const std::vector<AllocatorUsage> &usage = (*iter)->m_usage;
+    if (usage.empty()) continue;
+
+    int64 retained = 0;
+    int64 used = 0;
+    for (unsigned int i = 0; i < usage.size(); i++) {
+      std::string name = usage[i].name;
+      if (usage[i].itemSize) {
+        name += "." + boost::lexical_cast<std::string>(usage[i].itemSize);
+      }
+      std::pair<int64, int64> &total = allocators[name];
+      total.first += usage[i].retained;
+      total.second += usage[i].used;
+      retained += usage[i].retained;
+      used += usage[i].used;
+    }
+    out << "thread " << (long)(*iter)->m_thread << ": " << retained
+        << " retained, " << used << " used\n";
+    totalRetained += retained;
+    totalUsed += used;
+  }
+  out << "total: " << totalRetained << " retained, " << totalUsed
+      << " used\n";
+
+  for (std::map<std::string, std::pair<int64, int64> >::const_iterator iter =
+         allocators.begin(); iter != allocators.end(); ++iter) {
+    out << iter->first << ": " << iter->second.first << " retained, "
+        << iter->second.second << " used\n";
+  }
+  return out.str();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 }
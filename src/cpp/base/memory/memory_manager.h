@@ -19,7 +19,9 @@
 
 #include <cpp/base/memory/smart_allocator.h>
 #include <cpp/base/memory/linear_allocator.h>
+#include <cpp/base/memory/size_class_allocator.h>
 #include <cpp/base/memory/unsafe_pointer.h>
+#include <util/mutex.h>
 
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
@@ -32,7 +34,9 @@ namespace HPHP {
  *     exactly the same size. For example, EmptyArray.
  *  2. Interally malloc-ed and variable sized memory held by fixed size
  *     objects, for example, StringData's m_data. These memory can be backed up
- *     and restored by LinearAllocator.
+ *     and restored by LinearAllocator. Some of them, like array storage, are
+ *     allocated by SizeClassAllocator through smart_malloc() and discarded
+ *     all at once by rollback().
  *  3. Unsafe pointers held by fixed size objects, for example, ObjectData*
  *     held by Object. These pointers point to some external memory that's out
  *     of the control of MemoryManager, and therefore they are only interfaced
@@ -46,6 +50,7 @@ public:
   static ThreadLocal<MemoryManager> &TheMemoryManager();
 
   MemoryManager();
+  ~MemoryManager();
 
   /**
    * Without calling this, everything should work as if there is no memory
@@ -58,6 +63,11 @@ public:
    */
   void add(SmartAllocatorImpl *allocator);
 
+  /**
+   * Where smart_malloc() and smart_free() go.
+   */
+  SizeClassAllocator &getSizeClassAllocator() { return m_sizeClassAllocator;}
+
   /**
    * Register an unsafe pointer. Done by UnsafePointer's constructor.
    */
@@ -125,17 +135,62 @@ public:
    */
   void resetStats();
 
+  /**
+   * Called after each request. Once this thread holds more than
+   * RuntimeOption::RetainedMemoryMaxBytes, or if forced, free blocks are
+   * handed back to the OS.
+   */
+  void trim(bool force = false);
+
+  /**
+   * Called by a worker thread while it is waiting for requests. Hands back
+   * all free blocks once it has been idle for
+   * RuntimeOption::IdleMemoryTrimSeconds, or when TrimAll() asked for it.
+   */
+  void onIdle();
+
+  /**
+   * Asks every thread to trim all its free blocks next time it is idle.
+   */
+  static void TrimAll();
+
+  /**
+   * Retained versus used bytes of each thread and each allocator, as of
+   * each thread's last trim() or onIdle(). Threads only take these snapshots
+   * when RetainedMemoryMaxBytes or IdleMemoryTrimSeconds is set.
+   */
+  static std::string ReportRetainedMemory();
+
 private:
   static ThreadLocal<MemoryManager> *s_singleton;
+  static int s_trimGeneration;
+
+  struct AllocatorUsage {
+    const char *name; // formatted with itemSize only when reported
+    int itemSize;
+    int64 retained;
+    int64 used;
+  };
+  void releaseMemory();
+  void updateUsage();
 
   bool m_enabled;
   bool m_checkpoint;
 
   std::vector<SmartAllocatorImpl*> m_smartAllocators;
   LinearAllocator m_linearAllocator;
+  SizeClassAllocator m_sizeClassAllocator;
   std::set<UnsafePointer*> m_unsafePointers;
 
   MemoryUsageStats m_stats;
+
+  // retention policy
+  pthread_t m_thread;
+  time_t m_lastActive;
+  bool m_idleTrimmed;
+  int m_trimGeneration;
+  Mutex m_usageMutex;
+  std::vector<AllocatorUsage> m_usage; // guarded by m_usageMutex
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,243 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010 Facebook, Inc. (http://www.facebook.com)          |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+
+#include <cpp/base/memory/size_class_allocator.h>
+#include <cpp/base/memory/memory_manager.h>
+#include <cpp/base/server/server_stats.h>
+#include <cpp/base/runtime_option.h>
+#include <cpp/base/util/exceptions.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+SizeClassAllocator::SizeClassAllocator()
+  : m_enabled(false), m_sweeping(false), m_slab(0), m_pos(0),
+    m_slabCount(0), m_mallocCount(0), m_stats(NULL) {
+  memset(m_freelists, 0, sizeof(m_freelists));
+}
+
+SizeClassAllocator::~SizeClassAllocator() {
+  for (unsigned int i = 0; i < m_slabs.size(); i++) {
+    free(m_slabs[i]);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SizeClassAllocator::addUsage(int64 bytes) {
+  if (m_stats) {
+    m_stats->usage += bytes;
+    if (m_stats->usage > m_stats->peakUsage) {
+      int64 prevPeakUsage = m_stats->peakUsage;
+      m_stats->peakUsage = m_stats->usage;
+      if (RuntimeOption::RequestMemoryMaxBytes > 0 &&
+          m_stats->peakUsage > RuntimeOption::RequestMemoryMaxBytes &&
+          prevPeakUsage <= RuntimeOption::RequestMemoryMaxBytes) {
+        throw FatalErrorException("request has exceeded memory limit");
+      }
+    }
+  }
+}
+
+void SizeClassAllocator::checkOwner(Header *h) const {
+#ifndef RELEASE
+  // uncounted buffers are plain malloc() and touch no per thread state
+  ASSERT(h->sizeClass == Uncounted || h->owner == this);
+#endif
+}
+
+SizeClassAllocator::Header *SizeClassAllocator::carve(int sizeClass) {
+  int bytes = sizeof(Header) + (1 << (sizeClass + MinShift));
+  if (m_slabs.empty() || m_pos + bytes > SlabSize) {
+    if (!m_slabs.empty()) {
+      m_slab++;
+    }
+    if (m_slab == (int)m_slabs.size()) {
+      m_slabs.push_back((char *)malloc(SlabSize));
+      if (m_stats) {
+        m_stats->alloc += SlabSize;
+        if (m_stats->alloc > m_stats->peakAlloc) {
+          m_stats->peakAlloc = m_stats->alloc;
+        }
+      }
+    }
+    m_pos = 0;
+  }
+  Header *h = (Header *)(m_slabs[m_slab] + m_pos);
+  m_pos += bytes;
+  return h;
+}
+
+void *SizeClassAllocator::alloc(int size) {
+  ASSERT(size >= 0);
+  if (m_enabled && !m_sweeping && size <= (1 << MaxShift)) {
+    int sizeClass = 0;
+    while ((1 << (sizeClass + MinShift)) < size) sizeClass++;
+
+    Header *h = m_freelists[sizeClass];
+    if (h) {
+      m_freelists[sizeClass] = *(Header **)(h + 1);
+    } else {
+      h = carve(sizeClass);
+      h->sizeClass = sizeClass;
+      h->size = 1 << (sizeClass + MinShift);
+    }
+#ifndef RELEASE
+    h->owner = this;
+#endif
+    m_slabCount++;
+    addUsage(h->size);
+    return h + 1;
+  }
+
+  Header *h = (Header *)malloc(sizeof(Header) + size);
+  h->size = size;
+#ifndef RELEASE
+  h->owner = this;
+#endif
+  if (m_enabled && !m_sweeping) {
+    h->sizeClass = Counted;
+    m_mallocCount++;
+    addUsage(size);
+  } else {
+    h->sizeClass = Uncounted;
+  }
+  return h + 1;
+}
+
+void *SizeClassAllocator::realloc(void *p, int size) {
+  if (p == NULL) {
+    return alloc(size);
+  }
+
+  Header *h = (Header *)p - 1;
+  checkOwner(h);
+  if (h->sizeClass < 0) {
+    int oldSize = h->size;
+    h = (Header *)::realloc(h, sizeof(Header) + size);
+    h->size = size;
+    if (h->sizeClass == Counted && !m_sweeping) {
+      addUsage(size - oldSize);
+    }
+    return h + 1;
+  }
+
+  if (size <= h->size) {
+    return p;
+  }
+  void *ret = alloc(size);
+  memcpy(ret, p, h->size);
+  dealloc(p);
+  return ret;
+}
+
+void SizeClassAllocator::dealloc(void *p) {
+  if (p == NULL) return;
+
+  Header *h = (Header *)p - 1;
+  checkOwner(h);
+  if (h->sizeClass >= 0) {
+    ASSERT(h->sizeClass < ClassCount);
+    if (m_sweeping) return; // the whole slab will be reset()
+    *(Header **)(h + 1) = m_freelists[h->sizeClass];
+    m_freelists[h->sizeClass] = h;
+    if (m_stats) {
+      m_stats->usage -= h->size;
+    }
+  } else {
+    if (h->sizeClass == Counted && !m_sweeping && m_stats) {
+      m_stats->usage -= h->size;
+    }
+    free(h);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SizeClassAllocator::enable() {
+#ifndef DEBUGGING_SMART_ALLOCATOR
+  m_enabled = true; // otherwise leave everything to malloc for leak checkers
+#endif
+}
+
+void SizeClassAllocator::reset() {
+  m_sweeping = false;
+  m_slab = 0;
+  m_pos = 0;
+  memset(m_freelists, 0, sizeof(m_freelists));
+  m_slabCount = 0;
+  m_mallocCount = 0;
+}
+
+int64 SizeClassAllocator::trim() {
+  int64 freed = 0;
+  for (unsigned int i = m_slab + 1; i < m_slabs.size(); i++) {
+    free(m_slabs[i]);
+    freed += SlabSize;
+  }
+  if (!m_slabs.empty()) {
+    m_slabs.resize(m_slab + 1);
+  }
+  return freed;
+}
+
+void SizeClassAllocator::logStats() {
+  ServerStats::Log("mem.sizeclass.slab", m_slabCount);
+  ServerStats::Log("mem.sizeclass.malloc", m_mallocCount);
+}
+
+void SizeClassAllocator::checkMemory(bool detailed) {
+  printf("SizeClassAllocator: %d slabs, slab = %d, pos = %d, "
+         "%d from slabs, %d from malloc\n", (int)m_slabs.size(),
+         m_slab, m_pos, m_slabCount, m_mallocCount);
+
+  if (detailed) {
+    for (int i = 0; i < ClassCount; i++) {
+      int count = 0;
+      for (Header *h = m_freelists[i]; h; h = *(Header **)(h + 1)) {
+        count++;
+      }
+      printf("%16d bytes: %8d free\n", 1 << (i + MinShift), count);
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void *smart_malloc(size_t size) {
+  return MemoryManager::TheMemoryManager()->getSizeClassAllocator().
+    alloc(size);
+}
+
+void *smart_calloc(size_t count, size_t size) {
+  size_t bytes = count * size;
+  void *p = smart_malloc(bytes);
+  memset(p, 0, bytes);
+  return p;
+}
+
+void *smart_realloc(void *p, size_t size) {
+  return MemoryManager::TheMemoryManager()->getSizeClassAllocator().
+    realloc(p, size);
+}
+
+void smart_free(void *p) {
+  MemoryManager::TheMemoryManager()->getSizeClassAllocator().dealloc(p);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
@@ -0,0 +1,137 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010 Facebook, Inc. (http://www.facebook.com)          |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+
+#ifndef __HPHP_SIZE_CLASS_ALLOCATOR_H__
+#define __HPHP_SIZE_CLASS_ALLOCATOR_H__
+
+#include <util/base.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+struct MemoryUsageStats;
+
+/**
+ * Variable sized counterpart of SmartAllocator, for memory that fixed size
+ * objects malloc internally and own exclusively, like HphpVector's storage or
+ * ZendArray's bucket table. Buffers are carved out of big slabs by power-of-2
+ * size classes and recycled through per-class free lists. When a generation
+ * is rolled back, all of them are released by one reset(), instead of being
+ * freed one by one.
+ *
+ * Before a checkpoint is taken, while sweeping, and for buffers bigger than
+ * the largest size class, it falls back to malloc(). Each buffer carries a
+ * small header, so smart_free() always knows where it came from.
+ *
+ * There is no locking: a buffer from a generation has to be freed by the
+ * thread that allocated it, as free lists and usage stats are per thread.
+ * Debug builds record the owner in the header and assert on this.
+ */
+class SizeClassAllocator {
+public:
+  enum {
+    MinShift = 4,          // smallest class: 16 bytes
+    MaxShift = 12,         // largest class: 4096 bytes
+    ClassCount = MaxShift - MinShift + 1,
+    SlabSize = 256 * 1024,
+  };
+
+  SizeClassAllocator();
+  ~SizeClassAllocator();
+
+  /**
+   * Called by MemoryManager to store its usage stats pointer inside this
+   * allocator for easy access during alloc/free time.
+   */
+  void registerStats(MemoryUsageStats *stats) { m_stats = stats;}
+
+  void *alloc(int size);
+  void *realloc(void *p, int size);
+  void dealloc(void *p);
+
+  /**
+   * MemoryManager functions. Slabs are only used between enable() and
+   * beginSweep(); reset() then recycles all of them at once.
+   */
+  void enable();
+  void beginSweep() { m_sweeping = true;}
+  void reset();
+  void logStats();
+  void checkMemory(bool detailed);
+
+  /**
+   * Slabs held versus slab space handed out in current generation.
+   */
+  int64 getRetainedBytes() const { return (int64)m_slabs.size() * SlabSize;}
+  int64 getUsedBytes() const {
+    return m_slabs.empty() ? 0 : (int64)m_slab * SlabSize + m_pos;
+  }
+
+  /**
+   * Frees slabs past the current one. Returns number of bytes freed.
+   */
+  int64 trim();
+
+private:
+  enum {
+    Uncounted = -2, // malloc-ed outside of a generation
+    Counted = -1,   // malloc-ed within a generation, part of usage stats
+  };
+
+  struct Header {
+    int32 sizeClass; // index into m_freelists, or Uncounted/Counted
+    int32 size;      // usable bytes following this header
+#ifndef RELEASE
+    SizeClassAllocator *owner; // checked by realloc() and dealloc()
+#endif
+  };
+
+  bool m_enabled;
+  bool m_sweeping;
+
+  std::vector<char *> m_slabs; // kept across generations
+  int m_slab;                  // current slab
+  int m_pos;                   // position inside current slab
+
+  Header *m_freelists[ClassCount];
+
+  int m_slabCount;   // number of allocations served from slabs
+  int m_mallocCount; // number of allocations that had to malloc()
+
+  MemoryUsageStats *m_stats;
+
+  Header *carve(int sizeClass);
+  void addUsage(int64 bytes);
+  void checkOwner(Header *h) const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Drop-in replacements of malloc/calloc/realloc/free backed by the calling
+ * thread's SizeClassAllocator. Memory from these must never be passed to
+ * the libc versions, or vice versa, nor to another thread's smart_free().
+ */
+void *smart_malloc(size_t size);
+void *smart_calloc(size_t count, size_t size);
+void *smart_realloc(void *p, size_t size);
+void smart_free(void *p);
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __HPHP_SIZE_CLASS_ALLOCATOR_H__
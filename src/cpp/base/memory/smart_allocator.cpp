@@ -20,6 +20,9 @@
 #include <cpp/base/server/server_stats.h>
 #include <cpp/base/runtime_option.h>
 #include <util/logger.h>
+#include <sys/mman.h>
+#include <algorithm>
+#include <climits>
 
 using namespace std;
 using namespace boost;
@@ -32,6 +35,18 @@ namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 // helpers
 
+/**
+ * Tells the kernel it can take back whole pages inside this range.
+ */
+static void release_pages(char *p, int size) {
+  static uintptr_t pagesize = sysconf(_SC_PAGESIZE);
+  uintptr_t start = ((uintptr_t)p + pagesize - 1) & ~(pagesize - 1);
+  uintptr_t end = ((uintptr_t)p + size) & ~(pagesize - 1);
+  if (start < end) {
+    madvise((void*)start, end - start, MADV_DONTNEED);
+  }
+}
+
 static int calculate_item_count(int itemSize) {
   int itemCount = SLAB_SIZE / itemSize;
   if (itemCount == 0) {
@@ -338,6 +353,81 @@ void SmartAllocatorImpl::logStats() {
   ServerStats::Log(key + ".freed", freed);
 }
 
+int64 SmartAllocatorImpl::getUsedBytes() const {
+  int allocated = m_itemCount * m_row + (m_col / m_itemSize);
+  int freed = m_pos + 1;
+  return (int64)(allocated - freed) * m_itemSize;
+}
+
+int64 SmartAllocatorImpl::trim() {
+  ASSERT(m_backupBlocks.empty());
+  if (m_pos < 0) return 0;
+
+  // find out which block each free item belongs to
+  vector<pair<char*, int> > blocks;
+  blocks.reserve(m_row + 1);
+  for (int i = 0; i <= m_row; i++) {
+    blocks.push_back(pair<char*, int>(m_blocks[i], i));
+  }
+  sort(blocks.begin(), blocks.end());
+  vector<int> owners(m_pos + 1);
+  vector<int> freeCounts(m_row + 1);
+  for (int i = 0; i <= m_pos; i++) {
+    vector<pair<char*, int> >::const_iterator iter =
+      upper_bound(blocks.begin(), blocks.end(),
+                  pair<char*, int>((char*)m_freelist[i], INT_MAX));
+    ASSERT(iter != blocks.begin());
+    owners[i] = (--iter)->second;
+    freeCounts[owners[i]]++;
+  }
+  vector<bool> unused(m_row + 1);
+  for (int i = 0; i <= m_row; i++) {
+    unused[i] = freeCounts[i] * m_itemSize == (i == m_row ? m_col : m_colMax);
+  }
+
+  // trailing unused blocks go away, except the first one
+  int row = m_row;
+  while (row > 0 && unused[row]) row--;
+
+  int64 freed = 0;
+  if (row < m_row) {
+    int pos = -1;
+    for (int i = 0; i <= m_pos; i++) {
+      if (owners[i] <= row) {
+        m_freelist[++pos] = m_freelist[i];
+      }
+    }
+    for (int i = row + 1; i <= m_row; i++) {
+      free(m_blocks[i]);
+      freed += m_colMax;
+    }
+    m_blocks.resize(row + 1);
+    m_row = row;
+    m_col = m_colMax;
+    m_pos = pos;
+    m_freelist.resize((m_row + 1) * m_itemCount);
+    vector<void *>(m_freelist).swap(m_freelist);
+  }
+
+  // unused blocks we have to keep still don't need physical pages
+  for (int i = 0; i <= row; i++) {
+    if (unused[i]) {
+      release_pages(m_blocks[i], m_colMax);
+    }
+  }
+  return freed;
+}
+
+void SmartAllocatorImpl::trimUnused() {
+  ASSERT(m_row == (int)m_blocks.size() - 1);
+  if (m_col < m_colMax) {
+    release_pages(m_blocks[m_row] + m_col, m_colMax - m_col);
+  }
+  if (m_freelist.capacity() > m_freelist.size()) {
+    vector<void *>(m_freelist).swap(m_freelist);
+  }
+}
+
 void SmartAllocatorImpl::checkMemory(bool detailed) {
   int allocated = m_itemCount * m_row + (m_col / m_itemSize);
   int freed = m_pos + 1;
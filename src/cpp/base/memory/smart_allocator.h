@@ -172,6 +172,29 @@ public:
   void logStats();
   void checkMemory(bool detailed);
 
+  /**
+   * Memory held in blocks versus memory held by live objects.
+   */
+  const char *getName() const { return m_name;}
+  int64 getRetainedBytes() const { return (int64)m_blocks.size() * m_colMax;}
+  int64 getUsedBytes() const;
+
+  /**
+   * Gives blocks that only have freed objects back to the OS: trailing ones
+   * are free()-ed, others are madvise()-ed. Only valid when there is no
+   * checkpoint, as backed up blocks have to stay where they are. Returns
+   * number of bytes free()-ed.
+   */
+  int64 trim();
+
+  /**
+   * What can be given back with a checkpoint. rollback() free()-s blocks
+   * allocated after it, but the rest of the current block and the room
+   * the free list grew to during a spike stay resident: the former is
+   * madvise()-ed, and the latter shrunk.
+   */
+  void trimUnused();
+
   void disableDealloc() { m_dealloc = false;}
   void disableRestore() { m_flag |= RestoreDisabled;}
 
@@ -33,8 +33,10 @@
 #include <util/capability.h>
 #include <cpp/base/source_info.h>
 #include <cpp/base/rtti_info.h>
+#include <cpp/base/call_profile.h>
 #include <cpp/base/util/light_process.h>
 #include <cpp/base/frame_injection.h>
+#include <cpp/base/time/timezone.h>
 
 #include <boost/program_options/options_description.hpp>
 #include <boost/program_options/positional_options.hpp>
@@ -335,6 +337,9 @@ static int execute_command_line(const char * file, int argc, char **argv) {
   }
 
   if (RuntimeOption::EnableCliRTTI) RTTIInfo::TheRTTIInfo.init(true);
+  if (RuntimeOption::EnableCliCallProfile) {
+    CallProfile::TheCallProfile.init(true);
+  }
 
   int exitCode = -1;
   bool ret = false;
@@ -344,6 +349,9 @@ static int execute_command_line(const char * file, int argc, char **argv) {
                     errorMsg);
   hphp_context_exit(context, true);
   hphp_session_exit();
+  if (RuntimeOption::EnableCliCallProfile) {
+    CallProfile::TheCallProfile.flush();
+  }
   if (ret) {
     exitCode = ExitException::ExitCode;
   }
@@ -594,6 +602,7 @@ static ThreadLocal<WarmupState> s_warmup_state;
 void hphp_process_init() {
   init_static_variables();
   Process::InitProcessStatics();
+  TimeZone::Preload(RuntimeOption::PreloadTimeZones);
   PageletServer::Restart();
   XboxServer::Restart();
 }
@@ -754,6 +763,7 @@ void hphp_session_exit() {
     ServerStatsHelper ssh("free");
     free_global_variables();
   }
+  mm->trim();
 }
 
 void hphp_process_exit() {
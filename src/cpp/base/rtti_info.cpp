@@ -32,6 +32,7 @@ namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
 RTTIInfo RTTIInfo::TheRTTIInfo;
+const char *RTTIInfo::MetaDataHeader = "hphp-rtti-meta 2";
 
 RTTIInfo::RTTIInfo() : m_loaded(false), m_count(0), m_profData(NULL) {
 }
@@ -139,14 +140,28 @@ void RTTIInfo::loadParamMap(const char **p) {
   }
 }
 
-void RTTIInfo::loadMetaData(const char *filename) {
+bool RTTIInfo::loadMetaData(const char *filename) {
   ASSERT(!m_loaded);
   FILE *f = fopen(filename, "r");
-  if (f == NULL) return;
+  if (f == NULL) return false;
   char line[1024];
+  if (!fgets(line, sizeof(line), f) ||
+      strcmp(line, (string(MetaDataHeader) + "\n").c_str())) {
+    Logger::Warning("%s was not written by this version of the compiler, "
+                    "ignoring it", filename);
+    fclose(f);
+    return false;
+  }
   if (fgets(line, sizeof(line), f)) {
     sscanf(line, "%d", &m_count);
   }
+  // parameter names in id order, then functions having them
+  for (int i = 0; i < m_count && fgets(line, sizeof(line), f); i++) {
+    int len = strlen(line);
+    if (len > 0 && line[len-1] == '\n') line[len-1] = 0;
+    m_name2id[line] = m_id2name.size();
+    m_id2name.push_back(line);
+  }
   while (fgets(line, sizeof(line), f)) {
     int len = strlen(line);
     ASSERT(len > 0);
@@ -154,6 +169,7 @@ void RTTIInfo::loadMetaData(const char *filename) {
     m_functions.insert(line);
   }
   fclose(f);
+  return true;
 }
 
 bool RTTIInfo::loadProfData(const char *rttiDirectory) {
@@ -214,5 +230,27 @@ bool RTTIInfo::exists(const char *funcName) {
   return m_functions.find(funcName) != m_functions.end();
 }
 
+DataType RTTIInfo::getDominantType(const std::string &paramKey,
+                                   unsigned int minCount, int ratio) {
+  if (!m_profData) return KindOfVariant;
+  map<string, int>::const_iterator iter = m_name2id.find(paramKey);
+  if (iter == m_name2id.end() || iter->second >= m_count) {
+    return KindOfVariant;
+  }
+  const RTTICounter &counter = m_profData[iter->second];
+  unsigned int total = 0;
+  for (int j = 0; j < KindOfLast; j++) total += counter[j];
+  if (total == 0 || total < minCount) return KindOfVariant;
+
+  unsigned int ints = counter[KindOfByte] + counter[KindOfInt16] +
+                      counter[KindOfInt32] + counter[KindOfInt64];
+  unsigned int strs = counter[LiteralString] + counter[KindOfString];
+  unsigned int arrs = counter[KindOfArray];
+  if ((int64)ints * 100 >= (int64)total * ratio) return KindOfInt64;
+  if ((int64)strs * 100 >= (int64)total * ratio) return KindOfString;
+  if ((int64)arrs * 100 >= (int64)total * ratio) return KindOfArray;
+  return KindOfVariant;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 }
@@ -19,6 +19,8 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <set>
 #include <util/mutex.h>
 #include <cpp/base/types.h>
 
@@ -31,10 +33,24 @@ class RTTIInfo {
 public:
   static RTTIInfo TheRTTIInfo;
   void translate_rtti(const char *rttiDir);
-  void loadMetaData(const char *filename);
+
+  /**
+   * The meta data file starts with MetaDataHeader, which changes with its
+   * format. Files without it, or written in another format, are rejected.
+   */
+  static const char *MetaDataHeader;
+  bool loadMetaData(const char *filename);
   bool loadProfData(const char *rttiDir);
   bool exists(const char *funcName);
 
+  /**
+   * The type a parameter was passed as in at least ratio percent of its
+   * profiled calls, with ints and strings of all kinds merged; KindOfVariant
+   * if there was no such type or fewer than minCount calls.
+   */
+  DataType getDominantType(const std::string &paramKey,
+                           unsigned int minCount, int ratio);
+
 public:
   RTTIInfo();
   ~RTTIInfo() { if (m_profData) free(m_profData);}
@@ -47,6 +63,7 @@ private:
   bool m_loaded;
   int m_count;
   std::vector<std::string> m_id2name;
+  std::map<std::string, int> m_name2id;
   std::set<std::string> m_functions;
   RTTICounter *m_profData;
 
@@ -23,6 +23,7 @@
 #include <util/stack_trace.h>
 #include <util/process.h>
 #include <util/file_cache.h>
+#include <util/db_conn.h>
 #include <cpp/base/preg.h>
 #include <cpp/base/server/access_log.h>
 
@@ -67,12 +68,15 @@ int RuntimeOption::ServerThreadCount = 50;
 int RuntimeOption::PageletServerThreadCount = 0;
 int RuntimeOption::RequestTimeoutSeconds = -1;
 int RuntimeOption::RequestMemoryMaxBytes = -1;
+int64 RuntimeOption::RetainedMemoryMaxBytes = -1;
+int RuntimeOption::IdleMemoryTrimSeconds = 0;
 int RuntimeOption::ResponseQueueCount;
 int RuntimeOption::ServerGracefulShutdownWait;
 bool RuntimeOption::ServerHarshShutdown = true;
 bool RuntimeOption::ServerEvilShutdown = true;
 int RuntimeOption::ServerDanglingWait;
 int RuntimeOption::GzipCompressionLevel = 3;
+int RuntimeOption::GzipCompressionThreads = 0;
 bool RuntimeOption::EnableKeepAlive = true;
 bool RuntimeOption::EnableEarlyFlush = true;
 bool RuntimeOption::ForceChunkedEncoding = false;
@@ -107,11 +111,14 @@ std::string RuntimeOption::DefaultDocument;
 std::string RuntimeOption::ErrorDocument404;
 std::string RuntimeOption::FatalErrorMessage;
 std::string RuntimeOption::FontPath;
+std::vector<std::string> RuntimeOption::PreloadTimeZones;
 bool RuntimeOption::EnableStaticContentCache = true;
 bool RuntimeOption::EnableStaticContentFromDisk = true;
 
 std::string RuntimeOption::RTTIDirectory;
 bool RuntimeOption::EnableCliRTTI = false;
+std::string RuntimeOption::CallProfileDirectory;
+bool RuntimeOption::EnableCliCallProfile = false;
 
 std::string RuntimeOption::StartupDocument;
 std::string RuntimeOption::WarmupDocument;
@@ -178,6 +185,7 @@ int64 RuntimeOption::MaxRSS = 0;
 bool RuntimeOption::EnableMemoryManager = false;
 bool RuntimeOption::CheckMemory = false;
 bool RuntimeOption::UseZendArray = true;
+bool RuntimeOption::UseHphpArray = false;
 bool RuntimeOption::EnableApc = true;
 bool RuntimeOption::ApcUseSharedMemory = false;
 int RuntimeOption::ApcSharedMemorySize = 1024; // 1GB
@@ -193,6 +201,10 @@ int RuntimeOption::ApcKeyFrequencyUpdatePeriod = 1000;
 bool RuntimeOption::ApcUseLockedRefs = false;
 bool RuntimeOption::ApcExpireOnSets = false;
 int RuntimeOption::ApcPurgeFrequency = 4096;
+int RuntimeOption::ApcStaleGracePeriod = 0;
+int RuntimeOption::ApcFillLockTimeout = 10;
+int64 RuntimeOption::ApcMaximumMemory = 0;
+bool RuntimeOption::ApcPrefixIndex = false;
 
 bool RuntimeOption::EnableDnsCache = false;
 int RuntimeOption::DnsCacheTTL = 10 * 60; // 10 minutes
@@ -372,6 +384,8 @@ void RuntimeOption::Load(Hdf &config) {
     PageletServerThreadCount = server["PageletServerThreadCount"].getInt32(0);
     RequestTimeoutSeconds = server["RequestTimeoutSeconds"].getInt32(-1);
     RequestMemoryMaxBytes = server["RequestMemoryMaxBytes"].getInt64(-1);
+    RetainedMemoryMaxBytes = server["RetainedMemoryMaxBytes"].getInt64(-1);
+    IdleMemoryTrimSeconds = server["IdleMemoryTrimSeconds"].getInt32(0);
     ResponseQueueCount = server["ResponseQueueCount"].getInt32(0);
     if (ResponseQueueCount <= 0) {
       ResponseQueueCount = ServerThreadCount / 10;
@@ -385,6 +399,7 @@ void RuntimeOption::Load(Hdf &config) {
       ServerGracefulShutdownWait = ServerDanglingWait;
     }
     GzipCompressionLevel = server["GzipCompressionLevel"].getInt16(3);
+    GzipCompressionThreads = server["GzipCompressionThreads"].getInt32(0);
     EnableKeepAlive = server["EnableKeepAlive"].getBool(true);
     EnableEarlyFlush = server["EnableEarlyFlush"].getBool(true);
     ForceChunkedEncoding = server["ForceChunkedEncoding"].getBool();
@@ -425,6 +440,7 @@ void RuntimeOption::Load(Hdf &config) {
     if (!FontPath.empty() && FontPath[FontPath.length() - 1] != '/') {
       FontPath += "/";
     }
+    server["PreloadTimeZones"].get(PreloadTimeZones);
     EnableStaticContentCache =
       server["EnableStaticContentCache"].getBool(true);
     EnableStaticContentFromDisk =
@@ -436,6 +452,12 @@ void RuntimeOption::Load(Hdf &config) {
       RTTIDirectory += "/";
     }
     EnableCliRTTI = server["EnableCliRTTI"].getBool();
+    CallProfileDirectory = server["CallProfileDirectory"].getString("/tmp/");
+    if (!CallProfileDirectory.empty() &&
+        CallProfileDirectory[CallProfileDirectory.length() - 1] != '/') {
+      CallProfileDirectory += "/";
+    }
+    EnableCliCallProfile = server["EnableCliCallProfile"].getBool();
 
     StartupDocument = server["StartupDocument"].getString();
     normalizePath(StartupDocument);
@@ -461,6 +483,7 @@ void RuntimeOption::Load(Hdf &config) {
     EnableMemoryManager = server["EnableMemoryManager"].getBool();
     CheckMemory = server["CheckMemory"].getBool();
     UseZendArray = server["UseZendArray"].getBool(true);
+    UseHphpArray = server["UseHphpArray"].getBool();
 
     Hdf apc = server["APC"];
     EnableApc = apc["EnableApc"].getBool(true);
@@ -494,9 +517,14 @@ void RuntimeOption::Load(Hdf &config) {
     ApcUseLockedRefs = apc["UseLockedRefs"].getBool();
     ApcExpireOnSets = apc["ExpireOnSets"].getBool();
     ApcPurgeFrequency = apc["PurgeFrequency"].getInt32(4096);
+    ApcStaleGracePeriod = apc["StaleGracePeriod"].getInt32(0);
+    ApcFillLockTimeout = apc["FillLockTimeout"].getInt32(10);
 
     ApcKeyMaturityThreshold = apc["KeyMaturityThreshold"].getInt32(20);
     ApcMaximumCapacity = apc["MaximumCapacity"].getInt64(0);
+    ApcMaximumMemory = apc["MaximumMemory"].getInt64(0); // MB
+    // for apc_*_prefix(), MaximumMemory indexes keys as well
+    ApcPrefixIndex = apc["PrefixIndex"].getBool();
     ApcKeyFrequencyUpdatePeriod = apc["KeyFrequencyUpdatePeriod"].
       getInt32(1000);
 
@@ -598,6 +626,14 @@ void RuntimeOption::Load(Hdf &config) {
     MySQLReadTimeout = mysql["ReadTimeout"].getInt32(1000);
     MySQLSlowQueryThreshold = mysql["SlowQueryThreshold"].getInt32(1000);
     MySQLKillOnTimeout = mysql["KillOnTimeout"].getBool();
+
+    // fb_parallel_query() and fb_crossall_query()
+    DBConn::MultiplexParallelQueries =
+      mysql["MultiplexParallelQueries"].getBool();
+    Hdf pool = mysql["ConnectionPool"];
+    DBConnPool::MaxIdlePerServer = pool["MaxIdlePerServer"].getUInt32(0);
+    DBConnPool::MaxIdleSeconds = pool["MaxIdleSeconds"].getUInt32(60);
+    DBConnPool::PingAfterSeconds = pool["PingAfterSeconds"].getUInt32(5);
   }
   {
     Hdf http = config["Http"];
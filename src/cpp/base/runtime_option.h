@@ -66,12 +66,15 @@ public:
   static int PageletServerThreadCount;
   static int RequestTimeoutSeconds;
   static int RequestMemoryMaxBytes;
+  static int64 RetainedMemoryMaxBytes;
+  static int IdleMemoryTrimSeconds;
   static int ResponseQueueCount;
   static int ServerGracefulShutdownWait;
   static int ServerDanglingWait;
   static bool ServerHarshShutdown;
   static bool ServerEvilShutdown;
   static int GzipCompressionLevel;
+  static int GzipCompressionThreads;
   static bool EnableKeepAlive;
   static bool EnableEarlyFlush;
   static bool ForceChunkedEncoding;
@@ -105,11 +108,14 @@ public:
   static std::string ErrorDocument404;
   static std::string FatalErrorMessage;
   static std::string FontPath;
+  static std::vector<std::string> PreloadTimeZones;
   static bool EnableStaticContentCache;
   static bool EnableStaticContentFromDisk;
 
   static std::string RTTIDirectory;
   static bool EnableCliRTTI;
+  static std::string CallProfileDirectory;
+  static bool EnableCliCallProfile;
 
   static std::string StartupDocument;
   static std::string WarmupDocument;
@@ -176,6 +182,7 @@ public:
   static bool EnableMemoryManager;
   static bool CheckMemory;
   static bool UseZendArray;
+  static bool UseHphpArray;
   static bool EnableApc;
   static bool ApcUseSharedMemory;
   static int ApcSharedMemorySize;
@@ -199,6 +206,10 @@ public:
   static bool ApcUseLockedRefs;
   static bool ApcExpireOnSets;
   static int ApcPurgeFrequency;
+  static int ApcStaleGracePeriod;
+  static int ApcFillLockTimeout;
+  static int64 ApcMaximumMemory;
+  static bool ApcPrefixIndex;
 
   static bool EnableDnsCache;
   static int DnsCacheTTL;
@@ -179,7 +179,6 @@ void AccessLog::skipField(const char* &format) {
 
 bool AccessLog::genField(ostringstream &out, const char* &format,
                          Transport *transport, const string &arg) {
-  int responseSize = transport->getResponseSize();
   int code = transport->getResponseCode();
 
   while (!isalpha(*format)) { format++; }
@@ -188,10 +187,10 @@ bool AccessLog::genField(ostringstream &out, const char* &format,
 
   switch (type) {
   case 'b':
-    if (responseSize == 0) return false;
+    if (transport->getResponseSize() == 0) return false;
     // Fall through
   case 'B':
-    out << responseSize;
+    out << transport->getResponseSize();
     break;
   case 'h':
     out << transport->getRemoteHost();
@@ -117,8 +117,10 @@ void AdminRequestHandler::handleRequest(Transport *transport) {
         "/leak-off:        end leak detection and report leaking\n"
         "    cutoff        optional, default 20 seconds, ignore newer allocs\n"
 #endif
+        "/free-mem:        ask idle workers to release free memory to system\n"
+        "/mem-usage:       show retained vs. used bytes of each thread and\n"
+        "                  allocator, as of their last request or trim\n"
 #ifdef GOOGLE_TCMALLOC
-        "/free-mem:        ask tcmalloc to release memory to system\n"
         "/tcmalloc-stats:  get internal tcmalloc stats\n"
 #endif
         ;
@@ -173,10 +175,22 @@ void AdminRequestHandler::handleRequest(Transport *transport) {
         handleLeakRequest(cmd, transport)) {
       break;
     }
-#ifdef GOOGLE_TCMALLOC
     if (cmd == "free-mem") {
+      MemoryManager::TrimAll();
+      if (HttpServer::Server) {
+        HttpServer::Server->getPageServer()->wakeIdleWorkers();
+      }
+#ifdef GOOGLE_TCMALLOC
       MallocExtension::instance()->ReleaseFreeMemory();
+#endif
+      transport->sendString("OK\n");
+      break;
+    }
+    if (cmd == "mem-usage") {
+      transport->sendString(MemoryManager::ReportRetainedMemory());
+      break;
     }
+#ifdef GOOGLE_TCMALLOC
     if (cmd == "tcmalloc-stats") {
       ostringstream stats;
       size_t user_allocated, heap_size, slack_bytes;
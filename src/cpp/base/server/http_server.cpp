@@ -25,6 +25,7 @@
 #include <cpp/base/class_info.h>
 #include <cpp/base/source_info.h>
 #include <cpp/base/rtti_info.h>
+#include <cpp/base/call_profile.h>
 #include <cpp/base/memory/memory_manager.h>
 #include <util/logger.h>
 #include <cpp/base/externals.h>
@@ -99,6 +100,7 @@ HttpServer::HttpServer()
   ClassInfo::Load();
   SourceInfo::TheSourceInfo.load();
   RTTIInfo::TheRTTIInfo.init(true);
+  CallProfile::TheCallProfile.init(true);
 
   hphp_process_init();
   apc_load(RuntimeOption::ApcLoadThread);
@@ -251,6 +253,7 @@ void HttpServer::run() {
 
   m_watchDog.waitForEnd();
   m_loggerThread.waitForEnd();
+  CallProfile::TheCallProfile.flush();
   Logger::Info("all servers stopped");
 }
 
@@ -367,8 +370,13 @@ void HttpServer::watchDog() {
     sleep(1);
     ++count;
 
+    if (RuntimeOption::EnableStats && RuntimeOption::EnableWebStats) {
+      ServerStats::Collect();
+    }
+
     if ((count % 60) == 0) { // every minute
       checkMemory();
+      CallProfile::TheCallProfile.flush();
     }
   }
 }
@@ -19,6 +19,7 @@
 #include <cpp/base/memory/memory_manager.h>
 #include <cpp/base/server/server_stats.h>
 #include <cpp/base/server/http_protocol.h>
+#include <util/lock.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 // static handler
@@ -58,7 +59,8 @@ void LibEventJob::stopTimer() {
     time_t dsec = end.tv_sec - start.tv_sec;
     long dnsec = end.tv_nsec - start.tv_nsec;
     int64 dusec = dsec * 1000000 + dnsec / 1000;
-    ServerStats::Log("page.wall.queuing", dusec);
+    static int s_queuing = ServerStats::RegisterCounter("page.wall.queuing");
+    ServerStats::Log(s_queuing, dusec);
   }
 }
 
@@ -129,6 +131,10 @@ void LibEventWorker::onThreadExit() {
   MemoryManager::TheMemoryManager().get()->cleanup();
 }
 
+void LibEventWorker::onThreadIdle() {
+  MemoryManager::TheMemoryManager().get()->onIdle();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // constructor and destructor
 
@@ -144,6 +150,12 @@ LibEventServer::LibEventServer(const std::string &address, int port,
   m_server = evhttp_new(m_eventBase);
   evhttp_set_gencb(m_server, on_request, this);
   m_responseQueue.create(m_eventBase);
+  m_dispatcher.setIdleTimeout(RuntimeOption::IdleMemoryTrimSeconds);
+
+  // one thread per queue, so chunks of one response stay in order
+  for (int i = 0; i < RuntimeOption::GzipCompressionThreads; i++) {
+    m_compressors.push_back(new CompressionDispatcher(1, this));
+  }
 }
 
 LibEventServer::~LibEventServer() {
@@ -155,6 +167,9 @@ LibEventServer::~LibEventServer() {
   if (getStatus() != STOPPING) {
     event_base_free(m_eventBase);
   }
+  for (unsigned int i = 0; i < m_compressors.size(); i++) {
+    delete m_compressors[i];
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -173,6 +188,9 @@ void LibEventServer::start() {
   }
 
   setStatus(RUNNING);
+  for (unsigned int i = 0; i < m_compressors.size(); i++) {
+    m_compressors[i]->start();
+  }
   m_dispatcher.start();
   m_dispatcherThread.start();
   m_timeoutThread.start();
@@ -235,6 +253,11 @@ void LibEventServer::stop() {
   // stop JobQueue processing
   m_dispatcher.stop();
 
+  // finish compressing all responses before event loop sends them out
+  for (unsigned int i = 0; i < m_compressors.size(); i++) {
+    m_compressors[i]->stop();
+  }
+
   // stop event loop
   setStatus(STOPPED);
   write(m_pipeStop.getIn(), "", 1);
@@ -280,6 +303,64 @@ void LibEventServer::onChunkedResponseEnd(int worker,
   m_responseQueue.enqueue(worker, request);
 }
 
+void LibEventServer::onResponseToCompress(CompressionJobPtr job) {
+  ASSERT(!m_compressors.empty());
+  m_compressors[job->worker % m_compressors.size()]->enqueue(job);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CompressionWorker
+
+void CompressionWorker::doJob(CompressionJobPtr job) {
+  ASSERT(m_opaque);
+  LibEventServer *server = (LibEventServer*)m_opaque;
+
+  int size = job->data.size();
+  int len = size;
+  char *compressed;
+  {
+    ServerStatsHelper ssh("gzip");
+    compressed = job->compressor->compress(job->data.data(), len, job->last);
+  }
+  if (compressed == NULL) {
+    Logger::Error("Unable to compress response: level=%d len=%d",
+                  RuntimeOption::GzipCompressionLevel, size);
+    len = 0;
+  }
+  if (RuntimeOption::EnableStats && RuntimeOption::EnableWebStats) {
+    static int s_gzipIn = ServerStats::RegisterCounter("gzip.uncompressed");
+    static int s_gzipOut = ServerStats::RegisterCounter("gzip.compressed");
+    static int s_network = ServerStats::RegisterCounter("network.compressed");
+    ServerStats::Log(s_gzipIn, size);
+    ServerStats::Log(s_gzipOut, len);
+    ServerStats::Log(s_network, len);
+    // this thread serves no pages, so hits stay with the request threads
+    ServerStats::FlushCounters("gzip");
+  }
+
+  if (job->chunked) {
+    if (len > 0 || job->firstChunk) { // an empty chunk ends the response
+      evbuffer *chunk = evbuffer_new();
+      evbuffer_add(chunk, compressed, len);
+      server->onChunkedResponse(job->worker, job->request, job->code, chunk,
+                                job->firstChunk);
+    }
+    if (job->last) {
+      server->onChunkedResponseEnd(job->worker, job->request);
+    }
+  } else {
+    evbuffer_add(job->request->output_buffer, compressed, len);
+    server->onResponse(job->worker, job->request, job->code);
+  }
+  free(compressed);
+
+  Lock lock(job->progress.get());
+  job->progress->sent += len;
+  if (--job->progress->pending == 0) {
+    job->progress->notifyAll();
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // PendingResponseQueue
 
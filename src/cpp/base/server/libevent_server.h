@@ -63,10 +63,51 @@ public:
   virtual void onThreadEnter();
   virtual void onThreadExit();
 
+  /**
+   * Called when thread has been waiting for a request for a while.
+   */
+  virtual void onThreadIdle();
+
 private:
   RequestHandler *m_handler;
 };
 
+/**
+ * One response, or one chunk of a chunked response, that still needs to be
+ * gzip-ed before it can be sent. Chunks of the same response share one
+ * compressor, and they are always handled by the same compression thread
+ * in the order they were sent.
+ */
+DECLARE_BOOST_TYPES(CompressionJob);
+class CompressionJob {
+public:
+  CompressionJob()
+    : worker(0), request(NULL), code(0), chunked(false), firstChunk(false),
+      last(false) {}
+
+  int worker;
+  evhttp_request *request;
+  int code;
+  std::string data;
+  StreamCompressorPtr compressor;
+  CompressionProgressPtr progress;
+  bool chunked;
+  bool firstChunk;
+  bool last; // flush compressor, and end response if chunked
+};
+
+/**
+ * Compression thread that takes gzip off request threads, when
+ * RuntimeOption::GzipCompressionThreads is set. It passes compressed data
+ * on to LibEventServer as if request thread had sent it.
+ */
+class CompressionWorker : public JobQueueWorker<CompressionJobPtr> {
+public:
+  virtual void doJob(CompressionJobPtr job);
+};
+typedef JobQueueDispatcher<CompressionJobPtr, CompressionWorker>
+  CompressionDispatcher;
+
 /**
  * Helper class for queuing up response sending back to event loop.
  */
@@ -134,6 +175,9 @@ public:
   virtual int getActiveWorker() {
     return m_dispatcher.getActiveWorker();
   }
+  virtual void wakeIdleWorkers() {
+    m_dispatcher.wakeIdleWorkers();
+  }
 
   void onThreadEnter();
 
@@ -150,6 +194,13 @@ public:
                          evbuffer *chunk, bool firstChunk);
   void onChunkedResponseEnd(int worker, evhttp_request *request);
 
+  /**
+   * Called by LibEventTransport when a response needs to be gzip-ed by one
+   * of the compression threads before it is sent.
+   */
+  bool isCompressingAsync() const { return !m_compressors.empty();}
+  void onResponseToCompress(CompressionJobPtr job);
+
 protected:
   virtual int getAcceptSocket();
 
@@ -169,6 +220,7 @@ private:
   AsyncFunc<LibEventServer> m_dispatcherThread;
 
   PendingResponseQueue m_responseQueue;
+  std::vector<CompressionDispatcher *> m_compressors;
 
   // dispatcher thread runs this function
   void dispatch();
@@ -18,6 +18,7 @@
 #include <cpp/base/server/libevent_server.h>
 #include <cpp/base/server/server.h>
 #include <cpp/base/runtime_option.h>
+#include <util/lock.h>
 #include <util/util.h>
 
 namespace HPHP {
@@ -182,7 +183,10 @@ void LibEventTransport::sendImpl(const void *data, int size, int code,
   ASSERT(!m_sendEnded);
   ASSERT(!m_sendStarted || chunked);
 
-  if (chunked) {
+  if (m_asyncCompression) {
+    compressResponse(data, size, code, chunked, !chunked);
+    if (!chunked) m_sendEnded = true;
+  } else if (chunked) {
     evbuffer *chunk = evbuffer_new();
     evbuffer_add(chunk, data, size);
     m_server->onChunkedResponse(m_workerId, m_request, code, chunk,
@@ -197,12 +201,58 @@ void LibEventTransport::sendImpl(const void *data, int size, int code,
 
 void LibEventTransport::onSendEndImpl() {
   if (m_chunkedEncoding) {
-    m_server->onChunkedResponseEnd(m_workerId, m_request);
+    if (m_asyncCompression) {
+      // flushes compressor, then ends the response in the same thread
+      compressResponse("", 0, m_responseCode, true, true);
+    } else {
+      m_server->onChunkedResponseEnd(m_workerId, m_request);
+    }
     m_sendEnded = true;
   } else {
     ASSERT(m_sendEnded); // otherwise, we didn't call send for this request
   }
 }
 
+bool LibEventTransport::supportsAsyncCompression() {
+  return m_server->isCompressingAsync();
+}
+
+void LibEventTransport::compressResponse(const void *data, int size,
+                                         int code, bool chunked, bool last) {
+  if (!m_asyncCompressor) {
+    m_asyncCompressor = StreamCompressorPtr
+      (new StreamCompressor(RuntimeOption::GzipCompressionLevel,
+                            CODING_GZIP, true));
+    m_compressionProgress = CompressionProgressPtr(new CompressionProgress());
+  }
+  {
+    Lock lock(m_compressionProgress.get());
+    m_compressionProgress->pending++;
+  }
+
+  CompressionJobPtr job(new CompressionJob());
+  job->worker = m_workerId;
+  job->request = m_request;
+  job->code = code;
+  job->data.assign((const char *)data, size);
+  job->compressor = m_asyncCompressor;
+  job->progress = m_compressionProgress;
+  job->chunked = chunked;
+  job->firstChunk = chunked && !m_sendStarted;
+  job->last = last;
+  m_server->onResponseToCompress(job);
+}
+
+int LibEventTransport::getResponseSize() const {
+  if (!m_compressionProgress) {
+    return Transport::getResponseSize();
+  }
+  Lock lock(m_compressionProgress.get());
+  while (m_compressionProgress->pending > 0) {
+    m_compressionProgress->wait();
+  }
+  return m_compressionProgress->sent;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 }
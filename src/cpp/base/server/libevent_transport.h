@@ -18,11 +18,26 @@
 #define __HTTP_SERVER_LIB_EVENT_TRANSPORT_H__
 
 #include <cpp/base/server/transport.h>
+#include <util/synchronizable.h>
 #include <evhttp.h>
 
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
+/**
+ * How far compression threads are with one response: how many of its
+ * compression jobs are still queued, and how many bytes they have handed
+ * to the event loop so far.
+ */
+DECLARE_BOOST_TYPES(CompressionProgress);
+class CompressionProgress : public Synchronizable {
+public:
+  CompressionProgress() : pending(0), sent(0) {}
+
+  int pending;
+  int sent;
+};
+
 class LibEventServer;
 class LibEventTransport : public Transport {
 public:
@@ -47,6 +62,13 @@ public:
   virtual void sendImpl(const void *data, int size, int code, bool chunked);
   virtual void onSendEndImpl();
   virtual bool isServerStopping();
+  virtual bool supportsAsyncCompression();
+
+  /**
+   * With async compression, this waits for the response to be compressed,
+   * so the access log gets the bytes actually sent.
+   */
+  virtual int getResponseSize() const;
 
 private:
   LibEventServer *m_server;
@@ -60,6 +82,11 @@ private:
   HeaderMap m_requestHeaders;
   bool m_sendStarted;
   bool m_sendEnded;
+  StreamCompressorPtr m_asyncCompressor;
+  CompressionProgressPtr m_compressionProgress;
+
+  void compressResponse(const void *data, int size, int code, bool chunked,
+                        bool last);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
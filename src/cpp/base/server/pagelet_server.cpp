@@ -33,7 +33,8 @@ class PageletTransport : public Transport, public Synchronizable {
 public:
   PageletTransport(CStrRef url, CArrRef headers, CStrRef postData,
                    CStrRef remoteHost)
-    : m_refCount(0), m_done(false), m_code(0) {
+    : m_refCount(0), m_done(false), m_flushed(false), m_code(0),
+      m_event(NULL) {
     m_url.append(url.data(), url.size());
     m_remoteHost.append(remoteHost.data(), remoteHost.size());
 
@@ -96,17 +97,23 @@ public:
     m_responseHeaders.erase(name);
   }
   virtual void sendImpl(const void *data, int size, int code,
-                        bool compressed) {
-    ASSERT(!compressed);
+                        bool chunked) {
+    Lock lock(this);
     m_response.append((const char*)data, size);
     if (code) {
       m_code = code;
     }
+    if (chunked && size) {
+      // flush() from the pagelet
+      m_flushed = true;
+      notifyEvent();
+    }
   }
   virtual void onSendEndImpl() {
     Lock lock(this);
     m_done = true;
     notify();
+    notifyEvent();
   }
 
   // task interface
@@ -114,6 +121,31 @@ public:
     return m_done;
   }
 
+  /**
+   * Whether a wait on this task would return now. Only called by the task's
+   * owner, which is the only one clearing m_flushed.
+   */
+  bool isReady(bool flushed) {
+    return m_done || (flushed && m_flushed);
+  }
+
+  /**
+   * Have m_event notified of what isReady() looks at, or stop that with
+   * NULL.
+   */
+  void setEvent(Synchronizable *event) {
+    Lock lock(this);
+    m_event = event;
+  }
+
+  String getFlushed() {
+    Lock lock(this);
+    String response(m_response.c_str(), m_response.size(), CopyString);
+    m_response.clear();
+    m_flushed = false;
+    return response;
+  }
+
   String getResults(Array &headers, int &code) {
     {
       Lock lock(this);
@@ -162,9 +194,20 @@ private:
   string m_remoteHost;
 
   bool m_done;
+  bool m_flushed; // m_response has flush()ed output not yet read
   HeaderMap m_responseHeaders;
-  string m_response;
+  string m_response; // minus whatever getFlushed() has taken
   int m_code;
+
+  Synchronizable *m_event; // somebody waiting on more than this task
+
+  // called with our own lock held, so m_event can't go away meanwhile
+  void notifyEvent() {
+    if (m_event) {
+      Lock lock(m_event);
+      m_event->notify();
+    }
+  }
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -251,5 +294,73 @@ String PageletServer::TaskResult(CObjRef task, Array &headers, int &code) {
   return ptask->getJob()->getResults(headers, code);
 }
 
+String PageletServer::TaskFlushed(CObjRef task) {
+  PageletTask *ptask = task.getTyped<PageletTask>();
+  return ptask->getJob()->getFlushed();
+}
+
+Variant PageletServer::TaskWaitAny(CArrRef tasks, int64 timeout_ms,
+                                   bool flushed) {
+  vector<pair<Variant, PageletTransport*> > jobs;
+  for (ArrayIter iter(tasks); iter; ++iter) {
+    CVarRef task = iter.secondRef();
+    if (task.isObject()) {
+      PageletTask *ptask =
+        task.toObject().getTyped<PageletTask>(true, true);
+      if (ptask) {
+        jobs.push_back(make_pair(iter.first(), ptask->getJob()));
+        continue;
+      }
+    }
+    Logger::Warning("pagelet_server_task_wait_any() ignoring a non-task");
+  }
+
+  struct timeval deadline;
+  if (timeout_ms > 0) {
+    gettimeofday(&deadline, NULL);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_usec += (timeout_ms % 1000) * 1000;
+    if (deadline.tv_usec >= 1000000) {
+      deadline.tv_sec++;
+      deadline.tv_usec -= 1000000;
+    }
+  }
+
+  Synchronizable event;
+  for (unsigned int i = 0; i < jobs.size(); i++) {
+    jobs[i].second->setEvent(&event);
+  }
+  Variant ret = false;
+  {
+    Lock lock(&event);
+    while (true) {
+      unsigned int i = 0;
+      for (; i < jobs.size(); i++) {
+        if (jobs[i].second->isReady(flushed)) break;
+      }
+      if (i < jobs.size()) {
+        ret = jobs[i].first;
+        break;
+      }
+      if (jobs.empty()) break;
+
+      if (timeout_ms > 0) {
+        struct timeval now;
+        gettimeofday(&now, NULL);
+        long long usecs = (deadline.tv_sec - now.tv_sec) * 1000000LL +
+          (deadline.tv_usec - now.tv_usec);
+        if (usecs <= 0) break;
+        event.wait(usecs / 1000000, (usecs % 1000000) * 1000);
+      } else {
+        event.wait();
+      }
+    }
+  }
+  for (unsigned int i = 0; i < jobs.size(); i++) {
+    jobs[i].second->setEvent(NULL);
+  }
+  return ret;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 }
@@ -42,10 +42,24 @@ public:
   static bool TaskStatus(CObjRef task);
 
   /**
-   * Get results of a task. This is blocking until task is finished.
-   *
+   * Get results of a task. This is blocking until task is finished. Output
+   * already taken by TaskFlushed() is not returned again.
    */
   static String TaskResult(CObjRef task, Array &headers, int &code);
+
+  /**
+   * Output the task has sent so far, by flush() or by finishing, that has
+   * not been taken yet. Non-blocking, so a page can send out its pagelets'
+   * output as it comes.
+   */
+  static String TaskFlushed(CObjRef task);
+
+  /**
+   * Blocks until one of the tasks is finished, or, with "flushed", has
+   * output for TaskFlushed(), and returns its key in "tasks". Returns false
+   * once timeout_ms has passed, if it's positive.
+   */
+  static Variant TaskWaitAny(CArrRef tasks, int64 timeout_ms, bool flushed);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
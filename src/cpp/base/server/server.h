@@ -155,6 +155,12 @@ public:
    */
   virtual int getActiveWorker() = 0;
 
+  /**
+   * Have worker threads that are waiting for requests run their idle time
+   * housekeeping, like returning free memory, right away.
+   */
+  virtual void wakeIdleWorkers() {}
+
   /**
    * This is for TypedServer to specialize a worker class to use.
    */
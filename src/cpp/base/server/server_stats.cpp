@@ -19,6 +19,7 @@
 #include <cpp/base/runtime_option.h>
 #include <cpp/base/memory/memory_manager.h>
 #include <util/json.h>
+#include <util/logger.h>
 #include <cpp/base/preg.h>
 #include <time.h>
 #include <cpp/base/comparisons.h>
@@ -475,6 +476,9 @@ private:
 Mutex ServerStats::s_lock;
 vector<ServerStats*> ServerStats::s_loggers;
 ThreadLocal<ServerStats> ServerStats::s_logger;
+hphp_string_map<int> ServerStats::s_counterIds;
+vector<SharedString> ServerStats::s_counterNames;
+volatile int ServerStats::s_counterCount = 0;
 
 void ServerStats::LogPage(const string &url, int code) {
   if (RuntimeOption::EnableStats && RuntimeOption::EnableWebStats) {
@@ -488,6 +492,45 @@ void ServerStats::Log(const string &name, int64 value) {
   }
 }
 
+int ServerStats::RegisterCounter(const string &name) {
+  Lock lock(s_lock, false);
+  hphp_string_map<int>::const_iterator iter = s_counterIds.find(name);
+  if (iter != s_counterIds.end()) {
+    return iter->second;
+  }
+  if (s_counterCount >= MaxCounters) {
+    Logger::Error("Too many server stats counters, not registering %s",
+                  name.c_str());
+    return -1;
+  }
+  int counter = s_counterCount;
+  s_counterIds[name] = counter;
+  s_counterNames.push_back(SharedString(name));
+  s_counterCount = counter + 1;
+  return counter;
+}
+
+void ServerStats::Log(int counter, int64 value) {
+  if (RuntimeOption::EnableStats && RuntimeOption::EnableWebStats &&
+      counter >= 0) {
+    ASSERT(counter < s_counterCount);
+    ServerStats::s_logger->log(counter, value);
+  }
+}
+
+void ServerStats::FlushCounters(const string &url) {
+  if (RuntimeOption::EnableStats && RuntimeOption::EnableWebStats) {
+    ServerStats::s_logger->pushPage(url, 0, 0);
+  }
+}
+
+void ServerStats::Collect() {
+  Lock lock(s_lock, false);
+  for (unsigned int i = 0; i < s_loggers.size(); i++) {
+    s_loggers[i]->drain();
+  }
+}
+
 void ServerStats::LogBytes(int64 bytes) {
   if (RuntimeOption::EnableStats && RuntimeOption::EnableWebStats) {
     ServerStats::s_logger->logBytes(bytes);
@@ -512,6 +555,7 @@ int64 ServerStats::Get(const string &name) {
 void ServerStats::Clear() {
   Lock lock(s_lock, false);
   for (unsigned int i = 0; i < s_loggers.size(); i++) {
+    s_loggers[i]->drain();
     s_loggers[i]->clear();
   }
 }
@@ -528,6 +572,7 @@ void ServerStats::CollectSlots(list<TimeSlot*> &slots, int64 from, int64 to) {
 
   Lock lock(s_lock, false);
   for (unsigned int i = 0; i < s_loggers.size(); i++) {
+    s_loggers[i]->drain();
     s_loggers[i]->collect(slots, tp1, tp2);
   }
 }
@@ -722,8 +767,10 @@ void ServerStats::ReportStatus(std::string &output, Format format) {
   w->writeFooter("process");
 
   w->writeHeader("threads");
+  ServerStats *retired = Retired();
   Lock lock(s_lock, false);
   for (unsigned int i = 0; i < s_loggers.size(); i++) {
+    if (s_loggers[i] == retired) continue;
     ThreadStatus &ts = s_loggers[i]->m_threadStatus;
 
     int64 duration = 0;
@@ -771,8 +818,10 @@ ServerStats::ThreadStatus::ThreadStatus()
   memset(m_vhost, 0, sizeof(m_vhost));
 }
 
-ServerStats::ServerStats() : m_last(0), m_min(0), m_max(0) {
+ServerStats::ServerStats()
+  : m_last(0), m_min(0), m_max(0), m_pending(NULL) {
   m_slots.resize(RuntimeOption::StatsMaxSlot);
+  memset(m_counters, 0, sizeof(m_counters));
   clear();
 
   Lock lock(s_lock, false);
@@ -780,50 +829,158 @@ ServerStats::ServerStats() : m_last(0), m_min(0), m_max(0) {
 }
 
 ServerStats::~ServerStats() {
+  ServerStats *retired = Retired();
+  {
+    Lock lock(s_lock, false);
+    for (unsigned int i = 0; i < s_loggers.size(); i++) {
+      if (s_loggers[i] == this) {
+        s_loggers.erase(s_loggers.begin() + i);
+        break;
+      }
+    }
+    // pages of an exiting thread still belong in reports: slot them the
+    // way Collect() does, and hand the slots over to the retired stats
+    drain();
+    retired->merge(*this);
+  }
   clear();
 }
 
+ServerStats *ServerStats::Retired() {
+  // never deleted, threads may still exit after static destructors ran
+  static ServerStats *s_retired = new ServerStats();
+  return s_retired;
+}
+
+void ServerStats::merge(ServerStats &src) {
+  Lock lock(m_lock, false);
+  Lock srcLock(src.m_lock, false);
+  for (unsigned int i = 0; i < src.m_slots.size(); i++) {
+    const TimeSlot &from = src.m_slots[i];
+    int64 now = from.m_time;
+    if (now == 0) continue;
+
+    TimeSlot &ts = m_slots[now % RuntimeOption::StatsMaxSlot];
+    if (ts.m_time > now) continue; // already rotated past it
+    if (ts.m_time != now) {
+      ts.m_time = now;
+      ts.m_pages.clear();
+    }
+    Merge(ts.m_pages, from.m_pages);
+
+    // collect() only takes slots whose time matches exactly, so these are
+    // just bounds
+    if (m_min == 0 || m_min > now) {
+      m_min = now;
+    }
+    if (m_max < now) {
+      m_max = now;
+    }
+  }
+}
+
 void ServerStats::log(const string &name, int64 value) {
   m_values[name] += value;
 }
 
 int64 ServerStats::get(const std::string &name) {
+  int64 ret = 0;
   CounterMap::const_iterator iter = m_values.find(name);
   if (iter != m_values.end()) {
-    return iter->second;
+    ret = iter->second;
+  }
+  Lock lock(s_lock, false);
+  hphp_string_map<int>::const_iterator citer = s_counterIds.find(name);
+  if (citer != s_counterIds.end()) {
+    ret += m_counters[citer->second];
   }
-  return 0;
+  return ret;
 }
 
 void ServerStats::logPage(const string &url, int code) {
-  int64 now = time(NULL) / RuntimeOption::StatsSlotDuration;
+  pushPage(url, code, 1);
+  m_threadStatus.m_mode = Idling;
+  m_threadStatus.m_done = time(0);
+}
+
+void ServerStats::pushPage(const string &url, int code, int hit) {
+  PageRecord *page = new PageRecord();
+  page->m_time = time(NULL) / RuntimeOption::StatsSlotDuration;
+  page->m_url = url;
+  page->m_code = code;
+  page->m_hit = hit;
+  page->m_values.swap(m_values);
+  int count = s_counterCount;
+  for (int i = 0; i < count; i++) {
+    if (m_counters[i]) {
+      page->m_counters.push_back(pair<int, int64>(i, m_counters[i]));
+      m_counters[i] = 0;
+    }
+  }
+  if (!hit && page->m_values.empty() && page->m_counters.empty()) {
+    delete page;
+    return;
+  }
+
+  PageRecord *head;
+  do {
+    head = m_pending;
+    page->m_next = head;
+  } while (!__sync_bool_compare_and_swap(&m_pending, head, page));
+}
+
+void ServerStats::drain() {
+  // caller holds s_lock, so s_counterNames is stable
+  PageRecord *pages = __sync_lock_test_and_set(&m_pending, (PageRecord*)NULL);
+  if (pages == NULL) return;
+
+  // the list is newest first, and slots have to be filled in time order
+  PageRecord *ordered = NULL;
+  while (pages) {
+    PageRecord *next = pages->m_next;
+    pages->m_next = ordered;
+    ordered = pages;
+    pages = next;
+  }
+
+  Lock lock(m_lock, false);
+  while (ordered) {
+    PageRecord *next = ordered->m_next;
+    addPage(*ordered);
+    delete ordered;
+    ordered = next;
+  }
+}
+
+void ServerStats::addPage(const PageRecord &page) {
+  int64 now = page.m_time;
   int slot = now % RuntimeOption::StatsMaxSlot;
 
-  {
-    Lock lock(m_lock, false);
-    int count = 0;
-    for (int64 t = m_last + 1; t < now; t++) {
-      m_slots[t % RuntimeOption::StatsMaxSlot].m_time = 0;
-      if (++count > RuntimeOption::StatsMaxSlot) {
-        break; // we have cleared all slots, good enough
-      }
+  int count = 0;
+  for (int64 t = m_last + 1; t < now; t++) {
+    m_slots[t % RuntimeOption::StatsMaxSlot].m_time = 0;
+    if (++count > RuntimeOption::StatsMaxSlot) {
+      break; // we have cleared all slots, good enough
     }
-    TimeSlot &ts = m_slots[slot];
-    if (ts.m_time != now) {
-      if (ts.m_time && m_min <= ts.m_time) {
-        m_min = ts.m_time + 1;
-      }
-      ts.m_time = now;
-      ts.m_pages.clear();
+  }
+  TimeSlot &ts = m_slots[slot];
+  if (ts.m_time != now) {
+    if (ts.m_time && m_min <= ts.m_time) {
+      m_min = ts.m_time + 1;
     }
-    PageStats &ps = ts.m_pages[url + lexical_cast<string>(code)];
-    ps.m_url = url;
-    ps.m_code = code;
-    ps.m_hit++;
-    Merge(ps.m_values, m_values);
+    ts.m_time = now;
+    ts.m_pages.clear();
+  }
+  PageStats &ps = ts.m_pages[page.m_url + lexical_cast<string>(page.m_code)];
+  ps.m_url = page.m_url;
+  ps.m_code = page.m_code;
+  ps.m_hit += page.m_hit;
+  Merge(ps.m_values, page.m_values);
+  for (unsigned int i = 0; i < page.m_counters.size(); i++) {
+    const pair<int, int64> &counter = page.m_counters[i];
+    ps.m_values[s_counterNames[counter.first]] += counter.second;
   }
 
-  m_values.clear();
   m_last = now;
   if (m_min == 0) {
     m_min = now;
@@ -831,9 +988,6 @@ void ServerStats::logPage(const string &url, int code) {
   if (m_max < now) {
     m_max = now;
   }
-
-  m_threadStatus.m_mode = Idling;
-  m_threadStatus.m_done = time(0);
 }
 
 void ServerStats::clear() {
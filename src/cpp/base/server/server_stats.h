@@ -45,6 +45,30 @@ public:
   static int64 Get(const std::string &name);
   static void LogPage(const std::string &url, int code);
   static void Clear();
+
+  /**
+   * Counters logged on hot paths are registered once, usually into a static,
+   * and logged by the returned handle: that's one add into a per-thread
+   * array, without hashing the name or taking any lock. The same name always
+   * gets the same handle. Returns -1 when there is no room for more, and
+   * logging -1 is a no-op.
+   */
+  static int RegisterCounter(const std::string &name);
+  static void Log(int counter, int64 value);
+
+  /**
+   * For threads that never finish a page, like background workers: hands
+   * what they have logged so far to Collect(), under "url", without
+   * counting a hit. Does nothing when nothing was logged.
+   */
+  static void FlushCounters(const std::string &url);
+
+  /**
+   * Moves pages every thread has logged into their time slots. Reports do
+   * this first anyway; the server calls it every second in the background,
+   * so the pending lists stay short.
+   */
+  static void Collect();
   static void GetKeys(std::string &out, int64 from, int64 to);
   static void Report(std::string &out, Format format, int64 from, int64 to,
                      const std::string &agg, const std::string &keys,
@@ -71,10 +95,21 @@ private:
     PRECISION = 1000,
   };
 
+  enum {
+    MaxCounters = 256,
+    CacheLineSize = 64,
+  };
+
   static Mutex s_lock;
   static std::vector<ServerStats*> s_loggers;
   static ThreadLocal<ServerStats> s_logger;
 
+  // registered counters, guarded by s_lock, except that s_counterCount
+  // only grows and may be read without it
+  static hphp_string_map<int> s_counterIds;
+  static std::vector<SharedString> s_counterNames;
+  static volatile int s_counterCount;
+
   typedef hphp_shared_string_map<int64> CounterMap;
 
   struct PageStats {
@@ -89,6 +124,19 @@ private:
     PageStatsMap m_pages;
   };
 
+  /**
+   * One finished page, waiting for Collect() to put it into its time slot.
+   */
+  struct PageRecord {
+    PageRecord *m_next;
+    int64 m_time;
+    std::string m_url;
+    int m_code;
+    int m_hit; // 0 for flushed counters
+    CounterMap m_values;
+    std::vector<std::pair<int, int64> > m_counters; // non-zero handles
+  };
+
   static void Merge(CounterMap &dest,
                     const CounterMap &src);
   static void Merge(PageStatsMap &dest, const PageStatsMap &src);
@@ -101,6 +149,12 @@ private:
                         std::map<std::string, int> &wantedKeys);
 
   static void CollectSlots(std::list<TimeSlot*> &slots, int64 from, int64 to);
+
+  /**
+   * Where the slots of exited threads end up. It is one of s_loggers, so
+   * reports include it, but it is not a thread of its own.
+   */
+  static ServerStats *Retired();
   static void FreeSlots(std::list<TimeSlot*> &slots);
 
   static void GetAllKeys(std::set<std::string> &allKeys,
@@ -116,11 +170,26 @@ private:
   int64 m_max;  // latest timepoint
   CounterMap m_values;  // current page's name value pairs
 
+  // current page's registered counters, only ever touched by this thread,
+  // and padded so no other thread's data shares their cache lines
+  char m_pad0[CacheLineSize];
+  int64 m_counters[MaxCounters];
+  char m_pad1[CacheLineSize];
+
+  // finished pages, newest first, pushed by this thread without locking and
+  // taken all at once by Collect()
+  PageRecord * volatile m_pending;
+
   void log(const std::string &name, int64 value);
+  void log(int counter, int64 value) { m_counters[counter] += value;}
   int64 get(const std::string &name);
   void logPage(const std::string &url, int code);
+  void pushPage(const std::string &url, int code, int hit);
+  void drain();
+  void addPage(const PageRecord &page);
   void clear();
   void collect(std::list<TimeSlot*> &slots, int64 from, int64 to);
+  void merge(ServerStats &src);
 
   /**
    * Live status, instead of historical statistics.
@@ -36,7 +36,7 @@ Transport::Transport()
   : m_url(NULL), m_postData(NULL), m_postDataParsed(false),
     m_chunkedEncoding(false), m_headerSent(false),
     m_responseCode(-1), m_responseSize(0), m_sendContentType(true),
-    m_compression(true), m_compressor(NULL) {
+    m_compression(true), m_compressor(NULL), m_asyncCompression(false) {
 }
 
 Transport::~Transport() {
@@ -376,6 +376,9 @@ bool Transport::setCookie(CStrRef name, CStrRef value, int expire /* = 0 */,
   if (!value.empty() && encode_url) {
     int encoded_value_len = value.size();
     encoded_value = url_encode(value.data(), encoded_value_len);
+    if (!encoded_value) {
+      encoded_value = strdup(value.data());
+    }
     len += encoded_value_len;
   } else if (!value.empty()) {
     encoded_value = strdup(value.data());
@@ -474,6 +477,10 @@ String Transport::prepareResponse(const void *data, int size, bool &compressed,
   // we don't use chunk encoding to send anything pre-compressed
   ASSERT(!compressed || !m_chunkedEncoding);
 
+  if (m_asyncCompression) {
+    compressed = true;
+    return response;
+  }
   if (compressed || !isCompressionEnabled() || !acceptEncoding("gzip")) {
     return response;
   }
@@ -482,14 +489,33 @@ String Transport::prepareResponse(const void *data, int size, bool &compressed,
   // Ethernet packet (1500 bytes), unless we are doing chunked encoding,
   // where we don't really know if next chunk will benefit from compresseion.
   if (m_chunkedEncoding || size > 1000) {
+    if (supportsAsyncCompression()) {
+      // we can't fall back to uncompressed data when it doesn't get any
+      // smaller, as headers are sent before it is compressed
+      m_asyncCompression = true;
+      compressed = true;
+      return response;
+    }
+
     if (m_compressor == NULL) {
       m_compressor = new StreamCompressor(RuntimeOption::GzipCompressionLevel,
                                          CODING_GZIP, true);
     }
     int len = size;
-    char *compressedData = m_compressor->compress((const char*)data, len, last);
+    char *compressedData;
+    {
+      ServerStatsHelper ssh("gzip");
+      compressedData = m_compressor->compress((const char*)data, len, last);
+    }
     if (compressedData) {
       String deleter(compressedData, len, AttachString);
+      if (RuntimeOption::EnableStats && RuntimeOption::EnableWebStats) {
+        static int s_gzipIn =
+          ServerStats::RegisterCounter("gzip.uncompressed");
+        static int s_gzipOut = ServerStats::RegisterCounter("gzip.compressed");
+        ServerStats::Log(s_gzipIn, size);
+        ServerStats::Log(s_gzipOut, len);
+      }
       if (m_chunkedEncoding || len < size) {
         response = deleter;
         compressed = true;
@@ -546,8 +572,14 @@ void Transport::sendRaw(void *data, int size, int code /* = 200 */,
 
   ServerStats::LogBytes(size);
   if (RuntimeOption::EnableStats && RuntimeOption::EnableWebStats) {
-    ServerStats::Log("network.uncompressed", size);
-    ServerStats::Log("network.compressed", response.size());
+    static int s_networkIn =
+      ServerStats::RegisterCounter("network.uncompressed");
+    static int s_networkOut =
+      ServerStats::RegisterCounter("network.compressed");
+    ServerStats::Log(s_networkIn, size);
+    if (!m_asyncCompression) { // otherwise logged by whoever compresses it
+      ServerStats::Log(s_networkOut, response.size());
+    }
   }
 }
 
@@ -173,6 +173,14 @@ public:
    */
   virtual bool isServerStopping() { return false;}
 
+  /**
+   * Whether sendImpl() can take uncompressed data of a gzip-ed response, and
+   * have it compressed later, off the request thread. When this returns
+   * true, prepareResponse() only decides on compression and sets
+   * m_asyncCompression, leaving all compression to sendImpl().
+   */
+  virtual bool supportsAsyncCompression() { return false;}
+
   ///////////////////////////////////////////////////////////////////////////
   // Pre-implemented utitlity functions.
 
@@ -257,7 +265,7 @@ public:
   bool isUploadedFile(CStrRef filename);
   bool moveUploadedFile(CStrRef filename, CStrRef destination);
 
-  int getResponseSize() const { return m_responseSize; }
+  virtual int getResponseSize() const { return m_responseSize; }
   int getResponseCode() const { return m_responseCode; }
 
 protected:
@@ -290,6 +298,7 @@ protected:
   bool m_sendContentType;
   bool m_compression;
   StreamCompressor *m_compressor;
+  bool m_asyncCompression;
 
   // helpers
   void parseGetParams();
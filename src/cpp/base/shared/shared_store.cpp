@@ -24,6 +24,7 @@
 #include <cpp/base/memory/leak_detectable.h>
 #include <cpp/base/server/server_stats.h>
 #include <util/lfu_table.h>
+#include <util/timer.h>
 #include <tbb/concurrent_hash_map.h>
 #include <queue>
 
@@ -42,7 +43,8 @@ class LockedSharedStore : public SharedStore {
 public:
   LockedSharedStore(int i) : SharedStore(i) {}
   virtual void clear();
-  virtual bool get(CStrRef key, Variant &value);
+  virtual bool getImpl(CStrRef key, Variant &value, int64 lockTimeout,
+                       bool &locked);
   virtual bool store(CStrRef key, CVarRef val, int64 ttl);
   virtual int64 inc(CStrRef key, int64 step, bool &found);
   virtual bool cas(CStrRef key, int64 old, int64 val);
@@ -57,7 +59,11 @@ protected:
   virtual void unlockMap() = 0;
   virtual void readUnlockMap() = 0;
   virtual void clearImpl() = 0;
+  virtual bool checkAccessed(CStrRef key);
 
+  virtual int64 staleGrace() const {
+    return RuntimeOption::ApcStaleGracePeriod;
+  }
 };
 
 
@@ -86,7 +92,10 @@ public:
       find_or_construct<ProcessSharedVariantLock>(valLocksName.c_str())
       [s_lockCount]();
     m_vars = SharedMemory<SharedMap>::OpenOrCreate(mapName.c_str());
+    // other processes store keys too, but the map itself is ordered
+    m_indexed = false;
   }
+  virtual bool canFindPrefix() const { return true;}
   virtual bool find(CStrRef key, StoreValue *&val, bool &expired) {
     ASSERT(expired == false);
     SharedMap::iterator iter =
@@ -105,6 +114,28 @@ public:
   virtual void set(CStrRef key, SharedVariant* v, int64 ttl) {
     (*m_vars)[SharedMemoryString(key.data(), key.size())].set(putVar(v), ttl);
   }
+  virtual int64 staleGrace() const {
+    // fill locks are per process, so other processes would never refresh
+    return 0;
+  }
+  virtual void findPrefix(CStrRef prefix, int limit,
+                          std::vector<PrefixMatch> &matches) {
+    readLockMap();
+    for (SharedMap::const_iterator iter =
+           m_vars->lower_bound(SharedMemoryString(prefix.data(),
+                                                  prefix.size()));
+         iter != m_vars->end() && iter->first.size() >= (size_t)prefix.size()
+           && memcmp(iter->first.data(), prefix.data(), prefix.size()) == 0;
+         ++iter) {
+      if (limit && (int)matches.size() >= limit) break;
+      PrefixMatch m;
+      m.key.assign(iter->first.data(), iter->first.size());
+      m.bytes = getVar(iter->second.var)->getSpaceUsage();
+      m.gen = 0;
+      matches.push_back(m);
+    }
+    readUnlockMap();
+  }
   virtual SharedVariant* construct(CStrRef key, CVarRef v) {
     ProcessSharedVariantLock* lock = getLock(key);
     return SharedMemoryManager::GetSegment()->construct<ProcessSharedVariant>
@@ -293,7 +324,7 @@ public:
 
     ASSERT(m_vars.find(key.get()) == m_vars.end());
     StoreValue &val = m_vars[key.get()->copy(true)];
-    val.set(v, ttl);
+    val.set(v, ttl, staleGrace());
   }
 
 
@@ -350,6 +381,18 @@ public:
     }
     unlockMap();
   }
+  virtual void scanKeys(std::vector<PrefixMatch> &matches) {
+    readLockMap();
+    for (StringMap::const_iterator iter = m_vars.begin();
+         iter != m_vars.end(); ++iter) {
+      PrefixMatch m;
+      m.key.assign(iter->first->data(), iter->first->size());
+      m.bytes = iter->second.var->getSpaceUsage();
+      m.gen = 0;
+      matches.push_back(m);
+    }
+    readUnlockMap();
+  }
   virtual void lockMap() {
     m_mlock.acquireWrite();
   }
@@ -445,7 +488,7 @@ class LfuTableSharedStore : public SharedStore,
                             private ThreadSharedVariantFactory {
 public:
   LfuTableSharedStore(int id, time_t maturity, size_t maxCap, int updatePeriod)
-    : SharedStore(id), m_vars(maturity, maxCap, updatePeriod) {
+    : SharedStore(id), m_vars(this, maturity, maxCap, updatePeriod) {
   }
 
   void set(CStrRef key, SharedVariant* v, int64 ttl, bool immortal = false) {
@@ -467,31 +510,51 @@ public:
   }
   virtual void clear() {
     m_vars.clear();
+    clearIndex();
   }
   virtual bool eraseImpl(CStrRef key, bool expired) {
     class EraseUpdater : public Map::AtomicUpdater {
     public:
-      EraseUpdater(bool exp) : res(false), expired(exp) {}
+      EraseUpdater(bool exp, LfuTableSharedStore *s)
+        : res(false), expired(exp), store(s) {}
       bool update(StringData* const &k, StoreValue &val, bool newlyCreated) {
         if (expired && !val.expired()) {
           return false;
         }
         res = true;
+        store->unindexKey(k->data(), k->size());
         return true;
       }
       bool res;
     private:
       bool expired;
+      LfuTableSharedStore *store;
     };
 
     if (key.isNull()) return false;
-    EraseUpdater updater(expired);
+    EraseUpdater updater(expired, this);
     m_vars.atomicUpdate(key.get(), updater, false);
     return updater.res;
   }
 
   void prime(const std::vector<SharedStore::KeyValuePair> &vars);
 
+  virtual bool checkAccessed(CStrRef key) {
+    class AccessReader : public Map::AtomicReader {
+    public:
+      AccessReader() : accessed(false) {}
+      void read(StringData* const &k, const StoreValue &val) {
+        accessed = val.accessed;
+        val.accessed = false;
+      }
+      bool accessed;
+    };
+    if (key.isNull()) return false;
+    AccessReader reader;
+    m_vars.atomicPeek(key.get(), reader);
+    return reader.accessed;
+  }
+
   virtual int size() {
     return m_vars.size();
   }
@@ -519,8 +582,26 @@ public:
     CountBody body(reachable, expired, persistent);
     m_vars.atomicForeach(body);
   }
+  virtual void scanKeys(std::vector<PrefixMatch> &matches) {
+    class ScanBody : public Map::AtomicReader {
+    public:
+      ScanBody(std::vector<PrefixMatch> &m) : matches(m) {}
+      void read(StringData* const &k, const StoreValue &val) {
+        PrefixMatch m;
+        m.key.assign(k->data(), k->size());
+        m.bytes = val.var->getSpaceUsage();
+        m.gen = 0;
+        matches.push_back(m);
+      }
+    private:
+      std::vector<PrefixMatch> &matches;
+    };
+    ScanBody body(matches);
+    m_vars.atomicForeach(body);
+  }
 
-  virtual bool get(CStrRef key, Variant &value);
+  virtual bool getImpl(CStrRef key, Variant &value, int64 lockTimeout,
+                       bool &locked);
   virtual bool store(CStrRef key, CVarRef val, int64 ttl);
   virtual int64 inc(CStrRef key, int64 step, bool &found);
   virtual bool cas(CStrRef key, int64 old, int64 val);
@@ -566,13 +647,23 @@ private:
     public LFUTable<StringData*, StoreValue, StringHash, StringEqual,
                     NodeDestructor> {
   public:
-    StringMap(time_t maturity, size_t maxCap, int updatePeriod)
+    StringMap(LfuTableSharedStore *store, time_t maturity, size_t maxCap,
+              int updatePeriod)
       : LFUTable<StringData*, StoreValue, StringHash, StringEqual,
                  NodeDestructor>
-    (maturity, maxCap, updatePeriod) {}
+    (maturity, maxCap, updatePeriod), m_store(store) {}
 
     typedef LFUTable<StringData*, StoreValue, StringHash, StringEqual,
                      NodeDestructor> baseType;
+
+  protected:
+    // values the table drops by itself leave the key index too
+    virtual void onEvict(StringData* const &k, StoreValue &val) {
+      m_store->unindexKey(k->data(), k->size());
+    }
+
+  private:
+    LfuTableSharedStore *m_store;
   };
   typedef StringMap Map;
   Map m_vars;
@@ -604,7 +695,19 @@ public:
       }
     }
   }
-  virtual bool get(CStrRef key, Variant &value);
+  virtual void scanKeys(std::vector<PrefixMatch> &matches) {
+    WriteLock l(m_lock);
+    for (Map::const_iterator iter = m_vars.begin();
+         iter != m_vars.end(); ++iter) {
+      PrefixMatch m;
+      m.key.assign(iter->first->data(), iter->first->size());
+      m.bytes = iter->second.var->getSpaceUsage();
+      m.gen = 0;
+      matches.push_back(m);
+    }
+  }
+  virtual bool getImpl(CStrRef key, Variant &value, int64 lockTimeout,
+                       bool &locked);
   virtual bool store(CStrRef key, CVarRef val, int64 ttl);
   virtual int64 inc(CStrRef key, int64 step, bool &found);
   virtual bool cas(CStrRef key, int64 old, int64 val);
@@ -641,6 +744,7 @@ protected:
       delete iter->first;
     }
     m_vars.clear();
+    clearIndex();
   }
   virtual bool eraseImpl(CStrRef key, bool expired) {
     if (key.isNull()) return false;
@@ -656,15 +760,28 @@ protected:
     return false;
   }
 
+  virtual bool checkAccessed(CStrRef key) {
+    ReadLock l(m_lock);
+    Map::const_accessor acc;
+    if (m_vars.find(acc, key.get())) {
+      bool accessed = acc->second.accessed;
+      acc->second.accessed = false;
+      return accessed;
+    }
+    return false;
+  }
+
   void eraseAcc(Map::accessor &acc) {
     acc->second.var->decRef();
     StringData *pkey = acc->first;
+    unindexKey(pkey->data(), pkey->size());
     m_vars.erase(acc);
     delete pkey;
   }
   void eraseAcc(Map::const_accessor &acc) {
     acc->second.var->decRef();
     StringData *pkey = acc->first;
+    unindexKey(pkey->data(), pkey->size());
     m_vars.erase(acc);
     delete pkey;
   }
@@ -738,12 +855,291 @@ protected:
 ///////////////////////////////////////////////////////////////////////////////
 // SharedStore
 
-SharedStore::SharedStore(int id) : m_id(id) {
+namespace {
+/**
+ * Handles of the counters logged on every access, registered on first use.
+ */
+struct APCCounters {
+  int hit, miss, update, add, erased, erase, inc, cas;
+  int stale, refresh, fillLock, fillWait;
+  int evicted, evictedBytes, evictTime;
+
+  APCCounters()
+    : hit(ServerStats::RegisterCounter("apc.hit")),
+      miss(ServerStats::RegisterCounter("apc.miss")),
+      update(ServerStats::RegisterCounter("apc.update")),
+      add(ServerStats::RegisterCounter("apc.new")),
+      erased(ServerStats::RegisterCounter("apc.erased")),
+      erase(ServerStats::RegisterCounter("apc.erase")),
+      inc(ServerStats::RegisterCounter("apc.inc")),
+      cas(ServerStats::RegisterCounter("apc.cas")),
+      stale(ServerStats::RegisterCounter("apc.stale")),
+      refresh(ServerStats::RegisterCounter("apc.refresh")),
+      fillLock(ServerStats::RegisterCounter("apc.fill_lock")),
+      fillWait(ServerStats::RegisterCounter("apc.fill_wait")),
+      evicted(ServerStats::RegisterCounter("apc.evicted")),
+      evictedBytes(ServerStats::RegisterCounter("apc.evicted_bytes")),
+      evictTime(ServerStats::RegisterCounter("apc.evict_time_us")) {
+  }
+};
+}
+
+static const APCCounters &apc_counters() {
+  static APCCounters s_counters;
+  return s_counters;
+}
+
+SharedStore::SharedStore(int id)
+  : m_id(id),
+    m_indexed(RuntimeOption::ApcPrefixIndex ||
+              (id == SHARED_STORE_APPLICATION_CACHE &&
+               RuntimeOption::ApcMaximumMemory > 0)),
+    m_inflation(0), m_indexBytes(0),
+    m_indexGen(0), m_evictions(0), m_evictTime(0), m_evictMaxTime(0),
+    m_fillCount(0) {
 }
 
 SharedStore::~SharedStore() {
 }
 
+bool SharedStore::get(CStrRef key, Variant &value) {
+  bool locked = false;
+  return getImpl(key, value, RuntimeOption::ApcFillLockTimeout, locked);
+}
+
+bool SharedStore::getOrLock(CStrRef key, Variant &value, int64 lockTimeout,
+                            bool &locked) {
+  locked = false;
+  if (getImpl(key, value, lockTimeout, locked)) {
+    return true;
+  }
+  if (!locked) {
+    locked = lockFill(key, lockTimeout);
+    if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
+      ServerStats::Log(locked ? apc_counters().fillLock :
+                       apc_counters().fillWait, 1);
+    }
+  }
+  return false;
+}
+
+bool SharedStore::lockFill(CStrRef key, int64 timeout) {
+  if (key.isNull()) return false;
+  Lock lock(m_fillMutex);
+  int64 now = time(NULL);
+  string name(key.data(), key.size());
+  hphp_string_map<int64>::iterator iter = m_fills.find(name);
+  if (iter != m_fills.end() && iter->second > now) {
+    return false;
+  }
+  if (m_fills.size() >= 1024) {
+    // locks that lapsed without their keys ever being stored
+    for (hphp_string_map<int64>::iterator it = m_fills.begin();
+         it != m_fills.end();) {
+      if (it->second <= now) {
+        m_fills.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+  }
+  m_fills[name] = now + timeout;
+  m_fillCount = m_fills.size();
+  return true;
+}
+
+void SharedStore::unlockFill(CStrRef key) {
+  if (m_fillCount == 0 || key.isNull()) return;
+  Lock lock(m_fillMutex);
+  m_fills.erase(string(key.data(), key.size()));
+  m_fillCount = m_fills.size();
+}
+
+int SharedStore::eraseByPrefix(CStrRef prefix) {
+  std::vector<PrefixMatch> matches;
+  findPrefix(prefix, 0, matches);
+  int count = 0;
+  for (unsigned int i = 0; i < matches.size(); i++) {
+    const PrefixMatch &m = matches[i];
+    if (erase(String(m.key.data(), m.key.size(), AttachLiteral))) {
+      count++;
+    } else {
+      forgetKey(m.key, m.gen);
+    }
+  }
+  return count;
+}
+
+Array SharedStore::getByPrefix(CStrRef prefix, int limit) {
+  std::vector<PrefixMatch> matches;
+  findPrefix(prefix, limit, matches);
+  Array ret = Array::Create();
+  for (unsigned int i = 0; i < matches.size(); i++) {
+    const PrefixMatch &m = matches[i];
+    String key(m.key.data(), m.key.size(), AttachLiteral);
+    Variant value;
+    bool locked = false;
+    if (getImpl(key, value, RuntimeOption::ApcFillLockTimeout, locked)) {
+      ret.set(String(m.key), value);
+    } else if (locked) {
+      // not refreshing it, so let another caller do it
+      unlockFill(key);
+    } else {
+      forgetKey(m.key, m.gen);
+    }
+  }
+  return ret;
+}
+
+int64 SharedStore::getPrefixSize(CStrRef prefix, int &count) {
+  std::vector<PrefixMatch> matches;
+  findPrefix(prefix, 0, matches);
+  int64 bytes = 0;
+  for (unsigned int i = 0; i < matches.size(); i++) {
+    bytes += matches[i].bytes;
+  }
+  count = matches.size();
+  return bytes;
+}
+
+void SharedStore::findPrefix(CStrRef prefix, int limit,
+                             std::vector<PrefixMatch> &matches) {
+  string p(prefix.data(), prefix.size());
+  ReadLock lock(m_indexLock);
+  for (KeyIndex::const_iterator iter = m_index.lower_bound(p);
+       iter != m_index.end() && iter->first.compare(0, p.size(), p) == 0;
+       ++iter) {
+    if (limit && (int)matches.size() >= limit) break;
+    PrefixMatch m;
+    m.key = iter->first;
+    m.bytes = iter->second.bytes;
+    m.gen = iter->second.gen;
+    matches.push_back(m);
+  }
+}
+
+void SharedStore::indexKey(CStrRef key, SharedVariant *var,
+                           bool evictable /* = true */) {
+  if (!m_indexed || key.isNull()) return;
+  int64 bytes = var->getSpaceUsage();
+  WriteLock lock(m_indexLock);
+  pair<KeyIndex::iterator, bool> ins = m_index.insert
+    (KeyIndex::value_type(string(key.data(), key.size()), IndexEntry()));
+  IndexEntry &entry = ins.first->second;
+  if (ins.second) {
+    entry.priority = -1;
+  } else if (entry.priority >= 0) {
+    m_evictionQueue.erase(make_pair(entry.priority, &ins.first->first));
+    entry.priority = -1;
+  }
+  m_indexBytes += bytes - entry.bytes;
+  entry.bytes = bytes;
+  entry.gen = ++m_indexGen;
+  if (evictable) prioritize(ins.first);
+}
+
+void SharedStore::prioritize(KeyIndex::iterator iter) {
+  IndexEntry &entry = iter->second;
+  entry.priority = m_inflation + 1.0 / (entry.bytes ? entry.bytes : 1);
+  m_evictionQueue.insert(make_pair(entry.priority, &iter->first));
+}
+
+void SharedStore::dropIndexEntry(KeyIndex::iterator iter) {
+  if (iter->second.priority >= 0) {
+    m_evictionQueue.erase(make_pair(iter->second.priority, &iter->first));
+  }
+  m_indexBytes -= iter->second.bytes;
+  m_index.erase(iter);
+}
+
+void SharedStore::unindexKey(const char *key, int len) {
+  if (!m_indexed) return;
+  WriteLock lock(m_indexLock);
+  KeyIndex::iterator iter = m_index.find(string(key, len));
+  if (iter != m_index.end()) {
+    dropIndexEntry(iter);
+  }
+}
+
+void SharedStore::clearIndex() {
+  WriteLock lock(m_indexLock);
+  m_evictionQueue.clear();
+  m_index.clear();
+  m_indexBytes = 0;
+  m_inflation = 0;
+}
+
+void SharedStore::forgetKey(const std::string &key, int64 gen) {
+  WriteLock lock(m_indexLock);
+  KeyIndex::iterator iter = m_index.find(key);
+  if (iter != m_index.end() && iter->second.gen == gen) {
+    dropIndexEntry(iter);
+  }
+}
+
+int64 SharedStore::getSpaceUsage() const {
+  ReadLock lock(m_indexLock);
+  return m_indexBytes;
+}
+
+int SharedStore::evict(int64 budget) {
+  if (getSpaceUsage() <= budget) return 0;
+
+  Lock evictLock(m_evictMutex);
+  Timer timer(Timer::WallTime);
+  int evicted = 0;
+  int64 bytes = 0;
+  int64 chances; // so hot keys can't keep us going forever
+  {
+    ReadLock lock(m_indexLock);
+    chances = m_index.size();
+  }
+  while (true) {
+    string key;
+    int64 gen, size;
+    {
+      WriteLock lock(m_indexLock);
+      if (m_indexBytes <= budget || m_evictionQueue.empty()) break;
+      EvictionQueue::iterator victim = m_evictionQueue.begin();
+      m_inflation = victim->first;
+      KeyIndex::iterator iter = m_index.find(*victim->second);
+      ASSERT(iter != m_index.end());
+      key = iter->first;
+      gen = iter->second.gen;
+      size = iter->second.bytes;
+    }
+
+    String k(key.data(), key.size(), AttachLiteral);
+    if (chances > 0 && checkAccessed(k)) {
+      chances--;
+      WriteLock lock(m_indexLock);
+      KeyIndex::iterator iter = m_index.find(key);
+      if (iter != m_index.end() && iter->second.gen == gen) {
+        m_evictionQueue.erase(make_pair(iter->second.priority, &iter->first));
+        prioritize(iter);
+      }
+      continue;
+    }
+    if (eraseImpl(k, false)) {
+      evicted++;
+      bytes += size;
+    } else {
+      forgetKey(key, gen);
+    }
+  }
+
+  int64 us = timer.getMicroSeconds();
+  m_evictions += evicted;
+  m_evictTime += us;
+  if (us > m_evictMaxTime) m_evictMaxTime = us;
+  if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
+    ServerStats::Log(apc_counters().evicted, evicted);
+    ServerStats::Log(apc_counters().evictedBytes, bytes);
+    ServerStats::Log(apc_counters().evictTime, us);
+  }
+  return evicted;
+}
+
 std::string SharedStore::GetSkeleton(CStrRef key) {
   std::string ret;
   const char *p = key.data();
@@ -767,10 +1163,25 @@ std::string SharedStore::GetSkeleton(CStrRef key) {
 void LockedSharedStore::clear() {
   lockMap();
   clearImpl();
+  clearIndex();
   unlockMap();
 }
 
-bool LockedSharedStore::get(CStrRef key, Variant &value) {
+bool LockedSharedStore::checkAccessed(CStrRef key) {
+  readLockMap();
+  StoreValue *val;
+  bool expired = false;
+  bool accessed = false;
+  if (find(key, val, expired)) {
+    accessed = val->accessed;
+    val->accessed = false;
+  }
+  readUnlockMap();
+  return accessed;
+}
+
+bool LockedSharedStore::getImpl(CStrRef key, Variant &value,
+                                int64 lockTimeout, bool &locked) {
   bool stats = RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats;
 
   readLockMap();
@@ -783,18 +1194,30 @@ bool LockedSharedStore::get(CStrRef key, Variant &value) {
     }
     value = false;
     if (stats) {
-      ServerStats::Log("apc.miss", 1);
+      ServerStats::Log(apc_counters().miss, 1);
     }
     return false;
   }
+  if (val->isStale()) {
+    if (lockFill(key, lockTimeout)) {
+      readUnlockMap();
+      locked = true;
+      value = false;
+      if (stats) ServerStats::Log(apc_counters().refresh, 1);
+      return false;
+    }
+    if (stats) ServerStats::Log(apc_counters().stale, 1);
+  }
   value = getVar(val->var)->toLocal();
+  val->touch();
   readUnlockMap();
-  if (stats) ServerStats::Log("apc.hit", 1);
+  if (stats) ServerStats::Log(apc_counters().hit, 1);
   return true;
 }
 
 
-bool ConcurrentTableSharedStore::get(CStrRef key, Variant &value) {
+bool ConcurrentTableSharedStore::getImpl(CStrRef key, Variant &value,
+                                         int64 lockTimeout, bool &locked) {
  bool stats = RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats;
  const StoreValue *val;
  ReadLock l(m_lock);
@@ -802,7 +1225,7 @@ bool ConcurrentTableSharedStore::get(CStrRef key, Variant &value) {
  {
    Map::const_accessor acc;
    if (!m_vars.find(acc, key.get())) {
-     if (stats) ServerStats::Log("apc.miss", 1);
+     if (stats) ServerStats::Log(apc_counters().miss, 1);
      return false;
    } else {
      val = &acc->second;
@@ -812,45 +1235,71 @@ bool ConcurrentTableSharedStore::get(CStrRef key, Variant &value) {
        expired = true;
      } else {
        value = val->var->toLocal();
+       val->touch();
      }
    }
  }
  if (expired) {
    if (stats) {
-     ServerStats::Log("apc.miss", 1);
+     ServerStats::Log(apc_counters().miss, 1);
    }
    eraseImpl(key, true);
    return false;
  }
  if (stats) {
-   ServerStats::Log("apc.hit", 1);
+   ServerStats::Log(apc_counters().hit, 1);
  }
  return true;
 }
 
 
-bool LfuTableSharedStore::get(CStrRef key, Variant &value) {
+bool LfuTableSharedStore::getImpl(CStrRef key, Variant &value,
+                                  int64 lockTimeout, bool &locked) {
   class GetReader : public Map::AtomicReader {
   public:
-    GetReader(Variant &v) : expired(false), value(v) {}
+    GetReader(Variant &v, CStrRef k, int64 t, LfuTableSharedStore *str)
+      : expired(false), stale(false), refresh(false), value(v), key(k),
+        lockTimeout(t), store(str) {}
     void read(StringData* const &k, const StoreValue &val) {
-      value = val.var->toLocal();
       expired = val.expired();
+      if (expired) return;
+      stale = val.isStale();
+      if (stale && store->lockFill(key, lockTimeout)) {
+        refresh = true;
+        return;
+      }
+      value = val.var->toLocal();
+      val.touch();
     }
     bool expired;
+    bool stale;
+    bool refresh;
     Variant &value;
+  private:
+    CStrRef key;
+    int64 lockTimeout;
+    LfuTableSharedStore *store;
   };
   bool stats = RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats;
-  GetReader reader(value);
-  if (!m_vars.atomicRead(key.get(), reader) || reader.expired) {
+  GetReader reader(value, key, lockTimeout, this);
+  if (!m_vars.atomicRead(key.get(), reader) || reader.expired ||
+      reader.refresh) {
     if (reader.expired) {
       erase(key, true);
     }
     value = false;
-    if (stats) ServerStats::Log("apc.miss", 1);
+    if (reader.refresh) {
+      locked = true;
+      if (stats) ServerStats::Log(apc_counters().refresh, 1);
+    } else {
+      if (stats) ServerStats::Log(apc_counters().miss, 1);
+    }
     return false;
   }
-  if (stats) ServerStats::Log("apc.hit", 1);
+  if (stats) {
+    if (reader.stale) ServerStats::Log(apc_counters().stale, 1);
+    ServerStats::Log(apc_counters().hit, 1);
+  }
   return true;
 }
 
@@ -863,12 +1312,12 @@ bool LockedSharedStore::store(CStrRef key, CVarRef val, int64 ttl) {
   bool expired = false;
   if (find(key, sval, expired) || expired) {
     getVar(sval->var)->decRef();
-    sval->set(putVar(var), ttl);
-    if (stats) ServerStats::Log("apc.update", 1);
+    sval->set(putVar(var), ttl, staleGrace());
+    if (stats) ServerStats::Log(apc_counters().update, 1);
   } else {
     set(key, var, ttl);
     if (stats) {
-      ServerStats::Log("apc.new", 1);
+      ServerStats::Log(apc_counters().add, 1);
       if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCKeyStats) {
         string prefix = "apc.new.";
         prefix += GetSkeleton(key);
@@ -876,8 +1325,10 @@ bool LockedSharedStore::store(CStrRef key, CVarRef val, int64 ttl) {
       }
     }
   }
+  indexKey(key, var);
 
   unlockMap();
+  unlockFill(key);
   return true;
 }
 
@@ -902,6 +1353,7 @@ bool ConcurrentTableSharedStore::store(CStrRef key, CVarRef val, int64 ttl) {
     }
     sval->set(var, ttl);
     expiry = sval->expiry;
+    indexKey(key, var);
   }
   if (RuntimeOption::ApcExpireOnSets) {
     if (ttl) {
@@ -911,9 +1363,9 @@ bool ConcurrentTableSharedStore::store(CStrRef key, CVarRef val, int64 ttl) {
   }
   if (stats) {
     if (present) {
-      ServerStats::Log("apc.update", 1);
+      ServerStats::Log(apc_counters().update, 1);
     } else {
-      ServerStats::Log("apc.new", 1);
+      ServerStats::Log(apc_counters().add, 1);
       if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCKeyStats) {
         string prefix = "apc.new.";
         prefix += GetSkeleton(key);
@@ -921,6 +1373,7 @@ bool ConcurrentTableSharedStore::store(CStrRef key, CVarRef val, int64 ttl) {
       }
     }
   }
+  unlockFill(key);
 
   return true;
 }
@@ -929,19 +1382,20 @@ bool ConcurrentTableSharedStore::store(CStrRef key, CVarRef val, int64 ttl) {
 bool LfuTableSharedStore::store(CStrRef key, CVarRef val, int64 ttl) {
   class StoreUpdater : public Map::AtomicUpdater {
   public:
-    StoreUpdater(int64 t, SharedVariant *v, CStrRef k)
-  : ttl(t), var(v), key(k), newkey(key.get()->copy(true)) {}
+    StoreUpdater(int64 t, SharedVariant *v, CStrRef k, LfuTableSharedStore *s)
+      : ttl(t), var(v), key(k), newkey(key.get()->copy(true)), store(s) {}
     bool update(StringData* const &k, StoreValue &val, bool newlyCreated) {
       bool stats = RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats;
+      int64 grace = RuntimeOption::ApcStaleGracePeriod;
       if (!newlyCreated) {
         val.var->decRef();
-        val.set(var, ttl);
-        if (stats) ServerStats::Log("apc.update", 1);
+        val.set(var, ttl, grace);
+        if (stats) ServerStats::Log(apc_counters().update, 1);
         delete newkey;
       } else {
-        val.set(var, ttl);
+        val.set(var, ttl, grace);
         if (stats) {
-          ServerStats::Log("apc.new", 1);
+          ServerStats::Log(apc_counters().add, 1);
           if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCKeyStats) {
             string prefix = "apc.new.";
             prefix += GetSkeleton(key);
@@ -949,6 +1403,7 @@ bool LfuTableSharedStore::store(CStrRef key, CVarRef val, int64 ttl) {
           }
         }
       }
+      store->indexKey(key, var);
       return false;
     }
     StringData *newKey() { return newkey; }
@@ -957,10 +1412,12 @@ bool LfuTableSharedStore::store(CStrRef key, CVarRef val, int64 ttl) {
     SharedVariant *var;
     CStrRef key;
     StringData *newkey;
+    LfuTableSharedStore *store;
   };
   SharedVariant* var = construct(key, val);
-  StoreUpdater updater(ttl, var, key);
+  StoreUpdater updater(ttl, var, key, this);
   m_vars.atomicUpdate(updater.newKey(), updater, true);
+  unlockFill(key);
   return true;
 }
 
@@ -969,7 +1426,9 @@ void LockedSharedStore::prime(const std::vector<KeyValuePair> &vars) {
   // we are priming, so we are not checking existence or expiration
   for (unsigned int i = 0; i < vars.size(); i++) {
     const KeyValuePair &item = vars[i];
-    set(String(item.key, item.len, AttachLiteral), item.value, 0);
+    String key(item.key, item.len, AttachLiteral);
+    set(key, item.value, 0);
+    indexKey(key, item.value, false);
   }
   unlockMap();
 }
@@ -985,6 +1444,7 @@ void ConcurrentTableSharedStore::prime
     String k(item.key, item.len, AttachLiteral);
     m_vars.insert(acc, k.get()->copy(true));
     acc->second.set(item.value, 0);
+    indexKey(k, item.value, false);
   }
 }
 
@@ -995,15 +1455,19 @@ void LfuTableSharedStore::prime
   for (unsigned int i = 0; i < vars.size(); i++) {
     const SharedStore::KeyValuePair &item = vars[i];
     // Primed values are immortal
-    set(String(item.key, item.len, AttachLiteral), item.value, 0, true);
+    String key(item.key, item.len, AttachLiteral);
+    set(key, item.value, 0, true);
+    indexKey(key, item.value, false);
   }
 }
 
 bool SharedStore::erase(CStrRef key, bool expired /* = false */) {
   bool success = eraseImpl(key, expired);
+  if (!expired) unlockFill(key);
 
   if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
-    ServerStats::Log(success ? "apc.erased" : "apc.erase", 1);
+    ServerStats::Log(success ? apc_counters().erased :
+                     apc_counters().erase, 1);
   }
   return success;
 }
@@ -1011,6 +1475,7 @@ bool SharedStore::erase(CStrRef key, bool expired /* = false */) {
 bool LockedSharedStore::eraseImpl(CStrRef key, bool expired /* = false */) {
   lockMap();
   bool success = eraseLockedImpl(key, expired);
+  if (success) unindexKey(key.data(), key.size());
   unlockMap();
   return success;
 }
@@ -1036,7 +1501,7 @@ int64 LockedSharedStore::inc(CStrRef key, int64 step, bool &found) {
   }
 
   if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
-    ServerStats::Log("apc.inc", 1);
+    ServerStats::Log(apc_counters().inc, 1);
   }
   return ret;
 }
@@ -1066,7 +1531,7 @@ int64 ConcurrentTableSharedStore::inc(CStrRef key, int64 step, bool &found) {
   }
 
   if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
-    ServerStats::Log("apc.inc", 1);
+    ServerStats::Log(apc_counters().inc, 1);
   }
   return ret;
 }
@@ -1104,7 +1569,7 @@ int64 LfuTableSharedStore::inc(CStrRef key, int64 step, bool &found) {
   m_vars.atomicUpdate(key.get(), updater, false);
 
   if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
-    ServerStats::Log("apc.inc", 1);
+    ServerStats::Log(apc_counters().inc, 1);
   }
   return updater.ret;
 }
@@ -1130,7 +1595,7 @@ bool LockedSharedStore::cas(CStrRef key, int64 old, int64 val) {
   }
 
   if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
-    ServerStats::Log("apc.cas", 1);
+    ServerStats::Log(apc_counters().cas, 1);
   }
   return success;
 }
@@ -1156,7 +1621,7 @@ bool ConcurrentTableSharedStore::cas(CStrRef key, int64 old, int64 val) {
   }
 
   if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
-    ServerStats::Log("apc.cas", 1);
+    ServerStats::Log(apc_counters().cas, 1);
   }
   return success;
 }
@@ -1192,12 +1657,12 @@ bool LfuTableSharedStore::cas(CStrRef key, int64 old, int64 val) {
   m_vars.atomicUpdate(key.get(), updater, false);
 
   if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
-    ServerStats::Log("apc.cas", 1);
+    ServerStats::Log(apc_counters().cas, 1);
   }
   return updater.success;
 }
 
-static std::string appendElement(int indent, const char *name, int value) {
+static std::string appendElement(int indent, const char *name, int64 value) {
   string ret;
   for (int i = 0; i < indent; i++) {
     ret += "  ";
@@ -1218,6 +1683,37 @@ std::string SharedStore::reportStats(int &reachable, int indent) {
   ret += appendElement(indent, "Expiration", size() - persistent);
   ret += appendElement(indent, "Expired", expired);
   ret += appendElement(indent, "Reachable", reachable);
+  ret += appendElement(indent, "FillLocks", m_fillCount);
+
+  std::vector<PrefixMatch> matches;
+  scanKeys(matches);
+  int64 bytes = 0;
+  typedef std::map<std::string, std::pair<int, int64> > SkeletonMap;
+  SkeletonMap skeletons;
+  for (unsigned int i = 0; i < matches.size(); i++) {
+    bytes += matches[i].bytes;
+    if (RuntimeOption::EnableAPCKeyStats) {
+      std::pair<int, int64> &group =
+        skeletons[GetSkeleton(String(matches[i].key))];
+      group.first++;
+      group.second += matches[i].bytes;
+    }
+  }
+  ret += appendElement(indent, "Bytes", bytes);
+  ret += appendElement(indent, "Evictions", m_evictions);
+  ret += appendElement(indent, "EvictionTime", m_evictTime);
+  ret += appendElement(indent, "MaxEvictionTime", m_evictMaxTime);
+  for (SkeletonMap::const_iterator iter = skeletons.begin();
+       iter != skeletons.end(); ++iter) {
+    for (int i = 0; i < indent; i++) ret += "  ";
+    ret += "<KeySkeleton>\n";
+    for (int i = 0; i <= indent; i++) ret += "  ";
+    ret += "<Name>" + iter->first + "</Name>\n";
+    ret += appendElement(indent + 1, "Keys", iter->second.first);
+    ret += appendElement(indent + 1, "Bytes", iter->second.second);
+    for (int i = 0; i < indent; i++) ret += "  ";
+    ret += "</KeySkeleton>\n";
+  }
   return ret;
 }
 
@@ -1229,20 +1725,30 @@ std::string LfuTableSharedStore::reportStats(int &reachable, int indent) {
   return ret;
 }
 
-void StoreValue::set(SharedVariant *v, int64 ttl) {
+void StoreValue::set(SharedVariant *v, int64 ttl, int64 grace /* = 0 */) {
   var = v;
-  expiry = ttl ? time(NULL) + ttl : 0;
+  if (ttl) {
+    int64 now = time(NULL);
+    expiry = now + ttl + grace;
+    stale = grace ? now + ttl : 0;
+  } else {
+    expiry = stale = 0;
+  }
 }
 bool StoreValue::expired() const {
   return expiry && time(NULL) >= expiry;
 }
+bool StoreValue::isStale() const {
+  return stale && time(NULL) >= stale;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 // SharedStores
 
 SharedStores s_apc_store;
 
-SharedStores::SharedStores() {
+SharedStores::SharedStores()
+  : m_evictor(this, &SharedStores::evictor), m_evictorStopped(true) {
 }
 
 void SharedStores::create() {
@@ -1283,6 +1789,21 @@ void SharedStores::create() {
       }
     }
   }
+
+  if (RuntimeOption::ApcMaximumMemory > 0) {
+    m_evictorStopped = false;
+    m_evictor.start();
+  }
+}
+
+void SharedStores::evictor() {
+  int64 budget = RuntimeOption::ApcMaximumMemory * 1024 * 1024;
+  while (!m_evictorStopped) {
+    usleep(100000);
+    m_stores[SHARED_STORE_APPLICATION_CACHE]->evict(budget);
+    // this thread never logs a page for its counters to go with
+    ServerStats::FlushCounters("apc-evict");
+  }
 }
 
 SharedStores::~SharedStores() {
@@ -1290,6 +1811,10 @@ SharedStores::~SharedStores() {
 }
 
 void SharedStores::clear() {
+  if (!m_evictorStopped) {
+    m_evictorStopped = true;
+    m_evictor.waitForEnd();
+  }
   for (int i = 0; i < MAX_SHARED_STORE; i++) {
     delete m_stores[i];
   }
@@ -20,7 +20,10 @@
 #include <cpp/base/types.h>
 #include <cpp/base/shared/shared_variant.h>
 #include <util/lock.h>
+#include <util/async_func.h>
 #include <cpp/base/type_array.h>
+#include <map>
+#include <set>
 
 #define SHARED_STORE_APPLICATION_CACHE 0
 #define SHARED_STORE_DNS_CACHE 1
@@ -31,11 +34,29 @@ namespace HPHP {
 
 class StoreValue {
 public:
-  StoreValue() : var(NULL), expiry(0) {}
-  void set(SharedVariant *v, int64 ttl);
+  StoreValue() : var(NULL), expiry(0), stale(0), accessed(false) {}
+  void set(SharedVariant *v, int64 ttl, int64 grace = 0);
   bool expired() const;
+
+  /**
+   * Past its ttl, but still within its grace period: the value is still
+   * served, except to the one caller that is told to refresh it.
+   */
+  bool isStale() const;
+
   SharedVariant *var;
-  int64 expiry;
+  int64 expiry; // including grace period
+  int64 stale;  // end of ttl, when there is a grace period
+
+  /**
+   * Set by reads, and cleared by the evictor when it gives the value a
+   * second chance. Written under read locks, which is fine for a hint.
+   */
+  mutable bool accessed;
+
+  void touch() const {
+    if (!accessed) accessed = true;
+  }
 };
 
 class SharedStore {
@@ -47,12 +68,48 @@ public:
   virtual int size() = 0;
   virtual void count(int &reachable, int &expired, int &persistent) = 0;
 
-  virtual bool get(CStrRef key, Variant &value) = 0;
+  bool get(CStrRef key, Variant &value);
   virtual bool store(CStrRef key, CVarRef val, int64 ttl) = 0;
   bool erase(CStrRef key, bool expired = false);
+
+  /**
+   * Like get(), but when the key is missing, only one caller at a time gets
+   * "locked" set and is expected to store it. The lock lasts until the key
+   * is stored or erased, or until lockTimeout seconds have passed.
+   */
+  bool getOrLock(CStrRef key, Variant &value, int64 lockTimeout,
+                 bool &locked);
   virtual int64 inc(CStrRef key, int64 step, bool &found) = 0;
   virtual bool cas(CStrRef key, int64 old, int64 val) = 0;
 
+  /**
+   * Operations on all keys starting with a prefix, found through an ordered
+   * index of keys instead of a scan of the whole table. getByPrefix() stops
+   * after "limit" keys, unless it is 0, and returns key => value. The index
+   * costs a lock and a copy of the key on every store, so it is only kept
+   * with APC.PrefixIndex, or for eviction with APC.MaximumMemory.
+   */
+  virtual bool canFindPrefix() const { return m_indexed;}
+  int eraseByPrefix(CStrRef prefix);
+  Array getByPrefix(CStrRef prefix, int limit);
+  int64 getPrefixSize(CStrRef prefix, int &count);
+
+  /**
+   * Bytes taken by all values, as the key index counts them.
+   */
+  int64 getSpaceUsage() const;
+
+  /**
+   * Evicts values until they fit in "budget" bytes, one key at a time and
+   * never holding any lock across keys, so stores go on meanwhile. Victims
+   * are picked by GreedyDual-Size: a value's priority is the priority of
+   * the last victim plus 1/size when it is stored or read, so big values
+   * and values nobody reads go first. Reads only flag the value, and a
+   * flagged victim is given its new priority instead of being evicted.
+   * Returns how many were evicted.
+   */
+  int evict(int64 budget);
+
   // for priming only
   virtual SharedVariant* construct(litstr str, int len, CStrRef v,
                                    bool serialized) = 0;
@@ -72,10 +129,84 @@ public:
 protected:
   int m_id;
 
+  /**
+   * When the value is stale, lockFill(key, lockTimeout) decides between
+   * returning it and a miss with "locked" set.
+   */
+  virtual bool getImpl(CStrRef key, Variant &value, int64 lockTimeout,
+                       bool &locked) = 0;
   virtual bool eraseImpl(CStrRef key, bool expired) = 0;
   virtual SharedVariant* construct(CStrRef key, CVarRef v) = 0;
   virtual SharedVariant* putVar(SharedVariant* v) const { return v; };
   virtual SharedVariant* getVar(SharedVariant* v) const { return v; };
+
+  /**
+   * Whether the key was read since the last time this was called.
+   */
+  virtual bool checkAccessed(CStrRef key) { return false;}
+
+  bool lockFill(CStrRef key, int64 timeout);
+  void unlockFill(CStrRef key);
+
+  /**
+   * Keeping the key index up to date, from under the store's own locks, so
+   * the index always agrees with the last store or erase of a key. Stores
+   * that can't see all their keys turn m_indexed off and override
+   * findPrefix() instead. Primed keys are indexed as not evictable.
+   */
+  struct PrefixMatch {
+    std::string key;
+    int64 bytes;
+    int64 gen; // when the key was indexed, for forgetKey()
+  };
+  virtual void findPrefix(CStrRef prefix, int limit,
+                          std::vector<PrefixMatch> &matches);
+
+  /**
+   * Every key with its size, for reportStats(). Stores that keep the key
+   * index only on demand override this with a scan of their own table.
+   */
+  virtual void scanKeys(std::vector<PrefixMatch> &matches) {
+    findPrefix(String(""), 0, matches);
+  }
+  void indexKey(CStrRef key, SharedVariant *var, bool evictable = true);
+  void unindexKey(const char *key, int len);
+  void clearIndex();
+  bool m_indexed;
+
+private:
+  struct IndexEntry {
+    int64 bytes;
+    int64 gen;
+    double priority;
+  };
+  typedef std::map<std::string, IndexEntry> KeyIndex;
+  typedef std::set<std::pair<double, const std::string *> > EvictionQueue;
+
+  mutable ReadWriteMutex m_indexLock;
+  KeyIndex m_index;
+  EvictionQueue m_evictionQueue; // lowest priority first
+  double m_inflation; // priority of the last victim
+  int64 m_indexBytes;
+  int64 m_indexGen;
+
+  Mutex m_evictMutex;
+  int64 m_evictions;
+  int64 m_evictTime;    // microseconds, all rounds
+  int64 m_evictMaxTime; // microseconds, longest round
+
+  void prioritize(KeyIndex::iterator iter);
+  void dropIndexEntry(KeyIndex::iterator iter);
+
+  /**
+   * For keys a prefix operation found missing from the table, like ones the
+   * LFU table evicted by itself: drops them, unless stored again since.
+   */
+  void forgetKey(const std::string &key, int64 gen);
+
+  Mutex m_fillMutex;
+  hphp_string_map<int64> m_fills; // key => when its fill lock lapses
+  volatile int m_fillCount;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -101,6 +232,13 @@ public:
 
 private:
   SharedStore* m_stores[MAX_SHARED_STORE];
+
+  /**
+   * Keeps the stores within ApcMaximumMemory, when it is set.
+   */
+  AsyncFunc<SharedStores> m_evictor;
+  volatile bool m_evictorStopped;
+  void evictor();
 };
 
 extern SharedStores s_apc_store;
@@ -40,5 +40,18 @@ int SharedVariant::countReachable() {
   return count;
 }
 
+int64 SharedVariant::getSpaceUsage() {
+  int64 size = sizeof(SharedVariant);
+  if (m_type == KindOfString) {
+    size += stringLength();
+  } else if (m_type == KindOfArray) {
+    int count = arrSize();
+    for (int i = 0; i < count; i++) {
+      size += getKey(i)->getSpaceUsage() + getValue(i)->getSpaceUsage();
+    }
+  }
+  return size;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 }
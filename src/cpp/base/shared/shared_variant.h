@@ -62,6 +62,11 @@ public:
 
   int countReachable();
 
+  /**
+   * Approximate bytes taken by this value and everything it holds.
+   */
+  virtual int64 getSpaceUsage();
+
  protected:
   int m_ref;
   DataType m_type;
@@ -16,26 +16,31 @@
 
 #include <cpp/base/shared/thread_shared_variant.h>
 #include <cpp/ext/ext_variable.h>
+#include <cpp/base/builtin_functions.h>
 #include <cpp/base/shared/shared_map.h>
 #include <cpp/base/array/array_element.h>
+#include <cpp/base/class_info.h>
+#include <cpp/base/externals.h>
 
 using namespace std;
 
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
-ThreadSharedVariant::ThreadSharedVariant(StringData *source) : m_owner(false) {
+ThreadSharedVariant::ThreadSharedVariant(StringData *source)
+  : m_owner(false), m_binary(false), m_structural(false) {
   m_type = KindOfString;
   m_data.str = source;
 }
 
-ThreadSharedVariant::ThreadSharedVariant(int64 num) : m_owner(false) {
+ThreadSharedVariant::ThreadSharedVariant(int64 num)
+  : m_owner(false), m_binary(false), m_structural(false) {
   m_type = KindOfInt64;
   m_data.num = num;
 }
 
 ThreadSharedVariant::ThreadSharedVariant(CVarRef source, bool serialized)
-  : m_owner(true) {
+  : m_owner(true), m_binary(false), m_structural(false) {
   ASSERT(!serialized || source.isString());
 
   m_ref = 1;
@@ -80,6 +85,7 @@ ThreadSharedVariant::ThreadSharedVariant(CVarRef source, bool serialized)
       SharedVariant** vals = new SharedVariant*[size];
 
       uint i = 0;
+      int64 elemSpace = 0;
       for (ArrayIterPtr it = source.begin(); !it->end(); it->next()) {
         ThreadSharedVariant* key
           = createAnother(it->first(), false);
@@ -88,7 +94,10 @@ ThreadSharedVariant::ThreadSharedVariant(CVarRef source, bool serialized)
         keys[i] = key;
         vals[i] = val;
         map[key] = i++;
+        // constant time, as nested arrays have theirs summed up already
+        elemSpace += key->getSpaceUsage() + val->getSpaceUsage();
       }
+      mapData->elemSpace = elemSpace;
       m_data.map = mapData;
       mapData->map.swap(map);
       mapData->keys = keys;
@@ -98,13 +107,88 @@ ThreadSharedVariant::ThreadSharedVariant(CVarRef source, bool serialized)
   default:
     {
       m_type = KindOfObject;
-      String s = f_serialize(source);
+      Object obj = source.toObject();
+      Array props = obj->o_toArray();
+      if (CanStoreProperties(obj, props)) {
+        m_structural = true;
+        Array unmangled = Array::Create();
+        for (ArrayIter iter(props); iter; ++iter) {
+          String key = iter.first().toString();
+          if (key.charAt(0) == '\00') {
+            // "\0*\0name" when protected, "\0class\0name" when private
+            key = key.substr(key.find('\00', 1) + 1);
+          }
+          unmangled.set(key, iter.second());
+        }
+        const char *clsName = obj->o_getClassName();
+        ThreadSharedVariantObjectData *objData =
+          new ThreadSharedVariantObjectData();
+        objData->clsName =
+          new StringData(clsName, strlen(clsName), CopyString);
+        objData->props = createAnother(unmangled, false);
+        m_data.obj = objData;
+        break;
+      }
+      m_binary = true;
+      String s = binary_serialize(source);
       m_data.str = new StringData(s.data(), s.size(), CopyString);
       break;
     }
   }
 }
 
+static bool is_plain_value(CVarRef v, int depth) {
+  if (v.isObject()) return false;
+  if (v.isArray()) {
+    if (depth > 64) return false;
+    Array arr = v.toArray();
+    for (ArrayIter iter(arr); iter; ++iter) {
+      if (!is_plain_value(iter.second(), depth + 1)) return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Objects of user classes without __sleep(), and stdClass objects, holding
+ * nothing but scalars, strings and arrays of them, are stored structurally.
+ * System classes may keep state outside their properties, and objects
+ * inside objects may be shared or cyclic, which only serialization keeps.
+ */
+bool ThreadSharedVariant::CanStoreProperties(CObjRef obj, CArrRef props) {
+  if (obj->isResource()) return false;
+  const char *clsName = obj->o_getClassName();
+  const ClassInfo *cls = ClassInfo::FindClass(clsName);
+  if (cls == NULL) return false;
+  if ((cls->getAttribute() & ClassInfo::IsSystem) &&
+      strcasecmp(clsName, "stdClass") != 0) {
+    return false;
+  }
+  if (cls->hasMethod("__sleep")) return false;
+  return is_plain_value(props, 0);
+}
+
+Object ThreadSharedVariant::propertiesToLocal() {
+  ThreadSharedVariantObjectData *objData = m_data.obj;
+  Object obj;
+  try {
+    obj = create_object(objData->clsName->data(), Array::Create(), false);
+  } catch (ClassNotFoundException &e) {
+    obj = create_object("__PHP_Incomplete_Class", Array::Create(), false);
+    obj->o_set("__PHP_Incomplete_Class_Name", -1,
+               String(objData->clsName->data(), objData->clsName->size(),
+                      CopyString));
+  }
+  SharedVariant *props = objData->props;
+  size_t size = props->arrSize();
+  for (size_t i = 0; i < size; i++) {
+    String key = props->getKey(i)->toLocal().toString();
+    obj.o_lval(key, -1).lval() = props->getValue(i)->toLocal();
+  }
+  obj->t___wakeup();
+  return obj;
+}
+
 Variant ThreadSharedVariant::toLocal() {
   ASSERT(m_owner);
   switch (m_type) {
@@ -130,8 +214,15 @@ Variant ThreadSharedVariant::toLocal() {
     }
   default:
     {
-      return f_unserialize(String(m_data.str->data(), m_data.str->size(),
-                                  AttachLiteral));
+      if (m_structural) {
+        return propertiesToLocal();
+      }
+      String s(m_data.str->data(), m_data.str->size(), AttachLiteral);
+      if (m_binary) {
+        bool success;
+        return binary_unserialize(s, success);
+      }
+      return f_unserialize(s);
     }
   }
 }
@@ -164,6 +255,12 @@ void ThreadSharedVariant::dump(std::string &out) {
     break;
   default:
     out += "object: ";
+    if (m_structural) {
+      out += m_data.obj->clsName->data();
+      out += " ";
+      ((ThreadSharedVariant*)m_data.obj->props)->dump(out);
+      return;
+    }
     out += m_data.str->data();
     break;
   }
@@ -172,8 +269,15 @@ void ThreadSharedVariant::dump(std::string &out) {
 
 ThreadSharedVariant::~ThreadSharedVariant() {
   switch (m_type) {
-  case KindOfString:
   case KindOfObject:
+    if (m_structural) {
+      delete m_data.obj->clsName;
+      m_data.obj->props->decRef();
+      delete m_data.obj;
+      break;
+    }
+    // fall through
+  case KindOfString:
     if (m_owner) {
       delete m_data.str;
     }
@@ -197,6 +301,35 @@ ThreadSharedVariant::~ThreadSharedVariant() {
   }
 }
 
+int64 ThreadSharedVariant::getSpaceUsage() {
+  int64 size = sizeof(ThreadSharedVariant);
+  switch (m_type) {
+  case KindOfString:
+    size += sizeof(StringData) + m_data.str->size();
+    break;
+  case KindOfArray:
+    {
+      size_t count = arrSize();
+      // key and value pointers, plus a hash map node
+      size += sizeof(ThreadSharedVariantMapData) +
+        count * (sizeof(SharedVariant*) * 4 + sizeof(int)) +
+        m_data.map->elemSpace;
+    }
+    break;
+  case KindOfObject:
+    if (m_structural) {
+      size += sizeof(ThreadSharedVariantObjectData) + sizeof(StringData) +
+        m_data.obj->clsName->size() + m_data.obj->props->getSpaceUsage();
+    } else {
+      size += sizeof(StringData) + m_data.str->size();
+    }
+    break;
+  default:
+    break;
+  }
+  return size;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 bool ThreadSharedVariant::operator==(const SharedVariant& svother) const {
@@ -27,6 +27,7 @@ namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
 class ThreadSharedVariantMapData;
+class ThreadSharedVariantObjectData;
 class ThreadSharedVariant;
 struct ThreadSharedVariantHash;
 
@@ -81,6 +82,8 @@ class ThreadSharedVariant : public SharedVariant {
 
   void loadElems(std::vector<ArrayElement *> &elems);
 
+  virtual int64 getSpaceUsage(); // constant time
+
   virtual SharedVariant* getKey(ssize_t pos) const {
     ASSERT(is(KindOfArray));
     return keys()[pos];
@@ -102,8 +105,11 @@ private:
     double dbl;
     StringData *str;
     ThreadSharedVariantMapData* map;
+    ThreadSharedVariantObjectData* obj;
   } m_data;
   bool m_owner;
+  bool m_binary; // object serialized by binary_serialize() or f_serialize()
+  bool m_structural; // object kept as class name and properties, not text
 
   const ThreadSharedVariantToIntMap &map() const;
   SharedVariant** keys() const;
@@ -112,6 +118,9 @@ private:
   ThreadSharedVariant(StringData *source);
   ThreadSharedVariant(int64 num);
   ThreadSharedVariantToIntMap::const_iterator lookup(CVarRef key);
+
+  static bool CanStoreProperties(CObjRef obj, CArrRef props);
+  Object propertiesToLocal();
 };
 
 class ThreadSharedVariantMapData {
@@ -119,6 +128,17 @@ public:
   ThreadSharedVariantToIntMap map;
   SharedVariant** keys;
   SharedVariant** vals;
+  int64 elemSpace; // getSpaceUsage() of all keys and values
+};
+
+/**
+ * An object of a class that can be rebuilt from its properties alone, with
+ * the properties kept as a shared array of unmangled names to values.
+ */
+class ThreadSharedVariantObjectData {
+public:
+  StringData *clsName;
+  SharedVariant *props;
 };
 
 class ThreadSharedVariantLockedRefs : public ThreadSharedVariant {
@@ -151,6 +151,48 @@ void StringData::append(const char *s, int len) {
   }
 }
 
+void StringData::append(const char * const *parts, const int *lens,
+                        int count) {
+  int dataLen = size();
+  int len = dataLen;
+  bool overlapping = false;
+  for (int i = 0; i < count; i++) {
+    if (lens[i] < 0 || (lens[i] & IsMask)) {
+      throw InvalidArgumentException("len", lens[i]);
+    }
+    len += lens[i];
+    if (parts[i] >= m_data && parts[i] <= m_data + dataLen) {
+      overlapping = true; // e.g. $a .= $a . $b
+    }
+  }
+  if (len == dataLen) return;
+  if (len & IsMask) {
+    throw InvalidArgumentException("len", len);
+  }
+
+  // one realloc for all parts, unless old data is not ours to grow or is
+  // still needed as a source
+  bool inPlace = isMalloced() && !overlapping;
+  char *buf;
+  if (inPlace) {
+    buf = (char*)realloc((void*)m_data, len + 1);
+  } else {
+    buf = (char*)malloc(len + 1);
+    memcpy(buf, m_data, dataLen);
+  }
+  char *p = buf + dataLen;
+  for (int i = 0; i < count; i++) {
+    memcpy(p, parts[i], lens[i]);
+    p += lens[i];
+  }
+  *p = '\0';
+  if (!inPlace) {
+    releaseData();
+  }
+  m_data = buf;
+  m_len = len;
+}
+
 StringData *StringData::copy(bool sharedMemory /* = false */) const {
   if (sharedMemory) {
     if (isLiteral()) {
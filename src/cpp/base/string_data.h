@@ -58,6 +58,7 @@ public:
   void assign(const char *data, int len, StringDataMode mode);
   void assign(SharedVariant *shared);
   void append(const char *s, int len);
+  void append(const char * const *parts, const int *lens, int count);
   StringData *copy(bool sharedMemory = false) const;
 
   ~StringData();
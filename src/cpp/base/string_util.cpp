@@ -283,6 +283,7 @@ String StringUtil::SqlEncode(CStrRef input) {
   if (input.empty()) return input;
   int len = input.size();
   char *ret = string_addslashes(input, len);
+  if (!ret) return input;
   return String(ret, len, AttachString);
 }
 
@@ -305,6 +306,7 @@ String StringUtil::HtmlEncode(CStrRef input, QuoteStyle quoteStyle) {
   int len = input.size();
   char *ret = string_html_encode(input, len, quoteStyle != NoQuotes,
                                  quoteStyle == BothQuotes);
+  if (!ret) return input;
   return String(ret, len, AttachString);
 }
 
@@ -382,6 +384,7 @@ String StringUtil::UrlEncode(CStrRef input, bool encodePlus /* = true */) {
   } else {
     ret = url_raw_encode(input.data(), len);
   }
+  if (!ret) return input;
   return String(ret, len, AttachString);
 }
 
@@ -17,6 +17,7 @@
 #include <cpp/base/time/datetime.h>
 #include <cpp/base/type_array.h>
 #include <cpp/base/util/string_buffer.h>
+#include <cpp/base/execution_context.h>
 #include <util/logger.h>
 
 namespace HPHP {
@@ -705,6 +706,326 @@ bool DateTime::fromString(CStrRef input, SmartObject<TimeZone> tz) {
   return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// date()/gmdate()/strtotime() fast paths
+
+class BrokenDownTime {
+public:
+  BrokenDownTime() : Valid(false) {}
+
+  bool Valid;
+  int64 TimeStamp;
+  std::string Zone; // timezone name the fields were computed under
+  int Year, Month, Day, Hour, Minute, Second;
+  int Dow, Doy, IsoWeek, IsoYear, IsoDow, Beat;
+  const char *WeekdayName;
+  const char *ShortWeekdayName;
+  int Offset;
+  bool Dst;
+  std::string Abbr;
+  std::string Name;
+};
+
+class DateCache {
+public:
+  DateCache() : ZoneTime(-1) {}
+
+  BrokenDownTime Local;
+  BrokenDownTime Utc;
+  hphp_string_map<std::string> Formats; // format => compiled format
+
+  /**
+   * TimeZone::CurrentName(), which may have to try getenv() and timezone
+   * lookups, resolved again only each second or after the request's own
+   * timezone is set.
+   */
+  const std::string &currentZone() {
+    time_t now = time(NULL);
+    String configured = g_context->getTimeZone();
+    if (now != ZoneTime || ConfiguredZone != configured.data()) {
+      ZoneTime = now;
+      ConfiguredZone = configured.data();
+      Zone = TimeZone::CurrentName().data();
+    }
+    return Zone;
+  }
+
+private:
+  time_t ZoneTime;
+  std::string ConfiguredZone;
+  std::string Zone;
+};
+static ThreadLocal<DateCache> s_date_cache;
+
+// widest output of any single format character, e.g. 'r' or 'e'
+#define MAX_DATE_SPEC_LENGTH 64
+#define MAX_DATE_BUFFER_LENGTH 512
+#define MAX_CACHED_DATE_FORMATS 1024
+
+/**
+ * Compiles a date() format into literal characters and '\0'-prefixed format
+ * characters, with escapes resolved. Returns false if the format can't be
+ * rendered into a fixed size buffer or has unusual escaping.
+ */
+static bool compile_date_format(CStrRef format, std::string &compiled) {
+  int maxLength = 0;
+  for (int i = 0; i < format.size(); i++) {
+    char ch = format.charAt(i);
+    switch (ch) {
+    case '\0':
+      return false;
+    case '\\':
+      if (++i == format.size() || format.charAt(i) == '\0') return false;
+      compiled += format.charAt(i);
+      maxLength++;
+      break;
+    case 'd': case 'D': case 'j': case 'l': case 'S': case 'w': case 'N':
+    case 'z': case 'W': case 'o': case 'F': case 'm': case 'M': case 'n':
+    case 't': case 'L': case 'y': case 'Y': case 'a': case 'A': case 'B':
+    case 'g': case 'G': case 'h': case 'H': case 'i': case 's': case 'u':
+    case 'I': case 'P': case 'O': case 'T': case 'e': case 'Z': case 'c':
+    case 'r': case 'U':
+      compiled += '\0';
+      compiled += ch;
+      maxLength += MAX_DATE_SPEC_LENGTH;
+      break;
+    default:
+      compiled += ch;
+      maxLength++;
+      break;
+    }
+  }
+  return maxLength < MAX_DATE_BUFFER_LENGTH;
+}
+
+static inline char *put_2digits(char *p, int n) {
+  *p++ = '0' + n / 10;
+  *p++ = '0' + n % 10;
+  return p;
+}
+
+static inline char *put_string(char *p, const char *s) {
+  while (*s) *p++ = *s++;
+  return p;
+}
+
+String DateTime::Format(CStrRef format, int64 timestamp, bool utc) {
+  if (format.empty()) {
+    throw ArgumentMissingException("format");
+  }
+
+  DateCache &cache = *s_date_cache;
+  std::string key(format.data(), format.size());
+  hphp_string_map<std::string>::const_iterator iter = cache.Formats.find(key);
+  if (iter == cache.Formats.end()) {
+    std::string compiled;
+    if (!compile_date_format(format, compiled)) {
+      return DateTime(timestamp, utc).toString(format, false);
+    }
+    if (cache.Formats.size() >= MAX_CACHED_DATE_FORMATS) {
+      cache.Formats.clear();
+    }
+    iter = cache.Formats.insert(make_pair(key, compiled)).first;
+  }
+  const std::string &compiled = iter->second;
+
+  BrokenDownTime &t = utc ? cache.Utc : cache.Local;
+  static const std::string s_utc("UTC");
+  const std::string &zone = utc ? s_utc : cache.currentZone();
+  if (!t.Valid || t.TimeStamp != timestamp || t.Zone != zone) {
+    DateTime dt(timestamp, utc);
+    t.Valid = true;
+    t.TimeStamp = timestamp;
+    t.Zone = zone;
+    t.Year = dt.year();
+    t.Month = dt.month();
+    t.Day = dt.day();
+    t.Hour = dt.hour();
+    t.Minute = dt.minute();
+    t.Second = dt.second();
+    t.Dow = dt.dow();
+    t.WeekdayName = dt.weekdayName();
+    t.ShortWeekdayName = dt.shortWeekdayName();
+    t.Doy = dt.doy();
+    t.IsoWeek = dt.isoWeek();
+    t.IsoYear = dt.isoYear();
+    t.IsoDow = dt.isoDow();
+    t.Beat = dt.beat();
+    if (utc) {
+      t.Offset = 0;
+      t.Dst = false;
+      t.Abbr = "GMT";
+      t.Name = "UTC";
+    } else {
+      t.Offset = dt.m_tz->offset(timestamp);
+      t.Dst = dt.m_tz->dst(timestamp);
+      t.Abbr = dt.m_tz->abbr().data();
+      t.Name = dt.m_tz->name().data();
+    }
+  }
+
+  char buf[MAX_DATE_BUFFER_LENGTH];
+  char *p = buf;
+  bool rfc_colon = false;
+  int hour12 = (t.Hour % 12) ? t.Hour % 12 : 12;
+  for (unsigned int i = 0; i < compiled.size(); i++) {
+    char ch = compiled[i];
+    if (ch) {
+      *p++ = ch;
+      continue;
+    }
+    switch (compiled[++i]) {
+    case 'd': p = put_2digits(p, t.Day); break;
+    case 'D': p = put_string(p, t.ShortWeekdayName); break;
+    case 'j': p += sprintf(p, "%d", t.Day); break;
+    case 'l': p = put_string(p, t.WeekdayName); break;
+    case 'S': p = put_string(p, OrdinalSuffix(t.Day)); break;
+    case 'w': p += sprintf(p, "%d", t.Dow); break;
+    case 'N': p += sprintf(p, "%d", t.IsoDow); break;
+    case 'z': p += sprintf(p, "%d", t.Doy); break;
+    case 'W': p += sprintf(p, "%02d", t.IsoWeek); break;
+    case 'o': p += sprintf(p, "%d", t.IsoYear); break;
+    case 'F': p = put_string(p, MonthNames[t.Month - 1]); break;
+    case 'm': p = put_2digits(p, t.Month); break;
+    case 'M': p = put_string(p, ShortMonthNames[t.Month - 1]); break;
+    case 'n': p += sprintf(p, "%d", t.Month); break;
+    case 't': p += sprintf(p, "%d", DaysInMonth(t.Year, t.Month)); break;
+    case 'L': *p++ = IsLeap(t.Year) ? '1' : '0'; break;
+    case 'y': p += sprintf(p, "%02d", t.Year % 100); break;
+    case 'Y':
+      p += sprintf(p, "%s%04d", t.Year < 0 ? "-" : "", abs(t.Year));
+      break;
+    case 'a': p = put_string(p, t.Hour >= 12 ? "pm" : "am"); break;
+    case 'A': p = put_string(p, t.Hour >= 12 ? "PM" : "AM"); break;
+    case 'B': p += sprintf(p, "%03d", t.Beat); break;
+    case 'g': p += sprintf(p, "%d", hour12); break;
+    case 'G': p += sprintf(p, "%d", t.Hour); break;
+    case 'h': p = put_2digits(p, hour12); break;
+    case 'H': p = put_2digits(p, t.Hour); break;
+    case 'i': p = put_2digits(p, t.Minute); break;
+    case 's': p = put_2digits(p, t.Second); break;
+    case 'u': p = put_string(p, "000000"); break;
+    case 'I': *p++ = t.Dst ? '1' : '0'; break;
+    case 'P': rfc_colon = true; /* break intentionally missing */
+    case 'O':
+      if (utc) {
+        p += sprintf(p, "+0%s0", rfc_colon ? ":" : "");
+      } else {
+        p += sprintf(p, "%c%02d%s%02d",
+                     (t.Offset < 0 ? '-' : '+'), abs(t.Offset / 3600),
+                     rfc_colon ? ":" : "", abs((t.Offset % 3600) / 60));
+      }
+      break;
+    case 'T': p = put_string(p, t.Abbr.c_str()); break;
+    case 'e': p = put_string(p, t.Name.c_str()); break;
+    case 'Z': p += sprintf(p, "%d", t.Offset); break;
+    case 'c':
+      p += sprintf(p, "%04d-%02d-%02dT%02d:%02d:%02d",
+                   t.Year, t.Month, t.Day, t.Hour, t.Minute, t.Second);
+      if (utc) {
+        p = put_string(p, "+0:0");
+      } else {
+        p += sprintf(p, "%c%02d:%02d", (t.Offset < 0 ? '-' : '+'),
+                     abs(t.Offset / 3600), abs((t.Offset % 3600) / 60));
+      }
+      break;
+    case 'r':
+      p += sprintf(p, "%3s, %02d %3s %04d %02d:%02d:%02d",
+                   t.ShortWeekdayName, t.Day,
+                   ShortMonthNames[t.Month - 1], t.Year,
+                   t.Hour, t.Minute, t.Second);
+      if (utc) {
+        p = put_string(p, " +00");
+      } else {
+        p += sprintf(p, " %c%02d%02d", (t.Offset < 0 ? '-' : '+'),
+                     abs(t.Offset / 3600), abs((t.Offset % 3600) / 60));
+      }
+      break;
+    case 'U': p += sprintf(p, "%lld", timestamp); break;
+    default:
+      ASSERT(false);
+      break;
+    }
+  }
+  return String(buf, p - buf, CopyString);
+}
+
+/**
+ * Reads exactly "len" digits at "s" into "value".
+ */
+static bool read_digits(const char *s, int len, int &value) {
+  value = 0;
+  for (int i = 0; i < len; i++) {
+    if (s[i] < '0' || s[i] > '9') return false;
+    value = value * 10 + (s[i] - '0');
+  }
+  return true;
+}
+
+bool DateTime::ParseCommon(CStrRef input, int64 timestamp, int64 &ret) {
+  const char *s = input.data();
+  int len = input.size();
+
+  if (len == 3 && strcmp(s, "now") == 0) {
+    ret = timestamp;
+    return true;
+  }
+
+  if (len >= 2 && len <= 19 && s[0] == '@') {
+    int i = 1;
+    bool negative = s[i] == '-';
+    if (negative) i++;
+    if (i == len) return false;
+    int64 value = 0;
+    for (; i < len; i++) {
+      if (s[i] < '0' || s[i] > '9') return false;
+      value = value * 10 + (s[i] - '0');
+    }
+    ret = negative ? -value : value;
+    return true;
+  }
+
+  // "YYYY-MM-DD" or "YYYY-MM-DD HH:MM:SS", in current timezone
+  if (len != 10 && len != 19) return false;
+  int y, m, d, h = 0, i = 0, sec = 0;
+  if (!read_digits(s, 4, y) || s[4] != '-' ||
+      !read_digits(s + 5, 2, m) || s[7] != '-' ||
+      !read_digits(s + 8, 2, d)) {
+    return false;
+  }
+  if (len == 19 &&
+      (s[10] != ' ' || !read_digits(s + 11, 2, h) || s[13] != ':' ||
+       !read_digits(s + 14, 2, i) || s[16] != ':' ||
+       !read_digits(s + 17, 2, sec))) {
+    return false;
+  }
+  if (m < 1 || m > 12 || d < 1 || d > 31 || h > 23 || i > 59 || sec > 59) {
+    return false;
+  }
+
+  const std::string &zone = s_date_cache->currentZone();
+  TimeZoneInfo tzi = TimeZone::GetTimeZoneInfo(String(zone.data(), zone.size(),
+                                                      AttachLiteral));
+  if (!tzi) return false;
+
+  timelib_time t;
+  memset(&t, 0, sizeof(t));
+  t.y = y;
+  t.m = m;
+  t.d = d;
+  t.h = h;
+  t.i = i;
+  t.s = sec;
+  t.tz_info = tzi.get();
+  t.zone_type = TIMELIB_ZONETYPE_ID;
+  t.is_localtime = 1;
+  timelib_update_ts(&t, tzi.get());
+
+  int error;
+  ret = timelib_date_to_int(&t, &error);
+  return !error;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // sun
 
@@ -218,6 +218,20 @@ public:
   static Array Parse(CStrRef datetime);
   static Array Parse(CStrRef ts, CStrRef format);
 
+  /**
+   * date()/gmdate() without creating a DateTime object. The broken-down time
+   * of the last timestamp and timezone, and pre-parsed format strings are
+   * cached per thread, so repeated calls within the same second only render.
+   */
+  static String Format(CStrRef format, int64 timestamp, bool utc = false);
+
+  /**
+   * strtotime() for "now", "@<timestamp>", "YYYY-MM-DD" and
+   * "YYYY-MM-DD HH:MM:SS" without going through timelib's parser. Returns
+   * false for any other input, which then needs fromString().
+   */
+  static bool ParseCommon(CStrRef input, int64 timestamp, int64 &ret);
+
 public:
   // constructor
   DateTime();
@@ -20,6 +20,7 @@
 #include <cpp/base/execution_context.h>
 #include <cpp/base/builtin_functions.h>
 #include <util/logger.h>
+#include <tbb/concurrent_hash_map.h>
 
 namespace HPHP {
 
@@ -27,20 +28,23 @@ IMPLEMENT_OBJECT_ALLOCATION(TimeZone);
 ///////////////////////////////////////////////////////////////////////////////
 // statics
 
+/**
+ * Parsed timezones are immutable once loaded, so they are shared by all
+ * threads. Each thread keeps its own map of the zones it has used, which
+ * makes repeated lookups lock-free; only a thread's first lookup of a zone
+ * goes to the process-wide map, and only the very first one parses tzdb.
+ */
+typedef tbb::concurrent_hash_map<std::string, TimeZoneInfo> TimeZoneInfoMap;
+static TimeZoneInfoMap s_timezone_cache;
+
 class TimeZoneData {
 public:
-  TimeZoneData() : Database(NULL) {}
-
-  const timelib_tzdb *Database;
   MapStringToTimeZoneInfo Cache;
 };
 static ThreadLocal<TimeZoneData> s_timezone_data;
 
 const timelib_tzdb *TimeZone::GetDatabase() {
-  const timelib_tzdb *&Database = s_timezone_data->Database;
-  if (Database == NULL) {
-    Database = timelib_builtin_db();
-  }
+  static const timelib_tzdb *Database = timelib_builtin_db();
   return Database;
 }
 
@@ -52,14 +56,40 @@ TimeZoneInfo TimeZone::GetTimeZoneInfo(CStrRef name) {
     return iter->second;
   }
 
-  TimeZoneInfo tzi(timelib_parse_tzfile((char *)name.data(), GetDatabase()),
-                   tzinfo_deleter());
+  TimeZoneInfo tzi;
+  {
+    TimeZoneInfoMap::const_accessor acc;
+    if (s_timezone_cache.find(acc, name.data())) {
+      tzi = acc->second;
+    }
+  }
+  if (!tzi) {
+    TimeZoneInfoMap::accessor acc;
+    if (s_timezone_cache.insert(acc, name.data())) {
+      acc->second = TimeZoneInfo(timelib_parse_tzfile((char *)name.data(),
+                                                      GetDatabase()),
+                                 tzinfo_deleter());
+    }
+    tzi = acc->second;
+    if (!tzi) {
+      // invalid names are not worth keeping around
+      s_timezone_cache.erase(acc);
+    }
+  }
   if (tzi) {
     Cache[name.data()] = tzi;
   }
   return tzi;
 }
 
+void TimeZone::Preload(const std::vector<std::string> &names) {
+  for (unsigned int i = 0; i < names.size(); i++) {
+    if (!GetTimeZoneInfo(names[i])) {
+      Logger::Warning("Unable to preload timezone '%s'", names[i].c_str());
+    }
+  }
+}
+
 bool TimeZone::IsValid(CStrRef name) {
   return timelib_timezone_id_is_valid((char*)name.data(), GetDatabase());
 }
@@ -55,6 +55,12 @@ public:
   static String AbbreviationToName(String abbr, int utcoffset = -1,
                                    bool isdst = true);
 
+  /**
+   * Parses the named timezones into the process-wide cache, so that no
+   * request pays for the first lookup of a configured zone.
+   */
+  static void Preload(const std::vector<std::string> &names);
+
 public:
   /**
    * Constructing a timezone object by name or a raw pointer (internal).
@@ -25,6 +25,9 @@
 #include <cpp/base/array/map_string.h>
 #include <cpp/base/array/map_variant.h>
 #include <cpp/base/array/empty_array.h>
+#include <cpp/base/array/zend_array.h>
+#include <cpp/base/array/hphp_array.h>
+#include <cpp/base/array/value_index.h>
 #include <cpp/base/shared/shared_map.h>
 #include <lib/system/gen/php/classes/stdclass.h>
 #include <cpp/base/variable_serializer.h>
@@ -144,11 +147,27 @@ Array Array::diffImpl(CArrRef array, bool by_key, bool by_value, bool match,
   ASSERT(by_key || key_cmp_function == NULL);
   ASSERT(by_value || value_cmp_function == NULL);
 
+  Array ret = Array::Create();
+  if (!by_key && !value_cmp_function) {
+    // Fast case: values compared by their string forms, so a hash set of
+    // them answers every lookup without sorting
+    ValueIndex index(true);
+    for (ArrayIter iter(array); iter; ++iter) {
+      index.add(iter.second());
+    }
+    for (ArrayIter iter(*this); iter; ++iter) {
+      Variant value = iter.second();
+      if (index.containsString(value) == match) {
+        ret.set(iter.first(), value);
+      }
+    }
+    return ret;
+  }
+
   if (!value_cmp_function) {
     value_cmp_function = SortStringAscending;
   }
 
-  Array ret = Array::Create();
   if (by_key && !key_cmp_function) {
     // Fast case
     for (ArrayIter iter(*this); iter; ++iter) {
@@ -490,6 +509,10 @@ CVarRef Array::set(CVarRef key, CVarRef v, int64 prehash /* = -1 */) {
 
 bool Array::valueExists(CVarRef search_value,
                         bool strict /* = false */) const {
+  bool found;
+  if (m_px && m_px->valueIndexLookup(search_value, strict, found)) {
+    return found;
+  }
   for (ArrayIter iter(*this); iter; ++iter) {
     if ((strict && iter.second().same(search_value)) ||
         (!strict && iter.second().equal(search_value))) {
@@ -652,6 +675,12 @@ void Array::unserialize(VariableUnserializer *unserializer) {
   if (size == 0) {
     operator=(Create());
   } else {
+    // the unserializer keeps pointers to the elements for back references,
+    // so they must not move while the array fills up; every element takes
+    // more than a byte, which bounds how many a bogus size can reserve
+    int64 avail = in.rdbuf()->in_avail();
+    if (avail < 0) avail = 0;
+    operator=(ArrayData::CreateWithCapacity(avail < size ? avail : size));
     for (int64 i = 0; i < size; i++) {
       Variant key = unserializer->unserializeKey();
       Variant &value = lvalAt(key);
@@ -837,8 +866,215 @@ static void _sort(vector<int> &indices, CArrRef source, Array::SortData &opaque,
   zend_qsort(&indices[0], count, sizeof(int), array_compare_func, &opaque);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// specialized sorting
+
+/**
+ * When all values (or all keys) are integers, or all are strings, and one of
+ * the builtin comparators is used, sorting doesn't need to go through
+ * PFUNC_CMP on Variants. Integers are radix sorted on their bits, strings are
+ * compared by a cached 8-byte prefix before falling back to a full compare.
+ * Only orders without observable ties are specialized: sort() and rsort()
+ * renumber, and keys are unique for ksort() and krsort().
+ */
+struct IntSortElem {
+  uint64 key; // with sign bit flipped, so unsigned order is signed order
+  int index;
+};
+
+struct StringSortElem {
+  uint64 prefix;
+  int index;
+};
+
+static bool int_sort_elem_less(const IntSortElem &e1, const IntSortElem &e2) {
+  return e1.key < e2.key;
+}
+
+#define INT_SORT_SIGN_BIT 0x8000000000000000ULL
+#define RADIX_SORT_THRESHOLD 64
+
+static void radix_sort(vector<IntSortElem> &elems) {
+  int count = elems.size();
+  if (count < RADIX_SORT_THRESHOLD) {
+    std::sort(elems.begin(), elems.end(), int_sort_elem_less);
+    return;
+  }
+
+  vector<IntSortElem> buffer(count);
+  IntSortElem *from = &elems[0];
+  IntSortElem *to = &buffer[0];
+  for (int shift = 0; shift < 64; shift += 8) {
+    int offsets[257];
+    memset(offsets, 0, sizeof(offsets));
+    for (int i = 0; i < count; i++) {
+      offsets[((from[i].key >> shift) & 0xff) + 1]++;
+    }
+    if (offsets[((from[0].key >> shift) & 0xff) + 1] == count) {
+      continue; // same byte everywhere, e.g. high bytes of small numbers
+    }
+    for (int b = 1; b < 257; b++) {
+      offsets[b] += offsets[b - 1];
+    }
+    for (int i = 0; i < count; i++) {
+      to[offsets[(from[i].key >> shift) & 0xff]++] = from[i];
+    }
+    std::swap(from, to);
+  }
+  if (from != &elems[0]) {
+    memcpy(&elems[0], from, count * sizeof(IntSortElem));
+  }
+}
+
+/**
+ * Big-endian first 8 bytes, zero padded. With "cstr", bytes after an
+ * embedded NUL are ignored the way strcmp() does.
+ */
+static uint64 string_sort_prefix(const char *s, int len, bool cstr) {
+  uint64 prefix = 0;
+  for (int i = 0; i < 8; i++) {
+    unsigned char ch = i < len ? s[i] : 0;
+    if (cstr && ch == 0) len = i;
+    prefix = (prefix << 8) | ch;
+  }
+  return prefix;
+}
+
+class StringSortLess {
+public:
+  StringSortLess(const vector<String> &strs, bool cstr)
+    : m_strs(strs), m_cstr(cstr) {}
+
+  bool operator()(const StringSortElem &e1, const StringSortElem &e2) const {
+    if (e1.prefix != e2.prefix) return e1.prefix < e2.prefix;
+    CStrRef s1 = m_strs[e1.index];
+    CStrRef s2 = m_strs[e2.index];
+    if (m_cstr) {
+      return strcmp(s1.data(), s2.data()) < 0;
+    }
+    int len1 = s1.size();
+    int len2 = s2.size();
+    int ret = memcmp(s1.data(), s2.data(), len1 < len2 ? len1 : len2);
+    return ret ? ret < 0 : len1 < len2;
+  }
+
+private:
+  const vector<String> &m_strs;
+  bool m_cstr;
+};
+
+static bool sort_specialized(Array &arr, Array::PFUNC_CMP cmp_func,
+                             bool by_key) {
+  bool regular = cmp_func == Array::SortRegularAscending ||
+                 cmp_func == Array::SortRegularDescending;
+  bool numeric = cmp_func == Array::SortNumericAscending ||
+                 cmp_func == Array::SortNumericDescending;
+  bool byString = cmp_func == Array::SortStringAscending ||
+                cmp_func == Array::SortStringDescending;
+  if (!regular && !numeric && !byString) return false;
+  bool descending = cmp_func == Array::SortRegularDescending ||
+                    cmp_func == Array::SortNumericDescending ||
+                    cmp_func == Array::SortStringDescending;
+
+  ArrayData *data = arr.get();
+  int count = arr.size();
+  if (count < 2) return false;
+
+  // find out whether elements are all integers or all strings
+  vector<ssize_t> positions;
+  positions.reserve(count);
+  vector<int64> ints;
+  vector<String> strs;
+  bool isInt = false;
+  bool isString = false;
+  for (ssize_t pos = data->iter_begin(); pos != ArrayData::invalid_index;
+       pos = data->iter_advance(pos)) {
+    Variant v = by_key ? data->getKey(pos) : data->getValue(pos);
+    switch (v.getType()) {
+    case KindOfByte:
+    case KindOfInt16:
+    case KindOfInt32:
+    case KindOfInt64:
+      if (isString) return false;
+      isInt = true;
+      ints.push_back(v.toInt64());
+      break;
+    case LiteralString:
+    case KindOfString:
+      if (isInt) return false;
+      isString = true;
+      strs.push_back(v.toString());
+      // regular comparison compares numeric strings as numbers
+      if (regular && strs.back().isNumeric()) return false;
+      break;
+    default:
+      return false;
+    }
+    if (isInt && byString) return false; // integers as strings: "10" < "9"
+    if (isString && numeric) return false;
+    positions.push_back(pos);
+  }
+
+  vector<int> indices;
+  indices.reserve(count);
+  if (isInt) {
+    vector<IntSortElem> elems(count);
+    for (int i = 0; i < count; i++) {
+      elems[i].key = (uint64)ints[i] ^ INT_SORT_SIGN_BIT;
+      elems[i].index = i;
+    }
+    radix_sort(elems);
+    for (int i = 0; i < count; i++) {
+      indices.push_back(elems[i].index);
+    }
+  } else {
+    vector<StringSortElem> elems(count);
+    for (int i = 0; i < count; i++) {
+      elems[i].prefix = string_sort_prefix(strs[i].data(), strs[i].size(),
+                                           byString);
+      elems[i].index = i;
+    }
+    std::sort(elems.begin(), elems.end(), StringSortLess(strs, byString));
+    for (int i = 0; i < count; i++) {
+      indices.push_back(elems[i].index);
+    }
+  }
+  if (descending) {
+    std::reverse(indices.begin(), indices.end());
+  }
+
+  Array sorted;
+  if (!RuntimeOption::UseZendArray) {
+    sorted = Array::Create();
+  } else if (RuntimeOption::UseHphpArray) {
+    sorted = NEW(HphpArray)(count);
+  } else {
+    sorted = NEW(ZendArray)(count);
+  }
+  for (int i = 0; i < count; i++) {
+    int index = indices[i];
+    if (!by_key) {
+      if (isInt) {
+        sorted.append(ints[index]);
+      } else {
+        sorted.append(strs[index]);
+      }
+    } else if (isInt) {
+      sorted.set(ints[index], data->getValue(positions[index]));
+    } else {
+      sorted.set(strs[index], data->getValue(positions[index]));
+    }
+  }
+  arr = sorted;
+  return true;
+}
+
 void Array::sort(PFUNC_CMP cmp_func, bool by_key, bool renumber,
                  const void *data /* = NULL */) {
+  if (by_key != renumber && sort_specialized(*this, cmp_func, by_key)) {
+    return;
+  }
+
   Array sorted = Array::Create();
   SortData opaque;
   vector<int> indices;
@@ -2508,7 +2508,8 @@ void Variant::serialize(VariableSerializer *serializer,
                         bool isArrayKey /* = false */) const {
   if (m_type == KindOfVariant) {
     // Ugly, but behavior is different for serialize
-    if (serializer->getType() == VariableSerializer::Serialize) {
+    if (serializer->getType() == VariableSerializer::Serialize ||
+        serializer->getType() == VariableSerializer::Binary) {
       if (serializer->incNestedLevel(m_data.pvar)) {
         serializer->writeOverflow(m_data.pvar);
       } else {
@@ -0,0 +1,158 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010 Facebook, Inc. (http://www.facebook.com)          |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include <cpp/base/util/crc32.h>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Slice-by-8: table[0] is the classic byte-at-a-time table, and table[k][b]
+ * is the CRC of byte b followed by k zero bytes, so eight table lookups fold
+ * eight input bytes at once.
+ */
+class Crc32Tables {
+public:
+  Crc32Tables(uint32 poly, bool reflected) {
+    for (int i = 0; i < 256; i++) {
+      uint32 crc;
+      if (reflected) {
+        crc = i;
+        for (int j = 0; j < 8; j++) {
+          crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+        }
+      } else {
+        crc = (uint32)i << 24;
+        for (int j = 0; j < 8; j++) {
+          crc = (crc & 0x80000000) ? (crc << 1) ^ poly : crc << 1;
+        }
+      }
+      table[0][i] = crc;
+    }
+    for (int i = 0; i < 256; i++) {
+      for (int k = 1; k < 8; k++) {
+        uint32 prev = table[k - 1][i];
+        table[k][i] = reflected ?
+          (prev >> 8) ^ table[0][prev & 0xff] :
+          (prev << 8) ^ table[0][prev >> 24];
+      }
+    }
+  }
+
+  uint32 table[8][256];
+};
+
+static Crc32Tables s_crc32(0xEDB88320, true);
+static Crc32Tables s_crc32_bzip2(0x04C11DB7, false);
+static Crc32Tables s_crc32c(0x82F63B78, true);
+
+static inline uint32 load_le32(const unsigned char *p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32)p[3] << 24);
+}
+
+static inline uint32 load_be32(const unsigned char *p) {
+  return ((uint32)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+static uint32 crc32_reflected(const Crc32Tables &tables, uint32 crc,
+                              const unsigned char *p, size_t len) {
+  const uint32 (*t)[256] = tables.table;
+  for (; len >= 8; p += 8, len -= 8) {
+    uint32 one = load_le32(p) ^ crc;
+    uint32 two = load_le32(p + 4);
+    crc = t[7][one & 0xff] ^ t[6][(one >> 8) & 0xff] ^
+      t[5][(one >> 16) & 0xff] ^ t[4][one >> 24] ^
+      t[3][two & 0xff] ^ t[2][(two >> 8) & 0xff] ^
+      t[1][(two >> 16) & 0xff] ^ t[0][two >> 24];
+  }
+  for (; len; p++, len--) {
+    crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xff];
+  }
+  return crc;
+}
+
+uint32 crc32_update(uint32 state, const void *data, size_t len) {
+  return crc32_reflected(s_crc32, state, (const unsigned char *)data, len);
+}
+
+uint32 crc32_bzip2_update(uint32 state, const void *data, size_t len) {
+  const uint32 (*t)[256] = s_crc32_bzip2.table;
+  const unsigned char *p = (const unsigned char *)data;
+  uint32 crc = state;
+  for (; len >= 8; p += 8, len -= 8) {
+    uint32 one = load_be32(p) ^ crc;
+    uint32 two = load_be32(p + 4);
+    crc = t[7][one >> 24] ^ t[6][(one >> 16) & 0xff] ^
+      t[5][(one >> 8) & 0xff] ^ t[4][one & 0xff] ^
+      t[3][two >> 24] ^ t[2][(two >> 16) & 0xff] ^
+      t[1][(two >> 8) & 0xff] ^ t[0][two & 0xff];
+  }
+  for (; len; p++, len--) {
+    crc = (crc << 8) ^ t[0][(crc >> 24) ^ *p];
+  }
+  return crc;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// crc32c
+
+#if defined(__x86_64__)
+
+static bool has_sse42() {
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    return false;
+  }
+  return (ecx & bit_SSE4_2) != 0;
+}
+
+static bool s_crc32c_hw = has_sse42();
+
+static uint32 crc32c_hw(uint32 state, const unsigned char *p, size_t len) {
+  uint64 crc = state;
+  for (; len && ((uintptr_t)p & 7); p++, len--) {
+    uint32 c32 = crc;
+    __asm__("crc32b %1, %0" : "+r"(c32) : "rm"(*p));
+    crc = c32;
+  }
+  for (; len >= 8; p += 8, len -= 8) {
+    __asm__("crc32q %1, %0" : "+r"(crc) : "rm"(*(const uint64 *)p));
+  }
+  uint32 c32 = crc;
+  for (; len; p++, len--) {
+    __asm__("crc32b %1, %0" : "+r"(c32) : "rm"(*p));
+  }
+  return c32;
+}
+
+#endif
+
+uint32 crc32c_update(uint32 state, const void *data, size_t len) {
+  const unsigned char *p = (const unsigned char *)data;
+#if defined(__x86_64__)
+  if (s_crc32c_hw) {
+    return crc32c_hw(state, p, len);
+  }
+#endif
+  return crc32_reflected(s_crc32c, state, p, len);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
@@ -0,0 +1,53 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010 Facebook, Inc. (http://www.facebook.com)          |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __HPHP_CRC32_H__
+#define __HPHP_CRC32_H__
+
+#include <util/base.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * CRC-32 checksums, continuing from a running state: start with 0xFFFFFFFF
+ * and invert the last state to get the checksum, e.g.
+ *
+ *   uint32 crc = crc32_update(0xFFFFFFFF, data, len) ^ 0xFFFFFFFF;
+ *
+ * Software versions process 8 bytes per step with slice-by-8 tables.
+ */
+
+/**
+ * Reflected IEEE 802.3 polynomial: crc32() and hash("crc32b").
+ */
+uint32 crc32_update(uint32 state, const void *data, size_t len);
+
+/**
+ * Non-reflected IEEE 802.3 polynomial, as in bzip2: hash("crc32").
+ */
+uint32 crc32_bzip2_update(uint32 state, const void *data, size_t len);
+
+/**
+ * Castagnoli polynomial: hash("crc32c"). Uses the SSE4.2 crc32 instruction
+ * when the CPU has it.
+ */
+uint32 crc32c_update(uint32 state, const void *data, size_t len);
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __HPHP_CRC32_H__
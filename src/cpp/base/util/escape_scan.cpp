@@ -0,0 +1,136 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010 Facebook, Inc. (http://www.facebook.com)          |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include <cpp/base/util/escape_scan.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef __SSE2__
+
+#define LOAD16(p) _mm_loadu_si128((const __m128i *)(p))
+#define SPLAT(c)  _mm_set1_epi8((char)(c))
+#define MATCH(v, c) _mm_cmpeq_epi8(v, SPLAT(c))
+
+// unsigned lo <= v <= hi for each byte
+static inline __m128i in_range(__m128i v, char lo, char hi) {
+  return _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(v, SPLAT(lo)), v),
+                       _mm_cmpeq_epi8(_mm_min_epu8(v, SPLAT(hi)), v));
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+int escape_scan_html(const char *s, int len, bool dq, bool sq) {
+  int i = 0;
+#ifdef __SSE2__
+  // a disabled quote is compared against '&' again, adding no new matches
+  char q1 = dq ? '"' : '&';
+  char q2 = sq ? '\'' : '&';
+  for (; i + 16 <= len; i += 16) {
+    __m128i v = LOAD16(s + i);
+    __m128i m = _mm_or_si128(_mm_or_si128(MATCH(v, '&'), MATCH(v, '<')),
+                             _mm_or_si128(MATCH(v, '>'),
+                                          _mm_or_si128(MATCH(v, q1),
+                                                       MATCH(v, q2))));
+    int mask = _mm_movemask_epi8(m);
+    if (mask) return i + __builtin_ctz(mask);
+  }
+#endif
+  for (; i < len; i++) {
+    switch (s[i]) {
+    case '&': case '<': case '>': return i;
+    case '"':  if (dq) return i; break;
+    case '\'': if (sq) return i; break;
+    default: break;
+    }
+  }
+  return len;
+}
+
+int escape_scan_sql(const char *s, int len) {
+  int i = 0;
+#ifdef __SSE2__
+  for (; i + 16 <= len; i += 16) {
+    __m128i v = LOAD16(s + i);
+    __m128i m = _mm_or_si128(_mm_or_si128(MATCH(v, '\0'), MATCH(v, '\'')),
+                             _mm_or_si128(MATCH(v, '"'), MATCH(v, '\\')));
+    int mask = _mm_movemask_epi8(m);
+    if (mask) return i + __builtin_ctz(mask);
+  }
+#endif
+  for (; i < len; i++) {
+    switch (s[i]) {
+    case '\0': case '\'': case '"': case '\\': return i;
+    default: break;
+    }
+  }
+  return len;
+}
+
+static inline bool url_safe(unsigned char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+    (c >= '0' && c <= '9') || c == '-' || c == '.' || c == '_';
+}
+
+int escape_scan_url(const char *s, int len) {
+  int i = 0;
+#ifdef __SSE2__
+  for (; i + 16 <= len; i += 16) {
+    __m128i v = LOAD16(s + i);
+    __m128i safe =
+      _mm_or_si128(_mm_or_si128(in_range(v, 'a', 'z'), in_range(v, 'A', 'Z')),
+                   _mm_or_si128(in_range(v, '0', '9'),
+                                _mm_or_si128(in_range(v, '-', '.'),
+                                             MATCH(v, '_'))));
+    int mask = _mm_movemask_epi8(safe) ^ 0xffff;
+    if (mask) return i + __builtin_ctz(mask);
+  }
+#endif
+  for (; i < len; i++) {
+    if (!url_safe(s[i])) return i;
+  }
+  return len;
+}
+
+int escape_scan_json(const char *s, int len) {
+  int i = 0;
+#ifdef __SSE2__
+  for (; i + 16 <= len; i += 16) {
+    __m128i v = LOAD16(s + i);
+    // signed compare catches both control characters and bytes >= 0x80
+    __m128i m = _mm_or_si128(_mm_cmplt_epi8(v, SPLAT(' ')),
+                             _mm_or_si128(MATCH(v, '"'),
+                                          _mm_or_si128(MATCH(v, '\\'),
+                                                       MATCH(v, '/'))));
+    int mask = _mm_movemask_epi8(m);
+    if (mask) return i + __builtin_ctz(mask);
+  }
+#endif
+  for (; i < len; i++) {
+    unsigned char c = s[i];
+    if (c < ' ' || c >= 0x80 || c == '"' || c == '\\' || c == '/') return i;
+  }
+  return len;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
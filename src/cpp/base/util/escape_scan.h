@@ -0,0 +1,59 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010 Facebook, Inc. (http://www.facebook.com)          |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __HPHP_ESCAPE_SCAN_H__
+#define __HPHP_ESCAPE_SCAN_H__
+
+#include <util/base.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Byte scanners shared by the string escaping functions. Each one returns the
+ * offset of the first byte in s[0, len) that its encoder has to rewrite, or
+ * len when there is none. Encoders use them to hand back the original string
+ * when nothing needs escaping, to size their output exactly, and to copy the
+ * clean runs between special bytes with memcpy().
+ *
+ * With SSE2 (always there on x86-64) 16 bytes are tested per iteration; the
+ * remaining tail and other platforms go one byte at a time.
+ */
+
+/**
+ * htmlspecialchars(): & < > and, depending on quote style, " and '.
+ */
+int escape_scan_html(const char *s, int len, bool dq, bool sq);
+
+/**
+ * addslashes(): \0 ' " and backslash.
+ */
+int escape_scan_sql(const char *s, int len);
+
+/**
+ * urlencode() and rawurlencode(): anything other than [0-9A-Za-z._-].
+ */
+int escape_scan_url(const char *s, int len);
+
+/**
+ * json_encode() strings: " / backslash, control characters and non-ASCII.
+ */
+int escape_scan_json(const char *s, int len);
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __HPHP_ESCAPE_SCAN_H__
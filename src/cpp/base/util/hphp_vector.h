@@ -20,6 +20,7 @@
 #include <cpp/base/types.h>
 #include <cpp/base/type_string.h>
 #include <cpp/base/util/hphp_map_cell.h>
+#include <cpp/base/memory/size_class_allocator.h>
 
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
@@ -66,8 +67,8 @@ template<typename T> inline void copy(T **dest, T **src, int count) {
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
- * A vector that's using LinearMemoryAllocator. This also makes the following
- * assumptions:
+ * A vector that's using LinearMemoryAllocator and SizeClassAllocator. This
+ * also makes the following assumptions:
  *
  *  1. T is movable within the vector without hurting anything.
  *  2. new T has all bytes 0
@@ -84,7 +85,7 @@ public:
       HphpVectorFuncs::allocate((T*)m_data, m_count);
     } else {
       m_size = 4 * sizeof(T);
-      m_data = (char*)calloc(m_size, 1);
+      m_data = (char*)smart_calloc(m_size, 1);
     }
     m_bytes = m_count * sizeof(T);
   }
@@ -97,7 +98,7 @@ public:
   ~HphpVector() {
     if (m_data) {
       HphpVectorFuncs::deallocate((T*)m_data, m_count);
-      free(m_data);
+      smart_free(m_data);
     }
   }
 
@@ -108,10 +109,10 @@ public:
       int oldsize = m_size;
       for (m_size = 4; m_size < newsize; m_size <<= 1);
       if (m_data) {
-        m_data = (char*)realloc(m_data, m_size);
+        m_data = (char*)smart_realloc(m_data, m_size);
         memset(m_data + oldsize, 0, m_size - oldsize);
       } else {
-        m_data = (char*)calloc(m_size, 1);
+        m_data = (char*)smart_calloc(m_size, 1);
       }
     }
   }
@@ -241,21 +242,21 @@ public:
   void restore(const char *&data) {
     int s = *(int*)data;
     data += sizeof(int);
-    m_data = (char*)malloc(m_size);
+    m_data = (char*)smart_malloc(m_size);
     memcpy(m_data, data, s);
     data += s;
   }
   void sweep() {
     HphpVectorFuncs::sweep((T*)m_data, m_count);
-    free(m_data);
+    smart_free(m_data);
     m_data = NULL;
   }
 
 private:
   HphpVector(int, int) : m_data(NULL) {} // purely for swap
 
-  char *m_data;  // malloc-ed memory
-  int m_size;    // malloc-ed size
+  char *m_data;  // smart_malloc-ed memory
+  int m_size;    // smart_malloc-ed size
   int m_count;   // item count
   int m_bytes;   // always equal to m_count * sizeof(T)
 };
@@ -69,6 +69,9 @@ Variant VariableSerializer::serialize(CVarRef v, bool ret) {
 
 void VariableSerializer::write(bool v) {
   switch (m_type) {
+  case Binary:
+    m_out->put(v ? 'T' : 'F');
+    break;
   case PrintR:
     if (v) *m_out << 1;
     break;
@@ -112,6 +115,10 @@ void VariableSerializer::write(int64 v) {
   case Serialize:
     *m_out << "i:" << v << ';';
     break;
+  case Binary:
+    m_out->put('I');
+    writeVarint(((uint64)v << 1) ^ (uint64)(v >> 63));
+    break;
   default:
     ASSERT(false);
     break;
@@ -120,6 +127,10 @@ void VariableSerializer::write(int64 v) {
 
 void VariableSerializer::write(double v) {
   switch (m_type) {
+  case Binary:
+    m_out->put('D');
+    m_out->write((const char *)&v, sizeof(v));
+    break;
   case JSON:
     if (!isinf(v) && !isnan(v)) {
       char *buf;
@@ -239,11 +250,16 @@ void VariableSerializer::write(litstr v, int len /* = -1 */,
       *m_out << "\";";
     }
     break;
+  case Binary:
+    if (v == NULL) v = "";
+    if (len < 0) len = strlen(v);
+    writeBinaryString(v, len);
+    break;
   case JSON:
     {
       if (len < 0) len = strlen(v);
       char *escaped = string_json_escape(v, len, m_option);
-      *m_out << escaped;
+      m_out->write(escaped, len);
       free(escaped);
     }
     break;
@@ -289,6 +305,9 @@ void VariableSerializer::writeNull() {
   case Serialize:
     *m_out << "N;";
     break;
+  case Binary:
+    m_out->put('N');
+    break;
   case JSON:
     *m_out << "null";
     break;
@@ -326,6 +345,18 @@ void VariableSerializer::writeOverflow(void* ptr, bool isObject /* = false */) {
       }
     }
     break;
+  case Binary:
+    {
+      map<void*, int>::const_iterator iter = m_arrayIds.find(ptr);
+      ASSERT(iter != m_arrayIds.end());
+      if (isObject || wasRef) {
+        m_out->put(isObject ? 'r' : 'R');
+        writeVarint(iter->second);
+      } else {
+        m_out->put('N');
+      }
+    }
+    break;
   case JSON:
     *m_out << "null";
     break;
@@ -406,6 +437,15 @@ void VariableSerializer::writeArrayHeader(const ArrayData *arr, int size) {
       *m_out << "a:" << size << ":{";
     }
     break;
+  case Binary:
+    if (!m_objClass.empty()) {
+      m_out->put('O');
+      writeBinaryString(m_objClass.data(), m_objClass.size());
+    } else {
+      m_out->put('A');
+    }
+    writeVarint(size);
+    break;
   case JSON:
     if (info.is_vector) {
       *m_out << "[";
@@ -520,6 +560,7 @@ void VariableSerializer::writeArrayKey(const ArrayData *arr, CVarRef key) {
     }
     break;
   case Serialize:
+  case Binary:
     if (info.is_object) {
       writeSerializedProperty(key.toString(), info.class_info);
     } else {
@@ -543,7 +584,7 @@ void VariableSerializer::writeArrayKey(const ArrayData *arr, CVarRef key) {
 
 void VariableSerializer::writeArrayValue(const ArrayData *arr, CVarRef value) {
   // Do not count referenced values after the first
-  if (m_type == Serialize &&
+  if ((m_type == Serialize || m_type == Binary) &&
       !(value.isReferenced() &&
         m_arrayIds.find(value.getVariantData()) != m_arrayIds.end()))
     m_valueCount++;
@@ -594,6 +635,8 @@ void VariableSerializer::writeArrayFooter(const ArrayData *arr) {
   case Serialize:
     *m_out << '}';
     break;
+  case Binary:
+    break; // size was written in header
   case JSON:
     if (info.is_vector) {
       *m_out << "]";
@@ -609,6 +652,39 @@ void VariableSerializer::writeArrayFooter(const ArrayData *arr) {
   m_arrayInfos.pop_back();
 }
 
+void VariableSerializer::writeVarint(uint64 v) {
+  char buf[10];
+  int len = 0;
+  while (v >= 0x80) {
+    buf[len++] = (char)(v | 0x80);
+    v >>= 7;
+  }
+  buf[len++] = (char)v;
+  m_out->write(buf, len);
+}
+
+void VariableSerializer::writeBinaryString(const char *v, int len) {
+  if (len > BinaryMaxTableString) {
+    m_out->put('B');
+    writeVarint(len);
+    m_out->write(v, len);
+    return;
+  }
+
+  std::string key(v, len);
+  hphp_string_map<int>::const_iterator iter = m_strings.find(key);
+  if (iter != m_strings.end()) {
+    m_out->put('s');
+    writeVarint(iter->second);
+  } else {
+    int id = m_strings.size();
+    m_strings[key] = id;
+    m_out->put('S');
+    writeVarint(len);
+    m_out->write(v, len);
+  }
+}
+
 void VariableSerializer::indent() {
 
   for (int i = 0; i < m_indent; i++) {
@@ -630,6 +706,7 @@ void VariableSerializer::indent() {
   case DebugDump:
     return ++m_counts[ptr] >= m_maxCount;
   case Serialize:
+  case Binary:
     {
       int ct = ++m_counts[ptr];
       if (m_arrayIds.find(ptr) != m_arrayIds.end() &&
@@ -29,6 +29,22 @@ class ClassInfo;
  * Maintaining states during serialization of a variable. We use this single
  * class to uniformly serialize variables according to different formats:
  * print_r(), var_export(), var_dump(), debug_zval_dump() or serialize().
+ *
+ * Binary is a compact counterpart of Serialize that VariableUnserializer
+ * reads back. Each value starts with a one byte tag:
+ *
+ *   N, T, F            null, true, false
+ *   I <varint>         integer, zigzag encoded
+ *   D <8 bytes>        double, raw in host byte order
+ *   S <varint> <data>  string, added to string table
+ *   s <varint>         string table entry, counting from 0
+ *   B <varint> <data>  string too long for string table
+ *   A <varint>         array of that many key/value pairs
+ *   O <string> <varint> object of a class, with that many properties
+ *   r/R <varint>       same back-references as in Serialize format
+ *
+ * Keys, property names and class names are strings or integers encoded the
+ * same way, so repeated ones are written only once.
  */
 class VariableSerializer {
 public:
@@ -42,8 +58,14 @@ public:
     DebugDump,
     Serialize,
     JSON,
+    Binary,
   };
 
+  /**
+   * Strings longer than this are not worth looking up in string table.
+   */
+  static const int BinaryMaxTableString = 64;
+
   /**
    * Constructor.
    */
@@ -117,8 +139,12 @@ private:
   };
   std::vector<ArrayInfo> m_arrayInfos;
 
+  hphp_string_map<int> m_strings; // for Binary string table
+
   void writePropertyPrivacy(const char *prop, const ClassInfo *cls);
   void writeSerializedProperty(CStrRef prop, const ClassInfo *cls);
+  void writeVarint(uint64 v);
+  void writeBinaryString(const char *v, int len);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,208 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010 Facebook, Inc. (http://www.facebook.com)          |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include <cpp/base/variable_unserializer.h>
+#include <cpp/base/variable_serializer.h>
+#include <cpp/base/type_array.h>
+#include <cpp/base/type_object.h>
+#include <cpp/base/type_variant.h>
+#include <cpp/base/externals.h>
+#include <cpp/base/builtin_functions.h>
+#include <util/exception.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+Variant VariableUnserializer::unserialize() {
+  Variant v;
+  if (m_type == Binary) {
+    readBinary(v);
+    if (m_buf != m_end) {
+      throw Exception("%d trailing bytes", (int)(m_end - m_buf));
+    }
+  } else {
+    v.unserialize(this);
+  }
+  return v;
+}
+
+Variant VariableUnserializer::unserializeKey() {
+  m_key = true;
+  Variant v;
+  v.unserialize(this);
+  m_key = false;
+  return v;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Binary format, see VariableSerializer
+
+char VariableUnserializer::readTag() {
+  if (m_buf >= m_end) {
+    throw Exception("Unexpected end of data");
+  }
+  return *m_buf++;
+}
+
+uint64 VariableUnserializer::readVarint() {
+  uint64 v = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    unsigned char c = (unsigned char)readTag();
+    v |= (uint64)(c & 0x7f) << shift;
+    if ((c & 0x80) == 0) {
+      return v;
+    }
+  }
+  throw Exception("Malformed varint");
+}
+
+String VariableUnserializer::readBinaryString(char tag) {
+  switch (tag) {
+  case 'S':
+  case 'B':
+    {
+      uint64 len = readVarint();
+      if (len > (uint64)(m_end - m_buf)) {
+        throw Exception("String length %lld exceeds data", (int64)len);
+      }
+      String s(m_buf, len, CopyString);
+      m_buf += len;
+      if (tag == 'S') {
+        m_strings.push_back(s);
+      }
+      return s;
+    }
+  case 's':
+    {
+      uint64 id = readVarint();
+      if (id >= m_strings.size()) {
+        throw Exception("Invalid string id %lld", (int64)id);
+      }
+      return m_strings[id];
+    }
+  default:
+    break;
+  }
+  throw Exception("Expected a string but got '%c'", tag);
+}
+
+Variant VariableUnserializer::readBinaryKey() {
+  char tag = readTag();
+  if (tag == 'I') {
+    uint64 v = readVarint();
+    return (int64)(v >> 1) ^ -(int64)(v & 1);
+  }
+  return readBinaryString(tag);
+}
+
+void VariableUnserializer::readBinary(Variant &v) {
+  char tag = readTag();
+  if (tag != 'R') {
+    add(&v);
+  }
+
+  switch (tag) {
+  case 'N': v = null;  break;
+  case 'T': v = true;  break;
+  case 'F': v = false; break;
+  case 'I':
+    {
+      uint64 n = readVarint();
+      v = (int64)(n >> 1) ^ -(int64)(n & 1);
+    }
+    break;
+  case 'D':
+    {
+      double d;
+      if (m_end - m_buf < (int)sizeof(d)) {
+        throw Exception("Unexpected end of data");
+      }
+      memcpy(&d, m_buf, sizeof(d));
+      m_buf += sizeof(d);
+      v = d;
+    }
+    break;
+  case 'S':
+  case 's':
+  case 'B':
+    v = readBinaryString(tag);
+    break;
+  case 'r': v = get(readVarint());      break;
+  case 'R': v = ref(get(readVarint())); break;
+  case 'A':
+    {
+      uint64 size = readVarint();
+      if (size > (uint64)(m_end - m_buf)) {
+        throw Exception("Array size %lld exceeds data", (int64)size);
+      }
+      // add() keeps pointers to the elements, see Array::unserialize()
+      Array arr = ArrayData::CreateWithCapacity(size);
+      for (uint64 i = 0; i < size; i++) {
+        Variant key = readBinaryKey();
+        readBinary(arr.lvalAt(key));
+      }
+      v = arr;
+    }
+    break;
+  case 'O':
+    readBinaryObject(v);
+    break;
+  default:
+    throw Exception("Unknown type '%c'", tag);
+  }
+}
+
+void VariableUnserializer::readBinaryObject(Variant &v) {
+  String clsName = readBinaryString(readTag());
+
+  Object obj;
+  try {
+    obj = create_object(clsName.data(), Array::Create(), false);
+  } catch (ClassNotFoundException &e) {
+    obj = create_object("__PHP_Incomplete_Class", Array::Create(), false);
+    obj->o_set("__PHP_Incomplete_Class_Name", -1, clsName);
+  }
+  v = obj;
+
+  uint64 size = readVarint();
+  if (size > (uint64)(m_end - m_buf)) {
+    throw Exception("Object size %lld exceeds data", (int64)size);
+  }
+  for (uint64 i = 0; i < size; i++) {
+    String key = readBinaryKey().toString();
+    int subLen = 0;
+    if (key.charAt(0) == '\00') {
+      if (key.charAt(1) == '*') {
+        subLen = 3; // protected
+      } else {
+        int pos = key.find('\00', 1); // private, skipping class name
+        if (pos == String::npos) {
+          throw Exception("Mangled private object property");
+        }
+        subLen = pos + 1;
+      }
+    }
+    Variant &value = subLen != 0 ?
+      obj.o_lval(key.substr(subLen), -1).lval() :
+      obj.o_lval(key, -1).lval();
+    readBinary(value);
+  }
+
+  obj->t___wakeup();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
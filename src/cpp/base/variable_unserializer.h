@@ -24,24 +24,27 @@ namespace HPHP {
 
 class VariableUnserializer {
 public:
-  VariableUnserializer(std::istream &in) : m_in(in), m_key(false) {}
+  /**
+   * Supported formats, see VariableSerializer.
+   */
+  enum Type {
+    Serialize,
+    Binary,
+  };
 
-  Variant unserialize() {
-    Variant v;
-    v.unserialize(this);
-    return v;
-  }
+  VariableUnserializer(std::istream &in)
+    : m_type(Serialize), m_in(&in), m_buf(NULL), m_end(NULL), m_key(false) {}
+  VariableUnserializer(const char *data, int size)
+    : m_type(Binary), m_in(NULL), m_buf(data), m_end(data + size),
+      m_key(false) {}
 
-  Variant unserializeKey() {
-    m_key = true;
-    Variant v;
-    v.unserialize(this);
-    m_key = false;
-    return v;
-  }
+  Variant unserialize();
+  Variant unserializeKey();
 
+  Type getType() const { return m_type;}
   std::istream &in() const {
-    return m_in;
+    ASSERT(m_in);
+    return *m_in;
   }
   void add(Variant* v) {
     if (!m_key) {
@@ -49,13 +52,28 @@ public:
     }
   }
   Variant &get(int id) {
+    if (id <= 0 || id > (int)m_refs.size()) {
+      throw Exception("Invalid reference id %d", id);
+    }
     return *m_refs[id-1];
   }
 
  private:
-  std::istream &m_in;
+  Type m_type;
+  std::istream *m_in;
+  const char *m_buf; // Binary only: current position
+  const char *m_end;
   std::vector<Variant*> m_refs;
+  std::vector<String> m_strings; // Binary only: string table
   bool m_key;
+
+  // Binary format
+  void readBinary(Variant &v);
+  char readTag();
+  uint64 readVarint();
+  String readBinaryString(char tag);
+  Variant readBinaryKey();
+  void readBinaryObject(Variant &v);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
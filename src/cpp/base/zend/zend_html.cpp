@@ -16,6 +16,7 @@
 */
 
 #include <cpp/base/zend/zend_html.h>
+#include <cpp/base/util/escape_scan.h>
 #include <cpp/base/type_array.h>
 #include <util/lock.h>
 
@@ -346,62 +347,67 @@ static void init_entity_table() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static inline int html_entity_extra(char c) {
+  switch (c) {
+  case '"':  return 5; // &quot;
+  case '\'': return 5; // &#039;
+  case '<':  return 3; // &lt;
+  case '>':  return 3; // &gt;
+  case '&':  return 4; // &amp;
+  default:
+    ASSERT(false);
+    return 0;
+  }
+}
+
+static inline char *html_entity(char *q, char c) {
+  switch (c) {
+  case '"':  memcpy(q, "&quot;", 6); return q + 6;
+  case '\'': memcpy(q, "&#039;", 6); return q + 6;
+  case '<':  memcpy(q, "&lt;",   4); return q + 4;
+  case '>':  memcpy(q, "&gt;",   4); return q + 4;
+  case '&':  memcpy(q, "&amp;",  5); return q + 5;
+  default:
+    ASSERT(false);
+    return q;
+  }
+}
+
 char *string_html_encode(const char *input, int &len, bool encode_double_quote,
                          bool encode_single_quote) {
   ASSERT(input);
-  if (!*input) {
-    return NULL;
+  bool dq = encode_double_quote;
+  bool sq = encode_single_quote;
+
+  int pos = escape_scan_html(input, len, dq, sq);
+  if (pos == len) {
+    return NULL; // nothing to encode, caller keeps the input
   }
 
   /**
-   * Though seems to be wasting memory a lot, we have to realize most of the
-   * time this function is called with small strings, or fragments of HTMLs.
-   * Allocating/deallocating anything less than 1K is trivial these days, and
-   * we want avoid string copying as much as possible. Of course, the return
-   * char * is really sent back at large, occupying unnessary space for
-   * potentially longer time than we need, we have to realize the two closest
-   * solutions are not that much better, either:
-   *
-   * 1. pre-calculate size by iterating through the string once: too time
-   *    consuming;
-   * 2. take a guess and double buffer size when over: still wasting, and
-   *    it may not save that much.
+   * Most strings have few special characters, so an extra pass hopping from
+   * one to the next is cheap, and it lets us allocate the exact output size
+   * instead of the worst case of 6 bytes per input byte.
    */
-  char *ret = (char *)malloc(len * 6 + 1);
-  char *q = ret;
-  for (const char *p = input; *p; p++) {
-    char c = *p;
-    switch (c) {
-    case '"':
-      if (encode_double_quote) {
-        *q++ = '&'; *q++ = 'q'; *q++ = 'u'; *q++ = 'o'; *q++ = 't'; *q++ = ';';
-      } else {
-        *q++ = c;
-      }
-      break;
-    case '\'':
-      if (encode_single_quote) {
-        *q++ = '&'; *q++ = '#'; *q++ = '0'; *q++ = '3'; *q++ = '9'; *q++ = ';';
-      } else {
-        *q++ = c;
-      }
-      break;
-    case '<':
-      *q++ = '&'; *q++ = 'l'; *q++ = 't'; *q++ = ';';
-      break;
-    case '>':
-      *q++ = '&'; *q++ = 'g'; *q++ = 't'; *q++ = ';';
-      break;
-    case '&':
-      *q++ = '&'; *q++ = 'a'; *q++ = 'm'; *q++ = 'p'; *q++ = ';';
-      break;
-    default:
-      *q++ = c;
-      break;
-    }
+  int size = len;
+  for (int i = pos; i < len; ) {
+    size += html_entity_extra(input[i++]);
+    i += escape_scan_html(input + i, len - i, dq, sq);
+  }
+
+  char *ret = (char *)malloc(size + 1);
+  memcpy(ret, input, pos);
+  char *q = ret + pos;
+  for (int i = pos; i < len; ) {
+    q = html_entity(q, input[i++]);
+    int n = escape_scan_html(input + i, len - i, dq, sq);
+    memcpy(q, input + i, n);
+    q += n;
+    i += n;
   }
   *q = 0;
   len = q - ret;
+  ASSERT(len == size);
   return ret;
 }
 
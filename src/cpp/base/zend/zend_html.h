@@ -44,6 +44,9 @@ namespace HPHP {
  *
  * 3. Double encoding parameter is not supported. That really sounds like
  *    a workaround of buggy coding. I don't find a legit use for that yet.
+ *
+ * 4. string_html_encode() returns NULL when the input has nothing to encode,
+ *    so callers can keep the original string instead of a copy.
  */
 
 char *string_html_encode(const char *input, int &len, bool encode_double_quote,
@@ -16,6 +16,7 @@
 */
 
 #include <cpp/base/zend/zend_string.h>
+#include <endian.h>
 
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
@@ -71,9 +72,10 @@ static unsigned char PADDING[64] = {
   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
 };
 
-// F, G, H and I are basic MD5 functions.
-#define F(x, y, z) (((x) & (y)) | ((~x) & (z)))
-#define G(x, y, z) (((x) & (z)) | ((y) & (~z)))
+// F, G, H and I are basic MD5 functions. F and G are written as bit selects
+// to save an operation each.
+#define F(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+#define G(x, y, z) ((y) ^ ((z) & ((x) ^ (y))))
 #define H(x, y, z) ((x) ^ (y) ^ (z))
 #define I(x, y, z) ((y) ^ ((x) | (~z)))
 
@@ -127,11 +129,15 @@ static void Encode(unsigned char *output, uint32 *input, unsigned int len) {
  */
 static void Decode(uint32 *output, const unsigned char *input,
                    unsigned int len) {
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+  memcpy(output, input, len);
+#else
   unsigned int i, j;
   for (i = 0, j = 0; j < len; i++, j += 4) {
     output[i] = ((uint32) input[j]) | (((uint32) input[j + 1]) << 8) |
       (((uint32) input[j + 2]) << 16) | (((uint32) input[j + 3]) << 24);
   }
+#endif
 }
 
 typedef struct {
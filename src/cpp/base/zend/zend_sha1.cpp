@@ -16,6 +16,8 @@
 */
 
 #include <cpp/base/zend/zend_string.h>
+#include <endian.h>
+#include <byteswap.h>
 
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
@@ -85,12 +87,14 @@ static void SHA1Encode(unsigned char *output, uint32 *input,
  */
 static void SHA1Decode(uint32 *output, const unsigned char *input,
                        unsigned int len) {
-  unsigned int i, j;
-
-  for (i = 0, j = 0; j < len; i++, j += 4) {
-    output[i] = ((uint32) input[j + 3]) | (((uint32) input[j + 2]) << 8) |
-      (((uint32) input[j + 1]) << 16) | (((uint32) input[j]) << 24);
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+  memcpy(output, input, len);
+  for (unsigned int i = 0; i < len / 4; i++) {
+    output[i] = bswap_32(output[i]);
   }
+#else
+  memcpy(output, input, len);
+#endif
 }
 
 /* SHA1 context. */
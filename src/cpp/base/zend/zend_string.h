@@ -226,7 +226,8 @@ char *string_wordwrap(const char *text, int &textlen, int linelength,
                       const char *breakchar, int breakcharlen, bool docut);
 
 /**
- * Encoding/decoding strings according to certain formats.
+ * Encoding/decoding strings according to certain formats. string_addslashes()
+ * returns NULL when there is nothing to escape.
  */
 char *string_addcslashes(const char *str, int &length, const char *what,
                          int wlength);
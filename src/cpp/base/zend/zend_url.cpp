@@ -17,6 +17,7 @@
 
 #include <cpp/base/zend/zend_url.h>
 #include <cpp/base/zend/zend_string.h>
+#include <cpp/base/util/escape_scan.h>
 
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
@@ -310,35 +311,46 @@ static int php_htoi(char *s) {
 
 static unsigned char hexchars[] = "0123456789ABCDEF";
 
-char *url_encode(const char *s, int &len) {
-  register unsigned char c;
-  unsigned char *to, *start;
-  unsigned char const *from, *end;
-
-  from = (unsigned char const *)s;
-  end = (unsigned char const *)s + len;
-  start = to = (unsigned char *)malloc(3 * len + 1);
+static char *url_encode_impl(const char *s, int &len, bool raw) {
+  int pos = escape_scan_url(s, len);
+  if (pos == len) {
+    return NULL;
+  }
 
-  while (from < end) {
-    c = *from++;
+  // " " stays one byte as "+" unless raw, everything else becomes "%XX"
+  int size = len;
+  for (int i = pos; i < len; ) {
+    if (raw || s[i] != ' ') size += 2;
+    i++;
+    i += escape_scan_url(s + i, len - i);
+  }
 
-    if (c == ' ') {
+  unsigned char *start = (unsigned char *)malloc(size + 1);
+  memcpy(start, s, pos);
+  unsigned char *to = start + pos;
+  for (int i = pos; i < len; ) {
+    unsigned char c = s[i++];
+    if (c == ' ' && !raw) {
       *to++ = '+';
-    } else if ((c < '0' && c != '-' && c != '.') ||
-           (c < 'A' && c > '9') ||
-           (c > 'Z' && c < 'a' && c != '_') ||
-           (c > 'z')) {
+    } else {
       to[0] = '%';
       to[1] = hexchars[c >> 4];
       to[2] = hexchars[c & 15];
       to += 3;
-    } else {
-      *to++ = c;
     }
+    int n = escape_scan_url(s + i, len - i);
+    memcpy(to, s + i, n);
+    to += n;
+    i += n;
   }
   *to = 0;
   len = to - start;
-  return (char *) start;
+  ASSERT(len == size);
+  return (char *)start;
+}
+
+char *url_encode(const char *s, int &len) {
+  return url_encode_impl(s, len, false);
 }
 
 char *url_decode(const char *s, int &len) {
@@ -420,24 +432,7 @@ int url_decode_ex(char *value, int len) {
 }
 
 char *url_raw_encode(const char *s, int &len) {
-  register int x, y;
-  unsigned char *str;
-
-  str = (unsigned char *)malloc(3 * len + 1);
-  for (x = 0, y = 0; len--; x++, y++) {
-    str[y] = (unsigned char) s[x];
-    if ((str[y] < '0' && str[y] != '-' && str[y] != '.') ||
-      (str[y] < 'A' && str[y] > '9') ||
-        (str[y] > 'Z' && str[y] < 'a' && str[y] != '_') ||
-      (str[y] > 'z')) {
-      str[y++] = '%';
-      str[y++] = hexchars[(unsigned char) s[x] >> 4];
-      str[y] = hexchars[(unsigned char) s[x] & 15];
-    }
-  }
-  str[y] = '\0';
-  len = y;
-  return ((char *)str);
+  return url_encode_impl(s, len, true);
 }
 
 char *url_raw_decode(const char *s, int &len) {
@@ -43,7 +43,8 @@ public:
 bool url_parse(Url &output, const char *str, int length);
 
 /**
- * raw_ versions ignore "+" or " ".
+ * raw_ versions ignore "+" or " ". Encoders return NULL when the input has
+ * nothing to encode.
  */
 char *url_encode(const char *s, int &len);
 char *url_decode(const char *s, int &len);
@@ -34,6 +34,7 @@ public:
       m_env(env), m_file(file) { }
 
   virtual String getFileName();
+  virtual const char *peekFileName() { return m_file;}
   virtual Array getArgs();
   static void SetLine(const Construct *c);
 private:
@@ -92,6 +92,28 @@ Variant f_apc_fetch(CVarRef key, Variant success /* = null */,
   return v;
 }
 
+Variant f_apc_fetch_or_lock(CStrRef key, Variant locked /* = null */,
+                            int64 lock_timeout /* = 0 */,
+                            int64 cache_id /* = 0 */) {
+  locked = false;
+  if (!RuntimeOption::EnableApc) return false;
+
+  if (cache_id < 0 || cache_id >= MAX_SHARED_STORE) {
+    throw InvalidArgumentException("cache_id", cache_id);
+  }
+  if (lock_timeout <= 0) {
+    lock_timeout = RuntimeOption::ApcFillLockTimeout;
+  }
+
+  Variant v;
+  bool tmp = false;
+  if (!s_apc_store[cache_id].getOrLock(key, v, lock_timeout, tmp)) {
+    v = false;
+  }
+  locked = tmp;
+  return v;
+}
+
 Variant f_apc_delete(CVarRef key, int64 cache_id /* = 0 */) {
   if (!RuntimeOption::EnableApc) return false;
 
@@ -117,6 +139,56 @@ Variant f_apc_delete(CVarRef key, int64 cache_id /* = 0 */) {
   return s_apc_store[cache_id].erase(key.toString());
 }
 
+static bool check_prefix_index(int64 cache_id) {
+  if (s_apc_store[cache_id].canFindPrefix()) return true;
+  // a misconfiguration, not something each call needs to be told about
+  static bool s_warned = false;
+  if (!s_warned) {
+    s_warned = true;
+    Logger::Warning("apc prefix operations need Server.APC.PrefixIndex");
+  }
+  return false;
+}
+
+Variant f_apc_delete_prefix(CStrRef prefix, int64 cache_id /* = 0 */) {
+  if (!RuntimeOption::EnableApc) return false;
+
+  if (cache_id < 0 || cache_id >= MAX_SHARED_STORE) {
+    throw InvalidArgumentException("cache_id", cache_id);
+  }
+  if (!check_prefix_index(cache_id)) return false;
+  return s_apc_store[cache_id].eraseByPrefix(prefix);
+}
+
+Variant f_apc_iterate_prefix(CStrRef prefix, int64 limit /* = 0 */,
+                             int64 cache_id /* = 0 */) {
+  if (!RuntimeOption::EnableApc) return false;
+
+  if (cache_id < 0 || cache_id >= MAX_SHARED_STORE) {
+    throw InvalidArgumentException("cache_id", cache_id);
+  }
+  if (limit < 0) {
+    throw InvalidArgumentException("limit", limit);
+  }
+  if (!check_prefix_index(cache_id)) return false;
+  return s_apc_store[cache_id].getByPrefix(prefix, limit);
+}
+
+Variant f_apc_prefix_info(CStrRef prefix, int64 cache_id /* = 0 */) {
+  if (!RuntimeOption::EnableApc) return false;
+
+  if (cache_id < 0 || cache_id >= MAX_SHARED_STORE) {
+    throw InvalidArgumentException("cache_id", cache_id);
+  }
+  if (!check_prefix_index(cache_id)) return false;
+  int count = 0;
+  int64 bytes = s_apc_store[cache_id].getPrefixSize(prefix, count);
+  Array ret = Array::Create();
+  ret.set("keys", count);
+  ret.set("bytes", bytes);
+  return ret;
+}
+
 bool f_apc_clear_cache(int64 cache_id /* = 0 */) {
   if (!RuntimeOption::EnableApc) return false;
 
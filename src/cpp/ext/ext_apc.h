@@ -27,7 +27,11 @@ namespace HPHP {
 bool f_apc_add(CStrRef key, CVarRef var, int64 ttl = 0, int64 cache_id = 0);
 bool f_apc_store(CStrRef key, CVarRef var, int64 ttl = 0, int64 cache_id = 0);
 Variant f_apc_fetch(CVarRef key, Variant success = null, int64 cache_id = 0);
+Variant f_apc_fetch_or_lock(CStrRef key, Variant locked = null, int64 lock_timeout = 0, int64 cache_id = 0);
 Variant f_apc_delete(CVarRef key, int64 cache_id = 0);
+Variant f_apc_delete_prefix(CStrRef prefix, int64 cache_id = 0);
+Variant f_apc_iterate_prefix(CStrRef prefix, int64 limit = 0, int64 cache_id = 0);
+Variant f_apc_prefix_info(CStrRef prefix, int64 cache_id = 0);
 bool f_apc_clear_cache(int64 cache_id = 0);
 Variant f_apc_inc(CStrRef key, int64 step = 1, Variant success = null, int64 cache_id = 0);
 Variant f_apc_dec(CStrRef key, int64 step = 1, Variant success = null, int64 cache_id = 0);
@@ -205,12 +205,12 @@ inline int64 f_idate(CStrRef format, int64 timestamp = TimeStamp::Current()) {
 }
 
 inline String f_date(CStrRef format, int64 timestamp = TimeStamp::Current()) {
-  return DateTime(timestamp, false).toString(format, false);
+  return DateTime::Format(format, timestamp, false);
 }
 
 inline String f_gmdate(CStrRef format,
                        int64 timestamp = TimeStamp::Current()) {
-  return DateTime(timestamp, true).toString(format, false);
+  return DateTime::Format(format, timestamp, true);
 }
 
 inline String f_strftime(CStrRef format,
@@ -248,6 +248,10 @@ inline Variant f_strtotime(CStrRef input,
     return false;
   }
 
+  int64 ret;
+  if (DateTime::ParseCommon(input, timestamp, ret)) {
+    return ret;
+  }
   DateTime dt(timestamp);
   if (!dt.fromString(input, SmartObject<TimeZone>())) {
     return false;
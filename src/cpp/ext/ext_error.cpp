@@ -132,5 +132,25 @@ bool f_user_error(CStrRef error_msg, int error_type /* = k_E_USER_NOTICE */) {
   return f_trigger_error(error_msg, error_type);
 }
 
+IMPLEMENT_OBJECT_ALLOCATION(BacktraceSnapshot);
+
+Variant f_hphp_backtrace_snapshot(Variant file, Variant line) {
+  if (!RuntimeOption::InjectedStacktrace) {
+    Array bt = f_debug_backtrace();
+    Variant frame = bt.dequeue();
+    file = frame["file"];
+    line = frame["line"];
+    return bt;
+  }
+  BacktraceSnapshot *snapshot = NEW(BacktraceSnapshot)();
+  Object ret(snapshot);
+  snapshot->frames.shift(file, line);
+  return ret;
+}
+
+Array f_hphp_backtrace_snapshot_array(CObjRef snapshot) {
+  return snapshot.getTyped<BacktraceSnapshot>()->frames.toArray();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 }
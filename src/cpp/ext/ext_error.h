@@ -36,6 +36,25 @@ Variant f_set_error_handler(CStrRef error_handler, int error_types = 0);
 String f_set_exception_handler(CStrRef exception_handler);
 bool f_trigger_error(CStrRef error_msg, int error_type = k_E_USER_NOTICE);
 bool f_user_error(CStrRef error_msg, int error_type = k_E_USER_NOTICE);
+Variant f_hphp_backtrace_snapshot(Variant file, Variant line);
+Array f_hphp_backtrace_snapshot_array(CObjRef snapshot);
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * What Exception keeps instead of its trace, until somebody asks for it.
+ */
+class BacktraceSnapshot : public ResourceData {
+public:
+  DECLARE_OBJECT_ALLOCATION(BacktraceSnapshot);
+
+  BacktraceSnapshot() : frames(true) {}
+
+  // overriding ResourceData
+  virtual const char *o_getClassName() const { return "BacktraceSnapshot";}
+
+  BacktraceFrames frames;
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 }
@@ -429,6 +429,21 @@ Variant f_fb_thrift_unserialize(CVarRef thing, Variant success,
   return false;
 }
 
+Variant f_fb_compact_serialize(CVarRef thing) {
+  return binary_serialize(thing);
+}
+
+Variant f_fb_compact_unserialize(CVarRef thing, Variant success) {
+  if (!thing.isString()) {
+    success = false;
+    return false;
+  }
+  bool ok;
+  Variant ret = binary_unserialize(thing.toString(), ok);
+  success = ok;
+  return ret;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static void output_dataset(Array &ret, int affected, DBDataSet &ds,
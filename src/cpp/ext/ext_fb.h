@@ -27,6 +27,8 @@ namespace HPHP {
 
 Variant f_fb_thrift_serialize(CVarRef thing);
 Variant f_fb_thrift_unserialize(CVarRef thing, Variant success, Variant errcode = null_variant);
+Variant f_fb_compact_serialize(CVarRef thing);
+Variant f_fb_compact_unserialize(CVarRef thing, Variant success);
 bool f_fb_rename_function(CStrRef orig_func_name, CStrRef new_func_name);
 bool f_fb_utf8ize(Variant input);
 Array f_fb_call_user_func_safe(int _argc, CVarRef function, CArrRef _argv = null_array);
@@ -58,8 +58,12 @@ public:
     HashEngines["snefru"]     = HashEnginePtr(new hash_snefru());
     HashEngines["gost"]       = HashEnginePtr(new hash_gost());
     HashEngines["adler32"]    = HashEnginePtr(new hash_adler32());
-    HashEngines["crc32"]      = HashEnginePtr(new hash_crc32(false));
-    HashEngines["crc32b"]     = HashEnginePtr(new hash_crc32(true));
+    HashEngines["crc32"]      =
+      HashEnginePtr(new hash_crc32(hash_crc32::CRC32));
+    HashEngines["crc32b"]     =
+      HashEnginePtr(new hash_crc32(hash_crc32::CRC32B));
+    HashEngines["crc32c"]     =
+      HashEnginePtr(new hash_crc32(hash_crc32::CRC32C));
     HashEngines["haval128,3"] = HashEnginePtr(new hash_haval(3,128));
     HashEngines["haval160,3"] = HashEnginePtr(new hash_haval(3,160));
     HashEngines["haval192,3"] = HashEnginePtr(new hash_haval(3,192));
@@ -389,6 +389,107 @@ String f_hphp_recursivedirectoryiterator_getsubpathname(CObjRef obj) {
   throw NotImplementedException(__func__);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// splobjectstorage
+
+/**
+ * SplObjectStorage's own $storage holds id => array('obj' => object,
+ * 'inf' => data), keyed by o_getId() so attach(), detach() and contains()
+ * don't have to look at other objects, and its internal pointer is the
+ * iterator's position. Being a plain array, it is copied on write after
+ * clone, and shows in print_r(), var_export() and serialize(). Objects get
+ * new ids when unserialized, so __wakeup() rekeys it.
+ */
+static c_splobjectstorage *get_splobjectstorage(CObjRef obj) {
+  c_splobjectstorage *sos = obj.getTyped<c_splobjectstorage>();
+  if (!sos->m_storage.isArray()) {
+    sos->m_storage = Array::Create();
+  }
+  return sos;
+}
+
+void f_hphp_splobjectstorage_rewind(CObjRef obj) {
+  c_splobjectstorage *sos = get_splobjectstorage(obj);
+  sos->m_storage.array_iter_reset();
+  sos->m_index = 0;
+}
+
+bool f_hphp_splobjectstorage_valid(CObjRef obj) {
+  c_splobjectstorage *sos = get_splobjectstorage(obj);
+  return !sos->m_storage.array_iter_key().isNull();
+}
+
+int64 f_hphp_splobjectstorage_key(CObjRef obj) {
+  c_splobjectstorage *sos = get_splobjectstorage(obj);
+  return sos->m_index;
+}
+
+Variant f_hphp_splobjectstorage_current(CObjRef obj) {
+  c_splobjectstorage *sos = get_splobjectstorage(obj);
+  return sos->m_storage.array_iter_current().rvalAt("obj");
+}
+
+void f_hphp_splobjectstorage_next(CObjRef obj) {
+  c_splobjectstorage *sos = get_splobjectstorage(obj);
+  sos->m_storage.array_iter_next();
+  sos->m_index++;
+}
+
+int64 f_hphp_splobjectstorage_count(CObjRef obj) {
+  c_splobjectstorage *sos = get_splobjectstorage(obj);
+  return sos->m_storage.getArrayData()->size();
+}
+
+bool f_hphp_splobjectstorage_contains(CObjRef obj, CVarRef o) {
+  if (!o.isObject()) return false;
+  c_splobjectstorage *sos = get_splobjectstorage(obj);
+  return sos->m_storage.getArrayData()->
+    exists((int64)o.getObjectData()->o_getId());
+}
+
+void f_hphp_splobjectstorage_attach(CObjRef obj, CVarRef o,
+                                    CVarRef inf /* = null */) {
+  if (!o.isObject()) return;
+  c_splobjectstorage *sos = get_splobjectstorage(obj);
+  // an existing key keeps its place in the iteration order
+  sos->m_storage.set((int64)o.getObjectData()->o_getId(),
+                     CREATE_MAP2("obj", o, "inf", inf));
+}
+
+void f_hphp_splobjectstorage_detach(CObjRef obj, CVarRef o) {
+  if (!o.isObject()) return;
+  c_splobjectstorage *sos = get_splobjectstorage(obj);
+  sos->m_storage.remove((int64)o.getObjectData()->o_getId());
+}
+
+Variant f_hphp_splobjectstorage_getinfo(CObjRef obj) {
+  c_splobjectstorage *sos = get_splobjectstorage(obj);
+  Variant id = sos->m_storage.array_iter_key();
+  if (id.isNull()) return null;
+  return sos->m_storage.rvalAt(id).rvalAt("inf");
+}
+
+void f_hphp_splobjectstorage_setinfo(CObjRef obj, CVarRef inf) {
+  c_splobjectstorage *sos = get_splobjectstorage(obj);
+  Variant id = sos->m_storage.array_iter_key();
+  if (!id.isNull()) {
+    sos->m_storage.lvalAt(id).set("inf", inf);
+  }
+}
+
+Variant f_hphp_splobjectstorage_offsetget(CObjRef obj, CVarRef o) {
+  if (o.isObject()) {
+    c_splobjectstorage *sos = get_splobjectstorage(obj);
+    int64 id = o.getObjectData()->o_getId();
+    if (sos->m_storage.getArrayData()->exists(id)) {
+      return sos->m_storage.rvalAt(id).rvalAt("inf");
+    }
+  }
+  throw_exception(create_object("unexpectedvalueexception",
+                                CREATE_VECTOR1("Object not found")));
+  return null;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 }
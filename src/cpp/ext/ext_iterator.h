@@ -117,6 +117,19 @@ Object f_hphp_recursivedirectoryiterator_getchildren(CObjRef obj);
 String f_hphp_recursivedirectoryiterator_getsubpath(CObjRef obj);
 String f_hphp_recursivedirectoryiterator_getsubpathname(CObjRef obj);
 
+void f_hphp_splobjectstorage_rewind(CObjRef obj);
+bool f_hphp_splobjectstorage_valid(CObjRef obj);
+int64 f_hphp_splobjectstorage_key(CObjRef obj);
+Variant f_hphp_splobjectstorage_current(CObjRef obj);
+void f_hphp_splobjectstorage_next(CObjRef obj);
+int64 f_hphp_splobjectstorage_count(CObjRef obj);
+bool f_hphp_splobjectstorage_contains(CObjRef obj, CVarRef o);
+void f_hphp_splobjectstorage_attach(CObjRef obj, CVarRef o, CVarRef inf = null);
+void f_hphp_splobjectstorage_detach(CObjRef obj, CVarRef o);
+Variant f_hphp_splobjectstorage_getinfo(CObjRef obj);
+void f_hphp_splobjectstorage_setinfo(CObjRef obj, CVarRef inf);
+Variant f_hphp_splobjectstorage_offsetget(CObjRef obj, CVarRef o);
+
 ///////////////////////////////////////////////////////////////////////////////
 }
 
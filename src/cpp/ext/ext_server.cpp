@@ -124,6 +124,16 @@ String f_pagelet_server_task_result(CObjRef task, Variant headers,
   return response;
 }
 
+String f_pagelet_server_task_flushed(CObjRef task) {
+  return PageletServer::TaskFlushed(task);
+}
+
+Variant f_pagelet_server_task_wait_any(CArrRef tasks,
+                                       int64 timeout_ms /* = 0 */,
+                                       bool flushed /* = false */) {
+  return PageletServer::TaskWaitAny(tasks, timeout_ms, flushed);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // xbox
 
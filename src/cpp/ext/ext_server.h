@@ -30,6 +30,8 @@ bool f_dangling_server_proxy_new_request(CStrRef host);
 Object f_pagelet_server_task_start(CStrRef url, CArrRef headers = null_array, CStrRef post_data = null_string);
 bool f_pagelet_server_task_status(CObjRef task);
 String f_pagelet_server_task_result(CObjRef task, Variant headers, Variant code);
+String f_pagelet_server_task_flushed(CObjRef task);
+Variant f_pagelet_server_task_wait_any(CArrRef tasks, int64 timeout_ms = 0, bool flushed = false);
 bool f_xbox_send_message(CStrRef msg, Variant ret, int64 timeout_ms, CStrRef host = "localhost");
 bool f_xbox_post_message(CStrRef msg, CStrRef host = "localhost");
 Object f_xbox_task_start(CStrRef message);
@@ -16,7 +16,7 @@
 */
 
 #include <cpp/ext/hash/hash_crc32.h>
-#include <cpp/ext/hash/php_hash_crc32_tables.h>
+#include <cpp/base/util/crc32.h>
 
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
@@ -25,8 +25,8 @@ typedef struct {
   unsigned int state;
 } PHP_CRC32_CTX;
 
-hash_crc32::hash_crc32(bool b)
-  : HashEngine(4, 4, sizeof(PHP_CRC32_CTX)), m_b(b) {
+hash_crc32::hash_crc32(Type type)
+  : HashEngine(4, 4, sizeof(PHP_CRC32_CTX)), m_type(type) {
 }
 
 void hash_crc32::hash_init(void *context_) {
@@ -37,27 +37,34 @@ void hash_crc32::hash_init(void *context_) {
 void hash_crc32::hash_update(void *context_, const unsigned char *input,
                              unsigned int len) {
   PHP_CRC32_CTX *context = (PHP_CRC32_CTX*)context_;
-  size_t i;
-  if (m_b) {
-    for (i = 0; i < len; ++i) {
-      context->state = (context->state >> 8) ^
-        crc32b_table[(context->state ^ input[i]) & 0xff];
-    }
-  } else {
-    for (i = 0; i < len; ++i) {
-      context->state = (context->state << 8) ^
-        crc32_table[(context->state >> 24) ^ (input[i] & 0xff)];
-    }
+  switch (m_type) {
+  case CRC32:
+    context->state = crc32_bzip2_update(context->state, input, len);
+    break;
+  case CRC32B:
+    context->state = crc32_update(context->state, input, len);
+    break;
+  case CRC32C:
+    context->state = crc32c_update(context->state, input, len);
+    break;
   }
 }
 
 void hash_crc32::hash_final(unsigned char *digest, void *context_) {
   PHP_CRC32_CTX *context = (PHP_CRC32_CTX*)context_;
   context->state=~context->state;
-  digest[3] = (unsigned char) ((context->state >> 24) & 0xff);
-  digest[2] = (unsigned char) ((context->state >> 16) & 0xff);
-  digest[1] = (unsigned char) ((context->state >> 8) & 0xff);
-  digest[0] = (unsigned char) (context->state & 0xff);
+  if (m_type == CRC32C) {
+    // most significant byte first, matching the usual notation
+    digest[0] = (unsigned char) ((context->state >> 24) & 0xff);
+    digest[1] = (unsigned char) ((context->state >> 16) & 0xff);
+    digest[2] = (unsigned char) ((context->state >> 8) & 0xff);
+    digest[3] = (unsigned char) (context->state & 0xff);
+  } else {
+    digest[3] = (unsigned char) ((context->state >> 24) & 0xff);
+    digest[2] = (unsigned char) ((context->state >> 16) & 0xff);
+    digest[1] = (unsigned char) ((context->state >> 8) & 0xff);
+    digest[0] = (unsigned char) (context->state & 0xff);
+  }
   context->state = 0;
 }
 
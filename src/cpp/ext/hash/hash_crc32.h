@@ -25,7 +25,13 @@ namespace HPHP {
 
 class hash_crc32 : public HashEngine {
 public:
-  hash_crc32(bool b);
+  enum Type {
+    CRC32,  // bzip2
+    CRC32B, // crc32()
+    CRC32C, // Castagnoli
+  };
+
+  hash_crc32(Type type);
 
   virtual void hash_init(void *context);
   virtual void hash_update(void *context, const unsigned char *buf,
@@ -33,7 +39,7 @@ public:
   virtual void hash_final(unsigned char *digest, void *context);
 
 private:
-  bool m_b;
+  Type m_type;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -40,11 +40,31 @@ inline Variant x_apc_fetch(CVarRef key, Variant success = null, int64 cache_id =
   return f_apc_fetch(key, ref(success), cache_id);
 }
 
+inline Variant x_apc_fetch_or_lock(CStrRef key, Variant locked = null, int64 lock_timeout = 0, int64 cache_id = 0) {
+  FUNCTION_INJECTION_BUILTIN(apc_fetch_or_lock);
+  return f_apc_fetch_or_lock(key, ref(locked), lock_timeout, cache_id);
+}
+
 inline Variant x_apc_delete(CVarRef key, int64 cache_id = 0) {
   FUNCTION_INJECTION_BUILTIN(apc_delete);
   return f_apc_delete(key, cache_id);
 }
 
+inline Variant x_apc_delete_prefix(CStrRef prefix, int64 cache_id = 0) {
+  FUNCTION_INJECTION_BUILTIN(apc_delete_prefix);
+  return f_apc_delete_prefix(prefix, cache_id);
+}
+
+inline Variant x_apc_iterate_prefix(CStrRef prefix, int64 limit = 0, int64 cache_id = 0) {
+  FUNCTION_INJECTION_BUILTIN(apc_iterate_prefix);
+  return f_apc_iterate_prefix(prefix, limit, cache_id);
+}
+
+inline Variant x_apc_prefix_info(CStrRef prefix, int64 cache_id = 0) {
+  FUNCTION_INJECTION_BUILTIN(apc_prefix_info);
+  return f_apc_prefix_info(prefix, cache_id);
+}
+
 inline bool x_apc_compile_file(CStrRef filename, bool atomic = true, int64 cache_id = 0) {
   FUNCTION_INJECTION_BUILTIN(apc_compile_file);
   return f_apc_compile_file(filename, atomic, cache_id);
@@ -80,6 +80,16 @@ inline bool x_user_error(CStrRef error_msg, int error_type = k_E_USER_NOTICE) {
   return f_user_error(error_msg, error_type);
 }
 
+inline Variant x_hphp_backtrace_snapshot(Variant file, Variant line) {
+  FUNCTION_INJECTION_BUILTIN(hphp_backtrace_snapshot);
+  return f_hphp_backtrace_snapshot(ref(file), ref(line));
+}
+
+inline Array x_hphp_backtrace_snapshot_array(CObjRef snapshot) {
+  FUNCTION_INJECTION_BUILTIN(hphp_backtrace_snapshot_array);
+  return f_hphp_backtrace_snapshot_array(snapshot);
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 }
@@ -43,6 +43,24 @@ inline Variant x_fb_thrift_unserialize(CVarRef thing, Variant success, Variant e
 }
 #endif
 
+#ifndef PROFILE_BUILTIN
+#define x_fb_compact_serialize f_fb_compact_serialize
+#else
+inline Variant x_fb_compact_serialize(CVarRef thing) {
+  FUNCTION_INJECTION(fb_compact_serialize);
+  return f_fb_compact_serialize(thing);
+}
+#endif
+
+#ifndef PROFILE_BUILTIN
+#define x_fb_compact_unserialize f_fb_compact_unserialize
+#else
+inline Variant x_fb_compact_unserialize(CVarRef thing, Variant success) {
+  FUNCTION_INJECTION(fb_compact_unserialize);
+  return f_fb_compact_unserialize(thing, ref(success));
+}
+#endif
+
 #ifndef PROFILE_BUILTIN
 #define x_fb_rename_function f_fb_rename_function
 #else
@@ -277,6 +277,114 @@ inline String x_hphp_recursivedirectoryiterator_getsubpathname(CObjRef obj) {
 }
 #endif
 
+#ifndef PROFILE_BUILTIN
+#define x_hphp_splobjectstorage_rewind f_hphp_splobjectstorage_rewind
+#else
+inline void x_hphp_splobjectstorage_rewind(CObjRef obj) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_rewind);
+  f_hphp_splobjectstorage_rewind(obj);
+}
+#endif
+
+#ifndef PROFILE_BUILTIN
+#define x_hphp_splobjectstorage_valid f_hphp_splobjectstorage_valid
+#else
+inline bool x_hphp_splobjectstorage_valid(CObjRef obj) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_valid);
+  return f_hphp_splobjectstorage_valid(obj);
+}
+#endif
+
+#ifndef PROFILE_BUILTIN
+#define x_hphp_splobjectstorage_key f_hphp_splobjectstorage_key
+#else
+inline int64 x_hphp_splobjectstorage_key(CObjRef obj) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_key);
+  return f_hphp_splobjectstorage_key(obj);
+}
+#endif
+
+#ifndef PROFILE_BUILTIN
+#define x_hphp_splobjectstorage_current f_hphp_splobjectstorage_current
+#else
+inline Variant x_hphp_splobjectstorage_current(CObjRef obj) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_current);
+  return f_hphp_splobjectstorage_current(obj);
+}
+#endif
+
+#ifndef PROFILE_BUILTIN
+#define x_hphp_splobjectstorage_next f_hphp_splobjectstorage_next
+#else
+inline void x_hphp_splobjectstorage_next(CObjRef obj) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_next);
+  f_hphp_splobjectstorage_next(obj);
+}
+#endif
+
+#ifndef PROFILE_BUILTIN
+#define x_hphp_splobjectstorage_count f_hphp_splobjectstorage_count
+#else
+inline int64 x_hphp_splobjectstorage_count(CObjRef obj) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_count);
+  return f_hphp_splobjectstorage_count(obj);
+}
+#endif
+
+#ifndef PROFILE_BUILTIN
+#define x_hphp_splobjectstorage_contains f_hphp_splobjectstorage_contains
+#else
+inline bool x_hphp_splobjectstorage_contains(CObjRef obj, CVarRef o) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_contains);
+  return f_hphp_splobjectstorage_contains(obj, o);
+}
+#endif
+
+#ifndef PROFILE_BUILTIN
+#define x_hphp_splobjectstorage_attach f_hphp_splobjectstorage_attach
+#else
+inline void x_hphp_splobjectstorage_attach(CObjRef obj, CVarRef o, CVarRef inf = null) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_attach);
+  f_hphp_splobjectstorage_attach(obj, o, inf);
+}
+#endif
+
+#ifndef PROFILE_BUILTIN
+#define x_hphp_splobjectstorage_detach f_hphp_splobjectstorage_detach
+#else
+inline void x_hphp_splobjectstorage_detach(CObjRef obj, CVarRef o) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_detach);
+  f_hphp_splobjectstorage_detach(obj, o);
+}
+#endif
+
+#ifndef PROFILE_BUILTIN
+#define x_hphp_splobjectstorage_getinfo f_hphp_splobjectstorage_getinfo
+#else
+inline Variant x_hphp_splobjectstorage_getinfo(CObjRef obj) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_getinfo);
+  return f_hphp_splobjectstorage_getinfo(obj);
+}
+#endif
+
+#ifndef PROFILE_BUILTIN
+#define x_hphp_splobjectstorage_setinfo f_hphp_splobjectstorage_setinfo
+#else
+inline void x_hphp_splobjectstorage_setinfo(CObjRef obj, CVarRef inf) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_setinfo);
+  f_hphp_splobjectstorage_setinfo(obj, inf);
+}
+#endif
+
+#ifndef PROFILE_BUILTIN
+#define x_hphp_splobjectstorage_offsetget f_hphp_splobjectstorage_offsetget
+#else
+inline Variant x_hphp_splobjectstorage_offsetget(CObjRef obj, CVarRef o) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_offsetget);
+  return f_hphp_splobjectstorage_offsetget(obj, o);
+}
+#endif
+
 
 ///////////////////////////////////////////////////////////////////////////////
 }
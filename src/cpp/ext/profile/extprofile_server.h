@@ -50,6 +50,16 @@ inline String x_pagelet_server_task_result(CObjRef task, Variant headers, Varian
   return f_pagelet_server_task_result(task, ref(headers), ref(code));
 }
 
+inline String x_pagelet_server_task_flushed(CObjRef task) {
+  FUNCTION_INJECTION_BUILTIN(pagelet_server_task_flushed);
+  return f_pagelet_server_task_flushed(task);
+}
+
+inline Variant x_pagelet_server_task_wait_any(CArrRef tasks, int64 timeout_ms = 0, bool flushed = false) {
+  FUNCTION_INJECTION_BUILTIN(pagelet_server_task_wait_any);
+  return f_pagelet_server_task_wait_any(tasks, timeout_ms, flushed);
+}
+
 inline bool x_xbox_send_message(CStrRef msg, Variant ret, int64 timeout_ms, CStrRef host = "localhost") {
   FUNCTION_INJECTION_BUILTIN(xbox_send_message);
   return f_xbox_send_message(msg, ref(ret), timeout_ms, host);
@@ -26,6 +26,7 @@ const char *g_source_info[] = { NULL};
 const char *g_source_cls2file[] = { NULL};
 const char *g_source_func2file[] = { NULL};
 const char *g_paramrtti_map[] = { NULL};
+const char *g_callprofile_map[] = { NULL};
 
 Object create_object(const char *s, const Array &params, bool init,
                      ObjectData *root) {
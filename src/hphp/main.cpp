@@ -81,8 +81,10 @@ struct ProgramOptions {
   bool force;
   int clusterCount;
   int optimizeLevel;
+  bool keepFrames;
   string filecache;
   string rttiDirectory;
+  string callProfileDirectory;
   string javaRoot;
   bool generateFFI;
   bool dump;
@@ -223,6 +225,9 @@ int prepareOptions(ProgramOptions &po, int argc, char **argv) {
      "compilation and build.")
     ("optimize-level", value<int>(&po.optimizeLevel)->default_value(1),
      "optimization level")
+    ("keep-frames", value<bool>(&po.keepFrames)->default_value(false),
+     "do not inline PHP functions at their call sites, so backtraces show "
+     "every call; same as KeepFrames = true in the config")
     ("gen-stats", value<bool>(&po.genStats)->default_value(false),
      "whether to generate dependency graphs and code errors")
     ("keep-tempdir,k", value<bool>(&po.keepTempDir)->default_value(false),
@@ -265,6 +270,10 @@ int prepareOptions(ProgramOptions &po, int argc, char **argv) {
      "if specified, generate a static file cache with this file name")
     ("rtti-directory", value<string>(&po.rttiDirectory)->default_value(""),
      "the directory of rtti profiling data")
+    ("call-profile-directory",
+     value<string>(&po.callProfileDirectory)->default_value(""),
+     "the directory of call count profiling data, used to lay out hot "
+     "functions together and cold ones out of the way")
     ("java-root",
      value<string>(&po.javaRoot)->default_value("php"),
      "the root package of generated Java FFI classes")
@@ -396,6 +405,10 @@ int prepareOptions(ProgramOptions &po, int argc, char **argv) {
     Option::PostOptimization = true;
   }
 
+  if (po.keepFrames) {
+    Option::KeepFrames = true;
+  }
+
   if (po.staticMethodAutoFix) {
     Option::StaticMethodAutoFix = true;
   }
@@ -470,6 +483,12 @@ int process(const ProgramOptions &po) {
       if (!package.parse()) {
         return 1;
       }
+      if (po.target == "cpp" && !Option::RTTIOutputFile.empty() &&
+          !po.rttiDirectory.empty()) {
+        // specialized clones have to be analyzed like any other function
+        Option::UseRTTIProfileData = true;
+        ar->cloneRTTIFuncs(po.rttiDirectory.c_str());
+      }
       ar->analyzeProgram();
     }
   }
@@ -683,15 +702,19 @@ int cppTarget(const ProgramOptions &po, AnalysisResultPtr ar,
   if (Option::PreOptimization) {
     Timer timer(Timer::WallTime, "pre-optimizing");
     ar->preOptimize();
+    Logger::Info("inlined %d call sites", ar->getInlineCount());
   }
 
 
-  if (!Option::RTTIOutputFile.empty()) {
-    if (!po.rttiDirectory.empty()) {
-      Option::UseRTTIProfileData = true;
-      ar->cloneRTTIFuncs(po.rttiDirectory.c_str());
+  if (!Option::RTTIOutputFile.empty() && !Option::UseRTTIProfileData) {
+    Option::GenRTTIProfileData = true;
+  }
+  if (!po.callProfileDirectory.empty()) {
+    if (ar->loadCallProfile(po.callProfileDirectory.c_str())) {
+      Option::UseCallProfileData = true;
     } else {
-      Option::GenRTTIProfileData = true;
+      Logger::Error("No call profile data found in %s",
+                    po.callProfileDirectory.c_str());
     }
   }
 
@@ -21,10 +21,29 @@ f('apc_fetch', Variant,
         'success' => array(Boolean | Reference, 'null'),
         'cache_id' => array(Int64, '0')));
 
+f('apc_fetch_or_lock', Variant,
+  array('key' => String,
+        'locked' => array(Boolean | Reference, 'null'),
+        'lock_timeout' => array(Int64, '0'),
+        'cache_id' => array(Int64, '0')));
+
 f('apc_delete', Variant,
   array('key' => Variant,
         'cache_id' => array(Int64, '0')));
 
+f('apc_delete_prefix', Variant,
+  array('prefix' => String,
+        'cache_id' => array(Int64, '0')));
+
+f('apc_iterate_prefix', Variant,
+  array('prefix' => String,
+        'limit' => array(Int64, '0'),
+        'cache_id' => array(Int64, '0')));
+
+f('apc_prefix_info', Variant,
+  array('prefix' => String,
+        'cache_id' => array(Int64, '0')));
+
 f('apc_compile_file', Boolean,
   array('filename' => String,
         'atomic' => array(Boolean, 'true'),
@@ -37,3 +37,10 @@ f('trigger_error', Boolean,
 f('user_error', Boolean,
   array('error_msg' => String,
         'error_type' => array(Int32, 'k_E_USER_NOTICE')));
+
+f('hphp_backtrace_snapshot', Variant,
+  array('file' => Variant | Reference,
+        'line' => Variant | Reference));
+
+f('hphp_backtrace_snapshot_array', StringVec,
+  array('snapshot' => Object));
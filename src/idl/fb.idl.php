@@ -18,6 +18,13 @@ f('fb_thrift_unserialize', Variant,
         'success' => Boolean | Reference,
         'errcode' => array(Int32 | Reference, 'null_variant')));
 
+f('fb_compact_serialize', Variant,
+  array('thing' => Variant));
+
+f('fb_compact_unserialize', Variant,
+  array('thing' => Variant,
+        'success' => Boolean | Reference));
+
 f('fb_rename_function', Boolean,
   array('orig_func_name' => String,
         'new_func_name' => String));
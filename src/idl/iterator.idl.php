@@ -95,3 +95,43 @@ f('hphp_recursivedirectoryiterator_getsubpath', String,
 
 f('hphp_recursivedirectoryiterator_getsubpathname', String,
   array('obj' => Resource));
+
+///////////////////////////////////////////////////////////////////////////////
+// splobjectstorage
+
+f('hphp_splobjectstorage_rewind', NULL,
+  array('obj' => Resource));
+
+f('hphp_splobjectstorage_valid', Boolean,
+  array('obj' => Resource));
+
+f('hphp_splobjectstorage_key', Int64,
+  array('obj' => Resource));
+
+f('hphp_splobjectstorage_current', Variant,
+  array('obj' => Resource));
+
+f('hphp_splobjectstorage_next', NULL,
+  array('obj' => Resource));
+
+f('hphp_splobjectstorage_count', Int64,
+  array('obj' => Resource));
+
+f('hphp_splobjectstorage_contains', Boolean,
+  array('obj' => Resource, 'o' => Variant));
+
+f('hphp_splobjectstorage_attach', NULL,
+  array('obj' => Resource, 'o' => Variant,
+        'inf' => array(Variant, 'null')));
+
+f('hphp_splobjectstorage_detach', NULL,
+  array('obj' => Resource, 'o' => Variant));
+
+f('hphp_splobjectstorage_getinfo', Variant,
+  array('obj' => Resource));
+
+f('hphp_splobjectstorage_setinfo', NULL,
+  array('obj' => Resource, 'inf' => Variant));
+
+f('hphp_splobjectstorage_offsetget', Variant,
+  array('obj' => Resource, 'o' => Variant));
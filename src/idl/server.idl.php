@@ -24,6 +24,14 @@ f('pagelet_server_task_result', String,
         'headers' => StringVec | Reference,
         'code' => Int64 | Reference));
 
+f('pagelet_server_task_flushed', String,
+  array('task' => Resource));
+
+f('pagelet_server_task_wait_any', Variant,
+  array('tasks' => VariantVec,
+        'timeout_ms' => array(Int64, '0'),
+        'flushed' => array(Boolean, 'false')));
+
 ///////////////////////////////////////////////////////////////////////////////
 
 f('xbox_send_message', Boolean,
@@ -35,8 +35,12 @@
 #include <lib/expression/constant_expression.h>
 #include <lib/expression/expression_list.h>
 #include <lib/expression/array_pair_expression.h>
+#include <lib/expression/parameter_expression.h>
+#include <lib/expression/simple_function_call.h>
+#include <lib/statement/function_statement.h>
 #include <util/process.h>
 #include <cpp/base/rtti_info.h>
+#include <cpp/base/call_profile.h>
 #include <cpp/ext/ext_json.h>
 
 using namespace HPHP;
@@ -50,7 +54,7 @@ AnalysisResult::AnalysisResult()
   : BlockScope("Root", StatementPtr(), BlockScope::ProgramScope),
     m_package(NULL), m_parseOnDemand(false), m_phase(AnalyzeInclude),
     m_newlyInferred(0), m_dynamicClass(false), m_dynamicFunction(false),
-    m_classForcedVariants(false), m_optCounter(0),
+    m_classForcedVariants(false), m_optCounter(0), m_inlineCount(0),
     m_scalarArraysCounter(0), m_paramRTTICounter(0),
     m_scalarArraySortedAvgLen(0), m_scalarArraySortedIndex(0),
     m_scalarArraySortedSumLen(0), m_scalarArrayCompressedTextSize(0) {
@@ -734,15 +738,41 @@ void AnalysisResult::getTrueDeps(FileScopePtr f,
   }
 }
 
+namespace {
+class FileHotnessCmp {
+public:
+  FileHotnessCmp(const map<string, int64> &counts) : m_counts(counts) {}
+  bool operator()(const FileScopePtr &f1, const FileScopePtr &f2) const {
+    return count(f1) > count(f2);
+  }
+private:
+  const map<string, int64> &m_counts;
+  int64 count(const FileScopePtr &f) const {
+    map<string, int64>::const_iterator iter = m_counts.find(f->getName());
+    return iter == m_counts.end() ? 0 : iter->second;
+  }
+};
+}
+
 void AnalysisResult::clusterByFileSizes(StringToFileScopePtrVecMap &clusters,
                                         int clusterCount) {
   ASSERT(clusterCount > 0);
 
-  std::map<std::string, FileScopePtr> sortedFiles;
+  std::map<std::string, FileScopePtr> fileMap;
   long totalSize = 0;
   BOOST_FOREACH(FileScopePtr f, m_fileScopes) {
     totalSize += f->getSize();
-    sortedFiles[f->getName()] = f;
+    fileMap[f->getName()] = f;
+  }
+  FileScopePtrVec sortedFiles;
+  for (std::map<std::string, FileScopePtr>::const_iterator iter =
+         fileMap.begin(); iter != fileMap.end(); ++iter) {
+    sortedFiles.push_back(iter->second);
+  }
+  if (Option::UseCallProfileData) {
+    // hottest files first, so that they end up in the same clusters
+    stable_sort(sortedFiles.begin(), sortedFiles.end(),
+                FileHotnessCmp(m_fileCallCounts));
   }
 
   const int FUZZYNESS = 1024; // 1kB
@@ -752,9 +782,8 @@ void AnalysisResult::clusterByFileSizes(StringToFileScopePtrVecMap &clusters,
   int count = 1;
   string clusterName = Option::FormatClusterFile(count);
   FileScopePtrVec largeFiles;
-  for (std::map<std::string, FileScopePtr>::const_iterator iter =
-         sortedFiles.begin(); iter != sortedFiles.end(); ++iter) {
-    FileScopePtr f = iter->second;
+  for (unsigned int i = 0; i < sortedFiles.size(); i++) {
+    FileScopePtr f = sortedFiles[i];
     if (f->getSize() > clusterSize) {
       largeFiles.push_back(f);
     } else {
@@ -971,6 +1000,9 @@ void AnalysisResult::outputAllCPP(CodeGenerator::Output output,
   if (Option::GenRTTIProfileData) {
     outputRTTIMetaData(Option::RTTIOutputFile.c_str());
   }
+  if (Option::UseCallProfileData && output != CodeGenerator::SystemCPP) {
+    outputSectionOrder((m_outputPath + "/section_order.txt").c_str());
+  }
 }
 
 void AnalysisResult::outputAllCPP(CodeGenerator &cg) {
@@ -1178,6 +1210,14 @@ void AnalysisResult::outputCPPNameMaps() {
   cg.printf("NULL\n");
   cg.indentEnd("};\n");
 
+  cg.printSection("Call Profile Id -> Function");
+  cg.indentBegin("const char *g_callprofile_map[] = {\n");
+  for (unsigned int i = 0; i < m_callProfileNames.size(); i++) {
+    cg.printf("\"%s\", // %d\n", m_callProfileNames[i].c_str(), i);
+  }
+  cg.printf("NULL\n");
+  cg.indentEnd("};\n");
+
   cg.namespaceEnd();
   f.close();
 }
@@ -1189,7 +1229,16 @@ void AnalysisResult::outputRTTIMetaData(const char *filename) {
     throw Exception("Unable to open %s: %s", filename,
                     Util::safe_strerror(errno).c_str());
   }
+  fprintf(f, "%s\n", RTTIInfo::MetaDataHeader);
   fprintf(f, "%d\n", m_paramRTTICounter);
+  vector<string> params(m_paramRTTICounter);
+  for (map<string, int>::const_iterator
+         iter = m_paramRTTIs.begin(); iter != m_paramRTTIs.end(); ++iter) {
+    params[iter->second] = iter->first;
+  }
+  for (int i = 0; i < m_paramRTTICounter; i++) {
+    fprintf(f, "%s\n", params[i].c_str());
+  }
   for (set<string>::const_iterator
        iter = m_rttiFuncs.begin(); iter != m_rttiFuncs.end(); ++iter) {
     fprintf(f, "%s\n", iter->c_str());
@@ -1197,6 +1246,20 @@ void AnalysisResult::outputRTTIMetaData(const char *filename) {
   fclose(f);
 }
 
+void AnalysisResult::outputSectionOrder(const char *filename) {
+  ASSERT(filename && *filename);
+  FILE *f = fopen(filename, "w");
+  if (f == NULL) {
+    throw Exception("Unable to open %s: %s", filename,
+                    Util::safe_strerror(errno).c_str());
+  }
+  // for gold's --section-ordering-file, see HOT_FUNCTION()
+  for (unsigned int i = 0; i < m_hotFuncs.size(); i++) {
+    fprintf(f, ".text.hot.%d\n", i);
+  }
+  fclose(f);
+}
+
 void AnalysisResult::outputCPPDynamicTablesHeader
     (CodeGenerator &cg,
     bool includeGlobalVars /* = true*/, bool includes /* = true */) {
@@ -1237,6 +1300,7 @@ void AnalysisResult::createGlobalFuncTable() {
   for (StringToFunctionScopePtrVecMap::const_iterator iter =
          m_functionDecs.begin(); iter != m_functionDecs.end(); ++iter) {
     FunctionScopePtr func = iter->second[0];
+    if (func->isInternalFunction()) continue;
     if (func->isDynamic() || func->isRedeclaring()) {
       funcs.push_back(iter->second[0]->name().c_str());
     }
@@ -2271,7 +2335,7 @@ void AnalysisResult::outputCPPClassMap(CodeGenerator &cg) {
   for (StringToFunctionScopePtrVecMap::const_iterator iter =
          m_functionDecs.begin(); iter != m_functionDecs.end(); ++iter) {
     FunctionScopePtr func = iter->second[0];
-    if (func->isUserFunction()) {
+    if (func->isUserFunction() && !func->isInternalFunction()) {
       func->outputCPPClassMap(cg, ar);
     }
   }
@@ -2395,7 +2459,7 @@ void AnalysisResult::outputHSFFIStubs() {
     for (StringToFunctionScopePtrVecMap::const_iterator it = fns.begin();
          it != fns.end(); ++it) {
       BOOST_FOREACH(FunctionScopePtr func, it->second) {
-        if (func->inPseudoMain()) continue;
+        if (func->inPseudoMain() || func->isInternalFunction()) continue;
         if (first) {
           first = false;
         } else {
@@ -2640,39 +2704,216 @@ void AnalysisResult::addRTTIFunction(const std::string &id) {
   m_rttiFuncs.insert(id);
 }
 
-void AnalysisResult::cloneRTTIFuncs
-(ClassScopePtr cls, const StringToFunctionScopePtrVecMap &functions) {
-  for (StringToFunctionScopePtrVecMap::const_iterator iter =
-       functions.begin(); iter != functions.end(); ++iter) {
-    for (unsigned int j = 0; j < iter->second.size(); j++) {
-      FunctionScopePtr func = iter->second[j];
-      const string funcId = getFuncId(cls, func);
-      if (RTTIInfo::TheRTTIInfo.exists(funcId.c_str())) {
-        StatementPtr stmt = func->getStmt();
-        func->setStmtCloned(stmt->clone());
-      }
+static bool isSpecializable(ConstructPtr cp) {
+  if (!cp) return true;
+  StatementPtr s = dynamic_pointer_cast<Statement>(cp);
+  // a clone would have its own static variables, and would declare nested
+  // functions and classes a second time
+  if (s && (s->is(Statement::KindOfStaticStatement) ||
+            s->is(Statement::KindOfFunctionStatement) ||
+            s->is(Statement::KindOfClassStatement) ||
+            s->is(Statement::KindOfInterfaceStatement))) {
+    return false;
+  }
+  for (int i = 0; i < cp->getKidCount(); i++) {
+    if (!isSpecializable(cp->getNthKid(i))) return false;
+  }
+  return true;
+}
+
+typedef map<string, pair<string, TypePtrVec> > SpecializationMap;
+
+static int dispatchSpecialized(AnalysisResultPtr ar, ConstructPtr cp,
+                               const SpecializationMap &specs) {
+  int count = 0;
+  for (int i = 0; i < cp->getKidCount(); i++) {
+    ConstructPtr kid = cp->getNthKid(i);
+    if (!kid) continue;
+    count += dispatchSpecialized(ar, kid, specs);
+    SimpleFunctionCallPtr call = dynamic_pointer_cast<SimpleFunctionCall>(kid);
+    if (!call) continue;
+    SpecializationMap::const_iterator iter = specs.find(call->getName());
+    if (iter == specs.end()) continue;
+    ExpressionPtr dispatch =
+      call->dispatchSpecialized(ar, iter->second.first, iter->second.second);
+    if (dispatch) {
+      cp->setNthKid(i, dispatch);
+      count++;
     }
   }
+  return count;
 }
 
 void AnalysisResult::cloneRTTIFuncs(const char *RTTIDirectory) {
-  RTTIInfo::TheRTTIInfo.loadMetaData(Option::RTTIOutputFile.c_str());
-  RTTIInfo::TheRTTIInfo.loadProfData(RTTIDirectory);
+  RTTIInfo &info = RTTIInfo::TheRTTIInfo;
+  if (!info.loadMetaData(Option::RTTIOutputFile.c_str()) ||
+      !info.loadProfData(RTTIDirectory)) {
+    return;
+  }
+  cloneRTTIFuncs(info);
+}
 
+void AnalysisResult::cloneRTTIFuncs(RTTIInfo &info) {
+  // parameters seen with one type in this many calls and percent of them
+  const unsigned int MIN_CALLS = 1000;
+  const int DOMINANCE = 90;
+
+  if (Option::AllDynamic) return;
+
+  // clone top-level functions whose parameters have dominant types as
+  // "name$$rtti_<sig>", with one of i/s/a/v per parameter in <sig>
+  AnalysisResultPtr ar = shared_from_this();
+  SpecializationMap specs;
+  for (unsigned int i = 0; i < m_fileScopes.size(); i++) {
+    FileScopePtr fs = m_fileScopes[i];
+    StatementListPtr stmts = fs->getStmt();
+    if (!stmts) continue;
+    pushScope(fs);
+    int count = stmts->getCount();
+    for (int j = 0; j < count; j++) {
+      FunctionStatementPtr func =
+        dynamic_pointer_cast<FunctionStatement>((*stmts)[j]);
+      if (!func) continue;
+      FunctionScopePtr scope = func->getFunctionScope();
+      if (!scope || scope->isRedeclaring() || scope->isRefReturn() ||
+          !info.exists(scope->getId().c_str()) ||
+          !isSpecializable(func->getStmts())) {
+        continue;
+      }
+      ExpressionListPtr params = func->getParams();
+      TypePtrVec types;
+      string sig;
+      bool specialized = false;
+      for (int k = 0; params && k < params->getCount(); k++) {
+        ParameterExpressionPtr param =
+          dynamic_pointer_cast<ParameterExpression>((*params)[k]);
+        DataType dt = KindOfVariant;
+        if (!param->isRef()) {
+          dt = info.getDominantType(getParamRTTIEntryKey(ClassScopePtr(), scope,
+                                                         param->getName()),
+                                    MIN_CALLS, DOMINANCE);
+        }
+        switch (dt) {
+        case KindOfInt64:  types.push_back(Type::Int64);  sig += 'i'; break;
+        case KindOfString: types.push_back(Type::String); sig += 's'; break;
+        case KindOfArray:  types.push_back(Type::Array);  sig += 'a'; break;
+        default:           types.push_back(TypePtr());    sig += 'v'; break;
+        }
+        if (types.back()) specialized = true;
+      }
+      if (!specialized) continue;
+
+      string name = func->getName() + Option::IdPrefix + "rtti_" + sig;
+      FunctionStatementPtr clone =
+        dynamic_pointer_cast<FunctionStatement>(func->clone());
+      // the original name stays for backtraces and __FUNCTION__
+      clone->setName(name);
+      clone->onParse(ar);
+      clone->getFunctionScope()->setInternalFunction();
+      stmts->addElement(clone);
+      specs[func->getName()] = make_pair(name, types);
+    }
+    popScope();
+  }
+  if (specs.empty()) return;
+
+  int dispatched = 0;
   for (unsigned int i = 0; i < m_fileScopes.size(); i++) {
-    // standalone rtti functions
-    cloneRTTIFuncs(ClassScopePtr(), m_fileScopes[i]->getFunctions());
+    FileScopePtr fs = m_fileScopes[i];
+    if (!fs->getStmt()) continue;
+    pushScope(fs);
+    dispatched += dispatchSpecialized(ar, fs->getStmt(), specs);
+    popScope();
+  }
+  Logger::Info("specialized %d functions by rtti, dispatched from %d calls",
+               (int)specs.size(), dispatched);
+}
+
+int AnalysisResult::getCallProfileId(ClassScopePtr cls,
+                                     FunctionScopePtr func) {
+  string funcId = getFuncId(cls, func);
+  map<string, int>::const_iterator iter = m_callProfileIds.find(funcId);
+  if (iter != m_callProfileIds.end()) return iter->second;
+  int id = m_callProfileNames.size();
+  m_callProfileIds[funcId] = id;
+  m_callProfileNames.push_back(funcId);
+  return id;
+}
 
-    // class rtti methods
+bool AnalysisResult::loadCallProfile(const char *callProfileDirectory) {
+  if (!CallProfile::Load(callProfileDirectory, m_callCounts) ||
+      m_callCounts.empty()) {
+    return false;
+  }
+
+  // rank functions by call counts, hottest first
+  vector<pair<int64, string> > ranked;
+  int64 total = 0;
+  for (map<string, int64>::const_iterator iter = m_callCounts.begin();
+       iter != m_callCounts.end(); ++iter) {
+    ranked.push_back(pair<int64, string>(-iter->second, iter->first));
+    total += iter->second;
+  }
+  sort(ranked.begin(), ranked.end());
+  int64 covered = 0;
+  for (unsigned int i = 0; i < ranked.size(); i++) {
+    if (covered * 100 >= total * Option::HotFunctionCoverage) break;
+    covered -= ranked[i].first;
+    m_hotFuncs[ranked[i].second] = i;
+  }
+
+  // per-file totals for clustering
+  for (unsigned int i = 0; i < m_fileScopes.size(); i++) {
+    FileScopePtr fs = m_fileScopes[i];
+    int64 &count = m_fileCallCounts[fs->getName()];
+    const StringToFunctionScopePtrVecMap &funcs = fs->getFunctions();
+    for (StringToFunctionScopePtrVecMap::const_iterator iter = funcs.begin();
+         iter != funcs.end(); ++iter) {
+      for (unsigned int j = 0; j < iter->second.size(); j++) {
+        map<string, int64>::const_iterator it =
+          m_callCounts.find(getFuncId(ClassScopePtr(), iter->second[j]));
+        if (it != m_callCounts.end()) count += it->second;
+      }
+    }
     for (StringToClassScopePtrVecMap::const_iterator iter =
-         m_fileScopes[i]->getClasses().begin();
-         iter != m_fileScopes[i]->getClasses().end(); ++iter) {
+           fs->getClasses().begin(); iter != fs->getClasses().end(); ++iter) {
       for (unsigned int j = 0; j < iter->second.size(); j++) {
         ClassScopePtr cls = iter->second[j];
-        cloneRTTIFuncs(cls, cls->getFunctions());
+        const StringToFunctionScopePtrVecMap &methods = cls->getFunctions();
+        for (StringToFunctionScopePtrVecMap::const_iterator it2 =
+               methods.begin(); it2 != methods.end(); ++it2) {
+          for (unsigned int k = 0; k < it2->second.size(); k++) {
+            map<string, int64>::const_iterator it =
+              m_callCounts.find(getFuncId(cls, it2->second[k]));
+            if (it != m_callCounts.end()) count += it->second;
+          }
+        }
       }
     }
   }
+
+  Logger::Info("call profile: %d functions called, %d laid out as hot",
+               (int)m_callCounts.size(), (int)m_hotFuncs.size());
+  return true;
+}
+
+void AnalysisResult::outputCPPFunctionSection(CodeGenerator &cg,
+                                              ClassScopePtr cls,
+                                              FunctionScopePtr func) {
+  // inline functions get emitted into every file calling them, and mostly
+  // inlined away, so a section of their own would only get in the way
+  if (!Option::UseCallProfileData || func->isInlined() ||
+      cg.getOutput() == CodeGenerator::SystemCPP) {
+    return;
+  }
+  string funcId = getFuncId(cls, func);
+  map<string, int>::const_iterator iter = m_hotFuncs.find(funcId);
+  if (iter != m_hotFuncs.end()) {
+    cg.printf("HOT_FUNCTION(%d)\n", iter->second);
+  } else if (m_callCounts.find(funcId) == m_callCounts.end()) {
+    // never called while profiling
+    cg.printf("COLD_FUNCTION\n");
+  }
 }
 
 void AnalysisResult::outputCPPLiteralStringPrecomputation() {
@@ -37,6 +37,7 @@ DECLARE_BOOST_TYPES(CodeError);
 DECLARE_BOOST_TYPES(Location);
 DECLARE_BOOST_TYPES(AnalysisResult);
 DECLARE_BOOST_TYPES(ScalarExpression);
+class RTTIInfo;
 
 class AnalysisResult : public BlockScope, public FunctionContainer {
 public:
@@ -119,6 +120,13 @@ public:
   void preOptimize(int maxPass = 100);
   void postOptimize(int maxPass = 100);
   void incOptCounter() { m_optCounter++; }
+
+  /**
+   * Each call site replaced by its callee's body gets a unique id, so the
+   * callee's parameters can be renamed apart from the caller's variables.
+   */
+  int newInlineId() { return ++m_inlineCount; }
+  int getInlineCount() const { return m_inlineCount; }
   template<typename T>
   bool preOptimize(boost::shared_ptr<T> &before) {
     if (before) {
@@ -302,7 +310,24 @@ public:
                           FunctionScopePtr func,
                           const std::string &paramName);
   void addRTTIFunction(const std::string &id);
+
+  /**
+   * Creates clones of functions specialized for the parameter types seen
+   * in RTTI profile data, and dispatches to them from call sites where
+   * the arguments can be checked cheaply. Needs to run before analysis.
+   */
   void cloneRTTIFuncs(const char *RTTIDirectory);
+  void cloneRTTIFuncs(RTTIInfo &info);
+
+  /**
+   * Profiling function call counts and laying out generated code by them:
+   * hot functions are clustered together and ordered by the linker, never
+   * called ones are moved into .text.unlikely.
+   */
+  int getCallProfileId(ClassScopePtr cls, FunctionScopePtr func);
+  bool loadCallProfile(const char *callProfileDirectory);
+  void outputCPPFunctionSection(CodeGenerator &cg, ClassScopePtr cls,
+                                FunctionScopePtr func);
 
   /**
    * For global state output
@@ -343,6 +368,7 @@ private:
   StatementPtrSet m_calleesAdded;
   std::string m_outputPath;
   int m_optCounter;
+  int m_inlineCount;
 
   std::map<std::string, int> m_scalarArrays;
   int m_scalarArraysCounter;
@@ -351,6 +377,12 @@ private:
   std::set<std::string> m_rttiFuncs;
   int m_paramRTTICounter;
 
+  std::map<std::string, int> m_callProfileIds;
+  std::vector<std::string> m_callProfileNames;
+  std::map<std::string, int64> m_callCounts;
+  std::map<std::string, int64> m_fileCallCounts;
+  std::map<std::string, int> m_hotFuncs; // function id => rank
+
   bool m_insideScalarArray;
 
 public:
@@ -415,6 +447,7 @@ private:
   void outputCPPSourceInfos();
   void outputCPPNameMaps();
   void outputRTTIMetaData(const char *filename);
+  void outputSectionOrder(const char *filename);
   void outputCPPClassMap(CodeGenerator &cg);
   void outputCPPSystem();
   void outputCPPGlobalImplementations(CodeGenerator &cg);
@@ -454,9 +487,6 @@ private:
                        const char *buf, int len);
   void outputCPPLiteralStringPrecomputation();
 
-  void cloneRTTIFuncs(ClassScopePtr cls,
-                      const StringToFunctionScopePtrVecMap &functions);
-
   AnalysisResultPtr shared_from_this() {
     return boost::static_pointer_cast<AnalysisResult>
       (BlockScope::shared_from_this());
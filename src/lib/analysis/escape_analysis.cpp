@@ -0,0 +1,71 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010 Facebook, Inc. (http://www.facebook.com)          |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+
+#include <lib/analysis/escape_analysis.h>
+#include <lib/analysis/analysis_result.h>
+#include <lib/analysis/function_scope.h>
+#include <lib/analysis/variable_table.h>
+#include <lib/expression/simple_variable.h>
+
+using namespace HPHP;
+using namespace std;
+using namespace boost;
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool EscapeAnalysis::IsStableLocal(AnalysisResultPtr ar, SimpleVariablePtr var,
+                                   ConstructPtr region) {
+  if (!var || var->isThis()) return false;
+
+  // pseudo-main locals are globals, visible to every included file
+  FunctionScopePtr func = ar->getFunctionScope();
+  if (!func || func->inPseudoMain()) return false;
+
+  VariableTablePtr variables = func->getVariables();
+  if (variables->getAttribute(VariableTable::ContainsDynamicVariable) ||
+      variables->getAttribute(VariableTable::ContainsExtract) ||
+      variables->getAttribute(VariableTable::ContainsCompact) ||
+      variables->getAttribute(VariableTable::ContainsGetDefinedVars)) {
+    return false;
+  }
+
+  const string &name = var->getName();
+  if (variables->isGlobal(name) || variables->isSuperGlobal(name) ||
+      variables->isStatic(name) || variables->isReferenced(name) ||
+      variables->isLvalParam(name)) {
+    return false;
+  }
+  return !IsModifiedIn(name, region);
+}
+
+bool EscapeAnalysis::IsModifiedIn(const string &name, ConstructPtr region) {
+  if (!region) return false;
+
+  SimpleVariablePtr var = dynamic_pointer_cast<SimpleVariable>(region);
+  if (var) {
+    if (var->getName() != name) return false;
+    return var->getContext() &
+      (Expression::LValue | Expression::RefValue | Expression::UnsetContext |
+       Expression::RefParameter | Expression::InvokeArgument |
+       Expression::AssignmentLHS | Expression::DeepAssignmentLHS);
+  }
+
+  for (int i = 0; i < region->getKidCount(); i++) {
+    if (IsModifiedIn(name, region->getNthKid(i))) return true;
+  }
+  return false;
+}
@@ -0,0 +1,52 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010 Facebook, Inc. (http://www.facebook.com)          |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+
+#ifndef __ESCAPE_ANALYSIS_H__
+#define __ESCAPE_ANALYSIS_H__
+
+#include <lib/hphp.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+DECLARE_BOOST_TYPES(AnalysisResult);
+DECLARE_BOOST_TYPES(Construct);
+DECLARE_BOOST_TYPES(SimpleVariable);
+
+/**
+ * Conservative, intra-procedural escape analysis of local variables. A local
+ * is "stable" over a region of code when nothing in that region can write,
+ * unset or bind a reference to it, either by name or through the symbol
+ * table. Code generation uses this to borrow the local's value for the
+ * region instead of holding an extra reference count on it.
+ */
+class EscapeAnalysis {
+public:
+  /**
+   * Whether "var" is a plain local of the current function whose value
+   * cannot change or be captured by reference while "region" runs.
+   */
+  static bool IsStableLocal(AnalysisResultPtr ar, SimpleVariablePtr var,
+                            ConstructPtr region);
+
+private:
+  static bool IsModifiedIn(const std::string &name, ConstructPtr region);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+#endif // __ESCAPE_ANALYSIS_H__
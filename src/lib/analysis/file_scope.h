@@ -52,6 +52,7 @@ public:
     NoEffect = 256, // does not side effect
     HelperFunction = 512, // runtime helper function
     ContainsGetDefinedVars = 1024, // need VariableTable with getDefinedVars
+    InternalFunction = 2048, // generated by the compiler, not callable by name
   };
 
   typedef boost::adjacency_list<boost::setS, boost::vecS> Graph;
@@ -85,7 +85,10 @@ void FunctionContainer::outputCPPJumpTableSupport
          m_functions.begin(); iter != m_functions.end(); ++iter) {
     if (!iter->second[0]->isRedeclaring()) {
       FunctionScopePtr func = iter->second[0];
-      if (func->inPseudoMain() || !(systemcpp || func->isDynamic())) continue;
+      if (func->inPseudoMain() || func->isInternalFunction() ||
+          !(systemcpp || func->isDynamic())) {
+        continue;
+      }
       const char *name = iter->first.c_str();
       if (funcs) funcs->push_back(name);
 
@@ -146,7 +149,10 @@ void FunctionContainer::outputCPPJumpTableEvalSupport
          m_functions.begin(); iter != m_functions.end(); ++iter) {
     if (!iter->second[0]->isRedeclaring()) {
       FunctionScopePtr func = iter->second[0];
-      if (func->inPseudoMain() || !(systemcpp || func->isDynamic())) continue;
+      if (func->inPseudoMain() || func->isInternalFunction() ||
+          !(systemcpp || func->isDynamic())) {
+        continue;
+      }
       const char *name = iter->first.c_str();
       if (funcs) funcs->push_back(name);
 
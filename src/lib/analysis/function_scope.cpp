@@ -209,6 +209,14 @@ void FunctionScope::setHelperFunction() {
   m_attribute |= FileScope::HelperFunction;
 }
 
+bool FunctionScope::isInternalFunction() const {
+  return m_attribute & FileScope::InternalFunction;
+}
+
+void FunctionScope::setInternalFunction() {
+  m_attribute |= FileScope::InternalFunction;
+}
+
 bool FunctionScope::containsReference() const {
   return m_attribute & FileScope::ContainsReference;
 }
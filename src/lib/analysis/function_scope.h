@@ -135,6 +135,14 @@ public:
   bool isHelperFunction() const;
   void setHelperFunction();
 
+  /**
+   * Whether this function was generated by the compiler, like an RTTI
+   * specialized clone: it is left out of function_exists(), the dynamic
+   * invoke tables and ClassInfo, so only its own call sites reach it.
+   */
+  bool isInternalFunction() const;
+  void setInternalFunction();
+
   /**
    * Whether this function returns reference or has reference parameters.
    */
@@ -306,10 +314,6 @@ public:
     return m_ignored;
   }
 
-  void setStmtCloned(StatementPtr stmt) {
-    m_stmtCloned = stmt;
-  }
-
 private:
   bool m_method;
   FileScopeWeakPtr m_file;
@@ -335,7 +339,6 @@ private:
   bool m_containsThis; // contains a usage of $this?
   int m_callTempCountMax;
   int m_callTempCountCurrent;
-  StatementPtr m_stmtCloned; // cloned method body stmt
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -726,9 +726,53 @@ static bool castIfNeeded(TypePtr top, TypePtr arg,
   return false;
 }
 
+bool BinaryOpExpression::outputConcatAssign(CodeGenerator &cg,
+                                            AnalysisResultPtr ar) {
+  // $s .= a . b . c appends all parts with one reallocation, instead of
+  // building a temporary with concatN() and copying it over
+  if (m_exp2->is(Expression::KindOfSimpleFunctionCall)) {
+    SimpleFunctionCallPtr call =
+      dynamic_pointer_cast<SimpleFunctionCall>(m_exp2);
+    const std::string &name = call->getName();
+    if (!call->hasNoPrefix() || name.size() <= 6 ||
+        name.compare(0, 6, "concat") != 0 ||
+        name.find_first_not_of("0123456789", 6) != std::string::npos) {
+      return false;
+    }
+    cg.printf("concat_assign%s(", name.c_str() + 6);
+    m_exp1->outputCPP(cg, ar);
+    cg.printf(", ");
+    call->getParams()->outputCPP(cg, ar);
+    cg.printf(")");
+    return true;
+  }
+  if (m_exp2->is(Expression::KindOfBinaryOpExpression)) {
+    BinaryOpExpressionPtr binOpExp =
+      dynamic_pointer_cast<BinaryOpExpression>(m_exp2);
+    if (binOpExp->m_op != '.' ||
+        (binOpExp->m_exp1->hasEffect() && binOpExp->m_exp2->hasEffect())) {
+      return false;
+    }
+    cg.printf("concat_assign2(");
+    m_exp1->outputCPP(cg, ar);
+    cg.printf(", ");
+    binOpExp->m_exp1->outputCPP(cg, ar);
+    cg.printf(", ");
+    binOpExp->m_exp2->outputCPP(cg, ar);
+    cg.printf(")");
+    return true;
+  }
+  return false;
+}
+
 void BinaryOpExpression::outputCPPImpl(CodeGenerator &cg,
                                        AnalysisResultPtr ar) {
   bool bothEffect = m_exp1->hasEffect() && m_exp2->hasEffect();
+  if (m_op == T_CONCAT_EQUAL && !bothEffect &&
+      m_exp1->is(Expression::KindOfSimpleVariable) &&
+      outputConcatAssign(cg, ar)) {
+    return;
+  }
   // Reverse exceptions
   if (bothEffect) {
     switch (m_op) {
@@ -48,6 +48,7 @@ private:
   ExpressionPtr mergeConcat(AnalysisResultPtr ar);
   ExpressionPtr makeConcatCall(AnalysisResultPtr ar, int count,
                                ExpressionListPtr expList);
+  bool outputConcatAssign(CodeGenerator &cg, AnalysisResultPtr ar);
 
   ExpressionPtr m_exp1;
   ExpressionPtr m_exp2;
@@ -30,7 +30,8 @@ using namespace boost;
 ExpressionList::ExpressionList
 (EXPRESSION_CONSTRUCTOR_PARAMETERS)
   : Expression(EXPRESSION_CONSTRUCTOR_PARAMETER_VALUES), m_outputCount(-1),
-    m_controlOrder(0), m_tempStart(0), m_arrayElements(false) {
+    m_controlOrder(0), m_tempStart(0), m_arrayElements(false),
+    m_kind(ListKindParam) {
 }
 
 ExpressionPtr ExpressionList::clone() {
@@ -72,6 +73,7 @@ void ExpressionList::removeElement(int index) {
 }
 
 bool ExpressionList::isScalar() const {
+  if (m_kind == ListKindComma) return false;
   for (unsigned int i = 0; i < m_exps.size(); i++) {
     if (!m_exps[i]->isScalar()) return false;
   }
@@ -248,6 +250,12 @@ ExpressionPtr ExpressionList::postOptimize(AnalysisResultPtr ar) {
 
 TypePtr ExpressionList::inferTypes(AnalysisResultPtr ar, TypePtr type,
                                    bool coerce) {
+  if (m_kind == ListKindComma && !m_exps.empty()) {
+    for (unsigned int i = 0; i < m_exps.size() - 1; i++) {
+      m_exps[i]->inferAndCheck(ar, NEW_TYPE(Any), false);
+    }
+    return m_exps.back()->inferAndCheck(ar, type, coerce);
+  }
   for (unsigned int i = 0; i < m_exps.size(); i++) {
     if (m_exps[i]) m_exps[i]->inferAndCheck(ar, type, coerce);
   }
@@ -265,6 +273,16 @@ void ExpressionList::outputPHP(CodeGenerator &cg, AnalysisResultPtr ar) {
 }
 
 void ExpressionList::outputCPPImpl(CodeGenerator &cg, AnalysisResultPtr ar) {
+  if (m_kind == ListKindComma) {
+    cg.printf("(");
+    for (unsigned int i = 0; i < m_exps.size(); i++) {
+      if (i > 0) cg.printf(", ");
+      m_exps[i]->outputCPP(cg, ar);
+    }
+    cg.printf(")");
+    return;
+  }
+
   bool effectArr = controllingOrder();
   int tempstart = tempOffset();
   if (m_arrayElements) {
@@ -26,6 +26,11 @@ DECLARE_BOOST_TYPES(ExpressionList);
 
 class ExpressionList : public Expression {
 public:
+  enum ListKind {
+    ListKindParam, // parameters, arguments, array elements, etc.
+    ListKindComma, // evaluated in order, the last element is the value
+  };
+
   ExpressionList(EXPRESSION_CONSTRUCTOR_PARAMETERS);
 
   // change case to lower so to make it case insensitive
@@ -47,6 +52,8 @@ public:
   bool isScalarArrayPairs() const;
 
   int getCount() const { return m_exps.size();}
+  void setListKind(ListKind kind) { m_kind = kind;}
+  ListKind getListKind() const { return m_kind;}
   ExpressionPtr &operator[](int index);
 
   void getStrings(std::vector<std::string> &strings);
@@ -82,6 +89,7 @@ private:
   int m_controlOrder;
   int m_tempStart;
   bool m_arrayElements;
+  ListKind m_kind;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
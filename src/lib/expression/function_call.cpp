@@ -24,6 +24,16 @@
 #include <lib/analysis/class_scope.h>
 #include <lib/expression/expression_list.h>
 #include <lib/expression/array_pair_expression.h>
+#include <lib/expression/simple_variable.h>
+#include <lib/expression/simple_function_call.h>
+#include <lib/expression/assignment_expression.h>
+#include <lib/expression/parameter_expression.h>
+#include <lib/statement/method_statement.h>
+#include <lib/statement/statement_list.h>
+#include <lib/statement/return_statement.h>
+#include <lib/analysis/variable_table.h>
+#include <lib/option.h>
+#include <lib/parser/hphp.tab.hpp>
 
 using namespace HPHP;
 using namespace std;
@@ -110,6 +120,173 @@ ExpressionPtr FunctionCall::postOptimize(AnalysisResultPtr ar) {
   return ExpressionPtr();
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// inlining
+
+/**
+ * Whether exp still means the same thing when evaluated in a caller's frame,
+ * adding its node count to size.
+ */
+static bool isInlineable(ConstructPtr cp, const set<string> &params,
+                         int &size) {
+  if (!cp) return true;
+  ExpressionPtr exp = dynamic_pointer_cast<Expression>(cp);
+  if (!exp) return false;
+  size++;
+
+  switch (exp->getKindOf()) {
+  case Expression::KindOfSimpleVariable: {
+    // a callee's locals other than its parameters would not start out
+    // unset on every call once they live in the caller, and $this would
+    // bypass the callee's own property and method visibility checks
+    const string &name =
+      static_pointer_cast<SimpleVariable>(exp)->getName();
+    return params.find(name) != params.end();
+  }
+  case Expression::KindOfSimpleFunctionCall: {
+    static const char *frameFunctions[] = {
+      "func_get_arg", "func_get_args", "func_num_args", "extract", "compact",
+      "get_defined_vars", "debug_backtrace", "debug_print_backtrace",
+      "create_function", "get_class", "get_called_class", "get_parent_class",
+      NULL
+    };
+    SimpleFunctionCallPtr call = static_pointer_cast<SimpleFunctionCall>(exp);
+    FunctionScopePtr func = call->getFuncScope();
+    // calling other user functions could recurse back into us
+    if (!func || func->isUserFunction()) return false;
+    for (int i = 0; frameFunctions[i]; i++) {
+      if (call->getName() == frameFunctions[i]) return false;
+    }
+    break;
+  }
+  case Expression::KindOfScalarExpression:
+    switch (static_pointer_cast<ScalarExpression>(exp)->getType()) {
+    case T_CLASS_C:
+    case T_METHOD_C:
+    case T_FUNC_C:
+      return false;
+    default:
+      break;
+    }
+    break;
+  case Expression::KindOfDynamicVariable:
+  case Expression::KindOfDynamicFunctionCall:
+  case Expression::KindOfObjectMethodExpression:
+  case Expression::KindOfStaticMemberExpression:
+  case Expression::KindOfListAssignment:
+  case Expression::KindOfIncludeExpression:
+    return false;
+  default:
+    break;
+  }
+
+  for (int i = 0; i < exp->getKidCount(); i++) {
+    if (!isInlineable(exp->getNthKid(i), params, size)) return false;
+  }
+  return true;
+}
+
+static void renameVariables(ConstructPtr cp, const string &prefix) {
+  if (!cp) return;
+  SimpleVariablePtr var = dynamic_pointer_cast<SimpleVariable>(cp);
+  if (var) {
+    var->rename(prefix + var->getName());
+    return;
+  }
+  for (int i = 0; i < cp->getKidCount(); i++) {
+    renameVariables(cp->getNthKid(i), prefix);
+  }
+}
+
+ExpressionPtr FunctionCall::inlineCall(AnalysisResultPtr ar,
+                                       FunctionScopePtr func) {
+  if (Option::AutoInline <= 0 || Option::KeepFrames || !func ||
+      ar->getPhase() != AnalysisResult::SecondPreOptimize) {
+    return ExpressionPtr();
+  }
+  // "&f()" and friends need a real return value to refer to
+  if (m_context & (LValue | RefValue | UnsetContext | IssetContext)) {
+    return ExpressionPtr();
+  }
+
+  // the caller's variables must stay invisible to the callee, and vice versa
+  FunctionScopePtr caller = ar->getFunctionScope();
+  if (!caller || caller == func || caller->inPseudoMain()) {
+    return ExpressionPtr();
+  }
+  VariableTablePtr variables = caller->getVariables();
+  if (variables->getAttribute(VariableTable::ContainsDynamicVariable) ||
+      variables->getAttribute(VariableTable::ContainsExtract) ||
+      variables->getAttribute(VariableTable::ContainsCompact) ||
+      variables->getAttribute(VariableTable::ContainsGetDefinedVars)) {
+    return ExpressionPtr();
+  }
+
+  if (!func->isUserFunction() || func->inPseudoMain() ||
+      func->isRefReturn() || func->isVariableArgument() ||
+      func->isVolatile() || func->isRedeclaring() ||
+      func->isMagicMethod()) {
+    return ExpressionPtr();
+  }
+  MethodStatementPtr stmt =
+    dynamic_pointer_cast<MethodStatement>(func->getStmt());
+  if (!stmt) return ExpressionPtr();
+  StatementListPtr stmts = stmt->getStmts();
+  if (!stmts || stmts->getCount() != 1) return ExpressionPtr();
+  ReturnStatementPtr ret = dynamic_pointer_cast<ReturnStatement>((*stmts)[0]);
+  if (!ret || !ret->getRetExp()) return ExpressionPtr();
+
+  ExpressionListPtr params = stmt->getParams();
+  int paramCount = params ? params->getCount() : 0;
+  int argCount = m_params ? m_params->getCount() : 0;
+  if (argCount > paramCount) return ExpressionPtr();
+  for (int i = 0; i < argCount; i++) {
+    if ((*m_params)[i]->getContext() & RefParameter) return ExpressionPtr();
+  }
+  set<string> names;
+  for (int i = 0; i < paramCount; i++) {
+    ParameterExpressionPtr param =
+      dynamic_pointer_cast<ParameterExpression>((*params)[i]);
+    // type hints are checked on entry, and a missing argument warns
+    if (param->isRef() || !param->getTypeHint().empty() ||
+        (i >= argCount && !param->defaultValue())) {
+      return ExpressionPtr();
+    }
+    names.insert(param->getName());
+  }
+  int size = 0;
+  if (!isInlineable(ret->getRetExp(), names, size) ||
+      size > Option::AutoInline) {
+    return ExpressionPtr();
+  }
+
+  string prefix = "__inl" + lexical_cast<string>(ar->newInlineId()) + "_";
+  ExpressionListPtr result(new ExpressionList(getLocation(),
+                                              KindOfExpressionList));
+  result->setListKind(ExpressionList::ListKindComma);
+  for (int i = 0; i < paramCount; i++) {
+    ParameterExpressionPtr param =
+      dynamic_pointer_cast<ParameterExpression>((*params)[i]);
+    ExpressionPtr value;
+    if (i < argCount) {
+      value = (*m_params)[i];
+    } else {
+      value = param->defaultValue()->clone();
+      value->clearContext(InParameterExpression);
+    }
+    SimpleVariablePtr var(new SimpleVariable(getLocation(),
+                                             KindOfSimpleVariable,
+                                             prefix + param->getName()));
+    result->addElement(AssignmentExpressionPtr(
+      new AssignmentExpression(getLocation(), KindOfAssignmentExpression,
+                               var, value, false)));
+  }
+  ExpressionPtr body = ret->getRetExp()->clone();
+  renameVariables(body, prefix);
+  result->addElement(body);
+  return result;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 TypePtr FunctionCall::checkParamsAndReturn(AnalysisResultPtr ar,
@@ -44,6 +44,8 @@ public:
   virtual ExpressionPtr postOptimize(AnalysisResultPtr ar);
 
   void setAllowVoidReturn() { m_allowVoidReturn = true;}
+  ExpressionListPtr getParams() const { return m_params;}
+  FunctionScopePtr getFuncScope() const { return m_funcScope;}
   void setFunctionAndClassScope(FunctionScopePtr fsp, ClassScopePtr csp);
 protected:
   ExpressionPtr m_nameExp;
@@ -82,6 +84,16 @@ protected:
 
   TypePtr checkParamsAndReturn(AnalysisResultPtr ar, TypePtr type,
                                bool coerce, FunctionScopePtr func);
+
+  /**
+   * Replaces this call with func's body when func is just
+   * "return <exp>;" over its parameters only, never $this, within
+   * Option::AutoInline nodes and calling no other user functions. Arguments
+   * are assigned to renamed copies of the parameters first, so they are
+   * still evaluated once, in order. Nothing is inlined with
+   * Option::KeepFrames.
+   */
+  ExpressionPtr inlineCall(AnalysisResultPtr ar, FunctionScopePtr func);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
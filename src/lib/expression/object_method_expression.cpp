@@ -142,7 +142,22 @@ int ObjectMethodExpression::setNthKid(int n, ConstructPtr cp) {
 
 ExpressionPtr ObjectMethodExpression::preOptimize(AnalysisResultPtr ar) {
   ar->preOptimize(m_object);
-  return FunctionCall::preOptimize(ar);
+  FunctionCall::preOptimize(ar);
+  // $this->foo() can only mean our own foo() if it is private or final,
+  // and it has to fail when there is no $this
+  FunctionScopePtr caller = ar->getFunctionScope();
+  if (m_object->isThis() && !m_name.empty() &&
+      caller && !caller->isStatic()) {
+    ClassScopePtr cls = ar->getClassScope();
+    if (cls && !cls->isRedeclaring() &&
+        cls->derivesFromRedeclaring() == ClassScope::FromNormal) {
+      FunctionScopePtr func = cls->findFunction(ar, m_name, false);
+      if (func && (func->isPrivate() || func->isFinal())) {
+        return inlineCall(ar, func);
+      }
+    }
+  }
+  return ExpressionPtr();
 }
 
 ExpressionPtr ObjectMethodExpression::postOptimize(AnalysisResultPtr ar) {
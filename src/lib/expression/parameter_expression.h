@@ -39,6 +39,8 @@ public:
   bool hasRTTI() const { return m_hasRTTI;}
   void setHasRTTI() { m_hasRTTI = true;}
   const std::string &getName() const { return m_name;}
+  const std::string &getTypeHint() const { return m_type;}
+  ExpressionPtr defaultValue() const { return m_defaultValue;}
   void defaultToNull(AnalysisResultPtr ar);
 
   void rename(const std::string &name) { m_name = name;}
@@ -29,7 +29,11 @@
 #include <util/util.h>
 #include <lib/option.h>
 #include <lib/expression/simple_variable.h>
+#include <lib/expression/binary_op_expression.h>
+#include <lib/expression/unary_op_expression.h>
+#include <lib/expression/qop_expression.h>
 #include <lib/parser/parser.h>
+#include <lib/parser/hphp.tab.hpp>
 #include <cpp/base/type_string.h>
 #include <cpp/base/type_variant.h>
 
@@ -175,6 +179,87 @@ void SimpleFunctionCall::onParse(AnalysisResultPtr ar) {
                                 shared_from_this(), name);
 }
 
+ExpressionPtr SimpleFunctionCall::dispatchSpecialized(AnalysisResultPtr ar,
+                                                      const string &clone,
+                                                      const TypePtrVec &types) {
+  if (!m_className.empty() || (m_context & (LValue | RefValue))) {
+    return ExpressionPtr();
+  }
+  int argCount = m_params ? m_params->getCount() : 0;
+  for (int i = 0; i < argCount; i++) {
+    ExpressionPtr arg = (*m_params)[i];
+    // guards are evaluated before any of the arguments
+    if (arg->hasEffect() || (arg->getContext() & RefParameter)) {
+      return ExpressionPtr();
+    }
+  }
+  for (int i = argCount; i < (int)types.size(); i++) {
+    if (types[i]) return ExpressionPtr();
+  }
+
+  ExpressionPtr cond;
+  ExpressionListPtr params(new ExpressionList(getLocation(),
+                                              KindOfExpressionList));
+  for (int i = 0; i < argCount; i++) {
+    ExpressionPtr arg = (*m_params)[i];
+    TypePtr type = i < (int)types.size() ? types[i] : TypePtr();
+    if (!type) {
+      params->addElement(arg->clone());
+      continue;
+    }
+    const char *check;
+    int cast;
+    if (type->is(Type::KindOfInt64)) {
+      check = "is_int";    cast = T_INT_CAST;
+    } else if (type->is(Type::KindOfString)) {
+      check = "is_string"; cast = T_STRING_CAST;
+    } else {
+      ASSERT(type->is(Type::KindOfArray));
+      check = "is_array";  cast = T_ARRAY_CAST;
+    }
+    ScalarExpressionPtr sc = dynamic_pointer_cast<ScalarExpression>(arg);
+    if (sc) {
+      // literals are known statically
+      if ((type->is(Type::KindOfInt64) && sc->getType() == T_LNUMBER) ||
+          (type->is(Type::KindOfString) && sc->isLiteralString())) {
+        params->addElement(arg->clone());
+        continue;
+      }
+      return ExpressionPtr();
+    }
+    SimpleVariablePtr var = dynamic_pointer_cast<SimpleVariable>(arg);
+    if (!var || var->getName() == "this") return ExpressionPtr();
+
+    ExpressionListPtr checkParams(new ExpressionList(getLocation(),
+                                                     KindOfExpressionList));
+    checkParams->addElement(arg->clone());
+    SimpleFunctionCallPtr guard
+      (new SimpleFunctionCall(getLocation(), KindOfSimpleFunctionCall,
+                              check, checkParams, NULL));
+    guard->onParse(ar);
+    if (cond) {
+      cond = BinaryOpExpressionPtr
+        (new BinaryOpExpression(getLocation(), KindOfBinaryOpExpression,
+                                cond, guard, T_BOOLEAN_AND));
+    } else {
+      cond = guard;
+    }
+    params->addElement(UnaryOpExpressionPtr
+      (new UnaryOpExpression(getLocation(), KindOfUnaryOpExpression,
+                             arg->clone(), cast, true)));
+  }
+
+  SimpleFunctionCallPtr call
+    (new SimpleFunctionCall(getLocation(), KindOfSimpleFunctionCall,
+                            clone, params, NULL));
+  call->onParse(ar);
+  if (!cond) return call;
+  return QOpExpressionPtr
+    (new QOpExpression(getLocation(), KindOfQOpExpression,
+                       cond, call,
+                       dynamic_pointer_cast<Expression>(shared_from_this())));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // static analysis functions
 
@@ -285,7 +370,8 @@ void SimpleFunctionCall::analyzeProgram(AnalysisResultPtr ar) {
           }
           case FunctionExistsFunction: {
             FunctionScopePtr func = ar->findFunction(Util::toLower(symbol));
-            if (func && func->isUserFunction()) {
+            if (func && func->isUserFunction() &&
+                !func->isInternalFunction()) {
               func->setVolatile();
             }
             break;
@@ -379,7 +465,7 @@ ExpressionPtr SimpleFunctionCall::preOptimize(AnalysisResultPtr ar) {
         }
         case FunctionExistsFunction: {
           FunctionScopePtr func = ar->findFunction(Util::toLower(symbol));
-          if (!func) {
+          if (!func || func->isInternalFunction()) {
             return CONSTANT("false");
           } else if (!func->isVolatile()) {
             return CONSTANT("true");
@@ -410,6 +496,9 @@ ExpressionPtr SimpleFunctionCall::preOptimize(AnalysisResultPtr ar) {
       }
     }
   }
+  if (m_className.empty()) {
+    return inlineCall(ar, m_funcScope);
+  }
   return ExpressionPtr();
 }
 
@@ -741,7 +830,7 @@ void SimpleFunctionCall::outputCPPImpl(CodeGenerator &cg,
           case FunctionExistsFunction:
             {
               FunctionScopePtr func = ar->findFunction(Util::toLower(symbol));
-              if (func) {
+              if (func && !func->isInternalFunction()) {
                 if (func->isRedeclaring()) {
                   const char *name = func->getName().c_str();
                   cg.printf("(%s->%s%s != invoke_failed_%s)",
@@ -38,6 +38,17 @@ public:
   bool isDefineWithoutImpl(AnalysisResultPtr ar);
   void setValid() { m_valid = true; }
   void setNoPrefix() { m_noPrefix = true; }
+  bool hasNoPrefix() const { return m_noPrefix; }
+
+  /**
+   * Calls the type-specialized clone instead, when the arguments for all
+   * non-null types pass an is_int()/is_string()/is_array() check; falls
+   * back to this call otherwise. Returns null when an argument can't be
+   * checked without evaluating it twice.
+   */
+  ExpressionPtr dispatchSpecialized(AnalysisResultPtr ar,
+                                    const std::string &clone,
+                                    const TypePtrVec &types);
 
   virtual TypePtr inferAndCheck(AnalysisResultPtr ar, TypePtr type,
                                 bool coerce);
@@ -36,6 +36,7 @@ public:
                                 bool coerce);
 
   const std::string &getName() const { return m_name;}
+  void rename(const std::string &name) { m_name = name;}
 
 private:
   std::string m_name;
@@ -84,6 +84,8 @@ bool Option::Load(VariableTablePtr variables) {
   LOAD_OPTION(ConditionalIncludeExpandLevel);
   LOAD_OPTION(DependencyMaxProgram);
   LOAD_OPTION(CodeErrorMaxProgram);
+  LOAD_OPTION(AutoInline);
+  LOAD_OPTION(KeepFrames);
   return true;
 }
 
@@ -188,6 +190,9 @@ std::string Option::RTTIOutputFile;
 std::string Option::RTTIDirectory;
 bool Option::GenRTTIProfileData = false;
 bool Option::UseRTTIProfileData = false;
+bool Option::GenCallProfileData = false;
+bool Option::UseCallProfileData = false;
+int Option::HotFunctionCoverage = 99;
 
 bool Option::StaticMethodAutoFix = false;
 
@@ -216,6 +221,8 @@ int Option::InvokeFewArgsCount = 6;
 bool Option::PrecomputeLiteralStrings = false;
 bool Option::FlattenInvoke = true;
 int Option::InlineFunctionThreshold = -1;
+int Option::AutoInline = 8;
+bool Option::KeepFrames = false;
 bool Option::ControlEvalOrder = true;
 
 bool Option::AllDynamic = false;
@@ -501,9 +508,16 @@ void Option::Load(Hdf &config) {
   FlibDirectory = config["FlibDirectory"].getString();
   EnableXHP = config["EnableXHP"].getBool();
   RTTIOutputFile = config["RTTIOutputFile"].getString();
+  GenCallProfileData = config["GenCallProfileData"].getBool();
+  HotFunctionCoverage = config["HotFunctionCoverage"].getInt32(99);
+  if (HotFunctionCoverage <= 0 || HotFunctionCoverage > 100) {
+    HotFunctionCoverage = 99;
+  }
   EnableEval = (EvalLevel)config["EnableEval"].getByte(0);
   AllDynamic = config["AllDynamic"].getBool();
   AllVolatile = config["AllVolatile"].getBool();
+  AutoInline = config["AutoInline"].getInt32(8);
+  KeepFrames = config["KeepFrames"].getBool();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -119,6 +119,19 @@ public:
   static bool GenRTTIProfileData;
   static bool UseRTTIProfileData;
 
+  /**
+   * Whether to instrument every function and method with a call counter,
+   * whose output is later fed back with --call-profile-directory.
+   */
+  static bool GenCallProfileData;
+  static bool UseCallProfileData;
+
+  /**
+   * With call profile data, the most frequently called functions that
+   * together account for this percentage of all calls are laid out as hot.
+   */
+  static int HotFunctionCoverage;
+
   /**
    * Whether to change a method to static if it is called statically
    */
@@ -286,6 +299,8 @@ public:
   static bool PrecomputeLiteralStrings;
   static bool FlattenInvoke;
   static int InlineFunctionThreshold;
+  static int AutoInline; // max body size of functions inlined at call sites
+  static bool KeepFrames; // no inlining, so backtraces show every call
   static bool ControlEvalOrder;
 
 private:
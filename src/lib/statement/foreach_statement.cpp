@@ -21,6 +21,7 @@
 #include <lib/option.h>
 #include <lib/analysis/code_error.h>
 #include <lib/analysis/class_scope.h>
+#include <lib/analysis/escape_analysis.h>
 
 using namespace HPHP;
 using namespace std;
@@ -35,7 +36,7 @@ ForEachStatement::ForEachStatement
  ExpressionPtr value, bool valueRef, StatementPtr stmt)
   : Statement(STATEMENT_CONSTRUCTOR_PARAMETER_VALUES),
     m_array(array), m_name(name), m_value(value), m_ref(valueRef),
-    m_stmt(stmt) {
+    m_stmt(stmt), m_borrowArray(false) {
   if (!m_value) {
     m_value = m_name;
     m_ref = nameRef;
@@ -74,6 +75,16 @@ void ForEachStatement::analyzeProgram(AnalysisResultPtr ar) {
   if (m_name) m_name->analyzeProgram(ar);
   m_value->analyzeProgram(ar);
   if (m_stmt) m_stmt->analyzeProgram(ar);
+
+  if (ar->getPhase() == AnalysisResult::AnalyzeFinal) {
+    // A local array that nothing in the loop can modify or capture stays
+    // alive for the whole iteration, so the iterator may borrow it.
+    m_borrowArray = !m_ref &&
+      m_array->is(Expression::KindOfSimpleVariable) &&
+      EscapeAnalysis::IsStableLocal
+      (ar, dynamic_pointer_cast<SimpleVariable>(m_array),
+       shared_from_this());
+  }
 }
 
 ConstructPtr ForEachStatement::getNthKid(int n) const {
@@ -234,21 +245,28 @@ void ForEachStatement::outputCPP(CodeGenerator &cg, AnalysisResultPtr ar) {
       TypePtr actualType = m_array->getActualType();
       if (actualType && actualType->is(Type::KindOfArray)) {
         isArray = true;
-        cg.printf("ArrayIter %s%d = ", Option::IterPrefix, iterId);
+        cg.printf("ArrayIter %s%d", Option::IterPrefix, iterId);
       } else {
         cg.printf("ArrayIterPtr %s%d = ", Option::IterPrefix, iterId);
       }
       TypePtr expectedType = m_array->getExpectedType();
       // Clear m_expectedType to avoid type cast (toArray).
       m_array->setExpectedType(TypePtr());
-      m_array->outputCPP(cg, ar);
-      m_array->setExpectedType(expectedType);
-      cg.printf(".begin(");
-      ClassScopePtr cls = ar->getClassScope();
-      if (cls) {
-        cg.printf("\"%s\"", cls->getName().c_str());
+      if (isArray && m_borrowArray) {
+        cg.printf("(");
+        m_array->outputCPP(cg, ar);
+        cg.printf(", ArrayIter::noIncRef); ");
+      } else {
+        if (isArray) cg.printf(" = ");
+        m_array->outputCPP(cg, ar);
+        cg.printf(".begin(");
+        ClassScopePtr cls = ar->getClassScope();
+        if (cls) {
+          cg.printf("\"%s\"", cls->getName().c_str());
+        }
+        cg.printf("); ");
       }
-      cg.printf("); ");
+      m_array->setExpectedType(expectedType);
       if (isArray) {
         cg.printf("!%s%d.end(); ", Option::IterPrefix, iterId);
         cg.printf("++%s%d", Option::IterPrefix, iterId);
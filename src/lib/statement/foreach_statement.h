@@ -43,6 +43,7 @@ private:
   ExpressionPtr m_value;
   bool m_ref;
   StatementPtr m_stmt;
+  bool m_borrowArray; // iterate m_array without holding a reference
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -183,6 +183,7 @@ void FunctionStatement::outputCPP(CodeGenerator &cg, AnalysisResultPtr ar) {
 
   if (cg.getContext() == CodeGenerator::CppImplementation) {
     printSource(cg);
+    ar->outputCPPFunctionSection(cg, ClassScopePtr(), funcScope);
   }
 
   if (funcScope->isInlined()) cg.printf("inline ");
@@ -228,6 +229,11 @@ void FunctionStatement::outputCPP(CodeGenerator &cg, AnalysisResultPtr ar) {
       } else {
         cg.printf("FUNCTION_INJECTION(%s);\n",
                   funcScope->getOriginalName().c_str());
+        if (Option::GenCallProfileData &&
+            cg.getOutput() != CodeGenerator::SystemCPP) {
+          cg.printf("CALL_PROFILE_INJECTION(%d);\n",
+                    ar->getCallProfileId(ClassScopePtr(), funcScope));
+        }
         if (Option::GenRTTIProfileData && m_params) {
           for (int i = 0; i < m_params->getCount(); i++) {
             ParameterExpressionPtr param =
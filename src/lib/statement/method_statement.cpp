@@ -456,6 +456,7 @@ void MethodStatement::outputCPP(CodeGenerator &cg, AnalysisResultPtr ar) {
     break;
   case CodeGenerator::CppImplementation:
     if (m_stmt) {
+      ar->outputCPPFunctionSection(cg, ar->getClassScope(), funcScope);
       TypePtr type = funcScope->getReturnType();
       if (type) {
         type->outputCPPDecl(cg, ar);
@@ -489,6 +490,11 @@ void MethodStatement::outputCPP(CodeGenerator &cg, AnalysisResultPtr ar) {
                   scope->getOriginalName(), scope->getOriginalName(),
                   m_originalName.c_str());
       }
+      if (Option::GenCallProfileData &&
+          cg.getOutput() != CodeGenerator::SystemCPP) {
+        cg.printf("CALL_PROFILE_INJECTION(%d);\n",
+                  ar->getCallProfileId(ar->getClassScope(), funcScope));
+      }
       if (Option::GenRTTIProfileData && m_params) {
         for (int i = 0; i < m_params->getCount(); i++) {
           ParameterExpressionPtr param =
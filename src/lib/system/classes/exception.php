@@ -9,10 +9,9 @@ class Exception {
   function __construct($message = '', $code = 0) {
     $this->message = $message;
     $this->code = $code;
-    $this->trace = debug_backtrace();
-    $frame = array_shift($this->trace);
-    $this->file = $frame['file'];
-    $this->line = $frame['line'];
+    // only turned into an array by getTrace(), so var_dump(), print_r(),
+    // var_export() and (array) show a resource here until it is called
+    $this->trace = hphp_backtrace_snapshot($this->file, $this->line);
   }
 
   // message of exception
@@ -37,6 +36,9 @@ class Exception {
 
   // an array of the backtrace()
   final function getTrace() {
+    if (is_resource($this->trace)) {
+      $this->trace = hphp_backtrace_snapshot_array($this->trace);
+    }
     return $this->trace;
   }
 
@@ -62,6 +64,12 @@ class Exception {
   function __toString() {
     return $this->getMessage();
   }
+
+  // serializes the trace as an array
+  function __sleep() {
+    $this->getTrace();
+    return array_keys((array)$this);
+  }
 }
 
 class LogicException extends Exception {}
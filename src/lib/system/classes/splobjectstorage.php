@@ -1,60 +1,76 @@
 <?php
 
-class SplObjectStorage implements Iterator, Countable {
+class SplObjectStorage implements Iterator, Countable, ArrayAccess {
   private $storage = array();
   private $index = 0;
 
   function rewind() {
-    rewind($this->storage);
+    hphp_splobjectstorage_rewind($this);
   }
 
   function valid() {
-    return key($this->storage) !== false;
+    return hphp_splobjectstorage_valid($this);
   }
 
   function key() {
-    return $this->index;
+    return hphp_splobjectstorage_key($this);
   }
 
   function current() {
-    return current($this->storage);
+    return hphp_splobjectstorage_current($this);
   }
 
   function next() {
-    next($this->storage);
-    $this->index++;
+    hphp_splobjectstorage_next($this);
   }
 
   function count() {
-    return count($this->storage);
+    return hphp_splobjectstorage_count($this);
   }
 
   function contains($obj) {
-    if (is_object($obj)) {
-      foreach($this->storage as $object) {
-        if ($object === $obj) {
-          return true;
-        }
-      }
-    }
-    return false;
+    return hphp_splobjectstorage_contains($this, $obj);
   }
 
-  function attach($obj) {
-    if (is_object($obj) && !$this->contains($obj)) {
-      $this->storage[] = $obj;
-    }
+  function attach($obj, $inf = null) {
+    hphp_splobjectstorage_attach($this, $obj, $inf);
   }
 
   function detach($obj) {
-    if (is_object($obj)) {
-      foreach($this->storage as $idx => $object) {
-        if ($object === $obj) {
-          unset($this->storage[$idx]);
-          $this->rewind();
-          return;
-        }
-      }
+    hphp_splobjectstorage_detach($this, $obj);
+  }
+
+  function getInfo() {
+    return hphp_splobjectstorage_getinfo($this);
+  }
+
+  function setInfo($inf) {
+    hphp_splobjectstorage_setinfo($this, $inf);
+  }
+
+  function offsetExists($obj) {
+    return hphp_splobjectstorage_contains($this, $obj);
+  }
+
+  function offsetGet($obj) {
+    return hphp_splobjectstorage_offsetget($this, $obj);
+  }
+
+  function offsetSet($obj, $inf) {
+    hphp_splobjectstorage_attach($this, $obj, $inf);
+  }
+
+  function offsetUnset($obj) {
+    hphp_splobjectstorage_detach($this, $obj);
+  }
+
+  function __wakeup() {
+    // objects got new ids, which $storage is keyed by
+    $storage = $this->storage;
+    $this->storage = array();
+    $this->index = 0;
+    foreach ($storage as $entry) {
+      hphp_splobjectstorage_attach($this, $entry['obj'], $entry['inf']);
     }
   }
 }
@@ -43,6 +43,7 @@ class c_exception : virtual public ObjectData {
   public: Variant t_gettrace();
   public: String t_gettraceasstring();
   public: String t___tostring();
+  public: Variant t___sleep();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
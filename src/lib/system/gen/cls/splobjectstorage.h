@@ -19,16 +19,18 @@
 
 #include <cls/iterator.h>
 #include <cls/countable.h>
+#include <cls/arrayaccess.h>
 
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
 /* SRC: classes/splobjectstorage.php line 3 */
-class c_splobjectstorage : virtual public c_iterator, virtual public c_countable {
+class c_splobjectstorage : virtual public c_iterator, virtual public c_countable, virtual public c_arrayaccess {
   BEGIN_CLASS_MAP(splobjectstorage)
     PARENT_CLASS(traversable)
     PARENT_CLASS(iterator)
     PARENT_CLASS(countable)
+    PARENT_CLASS(arrayaccess)
   END_CLASS_MAP(splobjectstorage)
   DECLARE_CLASS(splobjectstorage, SplObjectStorage, ObjectData)
   DECLARE_INVOKES_FROM_EVAL
@@ -40,10 +42,18 @@ class c_splobjectstorage : virtual public c_iterator, virtual public c_countable
   public: int64 t_key();
   public: Variant t_current();
   public: void t_next();
-  public: int t_count();
+  public: int64 t_count();
   public: bool t_contains(CVarRef v_obj);
-  public: void t_attach(CVarRef v_obj);
+  public: void t_attach(CVarRef v_obj, CVarRef v_inf = null_variant);
   public: void t_detach(CVarRef v_obj);
+  public: Variant t_getinfo();
+  public: void t_setinfo(CVarRef v_inf);
+  public: bool t_offsetexists(CVarRef v_obj);
+  public: Variant t_offsetget(Variant v_obj);
+  public: virtual Variant &___offsetget_lval(Variant v_obj);
+  public: void t_offsetset(CVarRef v_obj, CVarRef v_inf);
+  public: void t_offsetunset(CVarRef v_obj);
+  public: Variant t___wakeup();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
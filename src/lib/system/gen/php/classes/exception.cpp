@@ -23,7 +23,7 @@ namespace HPHP {
 
 /* preface starts */
 /* preface finishes */
-/* SRC: classes/exception.php line 79 */
+/* SRC: classes/exception.php line 86 */
 Variant c_unexpectedvalueexception::os_get(const char *s, int64 hash) {
   return c_runtimeexception::os_get(s, hash);
 }
@@ -81,6 +81,11 @@ Variant c_unexpectedvalueexception::o_invoke(const char *s, CArrRef params, int6
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -126,6 +131,11 @@ Variant c_unexpectedvalueexception::o_invoke_few_args(const char *s, int64 hash,
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -208,6 +218,18 @@ Variant c_unexpectedvalueexception::o_invoke_from_eval(const char *s, Eval::Vari
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
@@ -276,7 +298,7 @@ Variant cw_unexpectedvalueexception$os_invoke(const char *c, const char *s, CArr
 void c_unexpectedvalueexception::init() {
   c_runtimeexception::init();
 }
-/* SRC: classes/exception.php line 76 */
+/* SRC: classes/exception.php line 83 */
 Variant c_overflowexception::os_get(const char *s, int64 hash) {
   return c_runtimeexception::os_get(s, hash);
 }
@@ -334,6 +356,11 @@ Variant c_overflowexception::o_invoke(const char *s, CArrRef params, int64 hash,
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -379,6 +406,11 @@ Variant c_overflowexception::o_invoke_few_args(const char *s, int64 hash, int co
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -461,6 +493,18 @@ Variant c_overflowexception::o_invoke_from_eval(const char *s, Eval::VariableEnv
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
@@ -529,7 +573,7 @@ Variant cw_overflowexception$os_invoke(const char *c, const char *s, CArrRef par
 void c_overflowexception::init() {
   c_runtimeexception::init();
 }
-/* SRC: classes/exception.php line 75 */
+/* SRC: classes/exception.php line 82 */
 Variant c_outofboundsexception::os_get(const char *s, int64 hash) {
   return c_runtimeexception::os_get(s, hash);
 }
@@ -587,6 +631,11 @@ Variant c_outofboundsexception::o_invoke(const char *s, CArrRef params, int64 ha
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -632,6 +681,11 @@ Variant c_outofboundsexception::o_invoke_few_args(const char *s, int64 hash, int
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -714,6 +768,18 @@ Variant c_outofboundsexception::o_invoke_from_eval(const char *s, Eval::Variable
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
@@ -782,7 +848,7 @@ Variant cw_outofboundsexception$os_invoke(const char *c, const char *s, CArrRef
 void c_outofboundsexception::init() {
   c_runtimeexception::init();
 }
-/* SRC: classes/exception.php line 67 */
+/* SRC: classes/exception.php line 74 */
 Variant c_logicexception::os_get(const char *s, int64 hash) {
   return c_exception::os_get(s, hash);
 }
@@ -840,6 +906,11 @@ Variant c_logicexception::o_invoke(const char *s, CArrRef params, int64 hash, bo
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -885,6 +956,11 @@ Variant c_logicexception::o_invoke_few_args(const char *s, int64 hash, int count
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -967,6 +1043,18 @@ Variant c_logicexception::o_invoke_from_eval(const char *s, Eval::VariableEnviro
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
@@ -1035,7 +1123,7 @@ Variant cw_logicexception$os_invoke(const char *c, const char *s, CArrRef params
 void c_logicexception::init() {
   c_exception::init();
 }
-/* SRC: classes/exception.php line 77 */
+/* SRC: classes/exception.php line 84 */
 Variant c_rangeexception::os_get(const char *s, int64 hash) {
   return c_runtimeexception::os_get(s, hash);
 }
@@ -1093,6 +1181,11 @@ Variant c_rangeexception::o_invoke(const char *s, CArrRef params, int64 hash, bo
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -1138,6 +1231,11 @@ Variant c_rangeexception::o_invoke_few_args(const char *s, int64 hash, int count
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -1220,6 +1318,18 @@ Variant c_rangeexception::o_invoke_from_eval(const char *s, Eval::VariableEnviro
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
@@ -1288,7 +1398,7 @@ Variant cw_rangeexception$os_invoke(const char *c, const char *s, CArrRef params
 void c_rangeexception::init() {
   c_runtimeexception::init();
 }
-/* SRC: classes/exception.php line 71 */
+/* SRC: classes/exception.php line 78 */
 Variant c_invalidargumentexception::os_get(const char *s, int64 hash) {
   return c_logicexception::os_get(s, hash);
 }
@@ -1346,6 +1456,11 @@ Variant c_invalidargumentexception::o_invoke(const char *s, CArrRef params, int6
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -1391,6 +1506,11 @@ Variant c_invalidargumentexception::o_invoke_few_args(const char *s, int64 hash,
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -1473,6 +1593,18 @@ Variant c_invalidargumentexception::o_invoke_from_eval(const char *s, Eval::Vari
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
@@ -1541,7 +1673,7 @@ Variant cw_invalidargumentexception$os_invoke(const char *c, const char *s, CArr
 void c_invalidargumentexception::init() {
   c_logicexception::init();
 }
-/* SRC: classes/exception.php line 78 */
+/* SRC: classes/exception.php line 85 */
 Variant c_underflowexception::os_get(const char *s, int64 hash) {
   return c_runtimeexception::os_get(s, hash);
 }
@@ -1599,6 +1731,11 @@ Variant c_underflowexception::o_invoke(const char *s, CArrRef params, int64 hash
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -1644,6 +1781,11 @@ Variant c_underflowexception::o_invoke_few_args(const char *s, int64 hash, int c
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -1726,6 +1868,18 @@ Variant c_underflowexception::o_invoke_from_eval(const char *s, Eval::VariableEn
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
@@ -1794,7 +1948,7 @@ Variant cw_underflowexception$os_invoke(const char *c, const char *s, CArrRef pa
 void c_underflowexception::init() {
   c_runtimeexception::init();
 }
-/* SRC: classes/exception.php line 73 */
+/* SRC: classes/exception.php line 80 */
 Variant c_outofrangeexception::os_get(const char *s, int64 hash) {
   return c_logicexception::os_get(s, hash);
 }
@@ -1852,6 +2006,11 @@ Variant c_outofrangeexception::o_invoke(const char *s, CArrRef params, int64 has
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -1897,6 +2056,11 @@ Variant c_outofrangeexception::o_invoke_few_args(const char *s, int64 hash, int
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -1979,6 +2143,18 @@ Variant c_outofrangeexception::o_invoke_from_eval(const char *s, Eval::VariableE
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
@@ -2047,7 +2223,7 @@ Variant cw_outofrangeexception$os_invoke(const char *c, const char *s, CArrRef p
 void c_outofrangeexception::init() {
   c_logicexception::init();
 }
-/* SRC: classes/exception.php line 69 */
+/* SRC: classes/exception.php line 76 */
 Variant c_badmethodcallexception::os_get(const char *s, int64 hash) {
   return c_badfunctioncallexception::os_get(s, hash);
 }
@@ -2105,6 +2281,11 @@ Variant c_badmethodcallexception::o_invoke(const char *s, CArrRef params, int64
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -2150,6 +2331,11 @@ Variant c_badmethodcallexception::o_invoke_few_args(const char *s, int64 hash, i
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -2232,6 +2418,18 @@ Variant c_badmethodcallexception::o_invoke_from_eval(const char *s, Eval::Variab
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
@@ -2300,7 +2498,7 @@ Variant cw_badmethodcallexception$os_invoke(const char *c, const char *s, CArrRe
 void c_badmethodcallexception::init() {
   c_badfunctioncallexception::init();
 }
-/* SRC: classes/exception.php line 74 */
+/* SRC: classes/exception.php line 81 */
 Variant c_runtimeexception::os_get(const char *s, int64 hash) {
   return c_exception::os_get(s, hash);
 }
@@ -2358,6 +2556,11 @@ Variant c_runtimeexception::o_invoke(const char *s, CArrRef params, int64 hash,
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -2403,6 +2606,11 @@ Variant c_runtimeexception::o_invoke_few_args(const char *s, int64 hash, int cou
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -2485,6 +2693,18 @@ Variant c_runtimeexception::o_invoke_from_eval(const char *s, Eval::VariableEnvi
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
@@ -2712,6 +2932,11 @@ Variant c_exception::o_invoke(const char *s, CArrRef params, int64 hash, bool fa
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -2757,6 +2982,11 @@ Variant c_exception::o_invoke_few_args(const char *s, int64 hash, int count, CVa
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -2839,6 +3069,18 @@ Variant c_exception::o_invoke_from_eval(const char *s, Eval::VariableEnvironment
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
@@ -2916,42 +3158,40 @@ void c_exception::t___construct(Variant v_message //  = ""
 ) {
   INSTANCE_METHOD_INJECTION(Exception, Exception::__construct);
   bool oldInCtor = gasInCtor(true);
-  Variant v_frame;
-
   m_message = v_message;
   m_code = v_code;
-  o_lval("trace", 0x0253015494C9CE77LL) = x_debug_backtrace();
-  v_frame = x_array_shift(ref(lval(o_lval("trace", 0x0253015494C9CE77LL))));
-  m_file = v_frame.rvalAt("file", 0x612E37678CE7DB5BLL);
-  m_line = v_frame.rvalAt("line", 0x21093C71DDF8728CLL);
+  o_lval("trace", 0x0253015494C9CE77LL) = x_hphp_backtrace_snapshot(ref(m_file), ref(m_line));
   gasInCtor(oldInCtor);
 } /* function */
-/* SRC: classes/exception.php line 19 */
+/* SRC: classes/exception.php line 17 */
 Variant c_exception::t_getmessage() {
   INSTANCE_METHOD_INJECTION(Exception, Exception::getMessage);
   return m_message;
 } /* function */
-/* SRC: classes/exception.php line 24 */
+/* SRC: classes/exception.php line 22 */
 Variant c_exception::t_getcode() {
   INSTANCE_METHOD_INJECTION(Exception, Exception::getCode);
   return m_code;
 } /* function */
-/* SRC: classes/exception.php line 29 */
+/* SRC: classes/exception.php line 27 */
 Variant c_exception::t_getfile() {
   INSTANCE_METHOD_INJECTION(Exception, Exception::getFile);
   return m_file;
 } /* function */
-/* SRC: classes/exception.php line 34 */
+/* SRC: classes/exception.php line 32 */
 Variant c_exception::t_getline() {
   INSTANCE_METHOD_INJECTION(Exception, Exception::getLine);
   return m_line;
 } /* function */
-/* SRC: classes/exception.php line 39 */
+/* SRC: classes/exception.php line 37 */
 Variant c_exception::t_gettrace() {
   INSTANCE_METHOD_INJECTION(Exception, Exception::getTrace);
+  if (x_is_resource(o_get("trace", 0x0253015494C9CE77LL))) {
+    o_lval("trace", 0x0253015494C9CE77LL) = x_hphp_backtrace_snapshot_array(toObject(o_get("trace", 0x0253015494C9CE77LL)));
+  }
   return o_get("trace", 0x0253015494C9CE77LL);
 } /* function */
-/* SRC: classes/exception.php line 44 */
+/* SRC: classes/exception.php line 45 */
 String c_exception::t_gettraceasstring() {
   INSTANCE_METHOD_INJECTION(Exception, Exception::getTraceAsString);
   int64 v_i = 0;
@@ -2976,12 +3216,18 @@ String c_exception::t_gettraceasstring() {
   concat_assign(v_s, concat3("#", toString(v_i), " {main}"));
   return v_s;
 } /* function */
-/* SRC: classes/exception.php line 62 */
+/* SRC: classes/exception.php line 63 */
 String c_exception::t___tostring() {
   INSTANCE_METHOD_INJECTION(Exception, Exception::__toString);
   return toString(t_getmessage());
 } /* function */
 /* SRC: classes/exception.php line 68 */
+Variant c_exception::t___sleep() {
+  INSTANCE_METHOD_INJECTION(Exception, Exception::__sleep);
+  t_gettrace();
+  return x_array_keys(toArray(((Object)(this))));
+} /* function */
+/* SRC: classes/exception.php line 75 */
 Variant c_badfunctioncallexception::os_get(const char *s, int64 hash) {
   return c_logicexception::os_get(s, hash);
 }
@@ -3039,6 +3285,11 @@ Variant c_badfunctioncallexception::o_invoke(const char *s, CArrRef params, int6
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -3084,6 +3335,11 @@ Variant c_badfunctioncallexception::o_invoke_few_args(const char *s, int64 hash,
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -3166,6 +3422,18 @@ Variant c_badfunctioncallexception::o_invoke_from_eval(const char *s, Eval::Vari
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
@@ -3234,7 +3502,7 @@ Variant cw_badfunctioncallexception$os_invoke(const char *c, const char *s, CArr
 void c_badfunctioncallexception::init() {
   c_logicexception::init();
 }
-/* SRC: classes/exception.php line 72 */
+/* SRC: classes/exception.php line 79 */
 Variant c_lengthexception::os_get(const char *s, int64 hash) {
   return c_logicexception::os_get(s, hash);
 }
@@ -3292,6 +3560,11 @@ Variant c_lengthexception::o_invoke(const char *s, CArrRef params, int64 hash, b
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -3337,6 +3610,11 @@ Variant c_lengthexception::o_invoke_few_args(const char *s, int64 hash, int coun
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -3419,6 +3697,18 @@ Variant c_lengthexception::o_invoke_from_eval(const char *s, Eval::VariableEnvir
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
@@ -3487,7 +3777,7 @@ Variant cw_lengthexception$os_invoke(const char *c, const char *s, CArrRef param
 void c_lengthexception::init() {
   c_logicexception::init();
 }
-/* SRC: classes/exception.php line 70 */
+/* SRC: classes/exception.php line 77 */
 Variant c_domainexception::os_get(const char *s, int64 hash) {
   return c_logicexception::os_get(s, hash);
 }
@@ -3545,6 +3835,11 @@ Variant c_domainexception::o_invoke(const char *s, CArrRef params, int64 hash, b
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -3590,6 +3885,11 @@ Variant c_domainexception::o_invoke_few_args(const char *s, int64 hash, int coun
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         return (t_getfile());
@@ -3672,6 +3972,18 @@ Variant c_domainexception::o_invoke_from_eval(const char *s, Eval::VariableEnvir
         return (t_gettrace());
       }
       break;
+    case 13:
+      HASH_GUARD(0x61D1244DDADBC02DLL, __sleep) {
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t___sleep());
+      }
+      break;
     case 14:
       HASH_GUARD(0x3CE90CB8F0C9579ELL, getfile) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
@@ -14,6 +14,7 @@
    +----------------------------------------------------------------------+
 */
 
+#include <php/classes/arrayaccess.h>
 #include <php/classes/iterator.h>
 #include <php/classes/splobjectstorage.h>
 #include <cpp/ext/ext.h>
@@ -105,19 +106,34 @@ void c_splobjectstorage::cloneSet(c_splobjectstorage *clone) {
 Variant c_splobjectstorage::o_invoke(const char *s, CArrRef params, int64 hash, bool fatal) {
   if (hash < 0) hash = hash_string_i(s);
   switch (hash & 31) {
+    case 0:
+      HASH_GUARD(0x3E6BCFB9742FC700LL, offsetexists) {
+        return (t_offsetexists(params.rvalAt(0)));
+      }
+      break;
     case 4:
       HASH_GUARD(0x6413CB5154808C44LL, valid) {
         return (t_valid());
       }
       break;
+    case 7:
+      HASH_GUARD(0x2D9D1E897828CA07LL, getinfo) {
+        return (t_getinfo());
+      }
+      break;
     case 10:
       HASH_GUARD(0x1670096FDE27AF6ALL, rewind) {
         return (t_rewind(), null);
       }
+      HASH_GUARD(0x2CDA6B454BEC094ALL, setinfo) {
+        return (t_setinfo(params.rvalAt(0)), null);
+      }
       break;
     case 12:
       HASH_GUARD(0x62DD82BFEB88A4ACLL, attach) {
-        return (t_attach(params.rvalAt(0)), null);
+        int count = params.size();
+        if (count <= 1) return (t_attach(params.rvalAt(0)), null);
+        return (t_attach(params.rvalAt(0), params.rvalAt(1)), null);
       }
       break;
     case 16:
@@ -139,14 +155,28 @@ Variant c_splobjectstorage::o_invoke(const char *s, CArrRef params, int64 hash,
       }
       break;
     case 24:
+      HASH_GUARD(0x61D11ECEF4404498LL, offsetget) {
+        return (t_offsetget(params.rvalAt(0)));
+      }
       HASH_GUARD(0x3C6D50F3BB8102B8LL, next) {
         return (t_next(), null);
       }
+      HASH_GUARD(0x0957F693A48AF738LL, offsetset) {
+        return (t_offsetset(params.rvalAt(0), params.rvalAt(1)), null);
+      }
+      break;
+    case 26:
+      HASH_GUARD(0x08329980E6369ABALL, offsetunset) {
+        return (t_offsetunset(params.rvalAt(0)), null);
+      }
       break;
     case 28:
       HASH_GUARD(0x5B3A4A72846B21DCLL, current) {
         return (t_current());
       }
+      HASH_GUARD(0x4389F50CAA085CDCLL, __wakeup) {
+        return (t___wakeup());
+      }
       break;
     default:
       break;
@@ -156,19 +186,33 @@ Variant c_splobjectstorage::o_invoke(const char *s, CArrRef params, int64 hash,
 Variant c_splobjectstorage::o_invoke_few_args(const char *s, int64 hash, int count, CVarRef a0, CVarRef a1, CVarRef a2, CVarRef a3, CVarRef a4, CVarRef a5) {
   if (hash < 0) hash = hash_string_i(s);
   switch (hash & 31) {
+    case 0:
+      HASH_GUARD(0x3E6BCFB9742FC700LL, offsetexists) {
+        return (t_offsetexists(a0));
+      }
+      break;
     case 4:
       HASH_GUARD(0x6413CB5154808C44LL, valid) {
         return (t_valid());
       }
       break;
+    case 7:
+      HASH_GUARD(0x2D9D1E897828CA07LL, getinfo) {
+        return (t_getinfo());
+      }
+      break;
     case 10:
       HASH_GUARD(0x1670096FDE27AF6ALL, rewind) {
         return (t_rewind(), null);
       }
+      HASH_GUARD(0x2CDA6B454BEC094ALL, setinfo) {
+        return (t_setinfo(a0), null);
+      }
       break;
     case 12:
       HASH_GUARD(0x62DD82BFEB88A4ACLL, attach) {
-        return (t_attach(a0), null);
+        if (count <= 1) return (t_attach(a0), null);
+        return (t_attach(a0, a1), null);
       }
       break;
     case 16:
@@ -190,14 +234,28 @@ Variant c_splobjectstorage::o_invoke_few_args(const char *s, int64 hash, int cou
       }
       break;
     case 24:
+      HASH_GUARD(0x61D11ECEF4404498LL, offsetget) {
+        return (t_offsetget(a0));
+      }
       HASH_GUARD(0x3C6D50F3BB8102B8LL, next) {
         return (t_next(), null);
       }
+      HASH_GUARD(0x0957F693A48AF738LL, offsetset) {
+        return (t_offsetset(a0, a1), null);
+      }
+      break;
+    case 26:
+      HASH_GUARD(0x08329980E6369ABALL, offsetunset) {
+        return (t_offsetunset(a0), null);
+      }
       break;
     case 28:
       HASH_GUARD(0x5B3A4A72846B21DCLL, current) {
         return (t_current());
       }
+      HASH_GUARD(0x4389F50CAA085CDCLL, __wakeup) {
+        return (t___wakeup());
+      }
       break;
     default:
       break;
@@ -210,6 +268,22 @@ Variant c_splobjectstorage::os_invoke(const char *c, const char *s, CArrRef para
 Variant c_splobjectstorage::o_invoke_from_eval(const char *s, Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller, int64 hash, bool fatal) {
   if (hash < 0) hash = hash_string_i(s);
   switch (hash & 31) {
+    case 0:
+      HASH_GUARD(0x3E6BCFB9742FC700LL, offsetexists) {
+        Variant a0;
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+          if (it == params.end()) break;
+          a0 = (*it)->eval(env);
+          it++;
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t_offsetexists(a0));
+      }
+      break;
     case 4:
       HASH_GUARD(0x6413CB5154808C44LL, valid) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
@@ -222,6 +296,18 @@ Variant c_splobjectstorage::o_invoke_from_eval(const char *s, Eval::VariableEnvi
         return (t_valid());
       }
       break;
+    case 7:
+      HASH_GUARD(0x2D9D1E897828CA07LL, getinfo) {
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t_getinfo());
+      }
+      break;
     case 10:
       HASH_GUARD(0x1670096FDE27AF6ALL, rewind) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
@@ -233,21 +319,43 @@ Variant c_splobjectstorage::o_invoke_from_eval(const char *s, Eval::VariableEnvi
         }
         return (t_rewind(), null);
       }
+      HASH_GUARD(0x2CDA6B454BEC094ALL, setinfo) {
+        Variant a0;
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+          if (it == params.end()) break;
+          a0 = (*it)->eval(env);
+          it++;
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t_setinfo(a0), null);
+      }
       break;
     case 12:
       HASH_GUARD(0x62DD82BFEB88A4ACLL, attach) {
         Variant a0;
+        Variant a1;
+        int count = 0;
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
         std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
         do {
           if (it == params.end()) break;
           a0 = (*it)->eval(env);
           it++;
+          count++;
+          if (it == params.end()) break;
+          a1 = (*it)->eval(env);
+          it++;
+          count++;
         } while(false);
         for (; it != params.end(); ++it) {
           (*it)->eval(env);
         }
-        return (t_attach(a0), null);
+        if (count <= 1) return (t_attach(a0), null);
+        return (t_attach(a0, a1), null);
       }
       break;
     case 16:
@@ -305,6 +413,20 @@ Variant c_splobjectstorage::o_invoke_from_eval(const char *s, Eval::VariableEnvi
       }
       break;
     case 24:
+      HASH_GUARD(0x61D11ECEF4404498LL, offsetget) {
+        Variant a0;
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+          if (it == params.end()) break;
+          a0 = (*it)->eval(env);
+          it++;
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t_offsetget(a0));
+      }
       HASH_GUARD(0x3C6D50F3BB8102B8LL, next) {
         const std::vector<Eval::ExpressionPtr> &params = caller->params();
         std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
@@ -315,6 +437,40 @@ Variant c_splobjectstorage::o_invoke_from_eval(const char *s, Eval::VariableEnvi
         }
         return (t_next(), null);
       }
+      HASH_GUARD(0x0957F693A48AF738LL, offsetset) {
+        Variant a0;
+        Variant a1;
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+          if (it == params.end()) break;
+          a0 = (*it)->eval(env);
+          it++;
+          if (it == params.end()) break;
+          a1 = (*it)->eval(env);
+          it++;
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t_offsetset(a0, a1), null);
+      }
+      break;
+    case 26:
+      HASH_GUARD(0x08329980E6369ABALL, offsetunset) {
+        Variant a0;
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+          if (it == params.end()) break;
+          a0 = (*it)->eval(env);
+          it++;
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t_offsetunset(a0), null);
+      }
       break;
     case 28:
       HASH_GUARD(0x5B3A4A72846B21DCLL, current) {
@@ -327,6 +483,16 @@ Variant c_splobjectstorage::o_invoke_from_eval(const char *s, Eval::VariableEnvi
         }
         return (t_current());
       }
+      HASH_GUARD(0x4389F50CAA085CDCLL, __wakeup) {
+        const std::vector<Eval::ExpressionPtr> &params = caller->params();
+        std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+        do {
+        } while(false);
+        for (; it != params.end(); ++it) {
+          (*it)->eval(env);
+        }
+        return (t___wakeup());
+      }
       break;
     default:
       break;
@@ -355,88 +521,106 @@ void c_splobjectstorage::init() {
 /* SRC: classes/splobjectstorage.php line 7 */
 void c_splobjectstorage::t_rewind() {
   INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::rewind);
-  x_rewind(toObject(m_storage));
+  x_hphp_splobjectstorage_rewind(((Object)(this)));
 } /* function */
 /* SRC: classes/splobjectstorage.php line 11 */
 bool c_splobjectstorage::t_valid() {
   INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::valid);
-  return !same(x_key(ref(lval(m_storage))), false);
+  return x_hphp_splobjectstorage_valid(((Object)(this)));
 } /* function */
 /* SRC: classes/splobjectstorage.php line 15 */
 int64 c_splobjectstorage::t_key() {
   INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::key);
-  return m_index;
+  return x_hphp_splobjectstorage_key(((Object)(this)));
 } /* function */
 /* SRC: classes/splobjectstorage.php line 19 */
 Variant c_splobjectstorage::t_current() {
   INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::current);
-  return x_current(ref(lval(m_storage)));
+  return x_hphp_splobjectstorage_current(((Object)(this)));
 } /* function */
 /* SRC: classes/splobjectstorage.php line 23 */
 void c_splobjectstorage::t_next() {
   INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::next);
-  x_next(ref(lval(m_storage)));
-  m_index++;
+  x_hphp_splobjectstorage_next(((Object)(this)));
 } /* function */
-/* SRC: classes/splobjectstorage.php line 28 */
-int c_splobjectstorage::t_count() {
+/* SRC: classes/splobjectstorage.php line 27 */
+int64 c_splobjectstorage::t_count() {
   INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::count);
-  return x_count(m_storage);
+  return x_hphp_splobjectstorage_count(((Object)(this)));
 } /* function */
-/* SRC: classes/splobjectstorage.php line 32 */
+/* SRC: classes/splobjectstorage.php line 31 */
 bool c_splobjectstorage::t_contains(CVarRef v_obj) {
   INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::contains);
-  Variant v_object;
-
-  if (x_is_object(v_obj)) {
-    {
-      LOOP_COUNTER(1);
-      Variant map2 = m_storage;
-      for (ArrayIterPtr iter3 = map2.begin("splobjectstorage"); !iter3->end(); iter3->next()) {
-        LOOP_COUNTER_CHECK(1);
-        v_object = iter3->second();
-        {
-          if (same(v_object, v_obj)) {
-            return true;
-          }
-        }
-      }
-    }
-  }
-  return false;
+  return x_hphp_splobjectstorage_contains(((Object)(this)), v_obj);
 } /* function */
-/* SRC: classes/splobjectstorage.php line 43 */
-void c_splobjectstorage::t_attach(CVarRef v_obj) {
+/* SRC: classes/splobjectstorage.php line 35 */
+void c_splobjectstorage::t_attach(CVarRef v_obj, CVarRef v_inf //  = null_variant
+) {
   INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::attach);
-  if (x_is_object(v_obj) && !(t_contains(v_obj))) {
-    m_storage.append((v_obj));
-  }
+  x_hphp_splobjectstorage_attach(((Object)(this)), v_obj, v_inf);
 } /* function */
-/* SRC: classes/splobjectstorage.php line 49 */
+/* SRC: classes/splobjectstorage.php line 39 */
 void c_splobjectstorage::t_detach(CVarRef v_obj) {
   INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::detach);
-  DECLARE_SYSTEM_GLOBALS(g);
-  Primitive v_idx = 0;
-  Variant v_object;
+  x_hphp_splobjectstorage_detach(((Object)(this)), v_obj);
+} /* function */
+/* SRC: classes/splobjectstorage.php line 43 */
+Variant c_splobjectstorage::t_getinfo() {
+  INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::getInfo);
+  return x_hphp_splobjectstorage_getinfo(((Object)(this)));
+} /* function */
+/* SRC: classes/splobjectstorage.php line 47 */
+void c_splobjectstorage::t_setinfo(CVarRef v_inf) {
+  INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::setInfo);
+  x_hphp_splobjectstorage_setinfo(((Object)(this)), v_inf);
+} /* function */
+/* SRC: classes/splobjectstorage.php line 51 */
+bool c_splobjectstorage::t_offsetexists(CVarRef v_obj) {
+  INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::offsetExists);
+  return x_hphp_splobjectstorage_contains(((Object)(this)), v_obj);
+} /* function */
+/* SRC: classes/splobjectstorage.php line 55 */
+Variant c_splobjectstorage::t_offsetget(Variant v_obj) {
+  INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::offsetGet);
+  return x_hphp_splobjectstorage_offsetget(((Object)(this)), v_obj);
+} /* function */
+/* SRC: classes/splobjectstorage.php line 55 */
+Variant &c_splobjectstorage::___offsetget_lval(Variant v_obj) {
+  INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::offsetGet);
+  Variant &v = get_system_globals()->__lvalProxy;
+  v = t_offsetget(v_obj);
+  return v;
+} /* function */
+/* SRC: classes/splobjectstorage.php line 59 */
+void c_splobjectstorage::t_offsetset(CVarRef v_obj, CVarRef v_inf) {
+  INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::offsetSet);
+  x_hphp_splobjectstorage_attach(((Object)(this)), v_obj, v_inf);
+} /* function */
+/* SRC: classes/splobjectstorage.php line 63 */
+void c_splobjectstorage::t_offsetunset(CVarRef v_obj) {
+  INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::offsetUnset);
+  x_hphp_splobjectstorage_detach(((Object)(this)), v_obj);
+} /* function */
+/* SRC: classes/splobjectstorage.php line 67 */
+Variant c_splobjectstorage::t___wakeup() {
+  INSTANCE_METHOD_INJECTION(SplObjectStorage, SplObjectStorage::__wakeup);
+  Variant v_storage;
+  Variant v_entry;
 
-  if (x_is_object(v_obj)) {
-    {
-      LOOP_COUNTER(4);
-      Variant map5 = m_storage;
-      for (ArrayIterPtr iter6 = map5.begin("splobjectstorage"); !iter6->end(); iter6->next()) {
-        LOOP_COUNTER_CHECK(4);
-        v_object = iter6->second();
-        v_idx = iter6->first();
-        {
-          if (same(v_object, v_obj)) {
-            m_storage.weakRemove(v_idx);
-            o_root_invoke_few_args("rewind", 0x1670096FDE27AF6ALL, 0);
-            return;
-          }
-        }
+  v_storage = m_storage;
+  m_storage = SystemScalarArrays::ssa_[0];
+  m_index = 0LL;
+  {
+    LOOP_COUNTER(1);
+    for (ArrayIterPtr iter3 = v_storage.begin("splobjectstorage"); !iter3->end(); iter3->next()) {
+      LOOP_COUNTER_CHECK(1);
+      v_entry = iter3->second();
+      {
+        x_hphp_splobjectstorage_attach(((Object)(this)), v_entry.rvalAt("obj", 0x7FB577570F61BD03LL), v_entry.rvalAt("inf", 0x098884B475638DDDLL));
       }
     }
   }
+  return null;
 } /* function */
 Object co_splobjectstorage(CArrRef params, bool init /* = true */) {
   return Object(p_splobjectstorage(NEW(c_splobjectstorage)())->dynCreate(params, init));
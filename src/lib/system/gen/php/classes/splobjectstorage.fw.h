@@ -31,6 +31,7 @@ FORWARD_DECLARE_CLASS(splobjectstorage)
 
 ///////////////////////////////////////////////////////////////////////////////
 }
+#include <php/classes/arrayaccess.fw.h>
 #include <php/classes/iterator.fw.h>
 
 #endif // __GENERATED_php_classes_splobjectstorage_fw_h__
@@ -22,6 +22,7 @@
 
 // Declarations
 #include <cls/splobjectstorage.h>
+#include <php/classes/arrayaccess.h>
 #include <php/classes/iterator.h>
 
 namespace HPHP {
@@ -8924,6 +8924,110 @@ Variant i_fb_call_user_func_array_safe(CArrRef params) {
   FUNCTION_INJECTION(fb_call_user_func_array_safe);
   return (f_fb_call_user_func_array_safe(params.rvalAt(0), params.rvalAt(1)));
 }
+Variant i_fb_compact_serialize(CArrRef params) {
+  FUNCTION_INJECTION(fb_compact_serialize);
+  return (f_fb_compact_serialize(params.rvalAt(0)));
+}
+Variant i_fb_compact_unserialize(CArrRef params) {
+  FUNCTION_INJECTION(fb_compact_unserialize);
+  return (f_fb_compact_unserialize(params.rvalAt(0), ref(const_cast<Array&>(params).lvalAt(1))));
+}
+Variant i_hphp_splobjectstorage_rewind(CArrRef params) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_rewind);
+  return (f_hphp_splobjectstorage_rewind(params.rvalAt(0)), null);
+}
+Variant i_hphp_splobjectstorage_valid(CArrRef params) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_valid);
+  return (f_hphp_splobjectstorage_valid(params.rvalAt(0)));
+}
+Variant i_hphp_splobjectstorage_key(CArrRef params) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_key);
+  return (f_hphp_splobjectstorage_key(params.rvalAt(0)));
+}
+Variant i_hphp_splobjectstorage_current(CArrRef params) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_current);
+  return (f_hphp_splobjectstorage_current(params.rvalAt(0)));
+}
+Variant i_hphp_splobjectstorage_next(CArrRef params) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_next);
+  return (f_hphp_splobjectstorage_next(params.rvalAt(0)), null);
+}
+Variant i_hphp_splobjectstorage_count(CArrRef params) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_count);
+  return (f_hphp_splobjectstorage_count(params.rvalAt(0)));
+}
+Variant i_hphp_splobjectstorage_contains(CArrRef params) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_contains);
+  return (f_hphp_splobjectstorage_contains(params.rvalAt(0), params.rvalAt(1)));
+}
+Variant i_hphp_splobjectstorage_attach(CArrRef params) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_attach);
+  int count = params.size();
+  if (count <= 2) return (f_hphp_splobjectstorage_attach(params.rvalAt(0), params.rvalAt(1)), null);
+  return (f_hphp_splobjectstorage_attach(params.rvalAt(0), params.rvalAt(1), params.rvalAt(2)), null);
+}
+Variant i_hphp_splobjectstorage_detach(CArrRef params) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_detach);
+  return (f_hphp_splobjectstorage_detach(params.rvalAt(0), params.rvalAt(1)), null);
+}
+Variant i_hphp_splobjectstorage_getinfo(CArrRef params) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_getinfo);
+  return (f_hphp_splobjectstorage_getinfo(params.rvalAt(0)));
+}
+Variant i_hphp_splobjectstorage_setinfo(CArrRef params) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_setinfo);
+  return (f_hphp_splobjectstorage_setinfo(params.rvalAt(0), params.rvalAt(1)), null);
+}
+Variant i_hphp_splobjectstorage_offsetget(CArrRef params) {
+  FUNCTION_INJECTION(hphp_splobjectstorage_offsetget);
+  return (f_hphp_splobjectstorage_offsetget(params.rvalAt(0), params.rvalAt(1)));
+}
+Variant i_hphp_backtrace_snapshot(CArrRef params) {
+  FUNCTION_INJECTION(hphp_backtrace_snapshot);
+  return (f_hphp_backtrace_snapshot(ref(const_cast<Array&>(params).lvalAt(0)), ref(const_cast<Array&>(params).lvalAt(1))));
+}
+Variant i_hphp_backtrace_snapshot_array(CArrRef params) {
+  FUNCTION_INJECTION(hphp_backtrace_snapshot_array);
+  return (f_hphp_backtrace_snapshot_array(params.rvalAt(0)));
+}
+Variant i_pagelet_server_task_flushed(CArrRef params) {
+  FUNCTION_INJECTION(pagelet_server_task_flushed);
+  return (f_pagelet_server_task_flushed(params.rvalAt(0)));
+}
+Variant i_pagelet_server_task_wait_any(CArrRef params) {
+  FUNCTION_INJECTION(pagelet_server_task_wait_any);
+  int count = params.size();
+  if (count <= 1) return (f_pagelet_server_task_wait_any(params.rvalAt(0)));
+  if (count == 2) return (f_pagelet_server_task_wait_any(params.rvalAt(0), params.rvalAt(1)));
+  return (f_pagelet_server_task_wait_any(params.rvalAt(0), params.rvalAt(1), params.rvalAt(2)));
+}
+Variant i_apc_fetch_or_lock(CArrRef params) {
+  FUNCTION_INJECTION(apc_fetch_or_lock);
+  int count = params.size();
+  if (count <= 1) return (f_apc_fetch_or_lock(params.rvalAt(0)));
+  if (count == 2) return (f_apc_fetch_or_lock(params.rvalAt(0), ref(const_cast<Array&>(params).lvalAt(1))));
+  if (count == 3) return (f_apc_fetch_or_lock(params.rvalAt(0), ref(const_cast<Array&>(params).lvalAt(1)), params.rvalAt(2)));
+  return (f_apc_fetch_or_lock(params.rvalAt(0), ref(const_cast<Array&>(params).lvalAt(1)), params.rvalAt(2), params.rvalAt(3)));
+}
+Variant i_apc_delete_prefix(CArrRef params) {
+  FUNCTION_INJECTION(apc_delete_prefix);
+  int count = params.size();
+  if (count <= 1) return (f_apc_delete_prefix(params.rvalAt(0)));
+  return (f_apc_delete_prefix(params.rvalAt(0), params.rvalAt(1)));
+}
+Variant i_apc_iterate_prefix(CArrRef params) {
+  FUNCTION_INJECTION(apc_iterate_prefix);
+  int count = params.size();
+  if (count <= 1) return (f_apc_iterate_prefix(params.rvalAt(0)));
+  if (count == 2) return (f_apc_iterate_prefix(params.rvalAt(0), params.rvalAt(1)));
+  return (f_apc_iterate_prefix(params.rvalAt(0), params.rvalAt(1), params.rvalAt(2)));
+}
+Variant i_apc_prefix_info(CArrRef params) {
+  FUNCTION_INJECTION(apc_prefix_info);
+  int count = params.size();
+  if (count <= 1) return (f_apc_prefix_info(params.rvalAt(0)));
+  return (f_apc_prefix_info(params.rvalAt(0), params.rvalAt(1)));
+}
 Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
   if (hash < 0) hash = hash_string_i(s);
   switch (hash & 4095) {
@@ -8958,6 +9062,9 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
     case 26:
       HASH_INVOKE(0x03834225EBBC101ALL, drawsettextundercolor);
       break;
+    case 30:
+      HASH_INVOKE(0x41FFB68D680CD01ELL, hphp_splobjectstorage_count);
+      break;
     case 32:
       HASH_INVOKE(0x583D163A6EB52020LL, oci_result);
       break;
@@ -9055,6 +9162,9 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
     case 132:
       HASH_INVOKE(0x53FD8C9AC3F4D084LL, dangling_server_proxy_new_request);
       break;
+    case 134:
+      HASH_INVOKE(0x5A720184BC916086LL, hphp_splobjectstorage_getinfo);
+      break;
     case 137:
       HASH_INVOKE(0x4AD554CBAB9CC089LL, call_user_method_array);
       break;
@@ -9275,6 +9385,7 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
     case 338:
       HASH_INVOKE(0x5D170BCBBBA02152LL, system);
       HASH_INVOKE(0x26DD46D8C1F47152LL, ldap_bind);
+      HASH_INVOKE(0x545C409E0409E152LL, hphp_splobjectstorage_offsetget);
       break;
     case 341:
       HASH_INVOKE(0x2623917110168155LL, fclose);
@@ -9378,6 +9489,9 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
     case 426:
       HASH_INVOKE(0x11A5C66A3D0711AALL, apc_sma_info);
       break;
+    case 427:
+      HASH_INVOKE(0x464D7EAB7AFD21ABLL, pagelet_server_task_flushed);
+      break;
     case 429:
       HASH_INVOKE(0x5A6EFF8C71A431ADLL, socket_get_status);
       HASH_INVOKE(0x50538F37398AF1ADLL, ldap_get_option);
@@ -9391,6 +9505,9 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
     case 438:
       HASH_INVOKE(0x33BD672B4AC301B6LL, mt_rand);
       break;
+    case 440:
+      HASH_INVOKE(0x5E1709C6EA3471B8LL, apc_fetch_or_lock);
+      break;
     case 445:
       HASH_INVOKE(0x4B3F35310DEA31BDLL, socket_create_pair);
       break;
@@ -9824,6 +9941,9 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
     case 780:
       HASH_INVOKE(0x553940FCE453330CLL, hphp_splfileobject_getmaxlinelen);
       break;
+    case 781:
+      HASH_INVOKE(0x10CFF761EBB7C30DLL, hphp_splobjectstorage_key);
+      break;
     case 789:
       HASH_INVOKE(0x4F1E663AE18FD315LL, msg_remove_queue);
       break;
@@ -10191,6 +10311,7 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
       break;
     case 1084:
       HASH_INVOKE(0x59ECE01C7629643CLL, mysql_drop_db);
+      HASH_INVOKE(0x6509414A211A043CLL, hphp_backtrace_snapshot);
       break;
     case 1088:
       HASH_INVOKE(0x5247425ED698B440LL, hphp_thread_is_warmup_enabled);
@@ -10442,6 +10563,7 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
       break;
     case 1299:
       HASH_INVOKE(0x772E8BF114FEF513LL, eregi_replace);
+      HASH_INVOKE(0x3043F36B49DAE513LL, apc_iterate_prefix);
       break;
     case 1300:
       HASH_INVOKE(0x100385A0988FD514LL, magickgetfilename);
@@ -10984,6 +11106,7 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
       break;
     case 1776:
       HASH_INVOKE(0x014BD9A6823256F0LL, extract);
+      HASH_INVOKE(0x514356D6DE0D06F0LL, fb_compact_serialize);
       break;
     case 1777:
       HASH_INVOKE(0x6B7347DF1AA7E6F1LL, drawpopdefs);
@@ -11413,6 +11536,7 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
       break;
     case 2119:
       HASH_INVOKE(0x4E69A952E3EA4847LL, magicksetfilename);
+      HASH_INVOKE(0x611DFFA3904A0847LL, hphp_splobjectstorage_current);
       break;
     case 2122:
       HASH_INVOKE(0x7D3F626E636C084ALL, ldap_delete);
@@ -11446,6 +11570,7 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
       break;
     case 2148:
       HASH_INVOKE(0x168EDA8238EEE864LL, mb_detect_order);
+      HASH_INVOKE(0x710F77DAAEA1D864LL, hphp_splobjectstorage_valid);
       break;
     case 2151:
       HASH_INVOKE(0x65A68A31B96E7867LL, hash);
@@ -11481,6 +11606,9 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
     case 2168:
       HASH_INVOKE(0x00F8C6758B50B878LL, drawpathcurvetoquadraticbezierabsolute);
       break;
+    case 2169:
+      HASH_INVOKE(0x1BD898EA5706A879LL, hphp_splobjectstorage_next);
+      break;
     case 2172:
       HASH_INVOKE(0x11DFC3C9D916387CLL, hphp_splfileobject_ftruncate);
       HASH_INVOKE(0x6451BCB825D1787CLL, chroot);
@@ -11736,6 +11864,9 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
     case 2423:
       HASH_INVOKE(0x0C16C797916C2977LL, posix_setegid);
       break;
+    case 2428:
+      HASH_INVOKE(0x31CE244AC043F97CLL, apc_delete_prefix);
+      break;
     case 2430:
       HASH_INVOKE(0x5067A65AD1D0297ELL, pixelgetiteratorexception);
       break;
@@ -11857,6 +11988,7 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
       break;
     case 2509:
       HASH_INVOKE(0x4E61FE901C1C29CDLL, array_intersect_key);
+      HASH_INVOKE(0x50D0FC7E841069CDLL, pagelet_server_task_wait_any);
       break;
     case 2510:
       HASH_INVOKE(0x7A9FB932873D09CELL, gmmktime);
@@ -12093,6 +12225,7 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
       break;
     case 2709:
       HASH_INVOKE(0x34B8A4E5AE0EFA95LL, pixelgetopacity);
+      HASH_INVOKE(0x571D3E819B770A95LL, hphp_splobjectstorage_contains);
       break;
     case 2711:
       HASH_INVOKE(0x0089115038C03A97LL, array_diff_ukey);
@@ -12339,6 +12472,9 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
     case 2886:
       HASH_INVOKE(0x00D8FE7A00252B46LL, escapeshellarg);
       break;
+    case 2892:
+      HASH_INVOKE(0x7BC65BD0C0F09B4CLL, apc_prefix_info);
+      break;
     case 2893:
       HASH_INVOKE(0x37DF53E4D9348B4DLL, xbox_post_message);
       break;
@@ -12512,12 +12648,18 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
     case 3041:
       HASH_INVOKE(0x25FBB61480091BE1LL, mysql_client_encoding);
       break;
+    case 3043:
+      HASH_INVOKE(0x086AA6707AD4ABE3LL, fb_compact_unserialize);
+      break;
     case 3047:
       HASH_INVOKE(0x1BB5D99C1D29CBE7LL, strstr);
       break;
     case 3048:
       HASH_INVOKE(0x4E903B706977ABE8LL, imagepsslantfont);
       break;
+    case 3050:
+      HASH_INVOKE(0x6E76D7E65DC7EBEALL, hphp_splobjectstorage_attach);
+      break;
     case 3051:
       HASH_INVOKE(0x505B44DDF2383BEBLL, drawgetfillcolor);
       HASH_INVOKE(0x0C1904372E8EDBEBLL, stream_copy_to_stream);
@@ -12608,6 +12750,9 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
     case 3128:
       HASH_INVOKE(0x21564F9315F3FC38LL, drawsettextdecoration);
       break;
+    case 3130:
+      HASH_INVOKE(0x1B7751A5E3C39C3ALL, hphp_splobjectstorage_setinfo);
+      break;
     case 3132:
       HASH_INVOKE(0x69488CC69B897C3CLL, hphp_recursiveiteratoriterator_getinneriterator);
       break;
@@ -12628,6 +12773,7 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
       break;
     case 3150:
       HASH_INVOKE(0x5DAC1C64D8F08C4ELL, openssl_pkey_get_private);
+      HASH_INVOKE(0x3A99EC4858729C4ELL, hphp_splobjectstorage_rewind);
       break;
     case 3152:
       HASH_INVOKE(0x04534F26B8D05C50LL, drawgetstrokecolor);
@@ -13183,6 +13329,7 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
     case 3582:
       HASH_INVOKE(0x21F24104004CFDFELL, evhttp_post);
       HASH_INVOKE(0x072690BF719D7DFELL, hphp_recursivedirectoryiterator_rewind);
+      HASH_INVOKE(0x6BC78F253C6E9DFELL, hphp_splobjectstorage_detach);
       break;
     case 3586:
       HASH_INVOKE(0x7829D2171DFBFE02LL, magickgetimagegamma);
@@ -13201,6 +13348,9 @@ Variant invoke_builtin(const char *s, CArrRef params, int64 hash, bool fatal) {
       HASH_INVOKE(0x05FAA2085D94FE12LL, urlencode);
       HASH_INVOKE(0x76636D0F0C090E12LL, curl_copy_handle);
       break;
+    case 3603:
+      HASH_INVOKE(0x5C51972860321E13LL, hphp_backtrace_snapshot_array);
+      break;
     case 3604:
       HASH_INVOKE(0x41E394B12170BE14LL, socket_send);
       HASH_INVOKE(0x3192209D50C1FE14LL, pixelsetalpha);
@@ -50938,6 +51088,420 @@ Variant ei_fb_call_user_func_array_safe(Eval::VariableEnvironment &env, const Ev
   FUNCTION_INJECTION(fb_call_user_func_array_safe);
   return (f_fb_call_user_func_array_safe(a0, a1));
 }
+Variant ei_fb_compact_serialize(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(fb_compact_serialize);
+  return (f_fb_compact_serialize(a0));
+}
+Variant ei_fb_compact_unserialize(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  Variant a1;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+    if (it == params.end()) break;
+    a1 = ref((*it)->refval(env));
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(fb_compact_unserialize);
+  return (f_fb_compact_unserialize(a0, ref(a1)));
+}
+Variant ei_hphp_splobjectstorage_rewind(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(hphp_splobjectstorage_rewind);
+  return (f_hphp_splobjectstorage_rewind(a0), null);
+}
+Variant ei_hphp_splobjectstorage_valid(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(hphp_splobjectstorage_valid);
+  return (f_hphp_splobjectstorage_valid(a0));
+}
+Variant ei_hphp_splobjectstorage_key(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(hphp_splobjectstorage_key);
+  return (f_hphp_splobjectstorage_key(a0));
+}
+Variant ei_hphp_splobjectstorage_current(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(hphp_splobjectstorage_current);
+  return (f_hphp_splobjectstorage_current(a0));
+}
+Variant ei_hphp_splobjectstorage_next(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(hphp_splobjectstorage_next);
+  return (f_hphp_splobjectstorage_next(a0), null);
+}
+Variant ei_hphp_splobjectstorage_count(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(hphp_splobjectstorage_count);
+  return (f_hphp_splobjectstorage_count(a0));
+}
+Variant ei_hphp_splobjectstorage_contains(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  Variant a1;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+    if (it == params.end()) break;
+    a1 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(hphp_splobjectstorage_contains);
+  return (f_hphp_splobjectstorage_contains(a0, a1));
+}
+Variant ei_hphp_splobjectstorage_attach(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  Variant a1;
+  Variant a2;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+    if (it == params.end()) break;
+    a1 = (*it)->eval(env);
+    it++;
+    if (it == params.end()) break;
+    a2 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(hphp_splobjectstorage_attach);
+  int count = params.size();
+  if (count <= 2) return (f_hphp_splobjectstorage_attach(a0, a1), null);
+  return (f_hphp_splobjectstorage_attach(a0, a1, a2), null);
+}
+Variant ei_hphp_splobjectstorage_detach(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  Variant a1;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+    if (it == params.end()) break;
+    a1 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(hphp_splobjectstorage_detach);
+  return (f_hphp_splobjectstorage_detach(a0, a1), null);
+}
+Variant ei_hphp_splobjectstorage_getinfo(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(hphp_splobjectstorage_getinfo);
+  return (f_hphp_splobjectstorage_getinfo(a0));
+}
+Variant ei_hphp_splobjectstorage_setinfo(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  Variant a1;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+    if (it == params.end()) break;
+    a1 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(hphp_splobjectstorage_setinfo);
+  return (f_hphp_splobjectstorage_setinfo(a0, a1), null);
+}
+Variant ei_hphp_splobjectstorage_offsetget(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  Variant a1;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+    if (it == params.end()) break;
+    a1 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(hphp_splobjectstorage_offsetget);
+  return (f_hphp_splobjectstorage_offsetget(a0, a1));
+}
+Variant ei_hphp_backtrace_snapshot(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  Variant a1;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = ref((*it)->refval(env));
+    it++;
+    if (it == params.end()) break;
+    a1 = ref((*it)->refval(env));
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(hphp_backtrace_snapshot);
+  return (f_hphp_backtrace_snapshot(ref(a0), ref(a1)));
+}
+Variant ei_hphp_backtrace_snapshot_array(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(hphp_backtrace_snapshot_array);
+  return (f_hphp_backtrace_snapshot_array(a0));
+}
+Variant ei_pagelet_server_task_flushed(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(pagelet_server_task_flushed);
+  return (f_pagelet_server_task_flushed(a0));
+}
+Variant ei_pagelet_server_task_wait_any(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  Variant a1;
+  Variant a2;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+    if (it == params.end()) break;
+    a1 = (*it)->eval(env);
+    it++;
+    if (it == params.end()) break;
+    a2 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(pagelet_server_task_wait_any);
+  int count = params.size();
+  if (count <= 1) return (f_pagelet_server_task_wait_any(a0));
+  if (count == 2) return (f_pagelet_server_task_wait_any(a0, a1));
+  return (f_pagelet_server_task_wait_any(a0, a1, a2));
+}
+Variant ei_apc_fetch_or_lock(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  Variant a1;
+  Variant a2;
+  Variant a3;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+    if (it == params.end()) break;
+    a1 = ref((*it)->refval(env));
+    it++;
+    if (it == params.end()) break;
+    a2 = (*it)->eval(env);
+    it++;
+    if (it == params.end()) break;
+    a3 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(apc_fetch_or_lock);
+  int count = params.size();
+  if (count <= 1) return (f_apc_fetch_or_lock(a0));
+  if (count == 2) return (f_apc_fetch_or_lock(a0, ref(a1)));
+  if (count == 3) return (f_apc_fetch_or_lock(a0, ref(a1), a2));
+  return (f_apc_fetch_or_lock(a0, ref(a1), a2, a3));
+}
+Variant ei_apc_delete_prefix(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  Variant a1;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+    if (it == params.end()) break;
+    a1 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(apc_delete_prefix);
+  int count = params.size();
+  if (count <= 1) return (f_apc_delete_prefix(a0));
+  return (f_apc_delete_prefix(a0, a1));
+}
+Variant ei_apc_iterate_prefix(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  Variant a1;
+  Variant a2;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+    if (it == params.end()) break;
+    a1 = (*it)->eval(env);
+    it++;
+    if (it == params.end()) break;
+    a2 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(apc_iterate_prefix);
+  int count = params.size();
+  if (count <= 1) return (f_apc_iterate_prefix(a0));
+  if (count == 2) return (f_apc_iterate_prefix(a0, a1));
+  return (f_apc_iterate_prefix(a0, a1, a2));
+}
+Variant ei_apc_prefix_info(Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller) {
+  Variant a0;
+  Variant a1;
+  const std::vector<Eval::ExpressionPtr> &params = caller->params();
+  std::vector<Eval::ExpressionPtr>::const_iterator it = params.begin();
+  do {
+    if (it == params.end()) break;
+    a0 = (*it)->eval(env);
+    it++;
+    if (it == params.end()) break;
+    a1 = (*it)->eval(env);
+    it++;
+  } while(false);
+  for (; it != params.end(); ++it) {
+    (*it)->eval(env);
+  }
+  FUNCTION_INJECTION(apc_prefix_info);
+  int count = params.size();
+  if (count <= 1) return (f_apc_prefix_info(a0));
+  return (f_apc_prefix_info(a0, a1));
+}
 Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment &env, const Eval::FunctionCallExpression *caller, int64 hash, bool fatal) {
   if (hash < 0) hash = hash_string_i(s);
   switch (hash & 4095) {
@@ -50972,6 +51536,9 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
     case 26:
       HASH_INVOKE_FROM_EVAL(0x03834225EBBC101ALL, drawsettextundercolor);
       break;
+    case 30:
+      HASH_INVOKE_FROM_EVAL(0x41FFB68D680CD01ELL, hphp_splobjectstorage_count);
+      break;
     case 32:
       HASH_INVOKE_FROM_EVAL(0x583D163A6EB52020LL, oci_result);
       break;
@@ -51069,6 +51636,9 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
     case 132:
       HASH_INVOKE_FROM_EVAL(0x53FD8C9AC3F4D084LL, dangling_server_proxy_new_request);
       break;
+    case 134:
+      HASH_INVOKE_FROM_EVAL(0x5A720184BC916086LL, hphp_splobjectstorage_getinfo);
+      break;
     case 137:
       HASH_INVOKE_FROM_EVAL(0x4AD554CBAB9CC089LL, call_user_method_array);
       break;
@@ -51289,6 +51859,7 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
     case 338:
       HASH_INVOKE_FROM_EVAL(0x5D170BCBBBA02152LL, system);
       HASH_INVOKE_FROM_EVAL(0x26DD46D8C1F47152LL, ldap_bind);
+      HASH_INVOKE_FROM_EVAL(0x545C409E0409E152LL, hphp_splobjectstorage_offsetget);
       break;
     case 341:
       HASH_INVOKE_FROM_EVAL(0x2623917110168155LL, fclose);
@@ -51392,6 +51963,9 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
     case 426:
       HASH_INVOKE_FROM_EVAL(0x11A5C66A3D0711AALL, apc_sma_info);
       break;
+    case 427:
+      HASH_INVOKE_FROM_EVAL(0x464D7EAB7AFD21ABLL, pagelet_server_task_flushed);
+      break;
     case 429:
       HASH_INVOKE_FROM_EVAL(0x5A6EFF8C71A431ADLL, socket_get_status);
       HASH_INVOKE_FROM_EVAL(0x50538F37398AF1ADLL, ldap_get_option);
@@ -51405,6 +51979,9 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
     case 438:
       HASH_INVOKE_FROM_EVAL(0x33BD672B4AC301B6LL, mt_rand);
       break;
+    case 440:
+      HASH_INVOKE_FROM_EVAL(0x5E1709C6EA3471B8LL, apc_fetch_or_lock);
+      break;
     case 445:
       HASH_INVOKE_FROM_EVAL(0x4B3F35310DEA31BDLL, socket_create_pair);
       break;
@@ -51838,6 +52415,9 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
     case 780:
       HASH_INVOKE_FROM_EVAL(0x553940FCE453330CLL, hphp_splfileobject_getmaxlinelen);
       break;
+    case 781:
+      HASH_INVOKE_FROM_EVAL(0x10CFF761EBB7C30DLL, hphp_splobjectstorage_key);
+      break;
     case 789:
       HASH_INVOKE_FROM_EVAL(0x4F1E663AE18FD315LL, msg_remove_queue);
       break;
@@ -52205,6 +52785,7 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
       break;
     case 1084:
       HASH_INVOKE_FROM_EVAL(0x59ECE01C7629643CLL, mysql_drop_db);
+      HASH_INVOKE_FROM_EVAL(0x6509414A211A043CLL, hphp_backtrace_snapshot);
       break;
     case 1088:
       HASH_INVOKE_FROM_EVAL(0x5247425ED698B440LL, hphp_thread_is_warmup_enabled);
@@ -52456,6 +53037,7 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
       break;
     case 1299:
       HASH_INVOKE_FROM_EVAL(0x772E8BF114FEF513LL, eregi_replace);
+      HASH_INVOKE_FROM_EVAL(0x3043F36B49DAE513LL, apc_iterate_prefix);
       break;
     case 1300:
       HASH_INVOKE_FROM_EVAL(0x100385A0988FD514LL, magickgetfilename);
@@ -52998,6 +53580,7 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
       break;
     case 1776:
       HASH_INVOKE_FROM_EVAL(0x014BD9A6823256F0LL, extract);
+      HASH_INVOKE_FROM_EVAL(0x514356D6DE0D06F0LL, fb_compact_serialize);
       break;
     case 1777:
       HASH_INVOKE_FROM_EVAL(0x6B7347DF1AA7E6F1LL, drawpopdefs);
@@ -53427,6 +54010,7 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
       break;
     case 2119:
       HASH_INVOKE_FROM_EVAL(0x4E69A952E3EA4847LL, magicksetfilename);
+      HASH_INVOKE_FROM_EVAL(0x611DFFA3904A0847LL, hphp_splobjectstorage_current);
       break;
     case 2122:
       HASH_INVOKE_FROM_EVAL(0x7D3F626E636C084ALL, ldap_delete);
@@ -53460,6 +54044,7 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
       break;
     case 2148:
       HASH_INVOKE_FROM_EVAL(0x168EDA8238EEE864LL, mb_detect_order);
+      HASH_INVOKE_FROM_EVAL(0x710F77DAAEA1D864LL, hphp_splobjectstorage_valid);
       break;
     case 2151:
       HASH_INVOKE_FROM_EVAL(0x65A68A31B96E7867LL, hash);
@@ -53495,6 +54080,9 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
     case 2168:
       HASH_INVOKE_FROM_EVAL(0x00F8C6758B50B878LL, drawpathcurvetoquadraticbezierabsolute);
       break;
+    case 2169:
+      HASH_INVOKE_FROM_EVAL(0x1BD898EA5706A879LL, hphp_splobjectstorage_next);
+      break;
     case 2172:
       HASH_INVOKE_FROM_EVAL(0x11DFC3C9D916387CLL, hphp_splfileobject_ftruncate);
       HASH_INVOKE_FROM_EVAL(0x6451BCB825D1787CLL, chroot);
@@ -53750,6 +54338,9 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
     case 2423:
       HASH_INVOKE_FROM_EVAL(0x0C16C797916C2977LL, posix_setegid);
       break;
+    case 2428:
+      HASH_INVOKE_FROM_EVAL(0x31CE244AC043F97CLL, apc_delete_prefix);
+      break;
     case 2430:
       HASH_INVOKE_FROM_EVAL(0x5067A65AD1D0297ELL, pixelgetiteratorexception);
       break;
@@ -53871,6 +54462,7 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
       break;
     case 2509:
       HASH_INVOKE_FROM_EVAL(0x4E61FE901C1C29CDLL, array_intersect_key);
+      HASH_INVOKE_FROM_EVAL(0x50D0FC7E841069CDLL, pagelet_server_task_wait_any);
       break;
     case 2510:
       HASH_INVOKE_FROM_EVAL(0x7A9FB932873D09CELL, gmmktime);
@@ -54107,6 +54699,7 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
       break;
     case 2709:
       HASH_INVOKE_FROM_EVAL(0x34B8A4E5AE0EFA95LL, pixelgetopacity);
+      HASH_INVOKE_FROM_EVAL(0x571D3E819B770A95LL, hphp_splobjectstorage_contains);
       break;
     case 2711:
       HASH_INVOKE_FROM_EVAL(0x0089115038C03A97LL, array_diff_ukey);
@@ -54353,6 +54946,9 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
     case 2886:
       HASH_INVOKE_FROM_EVAL(0x00D8FE7A00252B46LL, escapeshellarg);
       break;
+    case 2892:
+      HASH_INVOKE_FROM_EVAL(0x7BC65BD0C0F09B4CLL, apc_prefix_info);
+      break;
     case 2893:
       HASH_INVOKE_FROM_EVAL(0x37DF53E4D9348B4DLL, xbox_post_message);
       break;
@@ -54526,12 +55122,18 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
     case 3041:
       HASH_INVOKE_FROM_EVAL(0x25FBB61480091BE1LL, mysql_client_encoding);
       break;
+    case 3043:
+      HASH_INVOKE_FROM_EVAL(0x086AA6707AD4ABE3LL, fb_compact_unserialize);
+      break;
     case 3047:
       HASH_INVOKE_FROM_EVAL(0x1BB5D99C1D29CBE7LL, strstr);
       break;
     case 3048:
       HASH_INVOKE_FROM_EVAL(0x4E903B706977ABE8LL, imagepsslantfont);
       break;
+    case 3050:
+      HASH_INVOKE_FROM_EVAL(0x6E76D7E65DC7EBEALL, hphp_splobjectstorage_attach);
+      break;
     case 3051:
       HASH_INVOKE_FROM_EVAL(0x505B44DDF2383BEBLL, drawgetfillcolor);
       HASH_INVOKE_FROM_EVAL(0x0C1904372E8EDBEBLL, stream_copy_to_stream);
@@ -54622,6 +55224,9 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
     case 3128:
       HASH_INVOKE_FROM_EVAL(0x21564F9315F3FC38LL, drawsettextdecoration);
       break;
+    case 3130:
+      HASH_INVOKE_FROM_EVAL(0x1B7751A5E3C39C3ALL, hphp_splobjectstorage_setinfo);
+      break;
     case 3132:
       HASH_INVOKE_FROM_EVAL(0x69488CC69B897C3CLL, hphp_recursiveiteratoriterator_getinneriterator);
       break;
@@ -54642,6 +55247,7 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
       break;
     case 3150:
       HASH_INVOKE_FROM_EVAL(0x5DAC1C64D8F08C4ELL, openssl_pkey_get_private);
+      HASH_INVOKE_FROM_EVAL(0x3A99EC4858729C4ELL, hphp_splobjectstorage_rewind);
       break;
     case 3152:
       HASH_INVOKE_FROM_EVAL(0x04534F26B8D05C50LL, drawgetstrokecolor);
@@ -55197,6 +55803,7 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
     case 3582:
       HASH_INVOKE_FROM_EVAL(0x21F24104004CFDFELL, evhttp_post);
       HASH_INVOKE_FROM_EVAL(0x072690BF719D7DFELL, hphp_recursivedirectoryiterator_rewind);
+      HASH_INVOKE_FROM_EVAL(0x6BC78F253C6E9DFELL, hphp_splobjectstorage_detach);
       break;
     case 3586:
       HASH_INVOKE_FROM_EVAL(0x7829D2171DFBFE02LL, magickgetimagegamma);
@@ -55215,6 +55822,9 @@ Variant Eval::invoke_from_eval_builtin(const char *s, Eval::VariableEnvironment
       HASH_INVOKE_FROM_EVAL(0x05FAA2085D94FE12LL, urlencode);
       HASH_INVOKE_FROM_EVAL(0x76636D0F0C090E12LL, curl_copy_handle);
       break;
+    case 3603:
+      HASH_INVOKE_FROM_EVAL(0x5C51972860321E13LL, hphp_backtrace_snapshot_array);
+      break;
     case 3604:
       HASH_INVOKE_FROM_EVAL(0x41E394B12170BE14LL, socket_send);
       HASH_INVOKE_FROM_EVAL(0x3192209D50C1FE14LL, pixelsetalpha);
@@ -288,6 +288,7 @@ bool TestCodeRun::RunTests(const std::string &which) {
   RUN_TEST(TestArrayAssignment);
   RUN_TEST(TestArrayMerge);
   RUN_TEST(TestArrayUnique);
+  RUN_TEST(TestInArray);
   RUN_TEST(TestScalarArray);
   RUN_TEST(TestRange);
   RUN_TEST(TestVariant);
@@ -363,6 +364,8 @@ bool TestCodeRun::RunTests(const std::string &which) {
   RUN_TEST(TestExtImage);
   RUN_TEST(TestSplFile);
   RUN_TEST(TestIterator);
+  RUN_TEST(TestSplObjectStorage);
+  RUN_TEST(TestInlining);
   //RUN_TEST(TestEvaluationOrder);
 
   RUN_TEST(TestAdHoc);
@@ -534,6 +537,32 @@ bool TestCodeRun::TestExceptions() {
       "  var_dump(2);"
       "}"
       "foo();");
+  MVCR("<?php "
+      "function g($a) {"
+      "  if ($a) return new Exception('g');"
+      "  throw new Exception('t');"
+      "}"
+      "function f($a) {"
+      "  return g($a);"
+      "}"
+      "class C {"
+      "  function m() { return f(true); }"
+      "}"
+      "$c = new C();"
+      "$e = $c->m();"
+      "var_dump($e->getLine());"
+      "foreach ($e->getTrace() as $frame) {"
+      "  var_dump($frame['function'], $frame['line'],"
+      "           isset($frame['class']) ? $frame['class'] : '');"
+      "}"
+      "for ($i = 0; $i < 100; $i++) {"
+      "  try { f(false); } catch (Exception $e) {}"
+      "}"
+      "var_dump($e->getLine(), count($e->getTrace()));"
+      "$e = unserialize(serialize($c->m()));"
+      "var_dump($e->getMessage(), $e->getLine(), count($e->getTrace()));"
+      "$t = $e->getTrace();"
+      "var_dump($t[0]['function'], $t[1]['function']);");
   return true;
 }
 
@@ -1248,6 +1277,54 @@ bool TestCodeRun::TestArrayIterator() {
       "  print \"$a: $b\n\";"
       "}"
       );
+
+  // local arrays that foreach may iterate without holding a reference
+  MVCR("<?php "
+      "function modify() {"
+      "  $a = array(1, 2, 3);"
+      "  foreach ($a as $k => $v) {"
+      "    $a[] = $v * 10;"
+      "    if ($k == 0) unset($a[1]);"
+      "    var_dump($v);"
+      "  }"
+      "  var_dump($a);"
+      "  $b = array(1, 2, 3);"
+      "  foreach ($b as $v) {"
+      "    unset($b);"
+      "    var_dump($v);"
+      "  }"
+      "  var_dump(isset($b));"
+      "}"
+      "modify();");
+  MVCR("<?php "
+      "function byref() {"
+      "  $a = array(1, 2, 3);"
+      "  foreach ($a as $v) {"
+      "    var_dump($v);"
+      "  }"
+      "  foreach ($a as &$v) {"
+      "    $v *= 2;"
+      "  }"
+      "  unset($v);"
+      "  var_dump($a);"
+      "  foreach ($a as $v) {"
+      "    var_dump($v);"
+      "  }"
+      "}"
+      "byref();");
+  MVCR("<?php "
+      "function nested() {"
+      "  $a = array(1, 2, 3);"
+      "  foreach ($a as $x) {"
+      "    foreach ($a as $y) {"
+      "      echo $x, $y, ' ';"
+      "    }"
+      "    $b = $a;"
+      "    $b[] = $x;"
+      "  }"
+      "  echo count($a), count($b), \"\\n\";"
+      "}"
+      "nested();");
   return true;
 }
 
@@ -1368,6 +1445,27 @@ bool TestCodeRun::TestArrayUnique() {
   return true;
 }
 
+bool TestCodeRun::TestInArray() {
+  // searched often enough to be indexed, then changed through references
+  MVCR("<?php "
+      "function append_x(&$v, $k) { $v .= 'x'; }"
+      "function double(&$v) { $v *= 2; }"
+      "$a = array();"
+      "for ($i = 0; $i < 20; $i++) $a[] = 'v' . $i;"
+      "for ($i = 0; $i < 3; $i++) var_dump(in_array('v5', $a));"
+      "array_walk($a, 'append_x');"
+      "var_dump(in_array('v5', $a), in_array('v5x', $a));"
+      "$b = range(1, 20);"
+      "for ($i = 0; $i < 3; $i++) var_dump(in_array(3, $b));"
+      "foreach ($b as &$v) $v *= 2;"
+      "unset($v);"
+      "var_dump(in_array(3, $b), in_array(6, $b));"
+      "for ($i = 0; $i < 3; $i++) var_dump(in_array(40, $b));"
+      "call_user_func_array('double', array(&$b[19]));"
+      "var_dump(in_array(40, $b), in_array(80, $b));");
+  return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 bool TestCodeRun::TestVariant() {
@@ -6618,6 +6716,52 @@ bool TestCodeRun::TestConcat() {
       "var_dump($a);"
       "$a = 3;"
       "echo 0 + \"1$a\";");
+  MVCR("<?php "
+      "$a = 'a'; $b = 2; $c = 3.5; $d = null; $e = true;"
+      "echo $a . '-' . $b . '-' . $c . '-' . $d . '-' . $e . \"\\n\";"
+      "echo $a . 1 . $a . 2 . $a . 3 . $a . 4 . $a . 5 . $a . 6 . $a . 7 . "
+      "     $a . 8 . $a . 9 . \"\\n\";"
+      "echo \"<$a href='$b'>$c $d $e $a$b$c</$a>\\n\";"
+      "$s = \"[$a|$b|$c|$d|$e|$a|$b|$c|$d|$e|$a|$b|$c|$d|$e|$a|$b|$c]\";"
+      "var_dump($s);");
+  MVCR("<?php "
+      "$a = 'x';"
+      "$a .= 'y' . 'z';"
+      "$a .= $a . '-' . $a;"
+      "var_dump($a);"
+      "$b = $a;"
+      "$b .= '1' . $a . '2' . $b . '3';"
+      "var_dump($a, $b);"
+      "$c = 5;"
+      "$c .= $c . 'p' . 6;"
+      "var_dump($c);"
+      "$d = null;"
+      "$d .= 'q' . $c;"
+      "var_dump($d);"
+      "$arr = array('k' => 'v');"
+      "$arr['k'] .= 'w' . $a . 'x';"
+      "var_dump($arr);"
+      "function f(&$s) { $s .= '<' . $s . '>'; return $s; }"
+      "$e = 'r'; f($e); f($e);"
+      "var_dump($e);");
+  // same inside a function, where locals are typed String and int
+  MVCR("<?php "
+      "function g($n) {"
+      "  $s = 'x';"
+      "  $t = 'y';"
+      "  $i = 7;"
+      "  $s .= $t . '-' . $i;"
+      "  $s .= $s . '|' . $s;"
+      "  $t .= $t;"
+      "  $u = $s . $t . $i . $s . $t . $i . $s . $t . $i;"
+      "  $v = \"<$s|$t|$i|$s|$t|$i|$s|$t|$i|$s|$t|$i|$s|$t|$i|$s|$t>\";"
+      "  $w = '';"
+      "  for ($k = 0; $k < $n; $k++) {"
+      "    $w .= '[' . $k . ':' . $t . ']';"
+      "  }"
+      "  var_dump($s, $t, $u, $v, $w, $i);"
+      "}"
+      "g(3);");
 
   return true;
 }
@@ -7866,6 +8010,112 @@ bool TestCodeRun::TestIterator() {
   return true;
 }
 
+bool TestCodeRun::TestSplObjectStorage() {
+  MVCR("<?php "
+      "class A { public $v; function __construct($v) { $this->v = $v; } }"
+      "$s = new SplObjectStorage();"
+      "$a = new A(1); $b = new A(2); $c = new A(3);"
+      "$s->attach($a);"
+      "$s->attach($b, 'bee');"
+      "$s->attach($a);"
+      "var_dump(count($s), $s->count());"
+      "var_dump($s->contains($a), $s->contains($c));"
+      "var_dump(isset($s[$b]), $s[$b]);"
+      "$s[$c] = array(3);"
+      "foreach ($s as $i => $o) {"
+      "  var_dump($i, $o->v, $s->getInfo());"
+      "  $s->setInfo($o->v * 10);"
+      "}"
+      "var_dump($s[$a], $s[$b], $s[$c]);"
+      "$t = clone $s;"
+      "$s->detach($b);"
+      "unset($s[$c]);"
+      "var_dump(count($s), $s->contains($b), count($t), $t->contains($b));"
+      "for ($s->rewind(); $s->valid(); $s->next()) {"
+      "  var_dump($s->key(), $s->current()->v);"
+      "}"
+      "try {"
+      "  $s[$b];"
+      "} catch (UnexpectedValueException $e) {"
+      "  var_dump($e->getMessage());"
+      "}"
+      "$s->attach($b, 'bee');"
+      "$t = clone $s;"
+      "$s->detach($b);"
+      "$s[$a] = 'changed';"
+      "var_dump(count($t), $t->contains($b), $t[$a]);"
+      "$u = unserialize(serialize($t));"
+      "var_dump(count($u));"
+      "foreach ($u as $o) {"
+      "  var_dump($o->v, $u->contains($o), $u[$o]);"
+      "}");
+  return true;
+}
+
+bool TestCodeRun::TestInlining() {
+  MVCR("<?php "
+      "function add($a, $b = 10) { return $a + $b; }"
+      "function twice($s) { return $s . $s; }"
+      "function mod($a) { return $a = $a * 2; }"
+      "function next_id() { global $id; return ++$id; }"
+      "function show($x) { echo $x; return $x; }"
+      "function test() {"
+      "  $a = 1;"
+      "  var_dump(add($a, 2), add($a), add(add(1, 2), add(3, 4)));"
+      "  var_dump(twice('ab'), twice(twice('c')));"
+      "  var_dump(mod($a), $a);"
+      "  var_dump(add(show(1), show(2)));"
+      "  $id = 5;"
+      "  var_dump(next_id(), next_id(), $id);"
+      "  $b = 3;"
+      "  var_dump(add($b++, $b), $b);"
+      "  for ($i = 0; $i < 3; $i++) echo add($i, $i), \"\\n\";"
+      "}"
+      "test();");
+  MVCR("<?php "
+      "function fact($n) { return $n <= 1 ? 1 : $n * fact($n - 1); }"
+      "function &getref(&$a) { return $a; }"
+      "function args() { return func_get_args(); }"
+      "function name() { return __FUNCTION__; }"
+      "function local($a) { return $b = $a; }"
+      "function hinted(array $a) { return count($a); }"
+      "function inc(&$a) { return ++$a; }"
+      "function test() {"
+      "  var_dump(fact(5));"
+      "  $x = 1; $r = &getref($x); $r = 2; var_dump($x);"
+      "  var_dump(args(1, 2));"
+      "  var_dump(name());"
+      "  var_dump(local(3), local(4));"
+      "  var_dump(hinted(array(1, 2)));"
+      "  $y = 1; inc($y); var_dump($y);"
+      "}"
+      "test();");
+  MVCR("<?php "
+      "class A {"
+      "  private $x = 1;"
+      "  protected $y = 2;"
+      "  private function getX() { return $this->x; }"
+      "  final function getY() { return $this->y; }"
+      "  function getZ() { return 3; }"
+      "  private function sum($a) { return $this->x + $this->y + $a; }"
+      "  private function half($a) { return $a / 2; }"
+      "  final function cls() { return get_class(); }"
+      "  function test() {"
+      "    var_dump($this->getX(), $this->getY(), $this->getZ());"
+      "    var_dump($this->sum($this->getX()));"
+      "    $v = $this->getX(); $v++; var_dump($this->x);"
+      "    var_dump($this->half(5), $this->cls());"
+      "  }"
+      "}"
+      "class B extends A {"
+      "  function getZ() { return 4; }"
+      "}"
+      "$a = new A(); $a->test();"
+      "$b = new B(); $b->test();");
+
+  return true;
+}
+
 // please leave this unit test at last for debugging ad hoc code
 bool TestCodeRun::TestAdHoc() {
   return true;
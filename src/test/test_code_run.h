@@ -71,6 +71,7 @@ class TestCodeRun : public TestBase {
   bool TestArrayAssignment();
   bool TestArrayMerge();
   bool TestArrayUnique();
+  bool TestInArray();
   bool TestScalarArray();
   bool TestRange();
   bool TestVariant();
@@ -152,6 +153,8 @@ class TestCodeRun : public TestBase {
   bool TestExtImage();
   bool TestSplFile();
   bool TestIterator();
+  bool TestSplObjectStorage();
+  bool TestInlining();
 
   // debugging purpose
   bool TestAdHoc();
@@ -24,7 +24,11 @@
 #include <cpp/ext/ext_mysql.h>
 #include <cpp/ext/ext_curl.h>
 #include <cpp/base/shared/shared_store.h>
+#include <cpp/base/array/hphp_array.h>
+#include <util/hash.h>
 #include <cpp/base/runtime_option.h>
+#include <cpp/base/call_profile.h>
+#include <util/util.h>
 #include <test/test_mysql_info.inc>
 
 using namespace std;
@@ -41,10 +45,14 @@ bool TestCppBase::RunTests(const std::string &which) {
   RUN_TEST(TestSmartAllocator);
   RUN_TEST(TestString);
   RUN_TEST(TestArray);
+  RUN_TEST(TestHphpArray);
   RUN_TEST(TestObject);
   RUN_TEST(TestVariant);
   RUN_TEST(TestListAssignment);
+  RUN_TEST(TestSerialization);
+  RUN_TEST(TestCallProfile);
 #ifndef DEBUGGING_SMART_ALLOCATOR
+  RUN_TEST(TestSizeClassAllocator);
   RUN_TEST(TestMemoryManager);
 #endif
   return ret;
@@ -93,6 +101,52 @@ typedef SmartAllocator<SomeClass, -1, SmartAllocatorImpl::NoCallbacks>
         SomeClassAlloc;
 
 bool TestCppBase::TestSmartAllocator() {
+  {
+    IMPLEMENT_THREAD_LOCAL(SomeClassAlloc, allocator);
+    SomeClassAlloc *a = allocator.get();
+    int64 block = a->getRetainedBytes();
+
+    std::vector<SomeClass*> objs;
+    for (int64 i = 0; i < block * 3 / a->getItemSize(); i++) {
+      objs.push_back(new (a) SomeClass());
+    }
+    VERIFY(a->getRetainedBytes() == block * 3);
+    VERIFY(a->getUsedBytes() == block * 3);
+
+    // frees the last block, keeps the others
+    for (unsigned int i = objs.size() - 1; i >= objs.size() / 2; i--) {
+      a->dealloc(objs[i]);
+    }
+    VERIFY(a->trim() == block);
+    VERIFY(a->getRetainedBytes() == block * 2);
+    VERIFY(a->getUsedBytes() == block * 3 / 2);
+
+    // first block always stays
+    for (unsigned int i = 0; i < objs.size() / 2; i++) {
+      a->dealloc(objs[i]);
+    }
+    VERIFY(a->trim() == block);
+    VERIFY(a->getRetainedBytes() == block);
+    VERIFY(a->getUsedBytes() == 0);
+    VERIFY(new (a) SomeClass() != NULL);
+  }
+  {
+    IMPLEMENT_THREAD_LOCAL(SomeClassAlloc, allocator);
+    SomeClassAlloc *a = allocator.get();
+    int64 block = a->getRetainedBytes();
+
+    // what a checkpoint allows: live objects and accounting are untouched
+    SomeClass *kept = new (a) SomeClass();
+    kept->m_data = 42;
+    a->dealloc(new (a) SomeClass());
+    a->trimUnused();
+    VS(kept->m_data, 42);
+    VERIFY(a->getRetainedBytes() == block);
+    VERIFY(a->getUsedBytes() == a->getItemSize());
+    SomeClass *reused = new (a) SomeClass();
+    VS(reused->m_data, 0);
+  }
+
   int iMax = 1000000;
   int64 time1, time2;
   {
@@ -122,6 +176,74 @@ bool TestCppBase::TestSmartAllocator() {
   return Count(true);
 }
 
+bool TestCppBase::TestSizeClassAllocator() {
+  {
+    SizeClassAllocator allocator;
+    allocator.enable();
+
+    char *p = (char*)allocator.alloc(10);
+    memcpy(p, "012345678", 10);
+    p = (char*)allocator.realloc(p, 100);
+    VERIFY(strcmp(p, "012345678") == 0);
+    allocator.dealloc(p);
+    VERIFY(allocator.alloc(128) == p); // same size class, recycled
+
+    p = (char*)allocator.alloc(1 << 20); // beyond largest size class
+    memset(p, 0, 1 << 20);
+    p = (char*)allocator.realloc(p, 2 << 20);
+    allocator.dealloc(p);
+
+    allocator.beginSweep();
+    allocator.reset();
+  }
+  {
+    // outside of a generation, buffers are plain malloc() that any thread
+    // may free
+    SizeClassAllocator owner, other;
+    void *p = owner.alloc(10);
+    other.dealloc(p);
+  }
+
+  int iMax = 1000000;
+  int batch = 1000;
+  int64 time1, time2;
+  {
+    SizeClassAllocator allocator;
+    allocator.enable();
+
+    std::vector<void*> buffers(batch);
+    Timer t;
+    for (int i = 0; i < iMax; i += batch) {
+      for (int j = 0; j < batch; j++) {
+        buffers[j] = allocator.alloc(16 + (j & 255) * 8);
+      }
+      allocator.beginSweep();
+      allocator.reset();
+    }
+    time1 = t.getMicroSeconds();
+    if (!Test::s_quiet) {
+      printf("SizeClassAllocator: %lld us\n", time1);
+    }
+  }
+  {
+    std::vector<void*> buffers(batch);
+    Timer t;
+    for (int i = 0; i < iMax; i += batch) {
+      for (int j = 0; j < batch; j++) {
+        buffers[j] = malloc(16 + (j & 255) * 8);
+      }
+      for (int j = 0; j < batch; j++) {
+        free(buffers[j]);
+      }
+    }
+    time2 = t.getMicroSeconds();
+    if (!Test::s_quiet) {
+      printf("malloc/free: %lld us\n", time2);
+    }
+  }
+  return Count(true);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // data types
 
@@ -623,6 +745,204 @@ bool TestCppBase::TestArray() {
   return Count(true);
 }
 
+static void benchmark_array(const char *name, bool zend, bool hphp) {
+  bool savedZend = RuntimeOption::UseZendArray;
+  bool savedHphp = RuntimeOption::UseHphpArray;
+  RuntimeOption::UseZendArray = zend;
+  RuntimeOption::UseHphpArray = hphp;
+
+  const MemoryUsageStats &stats = MemoryManager::TheMemoryManager()->getStats();
+  int count = 100000;
+  for (int assoc = 0; assoc < 2; assoc++) {
+    int64 usage = stats.usage;
+    Timer t1;
+    Array arr = Array::Create();
+    for (int i = 0; i < count; i++) {
+      if (assoc) {
+        arr.set(String("key_") + String(i), i);
+      } else {
+        arr.append(i);
+      }
+    }
+    int64 build = t1.getMicroSeconds();
+    int64 bytes = stats.usage - usage;
+
+    int64 sum = 0;
+    Timer t2;
+    for (int n = 0; n < 10; n++) {
+      for (ArrayIter iter(arr); !iter.end(); iter.next()) {
+        sum += iter.second().toInt64();
+      }
+    }
+    int64 iterate = t2.getMicroSeconds();
+    if (!Test::s_quiet) {
+      printf("%s, %d %s: %lld bytes, build %lld us, 10x foreach %lld us\n",
+             name, count, assoc ? "string keys" : "appends", bytes, build,
+             iterate);
+    }
+  }
+
+  RuntimeOption::UseZendArray = savedZend;
+  RuntimeOption::UseHphpArray = savedHphp;
+}
+
+bool TestCppBase::TestHphpArray() {
+  // lists stay packed, until there is a hole or a string key
+  {
+    HphpArray *data = NEW(HphpArray)();
+    Array arr(data);
+    for (int i = 0; i < 100; i++) {
+      arr.append(i);
+    }
+    VERIFY(data->isPacked());
+    VERIFY(arr->isVectorData());
+    VS(arr.size(), 100);
+    VS(arr.pop(), 99);
+    VERIFY(data->isPacked());
+    arr.append(99); // array_pop() gave key 99 back
+    VERIFY(data->isPacked());
+    VS(arr[99], 99);
+
+    arr.remove(99);
+    VERIFY(data->isPacked());
+    arr.append(100); // but unset() doesn't
+    VERIFY(!data->isPacked());
+    VERIFY(!arr.exists(99));
+    VS(arr[100], 100);
+    VS(arr.size(), 100);
+  }
+  {
+    HphpArray *data = NEW(HphpArray)();
+    Array arr(data);
+    arr.append("a");
+    arr.set("name", "b");
+    VERIFY(!data->isPacked());
+    arr.append("c");
+    VS(arr, CREATE_MAP3(0, "a", "name", "b", 1, "c"));
+    arr.remove("name");
+    VS(arr, CREATE_MAP2(0, "a", 1, "c"));
+    VS(arr.dequeue(), "a");
+    VERIFY(data->isPacked()); // renumbered
+    VS(arr, CREATE_VECTOR1("c"));
+  }
+  // tombstones are squeezed out without changing order or lookups
+  {
+    Array arr(NEW(HphpArray)());
+    for (int i = 0; i < 1000; i++) {
+      arr.set(String("key_") + String(i), i);
+      if (i % 3) {
+        arr.remove(String("key_") + String(i - 1));
+      }
+    }
+    int expected = 2;
+    for (ArrayIter iter(arr); !iter.end(); iter.next()) {
+      VS(iter.first(), String("key_") + String(expected));
+      VS(iter.second(), expected);
+      expected = expected == 998 ? 999 : expected + 3;
+    }
+    VS(arr.size(), 334);
+    VS(arr["key_999"], 999);
+    VS(arr["key_998"], 998);
+    VERIFY(!arr.exists("key_997"));
+  }
+  // insert() moves the new element and renumbers
+  {
+    Array arr(NEW(HphpArray)());
+    arr.append("b");
+    arr.set("name", "c");
+    arr.append("d");
+    ArrayData *ret = arr->insert(arr->iter_begin(), "a", false);
+    VERIFY(ret == NULL);
+    VS(arr, CREATE_MAP4(0, "a", 1, "b", "name", "c", 2, "d"));
+  }
+  // internal pointer
+  {
+    Array arr(NEW(HphpArray)());
+    arr.set("a", 1);
+    arr.set("b", 2);
+    arr.set("c", 3);
+    VS(arr->current(), 1);
+    VS(arr->next(), 2);
+    arr.remove("b");
+    VS(arr->current(), 3);
+    VS(arr->key(), "c");
+    VS(arr->next(), false);
+    arr.set("d", 4); // pointer was past the end
+    VS(arr->current(), 4);
+    VS(arr->prev(), 3);
+    VS(arr->end(), 4);
+    VS(arr->reset(), 1);
+  }
+  // foreach by reference survives elements being moved around
+  {
+    Variant arr = Array(NEW(HphpArray)());
+    for (int i = 0; i < 8; i++) {
+      arr.append(i);
+    }
+    Variant v;
+    MutableArrayIter iter(&arr, NULL, v);
+    Array seen;
+    while (iter.advance()) {
+      seen.append(v);
+      if (equal(v, 0)) {
+        for (int i = 1; i < 7; i++) {
+          arr.remove(i);
+        }
+        arr.append(100);
+        arr.append(101);
+      }
+    }
+    VS(seen, CREATE_VECTOR4(0, 7, 100, 101));
+  }
+
+  // a string key and an int key with the same hash aren't mixed up
+  {
+    int64 h = hash_string("x", 1);
+    Variant arr = Array(NEW(HphpArray)());
+    for (int i = 0; i < 5; i++) {
+      arr.set(i, i);
+    }
+    arr.set(h, "h");
+    arr.set("x", "x");
+    arr.set(6, 6);
+    Variant v;
+    MutableArrayIter iter(&arr, NULL, v);
+    Array seen;
+    while (iter.advance()) {
+      seen.append(v);
+      if (equal(v, "x")) {
+        for (int i = 0; i < 5; i++) {
+          arr.remove(i);
+        }
+        arr.append("new"); // squeezes tombstones, moving "x"
+      }
+    }
+    VS(seen.size(), 9);
+    VS(seen[6], "x");
+    VS(seen[7], 6);
+    VS(seen[8], "new");
+  }
+  // inserting and unsetting over and over doesn't use up the index table
+  {
+    Array arr(NEW(HphpArray)());
+    arr.set("a", 1);
+    for (int i = 0; i < 10000; i++) {
+      String key = String("k") + String(i);
+      arr.set(key, i);
+      arr.remove(key);
+    }
+    VS(arr.size(), 1);
+    VERIFY(!arr.exists("missing"));
+    VERIFY(!arr.exists(12345));
+    VS(arr["a"], 1);
+  }
+
+  benchmark_array("Vector*/Map*", false, false);
+  benchmark_array("ZendArray", true, false);
+  benchmark_array("HphpArray", true, true);
+  return Count(true);
+}
+
 bool TestCppBase::TestObject() {
   {
     String s = "O:1:\"B\":1:{s:3:\"obj\";O:1:\"A\":1:{s:1:\"a\";i:10;}}";
@@ -838,6 +1158,63 @@ bool TestCppBase::TestListAssignment() {
   return Count(true);
 }
 
+bool TestCppBase::TestSerialization() {
+  bool success;
+  {
+    Variant v = CREATE_MAP3("i", -1234567890123LL, "d", 0.1, "s", "str");
+    VS(binary_unserialize(binary_serialize(v), success), v);
+    VERIFY(success);
+  }
+  {
+    // references survive the round trip
+    Variant v;
+    Variant a = "shared";
+    v.set(0, ref(a));
+    v.set(1, ref(a));
+    Variant copy = binary_unserialize(binary_serialize(v), success);
+    VERIFY(success);
+    copy.lvalAt(0) = "changed";
+    VS(copy[1], "changed");
+  }
+  {
+    VS(binary_unserialize("", success), false);
+    VERIFY(!success);
+    VS(binary_unserialize(String("S\x7f", 2, AttachLiteral), success), false);
+    VERIFY(!success);
+  }
+
+  Array rows;
+  for (int i = 0; i < 1000; i++) {
+    rows.append(CREATE_MAP4("id", i, "name", "row", "score", i * 0.5,
+                            "tags", CREATE_VECTOR2("hot", "new")));
+  }
+  int iMax = 100;
+  String bin, txt;
+  int64 time1, time2;
+  {
+    Timer t;
+    for (int i = 0; i < iMax; i++) {
+      bin = binary_serialize(rows);
+      binary_unserialize(bin, success);
+    }
+    time1 = t.getMicroSeconds();
+  }
+  {
+    Timer t;
+    for (int i = 0; i < iMax; i++) {
+      txt = f_serialize(rows);
+      f_unserialize(txt);
+    }
+    time2 = t.getMicroSeconds();
+  }
+  VERIFY(bin.size() < txt.size());
+  if (!Test::s_quiet) {
+    printf("binary: %d bytes, %lld us\n", bin.size(), time1);
+    printf("serialize: %d bytes, %lld us\n", txt.size(), time2);
+  }
+  return Count(true);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class TestGlobals {
@@ -957,3 +1334,45 @@ bool TestCppBase::TestMemoryManager() {
   DELETE(TestGlobals)(globals);
   return Count(true);
 }
+
+///////////////////////////////////////////////////////////////////////////////
+// profile data
+
+static void write_calls_file(const std::string &path, const char *content) {
+  FILE *f = fopen(path.c_str(), "w");
+  if (f) {
+    fputs(content, f);
+    fclose(f);
+  }
+}
+
+bool TestCppBase::TestCallProfile() {
+  char dir[] = "/tmp/test_callsXXXXXX";
+  VERIFY(mkdtemp(dir));
+  std::string root = dir;
+  Util::mkdir(root + "/123/");
+  Util::mkdir(root + "/123/456/");
+
+  std::map<std::string, int64> counts;
+  VERIFY(!CallProfile::Load(dir, counts));
+
+  // top level and per-process files add up, anything else is skipped
+  write_calls_file(root + "/a.calls", "3 foo\n2 c::bar\n5000000000 hot\n");
+  write_calls_file(root + "/123/process.calls",
+                   "4 foo\n"
+                   "garbage\n"
+                   "5 \n"
+                   "6 baz");
+  write_calls_file(root + "/123/process.calls.tmp", "100 foo\n");
+  write_calls_file(root + "/123/456/deep.calls", "100 foo\n");
+  VERIFY(CallProfile::Load(dir, counts));
+  Util::ssystem((std::string("rm -rf ") + dir).c_str());
+
+  VS((int)counts.size(), 4);
+  VS(counts["foo"], 7);
+  VS(counts["hot"], 5000000000LL); // past 32 bits
+  VS(counts["c::bar"], 2);
+  VS(counts["baz"], 6); // no newline at the end
+  return Count(true);
+}
+
@@ -39,6 +39,7 @@ class TestCppBase : public TestBase {
 
   // building blocks
   bool TestSmartAllocator();
+  bool TestSizeClassAllocator();
   bool TestMemoryManager();
 
   /**
@@ -55,9 +56,14 @@ class TestCppBase : public TestBase {
    */
   bool TestString();
   bool TestArray();
+  bool TestHphpArray();
   bool TestObject();
   bool TestVariant();
   bool TestListAssignment();
+  bool TestSerialization();
+
+  // profile data
+  bool TestCallProfile();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
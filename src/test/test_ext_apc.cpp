@@ -29,13 +29,18 @@ namespace HPHP {
 bool TestExtApc::RunTests(const std::string &which) {
   bool ret = true;
 
+  bool prefixIndex = RuntimeOption::ApcPrefixIndex;
+  RuntimeOption::ApcPrefixIndex = true;
   RuntimeOption::ApcUseSharedMemory = true;
   s_apc_store.reset();
   printf("Shared memory version:\n");
   RUN_TEST(test_apc_add);
   RUN_TEST(test_apc_store);
   RUN_TEST(test_apc_fetch);
+  RUN_TEST(test_apc_fetch_or_lock);
   RUN_TEST(test_apc_delete);
+  RUN_TEST(test_apc_delete_prefix);
+  RUN_TEST(test_apc_evict);
   RUN_TEST(test_apc_compile_file);
   RUN_TEST(test_apc_cache_info);
   RUN_TEST(test_apc_clear_cache);
@@ -59,7 +64,10 @@ bool TestExtApc::RunTests(const std::string &which) {
   RUN_TEST(test_apc_add);
   RUN_TEST(test_apc_store);
   RUN_TEST(test_apc_fetch);
+  RUN_TEST(test_apc_fetch_or_lock);
   RUN_TEST(test_apc_delete);
+  RUN_TEST(test_apc_delete_prefix);
+  RUN_TEST(test_apc_evict);
   RUN_TEST(test_apc_compile_file);
   RUN_TEST(test_apc_cache_info);
   RUN_TEST(test_apc_clear_cache);
@@ -82,7 +90,10 @@ bool TestExtApc::RunTests(const std::string &which) {
   RUN_TEST(test_apc_add);
   RUN_TEST(test_apc_store);
   RUN_TEST(test_apc_fetch);
+  RUN_TEST(test_apc_fetch_or_lock);
   RUN_TEST(test_apc_delete);
+  RUN_TEST(test_apc_delete_prefix);
+  RUN_TEST(test_apc_evict);
   RUN_TEST(test_apc_compile_file);
   RUN_TEST(test_apc_cache_info);
   RUN_TEST(test_apc_clear_cache);
@@ -105,7 +116,10 @@ bool TestExtApc::RunTests(const std::string &which) {
   RUN_TEST(test_apc_add);
   RUN_TEST(test_apc_store);
   RUN_TEST(test_apc_fetch);
+  RUN_TEST(test_apc_fetch_or_lock);
   RUN_TEST(test_apc_delete);
+  RUN_TEST(test_apc_delete_prefix);
+  RUN_TEST(test_apc_evict);
   RUN_TEST(test_apc_compile_file);
   RUN_TEST(test_apc_cache_info);
   RUN_TEST(test_apc_clear_cache);
@@ -130,7 +144,10 @@ bool TestExtApc::RunTests(const std::string &which) {
   RUN_TEST(test_apc_add);
   RUN_TEST(test_apc_store);
   RUN_TEST(test_apc_fetch);
+  RUN_TEST(test_apc_fetch_or_lock);
   RUN_TEST(test_apc_delete);
+  RUN_TEST(test_apc_delete_prefix);
+  RUN_TEST(test_apc_evict);
   RUN_TEST(test_apc_compile_file);
   RUN_TEST(test_apc_cache_info);
   RUN_TEST(test_apc_clear_cache);
@@ -147,6 +164,15 @@ bool TestExtApc::RunTests(const std::string &which) {
   RUN_TEST(test_apc_bin_dumpfile);
   RUN_TEST(test_apc_bin_loadfile);
 
+  RuntimeOption::ApcPrefixIndex = false;
+  RuntimeOption::ApcUseLockedRefs = false;
+  printf("\nDefault key index settings:\n");
+  RUN_TEST(test_apc_prefix_index);
+  RUN_TEST(test_apc_evictor);
+  RuntimeOption::ApcPrefixIndex = prefixIndex;
+  RuntimeOption::ApcTableType = RuntimeOption::ApcHashTable;
+  s_apc_store.reset();
+
   return ret;
 }
 
@@ -227,6 +253,38 @@ bool TestExtApc::test_apc_store() {
   VERIFY(tsFetched.get() != sharedString.get());
   VS(f_apc_fetch("ts"), "NewValue");
 
+  Object obj(NEW(c_stdclass)());
+  obj->o_set("a", -1, 1);
+  obj->o_set("b", -1, CREATE_VECTOR2("c", "d"));
+  f_apc_store("to", obj);
+  Object objFetched = f_apc_fetch("to");
+  VERIFY(objFetched.get() != obj.get());
+  VERIFY(objFetched.instanceof("stdclass"));
+  VS(objFetched->o_toArray(), obj->o_toArray());
+  objFetched->o_set("a", -1, 2);
+  VS(f_apc_fetch("to").toObject()->o_get("a", -1), 1);
+
+  // user class: private and protected properties come back where they
+  // were, mangled names of dynamic properties are stored unmangled, and
+  // __wakeup() runs on the copy only
+  Object user = create_object("apctestuser", Array());
+  user->o_set("pub", -1, "p");
+  user->o_set("kind", -1, "k");
+  user->o_set("secret", -1, CREATE_VECTOR2(1, 2));
+  user->o_lval(String("\0ApcTestUser\0extra", 18, CopyString), -1) = "e";
+  user->o_lval(String("\0*\0other", 8, CopyString), -1) = "o";
+  f_apc_store("tu", user);
+  Object userFetched = f_apc_fetch("tu");
+  VERIFY(userFetched.get() != user.get());
+  VERIFY(userFetched.instanceof("apctestuser"));
+  VS(userFetched->o_get("pub", -1), "p");
+  VS(userFetched->o_get("kind", -1), "k");
+  VS(userFetched->o_get("secret", -1), CREATE_VECTOR2(1, 2));
+  VS(userFetched->o_get("extra", -1), "e");
+  VS(userFetched->o_get("other", -1), "o");
+  VS(userFetched->o_get("woken", -1), true);
+  VS(user->o_get("woken", -1), false);
+
   return Count(true);
 }
 
@@ -251,6 +309,43 @@ bool TestExtApc::test_apc_fetch() {
   return Count(true);
 }
 
+bool TestExtApc::test_apc_fetch_or_lock() {
+  Variant locked;
+  f_apc_delete("tfill");
+  VS(f_apc_fetch_or_lock("tfill", ref(locked)), false);
+  VS(locked, true);
+  VS(f_apc_fetch_or_lock("tfill", ref(locked)), false);
+  VS(locked, false);
+  f_apc_store("tfill", "TestString");
+  VS(f_apc_fetch_or_lock("tfill", ref(locked)), "TestString");
+  VS(locked, false);
+
+  // giving up a fill by deleting the key lets the next caller have it
+  f_apc_delete("tfill");
+  VS(f_apc_fetch_or_lock("tfill", ref(locked)), false);
+  VS(locked, true);
+  f_apc_delete("tfill");
+  VS(f_apc_fetch_or_lock("tfill", ref(locked)), false);
+  VS(locked, true);
+  f_apc_delete("tfill");
+
+  if (!RuntimeOption::ApcUseSharedMemory &&
+      RuntimeOption::ApcTableType != RuntimeOption::ApcConcurrentTable) {
+    RuntimeOption::ApcStaleGracePeriod = 60;
+    f_apc_store("tstale", "OldValue", 1);
+    RuntimeOption::ApcStaleGracePeriod = 0;
+    sleep(1);
+    VS(f_apc_fetch("tstale"), false); // this caller refreshes
+    VS(f_apc_fetch("tstale"), "OldValue");
+    VS(f_apc_fetch_or_lock("tstale", ref(locked)), "OldValue");
+    VS(locked, false);
+    f_apc_store("tstale", "NewValue");
+    VS(f_apc_fetch("tstale"), "NewValue");
+    f_apc_delete("tstale");
+  }
+  return Count(true);
+}
+
 bool TestExtApc::test_apc_delete() {
   f_apc_store("ts", "TestString");
   f_apc_store("ta", CREATE_MAP2("a", 1, "b", 2));
@@ -271,6 +366,144 @@ bool TestExtApc::test_apc_delete() {
   return Count(true);
 }
 
+bool TestExtApc::test_apc_delete_prefix() {
+  f_apc_store("tp:1", "TestString");
+  f_apc_store("tp:2", CREATE_MAP2("a", 1, "b", 2));
+  f_apc_store("tq", 3);
+
+  VS(f_apc_iterate_prefix("tp:"),
+     CREATE_MAP2("tp:1", "TestString", "tp:2", CREATE_MAP2("a", 1, "b", 2)));
+  VS(f_apc_iterate_prefix("tp:", 1), CREATE_MAP1("tp:1", "TestString"));
+  VS(f_apc_iterate_prefix("tr"), Array::Create());
+
+  Variant info = f_apc_prefix_info("tp:");
+  VS(info["keys"], 2);
+  VERIFY(info["bytes"].toInt64() > 0);
+  VS(f_apc_prefix_info("tr")["bytes"], 0);
+
+  VS(f_apc_delete_prefix("tp:"), 2);
+  VS(f_apc_fetch("tp:1"), false);
+  VS(f_apc_fetch("tp:2"), false);
+  VS(f_apc_fetch("tq"), 3);
+  VS(f_apc_prefix_info("tp:")["keys"], 0);
+  VS(f_apc_delete_prefix("tp:"), 0);
+  f_apc_delete("tq");
+
+  return Count(true);
+}
+
+bool TestExtApc::test_apc_evict() {
+  if (RuntimeOption::ApcUseSharedMemory) {
+    return Count(true); // not indexed, and bounded by its segment anyway
+  }
+  SharedStore &store = s_apc_store[SHARED_STORE_APPLICATION_CACHE];
+  f_apc_store("tsmall", 1);
+  f_apc_store("tbig", String(std::string(10000, 'x')));
+  int64 used = store.getSpaceUsage();
+  VERIFY(used > 10000);
+
+  VS(store.evict(used), 0);
+  VS(store.evict(used - 1), 1); // the big one goes first
+  VS(f_apc_fetch("tbig"), false);
+  VS(f_apc_fetch("tsmall"), 1);
+  VERIFY(store.getSpaceUsage() < used - 10000);
+  f_apc_delete("tsmall");
+
+  if (RuntimeOption::ApcTableType == RuntimeOption::ApcLfuTable) {
+    // values the LFU table drops by itself are not counted any more
+    size_t maxCap = RuntimeOption::ApcMaximumCapacity;
+    RuntimeOption::ApcMaximumCapacity = 2;
+    s_apc_store.reset();
+    SharedStore &lfu = s_apc_store[SHARED_STORE_APPLICATION_CACHE];
+    f_apc_store("tlfu1", String(std::string(10000, 'x')));
+    f_apc_store("tlfu2", String(std::string(10000, 'y')));
+    f_apc_store("tlfu3", String(std::string(10000, 'z')));
+    VERIFY(lfu.getSpaceUsage() > 20000);
+    VERIFY(lfu.getSpaceUsage() < 30000);
+    RuntimeOption::ApcMaximumCapacity = maxCap;
+    s_apc_store.reset();
+  }
+
+  return Count(true);
+}
+
+bool TestExtApc::test_apc_prefix_index() {
+  static const RuntimeOption::ApcTableTypes types[] = {
+    RuntimeOption::ApcHashTable,
+    RuntimeOption::ApcLfuTable,
+    RuntimeOption::ApcConcurrentTable,
+  };
+  bool keyStats = RuntimeOption::EnableAPCKeyStats;
+  RuntimeOption::EnableAPCKeyStats = true;
+  for (unsigned int i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+    RuntimeOption::ApcTableType = types[i];
+
+    // neither PrefixIndex nor MaximumMemory: no index to search
+    s_apc_store.reset();
+    SharedStore &store = s_apc_store[SHARED_STORE_APPLICATION_CACHE];
+    VERIFY(!store.canFindPrefix());
+    f_apc_store("tk:1", String(std::string(1000, 'x')));
+    VS(f_apc_delete_prefix("tk:"), false);
+    VS(f_apc_iterate_prefix("tk:"), false);
+    VS(f_apc_prefix_info("tk:"), false);
+    VS(f_apc_fetch("tk:1"), String(std::string(1000, 'x')));
+
+    // but stats still count the bytes, from a scan
+    std::string stats = SharedStores::ReportStats(0);
+    size_t pos = stats.find("<Bytes>"); // the application cache comes first
+    VERIFY(pos != std::string::npos);
+    VERIFY(atoi(stats.c_str() + pos + strlen("<Bytes>")) > 1000);
+    VERIFY(stats.find("<KeySkeleton>") != std::string::npos);
+
+    // MaximumMemory alone indexes the application cache, for eviction
+    RuntimeOption::ApcMaximumMemory = 1024;
+    s_apc_store.reset();
+    VERIFY(s_apc_store[SHARED_STORE_APPLICATION_CACHE].canFindPrefix());
+    VERIFY(!s_apc_store[SHARED_STORE_DNS_CACHE].canFindPrefix());
+    f_apc_store("tk:1", 1);
+    VS(f_apc_iterate_prefix("tk:"), CREATE_MAP1("tk:1", 1));
+    VS(f_apc_delete_prefix("tk:"), 1);
+    RuntimeOption::ApcMaximumMemory = 0;
+  }
+  RuntimeOption::EnableAPCKeyStats = keyStats;
+  return Count(true);
+}
+
+bool TestExtApc::test_apc_evictor() {
+  static const RuntimeOption::ApcTableTypes types[] = {
+    RuntimeOption::ApcHashTable,
+    RuntimeOption::ApcLfuTable,
+    RuntimeOption::ApcConcurrentTable,
+  };
+  int64 budget = 1024 * 1024;
+  for (unsigned int i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+    RuntimeOption::ApcTableType = types[i];
+    RuntimeOption::ApcMaximumMemory = 1; // MB, and nothing else set
+    s_apc_store.reset();
+    SharedStore &store = s_apc_store[SHARED_STORE_APPLICATION_CACHE];
+
+    String value(std::string(100 * 1024, 'x'));
+    for (int j = 0; j < 30; j++) {
+      f_apc_store(String("tev:") + String(j), value);
+    }
+    VERIFY(store.getSpaceUsage() > budget);
+
+    // the background evictor runs every 100ms
+    for (int j = 0; j < 50 && store.getSpaceUsage() > budget; j++) {
+      usleep(100000);
+    }
+    VERIFY(store.getSpaceUsage() <= budget);
+    int left = 0;
+    for (int j = 0; j < 30; j++) {
+      if (!same(f_apc_fetch(String("tev:") + String(j)), false)) left++;
+    }
+    VERIFY(left > 0 && left <= 10);
+    RuntimeOption::ApcMaximumMemory = 0;
+  }
+  s_apc_store.reset();
+  return Count(true);
+}
+
 bool TestExtApc::test_apc_compile_file() {
   try {
     f_apc_compile_file("");
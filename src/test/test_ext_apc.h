@@ -30,7 +30,12 @@ class TestExtApc : public TestCppExt {
   bool test_apc_add();
   bool test_apc_store();
   bool test_apc_fetch();
+  bool test_apc_fetch_or_lock();
   bool test_apc_delete();
+  bool test_apc_delete_prefix();
+  bool test_apc_evict();
+  bool test_apc_prefix_index();
+  bool test_apc_evictor();
   bool test_apc_compile_file();
   bool test_apc_cache_info();
   bool test_apc_clear_cache();
@@ -17,6 +17,7 @@
 #include <test/test_ext_array.h>
 #include <cpp/ext/ext_variable.h>
 #include <cpp/ext/ext_array.h>
+#include <cpp/ext/ext_string.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -862,6 +863,12 @@ bool TestExtArray::test_array_unique() {
        "    [2] => 3\n"
        ")\n");
   }
+  {
+    Array input = CREATE_VECTOR6("1", 1, "01", 1.0, true, "");
+    input.append(null);
+    input.append(false);
+    VS(f_array_unique(input), CREATE_MAP3(0, "1", 2, "01", 5, ""));
+  }
   return Count(true);
 }
 
@@ -1179,6 +1186,40 @@ bool TestExtArray::test_in_array() {
     VERIFY(!f_in_array(CREATE_VECTOR2("f", "i"), a));
     VERIFY(f_in_array("o", a));
   }
+  {
+    // searched often enough to be indexed
+    Array a = Array::Create();
+    for (int i = 0; i < 100; i++) {
+      a.append(i * 2);
+    }
+    for (int i = 0; i < 10; i++) {
+      VERIFY(f_in_array(10, a));
+      VERIFY(!f_in_array(11, a, true));
+    }
+    VERIFY(f_in_array("10", a));
+    VERIFY(!f_in_array("10", a, true));
+    VERIFY(f_in_array("10abc", a));
+    a.set(5, 11);
+    VERIFY(f_in_array(11, a, true));
+    VERIFY(!f_in_array(10, a));
+  }
+  {
+    Array a = Array::Create();
+    for (int i = 0; i < 100; i++) {
+      a.append(String("s") + String(i));
+    }
+    a.append("10");
+    for (int i = 0; i < 10; i++) {
+      VERIFY(f_in_array("s42", a));
+      VERIFY(!f_in_array("s100", a, true));
+    }
+    VERIFY(f_in_array("1e1", a));
+    VERIFY(!f_in_array("1e1", a, true));
+    VERIFY(f_in_array(10, a));
+    VERIFY(!f_in_array(10, a, true));
+    a.remove(42);
+    VERIFY(!f_in_array("s42", a));
+  }
   return Count(true);
 }
 
@@ -1252,6 +1293,11 @@ bool TestExtArray::test_array_diff() {
   Array b = CREATE_VECTOR2("b", "c");
   VS(f_array_diff(2, b, a), CREATE_MAP1(1, "c"));
 
+  // values are compared as strings
+  Array c = CREATE_VECTOR5(1, "01", 2.5, "x", true);
+  Array d = CREATE_VECTOR2("1", "2.5");
+  VS(f_array_diff(2, c, d), CREATE_MAP2(1, "01", 3, "x"));
+
   return Count(true);
 }
 
@@ -1385,6 +1431,10 @@ bool TestExtArray::test_array_intersect() {
                NULL);
   VS(f_array_intersect(2, array1, array2),
      CREATE_MAP2("a", "green", "0", "red"));
+
+  Array c = CREATE_VECTOR5(1, "01", 2.5, "x", true);
+  Array d = CREATE_VECTOR2("1", "2.5");
+  VS(f_array_intersect(2, c, d), CREATE_MAP3(0, 1, 2, 2.5, 4, true));
   return Count(true);
 }
 
@@ -1499,6 +1549,38 @@ bool TestExtArray::test_sort() {
      "    [2] => lemon\n"
      "    [3] => orange\n"
      ")\n");
+
+  // large enough for radix sorting, with negative numbers
+  Array numbers;
+  for (int i = 0; i < 1000; i++) {
+    numbers.append((int64)((i * 7919) % 1000) - 500);
+  }
+  Variant sorted = numbers;
+  f_sort(ref(sorted));
+  for (int i = 0; i < 1000; i++) {
+    VS(sorted[i], i - 500);
+  }
+  f_rsort(ref(sorted));
+  VS(sorted[0], 499);
+  VS(sorted[999], -500);
+
+  sorted = CREATE_VECTOR4(10, 9, -(1LL << 40), 1LL << 40);
+  f_sort(ref(sorted));
+  VS(f_implode(",", sorted), "-1099511627776,9,10,1099511627776");
+  f_sort(ref(sorted), k_SORT_STRING);
+  VS(f_implode(",", sorted), "-1099511627776,10,1099511627776,9");
+
+  // strings sharing the cached prefix
+  sorted = CREATE_VECTOR4("abcdefghZ", "abcdefgh", "abcdefghA", "abc");
+  f_sort(ref(sorted));
+  VS(f_implode(",", sorted), "abc,abcdefgh,abcdefghA,abcdefghZ");
+
+  // numeric strings compare as numbers
+  sorted = CREATE_VECTOR3("10", "9", "2");
+  f_sort(ref(sorted));
+  VS(f_implode(",", sorted), "2,9,10");
+  f_sort(ref(sorted), k_SORT_STRING);
+  VS(f_implode(",", sorted), "10,2,9");
   return Count(true);
 }
 
@@ -1600,6 +1682,11 @@ bool TestExtArray::test_ksort() {
      "    [c] => apple\n"
      "    [d] => lemon\n"
      ")\n");
+
+  Variant numbers = CREATE_MAP3(3, "c", -1, "a", 2, "b");
+  f_ksort(ref(numbers));
+  VS(f_implode(",", numbers), "a,b,c");
+  VS(f_implode(",", f_array_keys(numbers)), "-1,2,3");
   return Count(true);
 }
 
@@ -267,6 +267,21 @@ bool TestExtDatetime::test_date() {
 
  VS(f_date("r", -5000000000), "Tue, 23 Jul 1811 07:06:40 -0800");
 
+  // same second again, served from the per-thread cache
+  d = f_strtotime("2008-09-10 12:34:56");
+  VS(f_date("Y-m-d H:i:s", d), "2008-09-10 12:34:56");
+  VS(f_date("Y-m-d H:i:s", d), "2008-09-10 12:34:56");
+  VS(f_date("c", d), "2008-09-10T12:34:56-07:00");
+  VS(f_date("e T", d), "America/Los_Angeles PDT");
+  VERIFY(f_date_default_timezone_set("Asia/Shanghai"));
+  VS(f_date("Y-m-d H:i:s", d), "2008-09-11 03:34:56");
+  VERIFY(f_date_default_timezone_set("America/Los_Angeles"));
+  VS(f_date("Y-m-d H:i:s", d), "2008-09-10 12:34:56");
+
+  // a format with a NUL in it is not the cached format before the NUL
+  VS(f_date("Y", d), "2008");
+  VERIFY(f_date(String("Y\0m", 3, AttachLiteral), d).size() > 4);
+
   return Count(true);
 }
 
@@ -306,6 +321,9 @@ bool TestExtDatetime::test_gmdate() {
   int d = f_mktime(0, 0, 0, 1, 1, 1998);
   VS(f_date("M d Y H:i:s",   d), "Jan 01 1998 00:00:00");
   VS(f_gmdate("M d Y H:i:s", d), "Jan 01 1998 08:00:00");
+  VS(f_gmdate("M d Y H:i:s", d), "Jan 01 1998 08:00:00");
+  VS(f_gmdate("c", d), "1998-01-01T08:00:00+0:0");
+  VS(f_gmdate("D, d M Y H:i:s T", d), "Thu, 01 Jan 1998 08:00:00 GMT");
   return Count(true);
 }
 
@@ -484,6 +502,11 @@ bool TestExtDatetime::test_strtotime() {
   VS(f_strtotime("+1 week 2 days 4 hours 2 seconds", 968569200), 969361202);
   VS(f_strtotime("next Thursday", 968569200), 968914800);
   VS(f_strtotime("last Monday", 968569200), 968050800);
+  VS(f_strtotime("now", 968569200), 968569200);
+  VS(f_strtotime("@1170288001"), 1170288001);
+  VS(f_strtotime("2000-09-10"), 968569200);
+  VS(f_strtotime("2008-09-10 12:34:56"), 1221075296);
+  VERIFY(same(f_strtotime("2008-13-10 12:34:56"), false));
 
   String str = "Not Good";
   Variant timestamp = f_strtotime(str);
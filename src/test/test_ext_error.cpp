@@ -16,6 +16,7 @@
 
 #include <test/test_ext_error.h>
 #include <cpp/ext/ext_error.h>
+#include <cpp/ext/ext_variable.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -33,6 +34,9 @@ bool TestExtError::RunTests(const std::string &which) {
   RUN_TEST(test_set_exception_handler);
   RUN_TEST(test_trigger_error);
   RUN_TEST(test_user_error);
+  RUN_TEST(test_hphp_backtrace_snapshot);
+  RUN_TEST(test_hphp_backtrace_snapshot_array);
+  RUN_TEST(test_exception_trace);
 
   return ret;
 }
@@ -102,3 +106,37 @@ bool TestExtError::test_user_error() {
   // tested in TestCodeRun::TestErrorHandler
   return Count(true);
 }
+
+bool TestExtError::test_hphp_backtrace_snapshot() {
+  // tested in TestCodeRun::TestExceptions
+  return Count(true);
+}
+
+bool TestExtError::test_hphp_backtrace_snapshot_array() {
+  Variant file, line;
+  Variant snapshot = f_hphp_backtrace_snapshot(ref(file), ref(line));
+  Array bt = f_debug_backtrace();
+  bt.dequeue(); // what snapshot took off
+  if (snapshot.isObject()) {
+    VS(f_hphp_backtrace_snapshot_array(snapshot.toObject()), bt);
+  } else {
+    VS(snapshot, bt);
+  }
+  return Count(true);
+}
+
+bool TestExtError::test_exception_trace() {
+  Object e = create_object("exception", Array());
+
+  // (array) and var_dump() see the snapshot until getTrace() is called
+  Variant trace = e.toArray()["trace"];
+  if (trace.isObject()) {
+    VERIFY(f_is_resource(trace));
+  }
+
+  Variant materialized = e->o_invoke("getTrace", Array(), -1);
+  VERIFY(materialized.isArray());
+  VS(e.toArray()["trace"], materialized);
+  VERIFY(!f_is_resource(e.toArray()["trace"]));
+  return Count(true);
+}
@@ -38,6 +38,9 @@ class TestExtError : public TestCppExt {
   bool test_set_exception_handler();
   bool test_trigger_error();
   bool test_user_error();
+  bool test_hphp_backtrace_snapshot();
+  bool test_hphp_backtrace_snapshot_array();
+  bool test_exception_trace();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
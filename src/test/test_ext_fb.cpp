@@ -16,6 +16,9 @@
 
 #include <test/test_ext_fb.h>
 #include <cpp/ext/ext_fb.h>
+#include <cpp/ext/ext_variable.h>
+#include <util/db_conn.h>
+#include <test/test_mysql_info.inc>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -24,6 +27,8 @@ bool TestExtFb::RunTests(const std::string &which) {
 
   RUN_TEST(test_fb_thrift_serialize);
   RUN_TEST(test_fb_thrift_unserialize);
+  RUN_TEST(test_fb_compact_serialize);
+  RUN_TEST(test_fb_compact_unserialize);
   RUN_TEST(test_fb_rename_function);
   RUN_TEST(test_fb_utf8ize);
   RUN_TEST(test_fb_call_user_func_safe);
@@ -56,6 +61,42 @@ bool TestExtFb::test_fb_thrift_unserialize() {
   return Count(true);
 }
 
+bool TestExtFb::test_fb_compact_serialize() {
+  Variant ret;
+  VS(f_fb_compact_unserialize(f_fb_compact_serialize("test"), ref(ret)),
+     "test");
+  VERIFY(same(ret, true));
+
+  ret = null;
+  Array arr = CREATE_MAP4("a", 1, "b", -2.5, 10, true, "c",
+                          CREATE_VECTOR2("a", null));
+  VS(f_fb_compact_unserialize(f_fb_compact_serialize(arr), ref(ret)), arr);
+  VERIFY(same(ret, true));
+
+  // repeated short strings are written once
+  Array rows;
+  for (int i = 0; i < 100; i++) {
+    rows.append(CREATE_MAP2("id", i, "name", "hiphop"));
+  }
+  String bin = f_fb_compact_serialize(rows);
+  String txt = f_serialize(rows);
+  VERIFY(bin.size() * 3 < txt.size());
+  VS(f_fb_compact_unserialize(bin, ref(ret)), rows);
+  VERIFY(same(ret, true));
+  return Count(true);
+}
+
+bool TestExtFb::test_fb_compact_unserialize() {
+  Variant ret;
+  VS(f_fb_compact_unserialize(123, ref(ret)), false);
+  VERIFY(same(ret, false));
+
+  ret = null;
+  VS(f_fb_compact_unserialize("A\x05I", ref(ret)), false);
+  VERIFY(same(ret, false));
+  return Count(true);
+}
+
 bool TestExtFb::test_fb_rename_function() {
   // tested in TestCodeRun
   return Count(true);
@@ -128,7 +169,53 @@ bool TestExtFb::test_fb_load_local_databases() {
 }
 
 bool TestExtFb::test_fb_parallel_query() {
-  // tested with PHP unit tests
+  Array sql_map, set_map, check_map;
+  for (int i = 0; i < 3; i++) {
+    Array query = CREATE_MAP4("ip", TEST_HOSTNAME, "db", TEST_DATABASE,
+                              "username", TEST_USERNAME,
+                              "password", TEST_PASSWORD);
+    query.set("sql", "SELECT INDEX AS idx");
+    sql_map.append(query);
+    query.set("sql", "SET @pooled = INDEX");
+    set_map.append(query);
+    query.set("sql", "SELECT @pooled IS NULL AS reset");
+    check_map.append(query);
+  }
+
+  DBConnPool::Clear();
+  DBConnPool::MaxIdlePerServer = 4;
+  DBConn::MultiplexParallelQueries = true;
+  {
+    // all three are open at once on this thread, then pooled
+    Array ret = f_fb_parallel_query(sql_map);
+    VERIFY(!ret.exists("error"));
+    VS(ret["result"].toArray().size(), 3);
+    VS(DBConnPool::GetIdleCount(), 3);
+  }
+  {
+    // pooled connections don't carry session state over
+    Array ret = f_fb_parallel_query(set_map);
+    VERIFY(!ret.exists("error"));
+    ret = f_fb_parallel_query(check_map);
+    VERIFY(!ret.exists("error"));
+    Array rows = ret["result"].toArray();
+    VS(rows.size(), 3);
+    for (ArrayIter iter = rows.begin(); !iter.end(); ++iter) {
+      VS(iter.second()["reset"].toInt64(), 1);
+    }
+    VS(DBConnPool::GetIdleCount(), 3);
+  }
+  DBConn::MultiplexParallelQueries = false;
+  {
+    // worker threads, which may pass connections to each other meanwhile
+    Array ret = f_fb_parallel_query(sql_map);
+    VERIFY(!ret.exists("error"));
+    VS(ret["result"].toArray().size(), 3);
+    VERIFY(DBConnPool::GetIdleCount() <= 3);
+  }
+  DBConnPool::MaxIdlePerServer = 0;
+  DBConnPool::Clear();
+  VS(DBConnPool::GetIdleCount(), 0);
   return Count(true);
 }
 
@@ -29,6 +29,8 @@ class TestExtFb : public TestCppExt {
 
   bool test_fb_thrift_serialize();
   bool test_fb_thrift_unserialize();
+  bool test_fb_compact_serialize();
+  bool test_fb_compact_unserialize();
   bool test_fb_rename_function();
   bool test_fb_utf8ize();
   bool test_fb_call_user_func_safe();
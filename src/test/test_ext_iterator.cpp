@@ -68,6 +68,18 @@ bool TestExtIterator::RunTests(const std::string &which) {
   RUN_TEST(test_hphp_recursivedirectoryiterator_getchildren);
   RUN_TEST(test_hphp_recursivedirectoryiterator_getsubpath);
   RUN_TEST(test_hphp_recursivedirectoryiterator_getsubpathname);
+  RUN_TEST(test_hphp_splobjectstorage_rewind);
+  RUN_TEST(test_hphp_splobjectstorage_valid);
+  RUN_TEST(test_hphp_splobjectstorage_key);
+  RUN_TEST(test_hphp_splobjectstorage_current);
+  RUN_TEST(test_hphp_splobjectstorage_next);
+  RUN_TEST(test_hphp_splobjectstorage_count);
+  RUN_TEST(test_hphp_splobjectstorage_contains);
+  RUN_TEST(test_hphp_splobjectstorage_attach);
+  RUN_TEST(test_hphp_splobjectstorage_detach);
+  RUN_TEST(test_hphp_splobjectstorage_getinfo);
+  RUN_TEST(test_hphp_splobjectstorage_setinfo);
+  RUN_TEST(test_hphp_splobjectstorage_offsetget);
 
   return ret;
 }
@@ -257,3 +269,51 @@ bool TestExtIterator::test_hphp_recursivedirectoryiterator_getsubpath() {
 bool TestExtIterator::test_hphp_recursivedirectoryiterator_getsubpathname() {
   return Count(true);
 }
+
+bool TestExtIterator::test_hphp_splobjectstorage_rewind() {
+  return Count(true);
+}
+
+bool TestExtIterator::test_hphp_splobjectstorage_valid() {
+  return Count(true);
+}
+
+bool TestExtIterator::test_hphp_splobjectstorage_key() {
+  return Count(true);
+}
+
+bool TestExtIterator::test_hphp_splobjectstorage_current() {
+  return Count(true);
+}
+
+bool TestExtIterator::test_hphp_splobjectstorage_next() {
+  return Count(true);
+}
+
+bool TestExtIterator::test_hphp_splobjectstorage_count() {
+  return Count(true);
+}
+
+bool TestExtIterator::test_hphp_splobjectstorage_contains() {
+  return Count(true);
+}
+
+bool TestExtIterator::test_hphp_splobjectstorage_attach() {
+  return Count(true);
+}
+
+bool TestExtIterator::test_hphp_splobjectstorage_detach() {
+  return Count(true);
+}
+
+bool TestExtIterator::test_hphp_splobjectstorage_getinfo() {
+  return Count(true);
+}
+
+bool TestExtIterator::test_hphp_splobjectstorage_setinfo() {
+  return Count(true);
+}
+
+bool TestExtIterator::test_hphp_splobjectstorage_offsetget() {
+  return Count(true);
+}
@@ -73,6 +73,18 @@ class TestExtIterator : public TestCppExt {
   bool test_hphp_recursivedirectoryiterator_getchildren();
   bool test_hphp_recursivedirectoryiterator_getsubpath();
   bool test_hphp_recursivedirectoryiterator_getsubpathname();
+  bool test_hphp_splobjectstorage_rewind();
+  bool test_hphp_splobjectstorage_valid();
+  bool test_hphp_splobjectstorage_key();
+  bool test_hphp_splobjectstorage_current();
+  bool test_hphp_splobjectstorage_next();
+  bool test_hphp_splobjectstorage_count();
+  bool test_hphp_splobjectstorage_contains();
+  bool test_hphp_splobjectstorage_attach();
+  bool test_hphp_splobjectstorage_detach();
+  bool test_hphp_splobjectstorage_getinfo();
+  bool test_hphp_splobjectstorage_setinfo();
+  bool test_hphp_splobjectstorage_offsetget();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
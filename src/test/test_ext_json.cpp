@@ -38,6 +38,10 @@ bool TestExtJson::test_json_encode() {
 
   VS(f_json_encode("a\xE0"), "\"\"");
   VS(f_json_encode("a\xE0", true), "\"a?\"");
+  VS(f_json_encode("0123456789abcdef/\"\\\n\x01"),
+     "\"0123456789abcdef\\/\\\"\\\\\\n\\u0001\"");
+  VS(f_json_encode("0123456789abcdef\"\xC3\xA9"),
+     "\"0123456789abcdef\\\"\\u00e9\"");
 
   VS(f_json_encode(CREATE_MAP2("0", "apple", "1", "banana")),
      "[\"apple\",\"banana\"]");
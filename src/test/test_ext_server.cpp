@@ -36,6 +36,8 @@ bool TestExtServer::RunTests(const std::string &which) {
   RUN_TEST(test_pagelet_server_task_start);
   RUN_TEST(test_pagelet_server_task_status);
   RUN_TEST(test_pagelet_server_task_result);
+  RUN_TEST(test_pagelet_server_task_flushed);
+  RUN_TEST(test_pagelet_server_task_wait_any);
   RUN_TEST(test_xbox_send_message);
   RUN_TEST(test_xbox_post_message);
   RUN_TEST(test_xbox_task_start);
@@ -107,6 +109,64 @@ bool TestExtServer::test_pagelet_server_task_result() {
   return Count(true);
 }
 
+bool TestExtServer::test_pagelet_server_task_flushed() {
+  Object task = f_pagelet_server_task_start("pageletserver?getparam=1",
+                                            CREATE_VECTOR1("MyHeader: 2"),
+                                            "postparam=3");
+  VS(f_pagelet_server_task_wait_any(CREATE_VECTOR1(task), 5000), 0);
+  VS(f_pagelet_server_task_flushed(task),
+     "pagelet postparam: 3pagelet getparam: 1pagelet header: 2");
+  VS(f_pagelet_server_task_flushed(task), "");
+
+  // what was taken is not returned again
+  Variant code, headers;
+  VS(f_pagelet_server_task_result(task, ref(headers), ref(code)), "");
+  VS(code, 200);
+
+  // streaming: a part flush()ed while the pagelet is still running
+  task = f_pagelet_server_task_start("pageletflush");
+  Array tasks = CREATE_VECTOR1(task);
+  VS(f_pagelet_server_task_wait_any(tasks, 5000, true), 0);
+  VERIFY(!f_pagelet_server_task_status(task));
+  VS(f_pagelet_server_task_flushed(task), "first part");
+  VS(f_pagelet_server_task_wait_any(tasks, 100, true), false);
+  VS(f_pagelet_server_task_wait_any(tasks, 5000, true), 0);
+  VERIFY(f_pagelet_server_task_status(task));
+  VS(f_pagelet_server_task_flushed(task), "second part");
+  VS(f_pagelet_server_task_result(task, ref(headers), ref(code)), "");
+  return Count(true);
+}
+
+bool TestExtServer::test_pagelet_server_task_wait_any() {
+  const int TEST_SIZE = 10;
+
+  Array tasks;
+  for (int i = 0; i < TEST_SIZE; ++i) {
+    String url = String("pageletserver?getparam=") + String(i);
+    tasks.set(String("t") + String(i),
+              f_pagelet_server_task_start(url, CREATE_VECTOR1("MyHeader: 0"),
+                                          "postparam=0"));
+  }
+
+  VS(f_pagelet_server_task_wait_any(Array::Create(), 10), false);
+
+  for (int i = 0; i < TEST_SIZE; ++i) {
+    Variant key = f_pagelet_server_task_wait_any(tasks, 5000);
+    VERIFY(tasks.exists(key));
+    Object task = tasks[key].toObject();
+    VERIFY(f_pagelet_server_task_status(task));
+
+    String expected = "pagelet postparam: 0pagelet getparam: ";
+    expected += key.toString().substr(1);
+    expected += "pagelet header: 0";
+    Variant code, headers;
+    VS(f_pagelet_server_task_result(task, ref(headers), ref(code)),
+       expected);
+    tasks.remove(key);
+  }
+  return Count(true);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 bool TestExtServer::test_xbox_send_message() {
@@ -133,6 +133,11 @@ bool TestExtString::test_stripcslashes() {
 
 bool TestExtString::test_addslashes() {
   VS(f_addslashes("'\"\\\n"), "\\'\\\"\\\\\n");
+  VS(f_addslashes(String("0123456789abcdef'0123\0", 22, AttachLiteral)),
+     "0123456789abcdef\\'0123\\0");
+
+  String clean = "nothing to escape in here at all";
+  VERIFY(f_addslashes(clean).get() == clean.get());
   return Count(true);
 }
 
@@ -452,6 +457,11 @@ bool TestExtString::test_htmlspecialchars_decode() {
 bool TestExtString::test_htmlspecialchars() {
   VS(f_htmlspecialchars("<a href='test'>Test</a>", k_ENT_QUOTES),
      "&lt;a href=&#039;test&#039;&gt;Test&lt;/a&gt;");
+  VS(f_htmlspecialchars("0123456789abcdef\"0123456789abcdef&'<>"),
+     "0123456789abcdef&quot;0123456789abcdef&amp;'&lt;&gt;");
+
+  String clean = "nothing to escape in here at all";
+  VERIFY(f_htmlspecialchars(clean).get() == clean.get());
   return Count(true);
 }
 
@@ -154,6 +154,8 @@ bool TestExtUrl::test_rawurldecode() {
 
 bool TestExtUrl::test_rawurlencode() {
   VS(f_rawurlencode("foo bar@baz"), "foo%20bar%40baz");
+  VS(f_rawurlencode("0123456789abcdef~0123456789_.-\xff"),
+     "0123456789abcdef%7E0123456789_.-%FF");
   return Count(true);
 }
 
@@ -164,5 +166,10 @@ bool TestExtUrl::test_urldecode() {
 
 bool TestExtUrl::test_urlencode() {
   VS(f_urlencode("foo bar@baz"), "foo+bar%40baz");
+  VS(f_urlencode("0123456789abcdef 0123456789/"),
+     "0123456789abcdef+0123456789%2F");
+
+  String clean = "ABCDEFGHIJKLMNOPQRSTUVWXYZ-abcdefghijklmnopqrstuvwxyz_0.9";
+  VERIFY(f_urlencode(clean).get() == clean.get());
   return Count(true);
 }
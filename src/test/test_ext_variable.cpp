@@ -16,6 +16,7 @@
 
 #include <test/test_ext_variable.h>
 #include <cpp/ext/ext_variable.h>
+#include <cpp/base/runtime_option.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -342,6 +343,41 @@ bool TestExtVariable::test_unserialize() {
     Variant v2 = f_unserialize("a:3:{s:1:\"a\";s:5:\"apple\";s:1:\"b\";i:2;s:1:\"c\";a:3:{i:0;i:1;i:1;s:1:\"y\";i:2;i:3;}}");
     VS(v1, v2);
   }
+  {
+    // back references into an array bigger than HphpArray's first capacity
+    bool savedZend = RuntimeOption::UseZendArray;
+    bool savedHphp = RuntimeOption::UseHphpArray;
+    RuntimeOption::UseZendArray = true;
+    RuntimeOption::UseHphpArray = true;
+
+    String text = "a:11:{";
+    for (int i = 0; i < 10; i++) {
+      text += String("i:") + String(i) + ";i:" + String(i) + ";";
+    }
+    text += "i:10;R:2;}";
+    Variant v = f_unserialize(text);
+    v.lvalAt(10) = 100;
+    VS(v[0], 100);
+    VS(v[9], 9);
+
+    std::string binary = "A\x0b";
+    for (int i = 0; i < 10; i++) {
+      binary += 'I';
+      binary += (char)(i * 2); // zigzag encoded
+      binary += 'I';
+      binary += (char)(i * 2);
+    }
+    binary += "I\x14R\x02";
+    bool success;
+    v = binary_unserialize(String(binary), success);
+    VERIFY(success);
+    v.lvalAt(10) = 100;
+    VS(v[0], 100);
+    VS(v[9], 9);
+
+    RuntimeOption::UseZendArray = savedZend;
+    RuntimeOption::UseHphpArray = savedHphp;
+  }
   return Count(true);
 }
 
@@ -20,6 +20,7 @@
 #include <cpp/ext/ext_string.h>
 #include <cpp/ext/ext_network.h>
 #include <cpp/ext/ext_soap.h>
+#include <cpp/ext/ext_output.h>
 #include <cpp/base/program_functions.h>
 #include <lib/system/gen/sys/system_globals.h>
 
@@ -84,6 +85,21 @@ const char *g_class_map[] = {
   /* constants */
   NULL,
 
+  /* header */ (const char *)ClassInfo::IsNothing, "apctestuser", "",
+  /* interfaces */
+  NULL,
+  /* methods    */
+  (const char *)ClassInfo::IsPublic, "__wakeup", NULL, NULL, NULL, NULL,
+  NULL,
+  /* properties */
+  (const char *)ClassInfo::IsPublic, "pub",
+  (const char *)ClassInfo::IsProtected, "kind",
+  (const char *)ClassInfo::IsPrivate, "secret",
+  (const char *)ClassInfo::IsPublic, "woken",
+  NULL,
+  /* constants */
+  NULL,
+
   /* header */ (const char *)ClassInfo::IsInterface, "itestable", "",
   /* interfaces */
   NULL,
@@ -104,9 +120,73 @@ const char *g_source_info[] = { NULL};
 const char *g_source_cls2file[] = { "test", "test_file", NULL};
 const char *g_source_func2file[] = { NULL};
 const char *g_paramrtti_map[] = { NULL};
+const char *g_callprofile_map[] = { NULL};
+
+// Used by test_ext_apc: what a user class with private and protected
+// properties and __wakeup() compiles down to
+class c_apctestuser : public ObjectData {
+public:
+  c_apctestuser() : m_woken(false) {}
+  virtual const char *o_getClassName() const { return "ApcTestUser";}
+  virtual bool o_instanceof(const char *s) const {
+    return s && strcasecmp(s, "apctestuser") == 0;
+  }
+  virtual void o_get(ArrayElementVec &props) const {
+    props.push_back(NEW(ArrayElement)("pub", m_pub));
+    props.push_back(NEW(ArrayElement)("kind", m_kind));
+    props.push_back(NEW(ArrayElement)("secret", m_secret));
+    props.push_back(NEW(ArrayElement)("woken", m_woken));
+  }
+  virtual Variant o_get(CStrRef s, int64 hash) {
+    Variant *prop = find(s);
+    return prop ? *prop : ObjectData::o_get(s, hash);
+  }
+  virtual Variant o_set(CStrRef s, int64 hash, CVarRef v,
+                        bool forInit = false) {
+    Variant *prop = find(s);
+    if (prop) return *prop = v;
+    return ObjectData::o_set(s, hash, v, forInit);
+  }
+  virtual Variant &o_lval(CStrRef s, int64 hash) {
+    Variant *prop = find(s);
+    return prop ? *prop : ObjectData::o_lval(s, hash);
+  }
+  virtual Variant t___wakeup() {
+    m_woken = true;
+    return null;
+  }
+
+protected:
+  virtual ObjectData *cloneImpl() {
+    c_apctestuser *obj = new c_apctestuser();
+    obj->m_pub = m_pub;
+    obj->m_kind = m_kind;
+    obj->m_secret = m_secret;
+    obj->m_woken = m_woken;
+    ObjectData::cloneSet(obj);
+    return obj;
+  }
+
+private:
+  Variant m_pub;
+  Variant m_kind;   // protected
+  Variant m_secret; // private
+  Variant m_woken;
+
+  Variant *find(CStrRef s) {
+    if (s == "pub")    return &m_pub;
+    if (s == "kind")   return &m_kind;
+    if (s == "secret") return &m_secret;
+    if (s == "woken")  return &m_woken;
+    return NULL;
+  }
+};
 
 Object create_object(const char *s, const Array &params, bool init,
                      ObjectData *root) {
+  if (strcasecmp(s, "apctestuser") == 0) {
+    return Object(new c_apctestuser());
+  }
   return create_builtin_object(s, params, init, root);
 }
 
@@ -309,6 +389,13 @@ Variant invoke_file(CStrRef path, bool once /* = false */,
     sleep(1); // give status check time to happen
     return true;
   }
+  if (cmd == "pageletflush") {
+    echo("first part");
+    f_flush();
+    sleep(2); // give the flushed part time to be read
+    echo("second part");
+    return true;
+  }
   return false;
 }
 
@@ -47,6 +47,12 @@ TestPerformance::TestPerformance() {
 bool TestPerformance::RunTests(const std::string &which) {
   bool ret = true;
   RUN_TEST(TestBasicOperations);
+  RUN_TEST(TestStringEscaping);
+  RUN_TEST(TestHashing);
+  RUN_TEST(TestConcatenation);
+  RUN_TEST(TestSorting);
+  RUN_TEST(TestSmallFunctions);
+  RUN_TEST(TestExceptions);
   RUN_TEST(TestMemoryUsage);
   RUN_TEST(TestAdHocFile);
   RUN_TEST(TestAdHoc);
@@ -135,6 +141,160 @@ bool TestPerformance::TestBasicOperations() {
       "\n\n/* Taking an object's property */"
       PERF_END);
 
+  VCR(PERF_START
+      "function iterate($n) { $a = array(1, 2, 3, 4, 5); $k = 0;\n"
+      "  for ($i = 0; $i < $n; $i++) { foreach ($a as $v) { $k += $v;}}\n"
+      "  return $k;}\n"
+      "iterate(" PERF_LOOP_COUNT ");"
+      "\n\n/* Iterating over a local array */"
+      PERF_END);
+
+  return true;
+}
+
+bool TestPerformance::TestStringEscaping() {
+  static const char *funcs[] = {
+    "htmlspecialchars", "addslashes", "urlencode", "rawurlencode",
+    "json_encode", NULL
+  };
+  for (int i = 0; funcs[i]; i++) {
+    string func = funcs[i];
+    string code =
+      PERF_START
+      "$a = str_repeat('template text without specials ', 8);\n"
+      "for ($i = 0; $i < 100; $i++) {"
+      "for ($j = 0; $j < " PERF_LOOP_COUNT "; $j++) { $b = " + func + "($a);}}"
+      "\n\n/* " + func + "() on a clean string */"
+      PERF_END;
+    VCR(code.c_str());
+
+    code =
+      PERF_START
+      "$a = str_repeat('<a href=\"x\">it\\'s/&amp;</a> ', 8);\n"
+      "for ($i = 0; $i < 100; $i++) {"
+      "for ($j = 0; $j < " PERF_LOOP_COUNT "; $j++) { $b = " + func + "($a);}}"
+      "\n\n/* " + func + "() on a string with specials */"
+      PERF_END;
+    VCR(code.c_str());
+  }
+  return true;
+}
+
+bool TestPerformance::TestHashing() {
+  static const char *exprs[] = {
+    "crc32($a)", "md5($a)", "sha1($a)", "hash('crc32', $a)",
+    "hash('crc32b', $a)", "hash('crc32c', $a)", NULL
+  };
+  for (int i = 0; exprs[i]; i++) {
+    string expr = exprs[i];
+    string code =
+      PERF_START
+      "$a = str_repeat('0123456789abcdef', 64);\n"
+      "for ($i = 0; $i < 20; $i++) {"
+      "for ($j = 0; $j < " PERF_LOOP_COUNT "; $j++) { $b = " + expr + ";}}"
+      "\n\n/* " + expr + " on 1KB */"
+      PERF_END;
+    VCR(code.c_str());
+  }
+  return true;
+}
+
+bool TestPerformance::TestConcatenation() {
+  VCR(PERF_START
+      "$name = 'name'; $id = 12345; $cls = 'item';\n"
+      "for ($i = 0; $i < 1000; $i++) {"
+      "for ($j = 0; $j < " PERF_LOOP_COUNT "; $j++) {"
+      "$b = \"<li class=\\\"$cls\\\" id=\\\"$id\\\"><a href=\\\"/p/$id\\\">\""
+      "   . \"$name</a></li>\";}}"
+      "\n\n/* template interpolation */"
+      PERF_END);
+  VCR(PERF_START
+      "$name = 'name'; $id = 12345;\n"
+      "for ($i = 0; $i < 100; $i++) { $b = '';"
+      "for ($j = 0; $j < 1000; $j++) {"
+      "$b .= '<td>' . $name . '</td><td>' . $id . '</td>';}}"
+      "\n\n/* .= with a multi-part right hand side */"
+      PERF_END);
+  return true;
+}
+
+bool TestPerformance::TestSorting() {
+  static const char *sizes[] = { "1000", "100000", "1000000", "10000000",
+                                 NULL };
+  for (int i = 0; sizes[i]; i++) {
+    string size = sizes[i];
+    string code =
+      PERF_START
+      "$a = array(); for ($i = 0; $i < " + size + "; $i++) "
+      "{ $a[] = mt_rand(-1000000000, 1000000000);}\n"
+      "$b = $a; sort($b); $b = $a; rsort($b);"
+      "\n\n/* sort() and rsort() on " + size + " integers */"
+      PERF_END;
+    VCR(code.c_str());
+
+    code =
+      PERF_START
+      "$a = array(); for ($i = 0; $i < " + size + "; $i++) "
+      "{ $a[] = 'key_' . mt_rand();}\n"
+      "$b = $a; sort($b); $b = array_flip($a); ksort($b);"
+      "\n\n/* sort() and ksort() on " + size + " strings */"
+      PERF_END;
+    VCR(code.c_str());
+  }
+  return true;
+}
+
+bool TestPerformance::TestSmallFunctions() {
+  VCR(PERF_START
+      "function add($a, $b) { return $a + $b; }\n"
+      "function test() { $k = 0;"
+      "for ($i = 0; $i < 1000; $i++) {"
+      "for ($j = 0; $j < " PERF_LOOP_COUNT "; $j++) { $k = add($k, $j);}}"
+      "return $k;} test();"
+      "\n\n/* calling a one-line helper */"
+      PERF_END);
+  VCR(PERF_START
+      "class C { private $v = 1;"
+      "private function get() { return $this->v; }"
+      "function test() { $k = 0;"
+      "for ($i = 0; $i < 1000; $i++) {"
+      "for ($j = 0; $j < " PERF_LOOP_COUNT "; $j++) { $k += $this->get();}}"
+      "return $k;}}\n"
+      "$c = new C(); $c->test();"
+      "\n\n/* calling a private getter */"
+      PERF_END);
+  return true;
+}
+
+bool TestPerformance::TestExceptions() {
+  VCR(PERF_START
+      "function deep($n) {"
+      "if ($n == 0) throw new Exception('deep'); return deep($n - 1);}\n"
+      "for ($i = 0; $i < " PERF_LOOP_COUNT "; $i++) {"
+      "try { deep(1); } catch (Exception $e) {}}"
+      "\n\n/* throw/catch 1 frame deep */"
+      PERF_END);
+  VCR(PERF_START
+      "function deep($n) {"
+      "if ($n == 0) throw new Exception('deep'); return deep($n - 1);}\n"
+      "for ($i = 0; $i < " PERF_LOOP_COUNT "; $i++) {"
+      "try { deep(50); } catch (Exception $e) {}}"
+      "\n\n/* throw/catch 50 frames deep */"
+      PERF_END);
+  VCR(PERF_START
+      "function deep($n) {"
+      "if ($n == 0) throw new Exception('deep'); return deep($n - 1);}\n"
+      "for ($i = 0; $i < " PERF_LOOP_COUNT "; $i++) {"
+      "try { deep(500); } catch (Exception $e) {}}"
+      "\n\n/* throw/catch 500 frames deep */"
+      PERF_END);
+  VCR(PERF_START
+      "function deep($n) {"
+      "if ($n == 0) throw new Exception('deep'); return deep($n - 1);}\n"
+      "for ($i = 0; $i < " PERF_LOOP_COUNT "; $i++) {"
+      "try { deep(500); } catch (Exception $e) { $e->getTrace(); }}"
+      "\n\n/* throw/catch 500 frames deep, asking for the trace */"
+      PERF_END);
   return true;
 }
 
@@ -31,6 +31,12 @@ class TestPerformance : public TestCodeRun {
   virtual bool RunTests(const std::string &which);
 
   bool TestBasicOperations();
+  bool TestStringEscaping();
+  bool TestHashing();
+  bool TestConcatenation();
+  bool TestSorting();
+  bool TestSmallFunctions();
+  bool TestExceptions();
   bool TestMemoryUsage();
   bool TestAdHocFile();
   bool TestAdHoc();
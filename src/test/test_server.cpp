@@ -28,6 +28,7 @@
 #include <cpp/base/server/http_request_handler.h>
 #include <cpp/base/util/http_client.h>
 #include <cpp/base/runtime_option.h>
+#include <util/hdf.h>
 
 using namespace std;
 using namespace boost;
@@ -38,6 +39,16 @@ using namespace HPHP;
 TestServer::TestServer() {
 }
 
+// port the test servers listen on, as configured in test/config-server.hdf
+static int get_server_port() {
+  static int port = 0;
+  if (port == 0) {
+    Hdf config("test/config-server.hdf");
+    port = config["Server"]["Port"].getInt16(8080);
+  }
+  return port;
+}
+
 bool TestServer::VerifyServerResponse(const char *input, const char *output,
                                       const char *url, const char *method,
                                       const char *header, const char *postdata,
@@ -69,7 +80,9 @@ bool TestServer::VerifyServerResponse(const char *input, const char *output,
 
   String server = "http://";
   server += f_php_uname("n");
-  server += ":8080/";
+  server += ":";
+  server += String(get_server_port());
+  server += "/";
   server += url;
   string actual, err;
   for (int i = 0; i < 10; i++) {
@@ -166,6 +179,7 @@ bool TestServer::RunTests(const std::string &which) {
   RUN_TEST(TestRequestHandling);
   //RUN_TEST(TestLibeventServer);
   RUN_TEST(TestHttpClient);
+  RUN_TEST(TestAsyncCompression);
 
   Logger::LogLevel = Logger::LogInfo;
   return ret;
@@ -506,3 +520,56 @@ bool TestServer::TestHttpClient() {
   server->waitForEnd();
   return Count(true);
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+class CompressibleHandler : public RequestHandler {
+public:
+  // implementing RequestHandler
+  virtual void handleRequest(Transport *transport) {
+    string response(10000, 'x'); // well over what is worth compressing
+    if (transport->getParam("chunked") == "1") {
+      transport->sendString(response, 200, false, true);
+      transport->sendString(response, 200, false, true);
+    } else {
+      transport->sendString(response + response);
+    }
+  }
+};
+
+bool TestServer::TestAsyncCompression() {
+  int threads = RuntimeOption::GzipCompressionThreads;
+  RuntimeOption::GzipCompressionThreads = 2;
+  int port = get_server_port();
+  ServerPtr server(new TypedServer<LibEventServer, CompressibleHandler>
+                   ("127.0.0.1", port, 50, -1));
+  RuntimeOption::GzipCompressionThreads = threads;
+  server->start();
+
+  string root = "http://127.0.0.1:" + lexical_cast<string>(port);
+  string urls[] = {
+    root + "/gzip",
+    root + "/gzip?chunked=1",
+  };
+  for (int i = 0; i < 2; i++) {
+    HttpClient http(5, 1, true, true);
+    StringBuffer response;
+    vector<String> responseHeaders;
+    int code = http.get(urls[i].c_str(), response, NULL, &responseHeaders);
+    VS(code, 200);
+    VS(response.detach(), String(string(20000, 'x')));
+
+    bool found = false;
+    for (unsigned int j = 0; j < responseHeaders.size(); j++) {
+      if (responseHeaders[j] == "Content-Encoding: gzip") {
+        found = true;
+      }
+    }
+    VERIFY(found);
+  }
+
+  server->stop();
+  server->waitForEnd();
+  return Count(true);
+}
+
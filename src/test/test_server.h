@@ -51,6 +51,9 @@ public:
   // test HttpClient class that proxy server uses
   bool TestHttpClient();
 
+  // test responses compressed on compression threads
+  bool TestAsyncCompression();
+
 protected:
   void RunServer();
   void StopServer();
@@ -15,6 +15,13 @@
 */
 
 #include <test/test_type_inference.h>
+#include <lib/parser/parser.h>
+#include <lib/code_generator.h>
+#include <lib/analysis/analysis_result.h>
+#include <lib/analysis/function_scope.h>
+#include <lib/system/builtin_symbols.h>
+#include <cpp/base/rtti_info.h>
+#include <util/util.h>
 
 using namespace std;
 
@@ -37,6 +44,7 @@ bool TestTypeInference::RunTests(const std::string &which) {
   RUN_TEST(TestFunctionReturn);
   RUN_TEST(TestFunctionParameter);
   RUN_TEST(TestMethodParameter);
+  RUN_TEST(TestRTTISpecialization);
   return ret;
 }
 
@@ -449,3 +457,77 @@ bool TestTypeInference::TestMethodParameter() {
 
   return true;
 }
+
+/**
+ * Parameters seen with one type in most of their profiled calls get a typed
+ * clone of their function, which only its call sites can reach.
+ */
+static bool write_rtti_file(const std::string &path, const char *content) {
+  FILE *f = fopen(path.c_str(), "w");
+  if (!f) return false;
+  fputs(content, f);
+  fclose(f);
+  return true;
+}
+
+bool TestTypeInference::TestRTTISpecialization() {
+  char dir[] = "/tmp/test_rttiXXXXXX";
+  VERIFY(mkdtemp(dir));
+  string meta = string(dir) + "/meta";
+  string profile = string(dir) + "/profile";
+  Util::mkdir(profile + "/");
+
+  // meta data from before the header was added is not misread
+  VERIFY(write_rtti_file(meta, "1\nfoo::a\nfoo\n"));
+  {
+    RTTIInfo info;
+    VERIFY(!info.loadMetaData(meta.c_str()));
+  }
+
+  VERIFY(write_rtti_file(meta, (string(RTTIInfo::MetaDataHeader) +
+                                "\n1\nfoo::a\nfoo\n").c_str()));
+  RTTICounter counter;
+  memset(&counter, 0, sizeof(counter));
+  counter[KindOfInt64] = 2000;
+  {
+    FILE *f = fopen((profile + "/1.rtti").c_str(), "w");
+    VERIFY(f);
+    fwrite(&counter, sizeof(counter), 1, f);
+    fclose(f);
+  }
+  RTTIInfo info;
+  VERIFY(info.loadMetaData(meta.c_str()));
+  VERIFY(info.exists("foo"));
+  VERIFY(info.loadProfData(profile.c_str()));
+  VERIFY(info.getDominantType("foo::a", 1000, 90) == KindOfInt64);
+
+  AnalysisResultPtr ar(new AnalysisResult());
+  BuiltinSymbols::load(ar);
+  Parser::parseString("<?php function foo($a) { return $a + 1;} "
+                      "$x = foo($y); "
+                      "$z = function_exists('foo$$rtti_i');", ar);
+  ar->cloneRTTIFuncs(info);
+  ar->analyzeProgram();
+  ar->preOptimize();
+  ar->inferTypes();
+  ar->postOptimize();
+  ostringstream code;
+  CodeGenerator cg(&code);
+  Option::GenerateCPPMacros = m_verbose;
+  ar->outputAllCPP(cg);
+  Util::ssystem((string("rm -rf ") + dir).c_str());
+
+  FunctionScopePtr clone = ar->findFunction("foo$$rtti_i");
+  VERIFY(clone);
+  VERIFY(clone->isInternalFunction());
+  VERIFY(!ar->findFunction("foo")->isInternalFunction());
+
+  // the call dispatches to the clone, whose parameter is typed...
+  string actual = code.str();
+  VERIFY(actual.find("f_foo$$rtti_i(int64 v_a)") != string::npos);
+  VERIFY(actual.find("is_int(") != string::npos);
+  // ...and nothing finds the clone by its name
+  VERIFY(actual.find("\"foo$$rtti_i\"") == string::npos);
+  return Count(true);
+}
+
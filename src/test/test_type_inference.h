@@ -39,6 +39,7 @@ class TestTypeInference : public TestTransformer {
   bool TestFunctionReturn();
   bool TestFunctionParameter();
   bool TestMethodParameter();
+  bool TestRTTISpecialization();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
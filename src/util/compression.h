@@ -39,6 +39,7 @@ char *gzinflate(const char *data, int &len, int limit = 0);
 
 ///////////////////////////////////////////////////////////////////////////////
 
+DECLARE_BOOST_TYPES(StreamCompressor);
 class StreamCompressor {
 public:
   StreamCompressor(int level, int encoding_mode, bool header);
@@ -21,7 +21,9 @@
 #include "lock.h"
 #include "async_job.h"
 #include "util.h"
+#include "timer.h"
 #include <boost/lexical_cast.hpp>
+#include <poll.h>
 
 using namespace std;
 using namespace boost;
@@ -91,12 +93,125 @@ const std::string &ServerData::getPassword() const {
   return m_password.empty() ? DefaultPassword : m_password;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Class DBConnPool
+
+unsigned int DBConnPool::MaxIdlePerServer = 0;
+unsigned int DBConnPool::MaxIdleSeconds = 60;
+unsigned int DBConnPool::PingAfterSeconds = 5;
+
+Mutex DBConnPool::s_mutex;
+DBConnPool::IdleConnMap DBConnPool::s_idle;
+
+std::string DBConnPool::GetKey(ServerDataPtr server, int connectTimeout,
+                               int readTimeout) {
+  // '\0' separated, so no username or password can forge another's key
+  string key = server->getUserName();
+  key += '\0';
+  key += server->getPassword();
+  key += '\0';
+  key += server->getIP();
+  key += '\0';
+  key += server->getDatabase();
+  key += '\0';
+  key += lexical_cast<string>(server->getPort());
+  key += '\0';
+  key += lexical_cast<string>(connectTimeout);
+  key += '\0';
+  key += lexical_cast<string>(readTimeout);
+  return key;
+}
+
+MYSQL *DBConnPool::Acquire(ServerDataPtr server, int connectTimeout,
+                           int readTimeout) {
+  if (MaxIdlePerServer == 0) {
+    return NULL;
+  }
+
+  string key = GetKey(server, connectTimeout, readTimeout);
+  while (true) {
+    IdleConn idle;
+    {
+      Lock lock(s_mutex);
+      IdleConnMap::iterator iter = s_idle.find(key);
+      if (iter == s_idle.end() || iter->second.empty()) {
+        return NULL;
+      }
+      // most recently used first, so the oldest ones can expire
+      idle = iter->second.back();
+      iter->second.pop_back();
+    }
+
+    time_t idleTime = time(NULL) - idle.lastUsed;
+    if (idleTime < (time_t)MaxIdleSeconds &&
+        (idleTime < (time_t)PingAfterSeconds || mysql_ping(idle.conn) == 0)) {
+      return idle.conn;
+    }
+    mysql_close(idle.conn);
+  }
+}
+
+void DBConnPool::Release(ServerDataPtr server, int connectTimeout,
+                         int readTimeout, MYSQL *conn) {
+  ASSERT(conn);
+  if (MaxIdlePerServer == 0) {
+    mysql_close(conn);
+    return;
+  }
+
+  time_t now = time(NULL);
+  vector<MYSQL*> expired;
+  {
+    string key = GetKey(server, connectTimeout, readTimeout);
+    Lock lock(s_mutex);
+    deque<IdleConn> &conns = s_idle[key];
+    while (!conns.empty() &&
+           (conns.size() >= MaxIdlePerServer ||
+            now - conns.front().lastUsed >= (time_t)MaxIdleSeconds)) {
+      expired.push_back(conns.front().conn);
+      conns.pop_front();
+    }
+    IdleConn idle;
+    idle.conn = conn;
+    idle.lastUsed = now;
+    conns.push_back(idle);
+  }
+
+  for (unsigned int i = 0; i < expired.size(); i++) {
+    mysql_close(expired[i]);
+  }
+}
+
+void DBConnPool::Clear() {
+  IdleConnMap idle;
+  {
+    Lock lock(s_mutex);
+    idle.swap(s_idle);
+  }
+  for (IdleConnMap::iterator iter = idle.begin(); iter != idle.end(); ++iter) {
+    for (unsigned int i = 0; i < iter->second.size(); i++) {
+      mysql_close(iter->second[i].conn);
+    }
+  }
+}
+
+int DBConnPool::GetIdleCount() {
+  Lock lock(s_mutex);
+  int count = 0;
+  for (IdleConnMap::const_iterator iter = s_idle.begin();
+       iter != s_idle.end(); ++iter) {
+    count += iter->second.size();
+  }
+  return count;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // static members
 
 unsigned int DBConn::DefaultWorkerCount = 50;
 unsigned int DBConn::DefaultConnectTimeout = 1000;
 unsigned int DBConn::DefaultReadTimeout = 1000;
+bool DBConn::MultiplexParallelQueries = false;
 
 Mutex DBConn::s_mutex;
 ServerDataPtrVec DBConn::s_localDatabases;
@@ -121,7 +236,7 @@ void DBConn::addLocalDB(unsigned int dbId, const char *ip, const char *db) {
 
 DBConn::DBConn()
   : m_conn(NULL), m_connectTimeout(DefaultConnectTimeout),
-    m_readTimeout(DefaultReadTimeout) {
+    m_readTimeout(DefaultReadTimeout), m_reusable(false) {
 }
 
 DBConn::~DBConn() {
@@ -137,34 +252,49 @@ void DBConn::open(ServerDataPtr server, int connectTimeout /* = -1 */,
   if (connectTimeout <= 0) connectTimeout = DefaultConnectTimeout;
   if (readTimeout <= 0) readTimeout = DefaultReadTimeout;
 
-  m_conn = mysql_init(NULL);
-  MySQLUtil::set_mysql_timeout(m_conn, MySQLUtil::ConnectTimeout, connectTimeout);
-  MySQLUtil::set_mysql_timeout(m_conn, MySQLUtil::ReadTimeout, readTimeout);
-  MYSQL *ret = mysql_real_connect(m_conn, server->getIP().c_str(),
-                                  server->getUserName().c_str(),
-                                  server->getPassword().c_str(),
+  m_conn = DBConnPool::Acquire(server, connectTimeout, readTimeout);
+  if (!m_conn) {
+    m_conn = mysql_init(NULL);
+    MySQLUtil::set_mysql_timeout(m_conn, MySQLUtil::ConnectTimeout,
+                                 connectTimeout);
+    MySQLUtil::set_mysql_timeout(m_conn, MySQLUtil::ReadTimeout, readTimeout);
+    MYSQL *ret = mysql_real_connect(m_conn, server->getIP().c_str(),
+                                    server->getUserName().c_str(),
+                                    server->getPassword().c_str(),
+                                    server->getDatabase().c_str(),
+                                    server->getPort(), NULL, 0);
+    if (!ret) {
+      const char *msg = mysql_error(m_conn);
+      string smsg = msg ? msg : "";
+      mysql_close(m_conn);
+      m_conn = NULL;
+      throw DBConnectionException(server->getIP().c_str(),
                                   server->getDatabase().c_str(),
-                                  server->getPort(), NULL, 0);
-  if (!ret) {
-    const char *msg = mysql_error(m_conn);
-    string smsg = msg ? msg : "";
-    mysql_close(m_conn);
-    m_conn = NULL;
-    throw DBConnectionException(server->getIP().c_str(),
-                                server->getDatabase().c_str(),
-                                smsg.c_str());
+                                  smsg.c_str());
+    }
   }
 
   m_server = server;
   m_connectTimeout = connectTimeout;
   m_readTimeout = readTimeout;
+  m_reusable = true;
 }
 
 void DBConn::close() {
   if (isOpened()) {
-    mysql_close(m_conn);
+    // COM_CHANGE_USER drops session state: user variables, temporary tables
+    // and open transactions must not be seen by the next user of m_conn
+    if (m_reusable && DBConnPool::MaxIdlePerServer > 0 &&
+        mysql_change_user(m_conn, m_server->getUserName().c_str(),
+                          m_server->getPassword().c_str(),
+                          m_server->getDatabase().c_str()) == 0) {
+      DBConnPool::Release(m_server, m_connectTimeout, m_readTimeout, m_conn);
+    } else {
+      mysql_close(m_conn);
+    }
     m_conn = NULL;
     m_server.reset();
+    m_reusable = false;
   }
 }
 
@@ -197,9 +327,12 @@ int DBConn::execute(const char *sql, DBDataSet *ds /* = NULL */,
   {
     bool failure;
     if ((failure = mysql_query(m_conn, sql))) {
+      m_reusable = false;
       if (retryQueryOnFail) {
         open(m_server, m_connectTimeout, m_readTimeout);
-        failure = mysql_query(m_conn, sql);
+        if ((failure = mysql_query(m_conn, sql))) {
+          m_reusable = false;
+        }
       }
       if (failure) {
         throw DatabaseException("Failed to execute SQL '%s': %s", sql,
@@ -208,8 +341,35 @@ int DBConn::execute(const char *sql, DBDataSet *ds /* = NULL */,
     }
   }
 
+  return storeResult(sql, ds);
+}
+
+void DBConn::sendQuery(const char *sql) {
+  ASSERT(sql && *sql);
+  ASSERT(isOpened());
+
+  if (mysql_send_query(m_conn, sql, strlen(sql))) {
+    m_reusable = false;
+    throw DatabaseException("Failed to execute SQL '%s': %s", sql,
+                            mysql_error(m_conn));
+  }
+}
+
+int DBConn::readResult(const char *sql, DBDataSet *ds) {
+  ASSERT(isOpened());
+
+  if (mysql_read_query_result(m_conn)) {
+    m_reusable = false;
+    throw DatabaseException("Failed to execute SQL '%s': %s", sql,
+                            mysql_error(m_conn));
+  }
+  return storeResult(sql, ds);
+}
+
+int DBConn::storeResult(const char *sql, DBDataSet *ds) {
   MYSQL_RES *result = mysql_store_result(m_conn);
   if (!result && mysql_errno(m_conn)) {
+    m_reusable = false;
     throw DatabaseException("Failed to execute SQL '%s': %s", sql,
                             mysql_error(m_conn));
   }
@@ -223,6 +383,11 @@ int DBConn::execute(const char *sql, DBDataSet *ds /* = NULL */,
   return affected;
 }
 
+int DBConn::getSocket() const {
+  ASSERT(isOpened());
+  return m_conn->net.fd;
+}
+
 int DBConn::getLastInsertId() {
   ASSERT(isOpened());
   return mysql_insert_id(m_conn);
@@ -302,8 +467,13 @@ int DBConn::parallelExecute(const ServerQueryVec &sqls,
 
 int DBConn::parallelExecute(QueryJobPtrVec &jobs,
                             map<int, string> &errors, int maxThread) {
-  if (maxThread <= 0) maxThread = DefaultWorkerCount;
-  JobDispatcher<QueryJob, QueryWorker>(jobs, maxThread).run();
+  // without pooling, multiplexing would connect to every server in turn
+  if (MultiplexParallelQueries && DBConnPool::MaxIdlePerServer > 0) {
+    multiplexExecute(jobs);
+  } else {
+    if (maxThread <= 0) maxThread = DefaultWorkerCount;
+    JobDispatcher<QueryJob, QueryWorker>(jobs, maxThread).run();
+  }
 
   int affected = 0;
   for (unsigned int i = 0; i < jobs.size(); i++) {
@@ -319,15 +489,112 @@ int DBConn::parallelExecute(QueryJobPtrVec &jobs,
   return affected;
 }
 
-void DBConn::QueryWorker::doJob(QueryJobPtr job) {
-  string &sql = job->m_sql;
-  Util::replaceAll(sql, "INDEX", lexical_cast<string>(job->m_index).c_str());
+void DBConn::multiplexExecute(QueryJobPtrVec &jobs) {
+  vector<boost::shared_ptr<DBConn> > conns(jobs.size());
+  vector<pollfd> fds;
+  vector<int> pending; // job index of each entry in fds
+  int readTimeout = 0;
 
-  if (!job->m_server) {
-    job->m_affected = -1;
-    job->m_error = "(server info missing)";
-    return;
+  for (unsigned int i = 0; i < jobs.size(); i++) {
+    QueryJobPtr job = jobs[i];
+    if (!job->prepare()) continue;
+
+    try {
+      conns[i] = boost::shared_ptr<DBConn>(new DBConn());
+      conns[i]->open(job->m_server, job->m_connectTimeout, job->m_readTimeout);
+      conns[i]->sendQuery(job->m_sql.c_str());
+
+      pollfd fd;
+      fd.fd = conns[i]->getSocket();
+      fd.events = POLLIN;
+      fd.revents = 0;
+      fds.push_back(fd);
+      pending.push_back(i);
+      if (readTimeout < (int)conns[i]->m_readTimeout) {
+        readTimeout = conns[i]->m_readTimeout;
+      }
+    } catch (Exception &e) {
+      job->setError(e.getMessage());
+    } catch (std::exception &e) {
+      job->setError(e.what());
+    } catch (...) {
+      job->setError("(unknown exception)");
+    }
+  }
+
+  Timer timer(Timer::WallTime);
+  while (!fds.empty()) {
+    int remaining = readTimeout - timer.getMicroSeconds() / 1000;
+    if (remaining <= 0) break;
+
+    int n = poll(&fds[0], fds.size(), remaining);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+
+    for (int i = fds.size() - 1; i >= 0 && n > 0; i--) {
+      if (fds[i].revents) {
+        n--;
+        int index = pending[i];
+        collectResult(jobs[index], *conns[index]);
+        fds.erase(fds.begin() + i);
+        pending.erase(pending.begin() + i);
+      }
+    }
+  }
+
+  for (unsigned int i = 0; i < pending.size(); i++) {
+    int index = pending[i];
+    conns[index]->m_reusable = false; // result still in flight
+    jobs[index]->setError("(query timed out)");
+  }
+}
+
+void DBConn::collectResult(QueryJobPtr job, DBConn &conn) {
+  const char *sql = job->m_sql.c_str();
+  try {
+    DBDataSet ds;
+    DBDataSet *pds = job->m_dsResult ? &ds : NULL;
+    try {
+      job->m_affected = conn.readResult(sql, pds);
+    } catch (DatabaseException &e) {
+      if (!job->m_retryQueryOnFail) throw;
+      // a pooled connection may have gone away; retry synchronously
+      conn.open(job->m_server, job->m_connectTimeout, job->m_readTimeout);
+      job->m_affected = conn.execute(sql, pds, false);
+    }
+    if (pds) {
+      Lock lock(*job->m_dsMutex);
+      job->m_dsResult->addDataSet(ds);
+    }
+  } catch (Exception &e) {
+    job->setError(e.getMessage());
+  } catch (std::exception &e) {
+    job->setError(e.what());
+  } catch (...) {
+    job->setError("(unknown exception)");
+  }
+}
+
+bool DBConn::QueryJob::prepare() {
+  Util::replaceAll(m_sql, "INDEX", lexical_cast<string>(m_index).c_str());
+
+  if (!m_server) {
+    setError("(server info missing)");
+    return false;
   }
+  return true;
+}
+
+void DBConn::QueryJob::setError(const std::string &error) {
+  m_affected = -1;
+  m_error = error;
+}
+
+void DBConn::QueryWorker::doJob(QueryJobPtr job) {
+  if (!job->prepare()) return;
+  string &sql = job->m_sql;
 
   try {
     DBConn conn;
@@ -343,15 +610,12 @@ void DBConn::QueryWorker::doJob(QueryJobPtr job) {
       job->m_affected = conn.execute(sql.c_str(), NULL,
                                      job->m_retryQueryOnFail);
     }
-  } catch (Exception e) {
-    job->m_affected = -1;
-    job->m_error = e.getMessage();
+  } catch (Exception &e) {
+    job->setError(e.getMessage());
   } catch (std::exception &e) {
-    job->m_affected = -1;
-    job->m_error = e.what();
+    job->setError(e.what());
   } catch (...) {
-    job->m_affected = -1;
-    job->m_error = "(unknown exception)";
+    job->setError("(unknown exception)");
   }
 }
 
@@ -64,6 +64,54 @@ typedef std::vector<ServerQuery> ServerQueryVec;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/**
+ * Process-wide cache of idle MySQL connections, keyed by server address,
+ * credentials, database and timeouts. DBConn takes connections from here in
+ * open() and hands them back in close(), so parallel queries against the same
+ * shards don't pay a TCP and auth handshake every time.
+ */
+class DBConnPool {
+ public:
+  static unsigned int MaxIdlePerServer; // 0 to disable pooling
+  static unsigned int MaxIdleSeconds;   // idle connections older are closed
+  static unsigned int PingAfterSeconds; // health check before reusing
+
+  /**
+   * Returns an idle connection that passed health checks, or NULL.
+   */
+  static MYSQL *Acquire(ServerDataPtr server, int connectTimeout,
+                        int readTimeout);
+
+  /**
+   * Gives a healthy connection back, or closes it when the pool is full.
+   * Callers reset its session state first.
+   */
+  static void Release(ServerDataPtr server, int connectTimeout,
+                      int readTimeout, MYSQL *conn);
+
+  /**
+   * Closes all idle connections.
+   */
+  static void Clear();
+
+  static int GetIdleCount();
+
+ private:
+  struct IdleConn {
+    MYSQL *conn;
+    time_t lastUsed;
+  };
+  typedef std::map<std::string, std::deque<IdleConn> > IdleConnMap;
+
+  static Mutex s_mutex;
+  static IdleConnMap s_idle;
+
+  static std::string GetKey(ServerDataPtr server, int connectTimeout,
+                            int readTimeout);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 /**
  * A connection class that connects to any of our databases.
  */
@@ -72,6 +120,7 @@ class DBConn {
   static unsigned int DefaultWorkerCount; // for parallel executions
   static unsigned int DefaultConnectTimeout;
   static unsigned int DefaultReadTimeout;
+  static bool MultiplexParallelQueries; // poll() instead of worker threads
 
  public:
   DBConn();
@@ -101,6 +150,11 @@ class DBConn {
    * Query local dbs in parallel. Returns number of total affecected rows.
    * Use "DBID" for any place in the query that needs to be replaced by dbId.
    * For example, "SELECT DBID as dbid, count(*) as count FROM ...".
+   *
+   * With MultiplexParallelQueries and pooling on, maxThread is ignored and
+   * all queries are sent from the calling thread over pooled connections,
+   * then their results are collected as the sockets become readable.
+   * Otherwise each query runs on a worker thread of its own.
    */
   static int parallelExecute
     (const char *sql, DBDataSet &ds, std::map<int, std::string> &errors,
@@ -144,6 +198,16 @@ class DBConn {
   ServerDataPtr m_server;
   unsigned int m_connectTimeout;
   unsigned int m_readTimeout;
+  bool m_reusable; // whether close() can hand m_conn back to DBConnPool
+
+  /**
+   * Split execute() for multiplexing: sendQuery() doesn't wait for the
+   * server, and readResult() collects what it sent back.
+   */
+  void sendQuery(const char *sql);
+  int readResult(const char *sql, DBDataSet *ds);
+  int storeResult(const char *sql, DBDataSet *ds);
+  int getSocket() const;
 
   class QueryJob {
   public:
@@ -165,6 +229,12 @@ class DBConn {
     bool m_retryQueryOnFail;
     int m_connectTimeout;
     int m_readTimeout;
+
+    /**
+     * Substitutes INDEX in m_sql. Returns false if there is nothing to run.
+     */
+    bool prepare();
+    void setError(const std::string &error);
   };
   DECLARE_BOOST_TYPES(QueryJob);
 
@@ -176,6 +246,8 @@ class DBConn {
   static int parallelExecute(QueryJobPtrVec &jobs,
                              std::map<int, std::string> &errors,
                              int maxThread);
+  static void multiplexExecute(QueryJobPtrVec &jobs);
+  static void collectResult(QueryJobPtr job, DBConn &conn);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -73,11 +73,23 @@ public:
   // trial class for signaling queue stop
   class StopSignal {};
 
+  // trial class for signaling a worker that has been waiting for too long
+  class IdleSignal {};
+
 public:
   /**
    * Constructor.
    */
-  JobQueue() : m_stopped(false), m_workerCount(0) {
+  JobQueue() : m_stopped(false), m_workerCount(0), m_idleTimeout(0),
+               m_idleWakeups(0) {
+  }
+
+  /**
+   * Have dequeue() throw IdleSignal whenever a worker has been waiting for
+   * a job longer than this many seconds. 0 to wait forever.
+   */
+  void setIdleTimeout(int seconds) {
+    m_idleTimeout = seconds;
   }
 
   /**
@@ -100,13 +112,31 @@ public:
       if (m_stopped) {
         throw StopSignal();
       }
-      wait();
+      int wakeups = m_idleWakeups;
+      bool timedout = false;
+      if (m_idleTimeout > 0) {
+        timedout = !wait(m_idleTimeout);
+      } else {
+        wait();
+      }
+      if (m_jobs.empty() && (timedout || wakeups != m_idleWakeups)) {
+        throw IdleSignal();
+      }
     }
     TJob job = m_jobs.front();
     m_jobs.pop_front();
     return job;
   }
 
+  /**
+   * Make every worker that's waiting for a job throw IdleSignal right away.
+   */
+  void wakeIdleWorkers() {
+    Lock lock(getMutex());
+    m_idleWakeups++;
+    notifyAll();
+  }
+
   /**
    * Purely for making sure no new jobs are queued when we are stopping.
    */
@@ -133,6 +163,8 @@ public:
   std::deque<TJob> m_jobs;
   bool m_stopped;
   int m_workerCount;
+  int m_idleTimeout;
+  int m_idleWakeups;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -169,6 +201,7 @@ public:
   virtual void doJob(TJob job) = 0;
   virtual void onThreadEnter() {}
   virtual void onThreadExit() {}
+  virtual void onThreadIdle() {}
 
   /**
    * Start this worker thread.
@@ -184,6 +217,8 @@ public:
         if (countActive) m_queue->decActiveWorker();
       } catch (typename JobQueue<TJob>::StopSignal) {
         m_stopped = true; // queue is empty and queue is stopped, so we are done
+      } catch (typename JobQueue<TJob>::IdleSignal) {
+        onThreadIdle();
       }
     }
     onThreadExit();
@@ -242,6 +277,17 @@ public:
     return m_queue.getActiveWorker();
   }
 
+  /**
+   * Call workers' onThreadIdle() after they have been waiting for a job for
+   * this many seconds, or whenever wakeIdleWorkers() is called.
+   */
+  void setIdleTimeout(int seconds) {
+    m_queue.setIdleTimeout(seconds);
+  }
+  void wakeIdleWorkers() {
+    m_queue.wakeIdleWorkers();
+  }
+
   /**
    * Creates worker threads and start running them. This is non-blocking.
    */
@@ -137,7 +137,7 @@ public:
     : m_head(NULL), m_tail(NULL), m_immortalCount(0),
       m_maturityThreshold(maturity), m_maximumCapacity(maxCap),
       m_updatePeriod(updatePeriod) {}
-  ~LFUTable() {
+  virtual ~LFUTable() {
     clear();
   }
 
@@ -184,6 +184,19 @@ public:
     return false;
   }
 
+  /**
+   * Like atomicRead(), without counting as an access.
+   */
+  bool atomicPeek(const K &k, AtomicReader &reader) {
+    ReadLock lock(m_mapLock);
+    typename Map::iterator it = m_map.find(k);
+    if (it != m_map.end()) {
+      reader.read(it->second->key, it->second->val);
+      return true;
+    }
+    return false;
+  }
+
   void atomicForeach(AtomicReader &reader) {
     ReadLock lock(m_mapLock);
     for (typename Map::const_iterator it = m_map.begin();
@@ -323,6 +336,13 @@ public:
     return !fail;
   }
 
+protected:
+  /**
+   * Called with the map lock held, right before an element is dropped to
+   * make room for a new one, so the owner can forget about it.
+   */
+  virtual void onEvict(const K &k, V &v) {}
+
 private:
   class Node {
   public:
@@ -407,6 +427,7 @@ private:
     while (size() - m_immortalCount >= m_maximumCapacity) {
       Node *m = popQueue();
       ASSERT(m);
+      onEvict(m->key, m->val);
       m_map.erase(m->key);
       delete m;
     }